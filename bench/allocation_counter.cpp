@@ -0,0 +1,158 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Counting replacement of the global allocation functions, used to report the allocations of the benchmarked stages.
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <nlohmann/json.hpp>
+#include "allocation_counter.h"
+
+namespace {
+
+std::atomic<uint64_t> allocation_count = 0;
+std::atomic<uint64_t> allocated_bytes = 0;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        void* pointer = std::malloc(size);
+        if (pointer != nullptr) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+namespace allocation_counter {
+
+//! Function used to get the number of allocations and allocated bytes since the start of the program
+Snapshot Current() {
+    return {allocation_count.load(std::memory_order_relaxed), allocated_bytes.load(std::memory_order_relaxed)};
+}
+
+//! Function used to report the allocations since the given snapshot as counters of the benchmark
+void Report(benchmark::State& state, const Snapshot& start) {
+    Snapshot end = Current();
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(end.allocations - start.allocations),
+                                                       benchmark::Counter::kAvgIterations);
+    state.counters["bytes"] = benchmark::Counter(static_cast<double>(end.bytes - start.bytes),
+                                                 benchmark::Counter::kAvgIterations,
+                                                 benchmark::Counter::OneK::kIs1024);
+}
+
+//! Function used to collect the reported allocations before printing the runs
+void BudgetReporter::ReportRuns(const std::vector<Run>& reports) {
+    for (const auto& run : reports) {
+        // Aggregates of repeated runs would otherwise overwrite the measured values
+        if (run.run_type != Run::RT_Iteration or run.skipped) {
+            continue;
+        }
+        auto counter = run.counters.find("allocations");
+        if (counter != run.counters.end()) {
+            allocations[run.benchmark_name()] = counter->second.value;
+        }
+    }
+    ConsoleReporter::ReportRuns(reports);
+}
+
+//! Function used to write the collected allocations into a budget file
+int BudgetReporter::WriteBudget(const std::string& path) const {
+    nlohmann::ordered_json budget_json;
+    for (const auto& allocation : allocations) {
+        budget_json[allocation.first] = std::llround(allocation.second);
+    }
+    std::ofstream f(path);
+    f << budget_json.dump(4) << std::endl;
+    if (!f.good()) {
+        std::cerr << "Failed to write allocation budget: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! Function used to compare the collected allocations against a budget file
+int BudgetReporter::CheckBudget(const std::string& path) const {
+    nlohmann::ordered_json budget_json;
+    try {
+        std::ifstream f(path);
+        budget_json = nlohmann::ordered_json::parse(f);
+    }
+    catch (const std::exception& err) {
+        std::cerr << "Failed to load allocation budget: " << path << std::endl;
+        return -1;
+    }
+
+    int result = 0;
+    for (const auto& allocation : allocations) {
+        if (!budget_json.contains(allocation.first)) {
+            continue;
+        }
+        // The allocations of a stage are deterministic, so every additional allocation is a regression
+        // One-time allocations, e.g. of static tables, are averaged out by rounding
+        long long measured = std::llround(allocation.second);
+        long long budget = budget_json.at(allocation.first).get<long long>();
+        if (measured > budget) {
+            std::cerr << "Allocation regression in " << allocation.first << ": " << measured
+                      << " allocations per iteration, budget is " << budget << std::endl;
+            result = -1;
+        }
+    }
+    return result;
+}
+
+} // namespace allocation_counter
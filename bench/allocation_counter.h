@@ -0,0 +1,82 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Counting replacement of the global allocation functions, used to report the allocations of the benchmarked stages.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_BENCH_ALLOCATION_COUNTER_H_
+#define SDF_MATTER_CONVERTER_BENCH_ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+namespace allocation_counter {
+
+//! Number of allocations and allocated bytes at a point in time
+struct Snapshot {
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+//! @brief Get the number of allocations and allocated bytes since the start of the program.
+Snapshot Current();
+
+//! @brief Report the allocations since the given snapshot as counters of the benchmark.
+//!
+//! The counters `allocations` and `bytes` are averaged over the iterations of the benchmark.
+//!
+//! @param state The state of the benchmark.
+//! @param start The snapshot taken before the benchmark loop.
+void Report(benchmark::State& state, const Snapshot& start);
+
+//! Reporter used to collect the reported allocations of every benchmark
+//! Prints the results like the default console reporter.
+class BudgetReporter : public benchmark::ConsoleReporter {
+public:
+    void ReportRuns(const std::vector<Run>& reports) override;
+
+    //! @brief Write the collected allocations into a budget file.
+    //!
+    //! @param path The path to the budget file.
+    //! @return 0 on success, negative on failure.
+    int WriteBudget(const std::string& path) const;
+
+    //! @brief Compare the collected allocations against a budget file.
+    //!
+    //! Every benchmark that allocates more often than listed in the budget gets reported as regression.
+    //! Benchmarks that are not listed in the budget are ignored.
+    //!
+    //! @param path The path to the budget file.
+    //! @return 0 if no benchmark exceeds its budget, negative otherwise.
+    int CheckBudget(const std::string& path) const;
+
+private:
+    //! Allocations per iteration for every benchmark
+    std::map<std::string, double> allocations;
+};
+
+} // namespace allocation_counter
+
+#endif //SDF_MATTER_CONVERTER_BENCH_ALLOCATION_COUNTER_H_
@@ -0,0 +1,444 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Benchmarks for the individual stages of the conversion in both directions.
+ * The scaling benchmarks run the mapping stages on generated models of increasing size.
+ * Every benchmark reports the allocations and allocated bytes per iteration, which can be checked against a budget.
+ */
+
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+#include <list>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include <pugixml.hpp>
+#include "allocation_counter.h"
+#include "generator.h"
+#include "library.h"
+#include "loader.h"
+#include "matter.h"
+#include "matter_to_sdf.h"
+#include "prescan.h"
+#include "sdf.h"
+#include "sdf_to_matter.h"
+
+using json = nlohmann::ordered_json;
+
+namespace {
+
+//! Inputs of every stage, derived from the fixtures once
+struct Fixtures {
+    pugi::xml_document device_xml;
+    std::list<pugi::xml_document> cluster_xml_list;
+    //! Matter to sdf
+    matter::Device device;
+    std::list<matter::Cluster> cluster_list;
+    //! Flat cluster library containing the cluster list
+    std::string library_path;
+    //! Sdf to matter
+    sdf::SdfModel sdf_model;
+    sdf::SdfMapping sdf_mapping;
+    json sdf_model_json;
+    json sdf_mapping_json;
+    std::list<matter::Cluster> mapped_cluster_list;
+};
+
+//! Function used to load a xml fixture
+void LoadXmlFixture(const std::string& name, pugi::xml_document& xml_document) {
+    std::string path = std::string(CONVERTER_BENCH_FIXTURES) + "/" + name;
+    if (!xml_document.load_file(path.c_str())) {
+        throw std::runtime_error("Failed to load fixture: " + path);
+    }
+}
+
+//! Function used to load the fixtures and prepare the input of every stage
+//! The sdf inputs get generated from the matter fixtures, so both directions work on the same data.
+Fixtures LoadFixtures() {
+    Fixtures fixtures;
+    LoadXmlFixture("OnOffLight.xml", fixtures.device_xml);
+    for (const char* name : {"Identify.xml", "OnOff.xml"}) {
+        LoadXmlFixture(name, fixtures.cluster_xml_list.emplace_back());
+    }
+
+    fixtures.device = matter::ParseDevice(fixtures.device_xml.document_element());
+    for (const auto& cluster_xml : fixtures.cluster_xml_list) {
+        fixtures.cluster_list.push_back(matter::ParseCluster(cluster_xml.document_element()));
+    }
+
+    fixtures.library_path = (std::filesystem::temp_directory_path() / "converter_bench.library").string();
+    int fd = open(fixtures.library_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 or library::WriteLibrary(fixtures.cluster_list, fd) != 0 or close(fd) != 0) {
+        throw std::runtime_error("Failed to save cluster library: " + fixtures.library_path);
+    }
+
+    MapMatterToSdf(fixtures.device, fixtures.cluster_list, fixtures.sdf_model, fixtures.sdf_mapping);
+    fixtures.sdf_model_json = sdf::SerializeSdfModel(fixtures.sdf_model);
+    fixtures.sdf_mapping_json = sdf::SerializeSdfMapping(fixtures.sdf_mapping);
+
+    std::optional<matter::Device> optional_device;
+    MapSdfToMatter(fixtures.sdf_model, fixtures.sdf_mapping, optional_device, fixtures.mapped_cluster_list);
+    return fixtures;
+}
+
+//! Function used to get the fixtures shared by all benchmarks
+Fixtures& GetFixtures() {
+    static Fixtures fixtures = LoadFixtures();
+    return fixtures;
+}
+
+void BM_ParseCluster(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        for (const auto& cluster_xml : fixtures.cluster_xml_list) {
+            matter::Cluster cluster = matter::ParseCluster(cluster_xml.document_element());
+            benchmark::DoNotOptimize(cluster);
+        }
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations() * fixtures.cluster_xml_list.size());
+}
+BENCHMARK(BM_ParseCluster);
+
+//! Scans the headers of the cluster definitions, which is all that is needed to select the clusters of a device type
+void BM_ScanCluster(benchmark::State& state) {
+    std::vector<std::string> paths;
+    for (const char* name : {"Identify.xml", "OnOff.xml"}) {
+        paths.push_back((std::filesystem::path(CONVERTER_BENCH_FIXTURES) / name).string());
+    }
+    std::vector<loader::LoadedFile> files = loader::LoadFiles(paths);
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        for (const auto& file : files) {
+            prescan::ClusterHeader header;
+            if (prescan::ScanCluster(file.data.get(), file.size, header) != 0) {
+                state.SkipWithError("Failed to scan cluster");
+                break;
+            }
+            benchmark::DoNotOptimize(header);
+        }
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations() * files.size());
+}
+BENCHMARK(BM_ScanCluster);
+
+void BM_ParseDevice(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        matter::Device device = matter::ParseDevice(fixtures.device_xml.document_element());
+        benchmark::DoNotOptimize(device);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseDevice);
+
+//! Opens the cluster library and looks up every cluster and its aliases without decoding them
+void BM_ScanLibrary(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        library::LibraryView cluster_library;
+        if (cluster_library.Open(fixtures.library_path.c_str()) != 0) {
+            state.SkipWithError("Failed to load cluster library");
+            break;
+        }
+        for (const auto& cluster : cluster_library.Clusters()) {
+            benchmark::DoNotOptimize(cluster.Id());
+            for (const auto& alias : cluster.Aliases()) {
+                benchmark::DoNotOptimize(alias.Name());
+            }
+        }
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations() * fixtures.cluster_list.size());
+}
+BENCHMARK(BM_ScanLibrary);
+
+void BM_LoadLibraryCluster(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    library::LibraryView cluster_library;
+    if (cluster_library.Open(fixtures.library_path.c_str()) != 0) {
+        state.SkipWithError("Failed to load cluster library");
+        return;
+    }
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        for (const auto& cluster_view : cluster_library.Clusters()) {
+            matter::Cluster cluster = cluster_view.Load();
+            benchmark::DoNotOptimize(cluster);
+        }
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations() * fixtures.cluster_list.size());
+}
+BENCHMARK(BM_LoadLibraryCluster);
+
+//! Function used to get the paths of the files loaded by the loader benchmarks
+//! The files are copies of the cluster fixtures inside a temporary folder, like a folder of cluster definitions.
+const std::vector<std::string>& GetLoaderPaths() {
+    static const std::vector<std::string> paths = []() {
+        std::filesystem::path folder = std::filesystem::temp_directory_path() / "converter_bench.clusters";
+        std::filesystem::create_directories(folder);
+        std::vector<std::string> copies;
+        for (int i = 0; i < 128; i++) {
+            for (const char* name : {"Identify.xml", "OnOff.xml"}) {
+                std::filesystem::path copy = folder / (std::to_string(i) + "_" + name);
+                std::filesystem::copy_file(std::filesystem::path(CONVERTER_BENCH_FIXTURES) / name, copy,
+                                           std::filesystem::copy_options::overwrite_existing);
+                copies.push_back(copy.string());
+            }
+        }
+        return copies;
+    }();
+    return paths;
+}
+
+//! Loads a folder of cluster definitions in one batch, with io_uring or with the pool of threads
+void BM_LoadFiles(benchmark::State& state) {
+    const std::vector<std::string>& paths = GetLoaderPaths();
+    auto backend = state.range(0) == 0 ? loader::Backend::kThreads : loader::Backend::kIoUring;
+    if (backend == loader::Backend::kIoUring and !loader::IoUringSupported()) {
+        state.SkipWithError("io_uring is not supported");
+        return;
+    }
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        std::vector<loader::LoadedFile> files = loader::LoadFiles(paths, backend);
+        benchmark::DoNotOptimize(files);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+BENCHMARK(BM_LoadFiles)->ArgName("io_uring")->Arg(0)->Arg(1);
+
+//! Updates the index of a folder of unchanged cluster definitions, which only has to check the status of every file
+void BM_UpdateClusterIndex(benchmark::State& state) {
+    const std::vector<std::string>& paths = GetLoaderPaths();
+    prescan::ClusterIndex cluster_index;
+    std::vector<std::string> failed_paths;
+    cluster_index.Update(paths, failed_paths);
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        if (cluster_index.Update(paths, failed_paths)) {
+            state.SkipWithError("Unchanged cluster definitions were scanned again");
+            break;
+        }
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations() * paths.size());
+}
+BENCHMARK(BM_UpdateClusterIndex);
+
+void BM_MapMatterToSdf(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        sdf::SdfModel sdf_model;
+        sdf::SdfMapping sdf_mapping;
+        MapMatterToSdf(fixtures.device, fixtures.cluster_list, sdf_model, sdf_mapping);
+        benchmark::DoNotOptimize(sdf_model);
+        benchmark::DoNotOptimize(sdf_mapping);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapMatterToSdf);
+
+void BM_SerializeSdfModel(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        json sdf_model_json = sdf::SerializeSdfModel(fixtures.sdf_model);
+        benchmark::DoNotOptimize(sdf_model_json);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SerializeSdfModel);
+
+void BM_ParseSdfModel(benchmark::State& state) {
+    Fixtures& fixtures = GetFixtures();
+    // Parsing does not modify the input, so it can be reused for every iteration
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        sdf::SdfModel sdf_model = sdf::ParseSdfModel(fixtures.sdf_model_json);
+        benchmark::DoNotOptimize(sdf_model);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseSdfModel);
+
+void BM_MapSdfToMatter(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        std::optional<matter::Device> optional_device;
+        std::list<matter::Cluster> cluster_list;
+        MapSdfToMatter(fixtures.sdf_model, fixtures.sdf_mapping, optional_device, cluster_list);
+        benchmark::DoNotOptimize(optional_device);
+        benchmark::DoNotOptimize(cluster_list);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapSdfToMatter);
+
+void BM_SerializeCluster(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        for (const auto& cluster : fixtures.mapped_cluster_list) {
+            pugi::xml_document cluster_xml;
+            matter::SerializeCluster(cluster, cluster_xml);
+            benchmark::DoNotOptimize(cluster_xml);
+        }
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations() * fixtures.mapped_cluster_list.size());
+}
+BENCHMARK(BM_SerializeCluster);
+
+void BM_WriteCluster(benchmark::State& state) {
+    const Fixtures& fixtures = GetFixtures();
+    // The output gets discarded, so only the formatting and the buffering are measured
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0) {
+        state.SkipWithError("Failed to open /dev/null");
+        return;
+    }
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        for (const auto& cluster : fixtures.mapped_cluster_list) {
+            benchmark::DoNotOptimize(matter::WriteCluster(cluster, fd));
+        }
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetItemsProcessed(state.iterations() * fixtures.mapped_cluster_list.size());
+    close(fd);
+}
+BENCHMARK(BM_WriteCluster);
+
+//! Function used to get the generator options for the given number of clusters
+GeneratorOptions GetScalingOptions(const benchmark::State& state) {
+    GeneratorOptions options;
+    options.clusters = state.range(0);
+    return options;
+}
+
+void BM_MapMatterToSdfScaling(benchmark::State& state) {
+    std::list<matter::Cluster> cluster_list = GenerateClusters(GetScalingOptions(state));
+    matter::Device device = GenerateDevice(cluster_list);
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        sdf::SdfModel sdf_model;
+        sdf::SdfMapping sdf_mapping;
+        MapMatterToSdf(device, cluster_list, sdf_model, sdf_mapping);
+        benchmark::DoNotOptimize(sdf_model);
+        benchmark::DoNotOptimize(sdf_mapping);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_MapMatterToSdfScaling)->RangeMultiplier(2)->Range(1, 64)->Complexity();
+
+void BM_ParseSdfModelScaling(benchmark::State& state) {
+    sdf::SdfModel generated_sdf_model;
+    sdf::SdfMapping generated_sdf_mapping;
+    GenerateSdf(GetScalingOptions(state), generated_sdf_model, generated_sdf_mapping);
+    json sdf_model_json = sdf::SerializeSdfModel(generated_sdf_model);
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        sdf::SdfModel sdf_model = sdf::ParseSdfModel(sdf_model_json);
+        benchmark::DoNotOptimize(sdf_model);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ParseSdfModelScaling)->RangeMultiplier(2)->Range(1, 64)->Complexity();
+
+void BM_MapSdfToMatterScaling(benchmark::State& state) {
+    sdf::SdfModel sdf_model;
+    sdf::SdfMapping sdf_mapping;
+    GenerateSdf(GetScalingOptions(state), sdf_model, sdf_mapping);
+    allocation_counter::Snapshot allocations_start = allocation_counter::Current();
+    for (auto _ : state) {
+        std::optional<matter::Device> optional_device;
+        std::list<matter::Cluster> cluster_list;
+        MapSdfToMatter(sdf_model, sdf_mapping, optional_device, cluster_list);
+        benchmark::DoNotOptimize(optional_device);
+        benchmark::DoNotOptimize(cluster_list);
+    }
+    allocation_counter::Report(state, allocations_start);
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_MapSdfToMatterScaling)->RangeMultiplier(2)->Range(1, 64)->Complexity();
+
+//! Function used to take the value of a option in the form `--name=value` out of the arguments
+//! The remaining arguments are handed to the benchmark library, which rejects unknown options.
+std::string TakeOption(int& argc, char** argv, const char* name) {
+    std::string value;
+    std::size_t name_length = std::strlen(name);
+    int remaining = 1;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], name, name_length) == 0 and argv[i][name_length] == '=') {
+            value = argv[i] + name_length + 1;
+        } else {
+            argv[remaining++] = argv[i];
+        }
+    }
+    argc = remaining;
+    return value;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string budget_path = TakeOption(argc, argv, "--allocation_budget");
+    std::string budget_out_path = TakeOption(argc, argv, "--allocation_budget_out");
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    allocation_counter::BudgetReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    int result = 0;
+    if (!budget_out_path.empty() and reporter.WriteBudget(budget_out_path) < 0) {
+        result = 1;
+    }
+    if (!budget_path.empty() and reporter.CheckBudget(budget_path) < 0) {
+        result = 1;
+    }
+    return result;
+}
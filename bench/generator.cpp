@@ -0,0 +1,331 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <string>
+#include <vector>
+#include "generator.h"
+
+namespace {
+
+//! Primitive matter types used for the generated data fields
+const std::vector<std::string> kMatterTypes = {"uint8", "uint16", "int32", "bool", "string"};
+
+//! Sdf types matching the primitive matter types
+const std::vector<std::string> kSdfTypes = {"integer", "integer", "integer", "boolean", "string"};
+
+//! Function used to generate a mandatory conformance
+matter::Conformance GenerateMandatoryConformance() {
+    matter::Conformance conformance;
+    conformance.mandatory = true;
+    return conformance;
+}
+
+//! Function used to get the name of a generated struct on the given nesting level
+std::string GenerateStructName(std::size_t index, std::size_t level) {
+    return "Struct" + std::to_string(index) + "Level" + std::to_string(level) + "Struct";
+}
+
+//! Function used to get the matter type for the n-th generated element
+//! The generated elements cycle through the primitive types, the enums and the outermost level of the structs.
+std::string GenerateMatterType(const GeneratorOptions& options, std::size_t n) {
+    std::size_t type_count = kMatterTypes.size() + options.enums + options.structs;
+    std::size_t index = n % type_count;
+    if (index < kMatterTypes.size()) {
+        return kMatterTypes.at(index);
+    }
+    index -= kMatterTypes.size();
+    if (index < options.enums) {
+        return "Enum" + std::to_string(index) + "Enum";
+    }
+    return GenerateStructName(index - options.enums, 0);
+}
+
+//! Function used to generate a list of data fields
+std::list<matter::DataField> GenerateDataFields(const GeneratorOptions& options, std::size_t count) {
+    std::list<matter::DataField> data_fields;
+    for (std::size_t i = 0; i < count; i++) {
+        matter::DataField data_field;
+        data_field.id = i;
+        data_field.name = "Field" + std::to_string(i);
+        data_field.type = GenerateMatterType(options, i);
+        data_field.conformance = GenerateMandatoryConformance();
+        data_fields.push_back(data_field);
+    }
+    return data_fields;
+}
+
+//! Function used to generate a single cluster
+matter::Cluster GenerateCluster(const GeneratorOptions& options, std::size_t index) {
+    matter::Cluster cluster;
+    cluster.id = 0xFC00 + index;
+    cluster.name = "Generated Cluster " + std::to_string(index);
+    cluster.summary = "Synthetic cluster used for scaling benchmarks";
+    cluster.revision = 1;
+    cluster.revision_history[1] = "Initial revision";
+    cluster.cluster_aliases.emplace_back(cluster.id, "Generated" + std::to_string(index));
+
+    matter::ClusterClassification classification;
+    classification.hierarchy = "base";
+    classification.role = "application";
+    classification.pics_code = "GEN";
+    classification.scope = "Endpoint";
+    cluster.classification = classification;
+
+    for (std::size_t i = 0; i < options.enums; i++) {
+        std::list<matter::Item>& items = cluster.enums["Enum" + std::to_string(i) + "Enum"];
+        for (std::size_t j = 0; j < options.enum_items; j++) {
+            matter::Item item;
+            item.value = static_cast<int>(j);
+            item.name = "Item" + std::to_string(j);
+            item.summary = "Generated enum item";
+            item.conformance = GenerateMandatoryConformance();
+            items.push_back(item);
+        }
+    }
+
+    // Every level of a struct contains the next level as its first field
+    for (std::size_t i = 0; i < options.structs; i++) {
+        for (std::size_t level = 0; level < options.struct_depth; level++) {
+            matter::Struct& struct_fields = cluster.structs[GenerateStructName(i, level)];
+            std::size_t first_field = 0;
+            if (level + 1 < options.struct_depth) {
+                matter::DataField nested_field;
+                nested_field.id = 0;
+                nested_field.name = "Nested";
+                nested_field.type = GenerateStructName(i, level + 1);
+                nested_field.conformance = GenerateMandatoryConformance();
+                struct_fields.push_back(nested_field);
+                first_field = 1;
+            }
+            for (std::size_t j = first_field; j < options.struct_fields; j++) {
+                matter::DataField data_field;
+                data_field.id = j;
+                data_field.name = "Field" + std::to_string(j);
+                data_field.type = kMatterTypes.at(j % kMatterTypes.size());
+                data_field.conformance = GenerateMandatoryConformance();
+                struct_fields.push_back(data_field);
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < options.attributes; i++) {
+        matter::Attribute attribute;
+        attribute.id = i;
+        attribute.name = "Attribute" + std::to_string(i);
+        attribute.type = GenerateMatterType(options, i);
+        attribute.conformance = GenerateMandatoryConformance();
+        matter::Access access;
+        access.read = true;
+        access.read_privilege = "view";
+        attribute.access = access;
+        if (attribute.type == "uint16") {
+            matter::Constraint constraint;
+            constraint.type = "between";
+            constraint.min = static_cast<int64_t>(0);
+            constraint.max = static_cast<int64_t>(1000);
+            attribute.constraint = constraint;
+        }
+        cluster.attributes.push_back(attribute);
+    }
+
+    for (std::size_t i = 0; i < options.commands; i++) {
+        matter::Command command;
+        command.id = i;
+        command.name = "Command" + std::to_string(i);
+        command.direction = "commandToServer";
+        command.response = "Y";
+        command.conformance = GenerateMandatoryConformance();
+        matter::Access access;
+        access.invoke_privilege = "operate";
+        command.access = access;
+        command.command_fields = GenerateDataFields(options, 2);
+        cluster.client_commands.push_back(command);
+    }
+
+    for (std::size_t i = 0; i < options.events; i++) {
+        matter::Event event;
+        event.id = i;
+        event.name = "Event" + std::to_string(i);
+        event.priority = "info";
+        event.conformance = GenerateMandatoryConformance();
+        matter::Access access;
+        access.read_privilege = "view";
+        event.access = access;
+        event.data = GenerateDataFields(options, 2);
+        cluster.events.push_back(event);
+    }
+
+    return cluster;
+}
+
+//! Function used to generate a sdfData definition for a struct on the given nesting level
+sdf::DataQuality GenerateSdfStruct(const GeneratorOptions& options, std::size_t level) {
+    sdf::DataQuality data_quality;
+    data_quality.type = "object";
+    std::size_t first_field = 0;
+    if (level + 1 < options.struct_depth) {
+        data_quality.properties["Nested"] = GenerateSdfStruct(options, level + 1);
+        first_field = 1;
+    }
+    for (std::size_t i = first_field; i < options.struct_fields; i++) {
+        sdf::DataQuality field;
+        field.type = kSdfTypes.at(i % kSdfTypes.size());
+        data_quality.properties["Field" + std::to_string(i)] = field;
+    }
+    return data_quality;
+}
+
+//! Function used to generate a sdfChoice with the configured number of choices
+sdf::SdfChoice GenerateSdfChoice(const GeneratorOptions& options) {
+    sdf::SdfChoice sdf_choice;
+    for (std::size_t i = 0; i < options.enum_items; i++) {
+        sdf::DataQuality choice;
+        choice.const_ = static_cast<uint64_t>(i);
+        sdf_choice["Item" + std::to_string(i)] = choice;
+    }
+    return sdf_choice;
+}
+
+//! Function used to generate a single sdfObject
+//! The sdfRefs point to the sdfData definitions of the sdfObject itself.
+sdf::SdfObject GenerateSdfObject(const GeneratorOptions& options, const std::string& pointer) {
+    sdf::SdfObject sdf_object;
+    sdf_object.label = "Generated Object";
+    sdf_object.description = "Synthetic sdfObject used for scaling benchmarks";
+
+    std::vector<std::string> definitions;
+    for (std::size_t i = 0; i < options.enums; i++) {
+        sdf::DataQuality data_quality;
+        data_quality.type = "integer";
+        data_quality.sdf_choice = GenerateSdfChoice(options);
+        sdf_object.sdf_data["Enum" + std::to_string(i)] = data_quality;
+        definitions.push_back("Enum" + std::to_string(i));
+    }
+    for (std::size_t i = 0; i < options.structs; i++) {
+        sdf_object.sdf_data["Struct" + std::to_string(i)] = GenerateSdfStruct(options, 0);
+        definitions.push_back("Struct" + std::to_string(i));
+    }
+
+    for (std::size_t i = 0; i < options.attributes; i++) {
+        sdf::SdfProperty sdf_property;
+        sdf_property.readable = true;
+        sdf_property.writable = false;
+        if (i < options.sdf_refs and !definitions.empty()) {
+            sdf_property.sdf_ref = pointer + "/sdfData/" + definitions.at(i % definitions.size());
+        } else if (i < options.sdf_refs + options.sdf_choices) {
+            sdf_property.type = "integer";
+            sdf_property.sdf_choice = GenerateSdfChoice(options);
+        } else {
+            sdf_property.type = kSdfTypes.at(i % kSdfTypes.size());
+        }
+        sdf_object.sdf_property["Attribute" + std::to_string(i)] = sdf_property;
+    }
+
+    for (std::size_t i = 0; i < options.commands; i++) {
+        sdf::SdfAction sdf_action;
+        sdf::DataQuality input_data;
+        input_data.type = "object";
+        for (std::size_t j = 0; j < 2; j++) {
+            sdf::DataQuality field;
+            field.type = kSdfTypes.at(j % kSdfTypes.size());
+            input_data.properties["Field" + std::to_string(j)] = field;
+        }
+        sdf_action.sdf_input_data = input_data;
+        sdf_object.sdf_action["Command" + std::to_string(i)] = sdf_action;
+    }
+
+    for (std::size_t i = 0; i < options.events; i++) {
+        sdf::SdfEvent sdf_event;
+        sdf::DataQuality output_data;
+        output_data.type = "object";
+        for (std::size_t j = 0; j < 2; j++) {
+            sdf::DataQuality field;
+            field.type = kSdfTypes.at(j % kSdfTypes.size());
+            output_data.properties["Field" + std::to_string(j)] = field;
+        }
+        sdf_event.sdf_output_data = output_data;
+        sdf_object.sdf_event["Event" + std::to_string(i)] = sdf_event;
+    }
+
+    return sdf_object;
+}
+
+} // namespace
+
+//! Function used to generate a cluster library
+std::list<matter::Cluster> GenerateClusters(const GeneratorOptions& options) {
+    std::list<matter::Cluster> cluster_list;
+    for (std::size_t i = 0; i < options.clusters; i++) {
+        cluster_list.push_back(GenerateCluster(options, i));
+    }
+    return cluster_list;
+}
+
+//! Function used to generate a device type definition using every cluster
+matter::Device GenerateDevice(const std::list<matter::Cluster>& cluster_list) {
+    matter::Device device;
+    device.id = 0xFFF0;
+    device.name = "Generated Device";
+    device.revision = 1;
+    device.revision_history[1] = "Initial revision";
+
+    matter::DeviceClassification classification;
+    classification.class_ = "simple";
+    classification.scope = "endpoint";
+    device.classification = classification;
+
+    for (const auto& cluster : cluster_list) {
+        matter::Cluster device_cluster;
+        device_cluster.id = cluster.id;
+        device_cluster.name = cluster.name;
+        device_cluster.side = "server";
+        device_cluster.revision = cluster.revision;
+        device_cluster.conformance = GenerateMandatoryConformance();
+        device.clusters.push_back(device_cluster);
+    }
+    return device;
+}
+
+//! Function used to generate a sdf-model and sdf-mapping
+void GenerateSdf(const GeneratorOptions& options, sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping) {
+    sdf::InformationBlock information_block;
+    information_block.title = "Generated Model";
+    information_block.version = "1";
+    sdf_model.information_block = information_block;
+    sdf_mapping.information_block = information_block;
+
+    sdf::SdfThing sdf_thing;
+    sdf_thing.label = "Generated Device";
+    for (std::size_t i = 0; i < options.clusters; i++) {
+        std::string name = "Cluster" + std::to_string(i);
+        std::string pointer = "#/sdfThing/GeneratedDevice/sdfObject/" + name;
+        sdf_thing.sdf_object[name] = GenerateSdfObject(options, pointer);
+
+        sdf_mapping.map[pointer]["id"] = static_cast<uint64_t>(0xFC00 + i);
+        for (std::size_t j = 0; j < options.attributes; j++) {
+            sdf_mapping.map[pointer + "/sdfProperty/Attribute" + std::to_string(j)]["id"] = static_cast<uint64_t>(j);
+        }
+        for (std::size_t j = 0; j < options.commands; j++) {
+            sdf_mapping.map[pointer + "/sdfAction/Command" + std::to_string(j)]["id"] = static_cast<uint64_t>(j);
+        }
+        for (std::size_t j = 0; j < options.events; j++) {
+            sdf_mapping.map[pointer + "/sdfEvent/Event" + std::to_string(j)]["id"] = static_cast<uint64_t>(j);
+        }
+    }
+    sdf_model.sdf_thing["GeneratedDevice"] = sdf_thing;
+    sdf_mapping.map["#/sdfThing/GeneratedDevice"]["id"] = static_cast<uint64_t>(0xFFF0);
+}
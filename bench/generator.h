@@ -0,0 +1,81 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Generator for synthetic cluster libraries and sdf-models of configurable size.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_BENCH_GENERATOR_H_
+#define SDF_MATTER_CONVERTER_BENCH_GENERATOR_H_
+
+#include <cstddef>
+#include <list>
+#include "matter.h"
+#include "sdf.h"
+
+//! Options used to control the size of the generated models
+//! All counts except the number of clusters are counted per cluster or per sdfObject respectively.
+struct GeneratorOptions {
+    std::size_t clusters = 8;
+    std::size_t attributes = 16;
+    std::size_t commands = 4;
+    std::size_t events = 2;
+    //! Number of structs, each struct is nested struct_depth times with struct_fields fields per level
+    std::size_t structs = 2;
+    std::size_t struct_depth = 2;
+    std::size_t struct_fields = 4;
+    std::size_t enums = 2;
+    std::size_t enum_items = 8;
+    //! Number of sdfProperties that refer to a sdfData definition via sdfRef
+    std::size_t sdf_refs = 4;
+    //! Number of sdfProperties that contain their own sdfChoice
+    std::size_t sdf_choices = 2;
+};
+
+//! @brief Generate a cluster library.
+//!
+//! This function generates the given number of clusters with the configured number of attributes, commands, events
+//! and global data types.
+//!
+//! @param options The generator options.
+//! @return The generated clusters.
+std::list<matter::Cluster> GenerateClusters(const GeneratorOptions& options);
+
+//! @brief Generate a device type definition.
+//!
+//! This function generates a device type definition that uses every cluster of the cluster library as server cluster.
+//!
+//! @param cluster_list The generated clusters.
+//! @return The generated device type definition.
+matter::Device GenerateDevice(const std::list<matter::Cluster>& cluster_list);
+
+//! @brief Generate a sdf-model and sdf-mapping.
+//!
+//! This function generates a sdf-model containing a sdfThing with a sdfObject for every cluster as well as the
+//! sdf-mapping containing the ids of the elements.
+//!
+//! @param options The generator options.
+//! @param sdf_model The generated sdf-model.
+//! @param sdf_mapping The generated sdf-mapping.
+void GenerateSdf(const GeneratorOptions& options, sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping);
+
+#endif //SDF_MATTER_CONVERTER_BENCH_GENERATOR_H_
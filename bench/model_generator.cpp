@@ -0,0 +1,128 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Command line tool that writes synthetic cluster libraries and sdf-models of configurable size.
+ */
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <argparse/argparse.hpp>
+#include "generator.h"
+
+//! Helper function that saves a generated definition with the given writer function
+template <typename T> int SaveFile(const std::string& path, const T& input, int (*write)(const T&, int)) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to save file: " << path << std::endl;
+        return -1;
+    }
+    int result = write(input, fd);
+    if (close(fd) != 0 or result != 0) {
+        std::cerr << "Failed to save file: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! Main function
+int main(int argc, char *argv[]) {
+    // Define the program name
+    argparse::ArgumentParser program("model-generator");
+
+    GeneratorOptions options;
+    // Define the set of possible arguments, every count defaults to the default generator options
+    const std::pair<const char*, std::size_t*> counts[] = {
+            {"-clusters", &options.clusters},
+            {"-attributes", &options.attributes},
+            {"-commands", &options.commands},
+            {"-events", &options.events},
+            {"-structs", &options.structs},
+            {"-struct-depth", &options.struct_depth},
+            {"-struct-fields", &options.struct_fields},
+            {"-enums", &options.enums},
+            {"-enum-items", &options.enum_items},
+            {"-sdf-refs", &options.sdf_refs},
+            {"-sdf-choices", &options.sdf_choices}};
+    for (const auto& count : counts) {
+        program.add_argument(count.first)
+                .help("Number of generated elements")
+                .default_value(static_cast<int>(*count.second))
+                .scan<'i', int>();
+    }
+
+    program.add_argument("-o", "-output")
+            .required()
+            .help("Specify the output directory\n"
+                  "The clusters get written into the clusters subdirectory, next to device.xml, sdf-model.json "
+                  "and sdf-mapping.json");
+
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << program;
+        std::exit(1);
+    }
+
+    for (const auto& count : counts) {
+        int value = program.get<int>(count.first);
+        if (value < 0) {
+            std::cerr << "Negative value for " << count.first << std::endl;
+            std::exit(1);
+        }
+        *count.second = value;
+    }
+
+    std::filesystem::path output = program.get<std::string>("-output");
+    std::filesystem::create_directories(output / "clusters");
+
+    std::cout << "Generating Cluster XML" << std::endl;
+    std::list<matter::Cluster> cluster_list = GenerateClusters(options);
+    int counter = 0;
+    for (const auto& cluster : cluster_list) {
+        std::string path = (output / "clusters" / ("Cluster" + std::to_string(counter++) + ".xml")).string();
+        if (SaveFile(path, cluster, &matter::WriteCluster) != 0) {
+            return 1;
+        }
+    }
+
+    std::cout << "Generating Device XML" << std::endl;
+    if (SaveFile((output / "device.xml").string(), GenerateDevice(cluster_list), &matter::WriteDevice) != 0) {
+        return 1;
+    }
+
+    std::cout << "Generating SDF" << std::endl;
+    sdf::SdfModel sdf_model;
+    sdf::SdfMapping sdf_mapping;
+    GenerateSdf(options, sdf_model, sdf_mapping);
+    if (SaveFile((output / "sdf-model.json").string(), sdf_model, &sdf::WriteSdfModel) != 0 or
+        SaveFile((output / "sdf-mapping.json").string(), sdf_mapping, &sdf::WriteSdfMapping) != 0) {
+        return 1;
+    }
+
+    return 0;
+}
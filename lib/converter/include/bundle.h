@@ -0,0 +1,115 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Single file bundle used to store all output files of a conversion.
+ * A bundle is a ustar archive, so it can be unpacked with tar. Its last member is an index, which lists the name,
+ * the offset and the size of every other member, so a reader can access a member without walking the archive.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_BUNDLE_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_BUNDLE_H_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mapped_file.h"
+
+namespace bundle {
+
+//! Name of the index inside of a bundle
+extern const char* const kIndexName;
+
+//! Member of a bundle
+struct Entry {
+    std::string name;
+    //! Offset of the content from the start of the bundle
+    std::size_t offset;
+    std::size_t size;
+};
+
+//! Writer used to create a bundle
+//! The members get streamed directly into the bundle, their headers get written once their size is known. For this,
+//! the bundle has to be a regular file.
+class BundleWriter {
+public:
+    //! Constructor
+    BundleWriter() = default;
+
+    //! Destructor, closes an unfinished bundle without writing the index
+    ~BundleWriter();
+
+    BundleWriter(const BundleWriter&) = delete;
+    BundleWriter& operator=(const BundleWriter&) = delete;
+
+    //! Function used to create the bundle at the given path
+    //! Returns 0 on success and negative on failure.
+    int Open(const char* path);
+
+    //! Function used to add a member to the bundle
+    //! The given function has to write the content into the passed file descriptor and return 0 on success. Names are
+    //! limited to 99 characters. Returns 0 on success and negative on failure.
+    int Add(const std::string& name, const std::function<int(int)>& write);
+
+    //! Function used to write the index and to close the bundle
+    //! Returns 0 on success and negative on failure, including failures of previous additions.
+    int Close();
+
+    //! Function used to get the members added so far
+    const std::vector<Entry>& Entries() const {
+        return entries;
+    }
+
+private:
+    int fd = -1;
+    std::vector<Entry> entries;
+    //! Set, if writing one of the members failed
+    bool failed = false;
+};
+
+//! Reader used to access the members of a bundle
+//! The bundle gets mapped into memory, the content of the members stays valid as long as the reader exists.
+class BundleReader {
+public:
+    //! Function used to open the bundle at the given path
+    //! Returns 0 on success and negative on failure.
+    int Open(const char* path);
+
+    //! Function used to get the members of the bundle, excluding the index
+    const std::vector<Entry>& Entries() const {
+        return entries;
+    }
+
+    //! Function used to get the content of a member
+    std::string_view Content(const Entry& entry) const {
+        return {file.Data() + entry.offset, entry.size};
+    }
+
+private:
+    MappedFile file;
+    std::vector<Entry> entries;
+};
+
+} // namespace bundle
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_BUNDLE_H_
@@ -0,0 +1,150 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Content-addressed on-disk cache for the results of a conversion.
+ * An entry is keyed by the hash of everything that influences the output, so a hit can skip parsing, mapping and
+ * serializing and only has to copy the cached output files.
+ * Additionally, the cache records the clusters a device type depends on, so a changed cluster library only invalidates
+ * the device types that use one of the changed clusters.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_CACHE_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "matter_to_sdf.h"
+
+//! Version of the converter
+//! Part of every cache key. The build appends a hash of the converter sources, so every change of the sources
+//! invalidates the cached conversions and the cluster indices. Builds without it only use the release version.
+#ifndef SDF_MATTER_CONVERTER_VERSION
+#define SDF_MATTER_CONVERTER_VERSION "0.1.0"
+#endif
+
+namespace cache {
+
+//! Incremental SHA-256 hash as defined in FIPS 180-4
+class Sha256 {
+public:
+    //! Constructor
+    Sha256();
+
+    //! Function used to append data to the hashed message
+    void Update(const void* data, std::size_t size);
+
+    //! Function used to finish the hash, returns the digest as a lowercase hex string
+    std::string HexDigest();
+
+private:
+    //! Function used to process a single 64 byte block
+    void Transform(const unsigned char* block);
+
+    std::array<uint32_t, 8> state;
+    std::array<unsigned char, 64> block;
+    std::size_t block_size = 0;
+    uint64_t message_size = 0;
+};
+
+//! Key of a cache entry
+//! Every added value is prefixed by its size, so different splits of the same bytes lead to different keys. The key
+//! always contains the version of the converter.
+class CacheKey {
+public:
+    //! Constructor
+    CacheKey();
+
+    //! Function used to add a value to the key
+    void Add(const std::string& value) {
+        Add(value.data(), value.size());
+    }
+
+    //! Function used to add a value to the key, e.g. the content of an already loaded file
+    void Add(const char* data, std::size_t size);
+
+    //! Function used to add the content of a file to the key
+    //! Returns 0 on success and negative on failure.
+    int AddFile(const char* path);
+
+    //! Function used to finish the key
+    std::string Digest();
+
+private:
+    Sha256 hash;
+};
+
+//! Cache for the output files of a conversion
+//! Each entry is a directory named by its key, containing the output files and a manifest with the names of the
+//! outputs relative to the output prefix. Entries get written into a temporary directory first and are renamed once
+//! they are complete, so concurrent runs never see a partially written entry.
+class ConversionCache {
+public:
+    //! Constructor
+    explicit ConversionCache(std::string directory) : directory(std::move(directory)) {}
+
+    //! @brief Restore the outputs of a cached conversion.
+    //!
+    //! Copies the output files of the entry to the output prefix followed by their names.
+    //!
+    //! @param key The key of the entry.
+    //! @param output_prefix The prefix of the output paths.
+    //! @param output_paths The restored output paths.
+    //! @return 0 on a hit, negative if the entry does not exist or could not be restored.
+    int Restore(const std::string& key, const std::string& output_prefix, std::vector<std::string>& output_paths);
+
+    //! @brief Store the outputs of a conversion.
+    //!
+    //! An already existing entry is kept, also if another run stored it in the meantime.
+    //!
+    //! @param key The key of the entry.
+    //! @param output_prefix The prefix of the output paths, removed from the paths to get the names of the outputs.
+    //! @param output_paths The output paths.
+    //! @return 0 if the entry exists afterwards, negative on failure.
+    int Store(const std::string& key, const std::string& output_prefix, const std::vector<std::string>& output_paths);
+
+    //! @brief Load the recorded dependencies of a device type.
+    //!
+    //! @param key The key of the device type conversion without its dependencies.
+    //! @param dependencies The recorded dependencies.
+    //! @return 0 on success, negative if no dependencies were recorded.
+    int LoadDependencies(const std::string& key, ClusterDependencies& dependencies);
+
+    //! @brief Record the dependencies of a device type.
+    //!
+    //! @param key The key of the device type conversion without its dependencies.
+    //! @param dependencies The dependencies of the device type.
+    //! @return 0 on success, negative on failure.
+    int StoreDependencies(const std::string& key, const ClusterDependencies& dependencies);
+
+private:
+    //! Function used to get the directory of an entry
+    std::string EntryDirectory(const std::string& key) const;
+
+    std::string directory;
+};
+
+} // namespace cache
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_CACHE_H_
@@ -0,0 +1,121 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Compact binary interchange format for the sdf and Matter objects.
+ * The objects get encoded as CBOR (RFC 8949), prefixed by the self-described CBOR tag, so an encoded file can be told
+ * apart from a json or xml file by its first three bytes. Sdf-models and sdf-mappings use the same structure as their
+ * json representation, devices and clusters use a structure mirroring their xml elements.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_CBOR_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_CBOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "matter.h"
+#include "sdf.h"
+
+namespace cbor {
+
+//! @brief Check if the given data is encoded.
+//!
+//! @param data The data to check.
+//! @param size The size of the data.
+//! @return True, if the data starts with the self-described CBOR tag.
+bool IsEncoded(const char* data, std::size_t size);
+
+//! @brief Write an encoded sdf-model.
+//!
+//! @param sdf_model The input sdf-model.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure.
+int WriteSdfModel(const sdf::SdfModel& sdf_model, int fd);
+
+//! @brief Write an encoded sdf-mapping.
+//!
+//! @param sdf_mapping The input sdf-mapping.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure.
+int WriteSdfMapping(const sdf::SdfMapping& sdf_mapping, int fd);
+
+//! @brief Write an encoded device type.
+//!
+//! @param device The input device type.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure.
+int WriteDevice(const matter::Device& device, int fd);
+
+//! @brief Write an encoded cluster.
+//!
+//! @param cluster The input cluster.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure.
+int WriteCluster(const matter::Cluster& cluster, int fd);
+
+//! @brief Append an encoded cluster to a buffer.
+//!
+//! The appended data can be read with ReadCluster, which allows to embed encoded clusters into other files.
+//!
+//! @param cluster The input cluster.
+//! @param output The buffer the encoded cluster gets appended to.
+void AppendCluster(const matter::Cluster& cluster, std::vector<std::uint8_t>& output);
+
+//! @brief Read an encoded sdf-model.
+//!
+//! Throws a `nlohmann::json::exception` if the data is not a valid encoded sdf-model.
+//!
+//! @param data The encoded data.
+//! @param size The size of the encoded data.
+//! @return The resulting sdf-model.
+sdf::SdfModel ReadSdfModel(const char* data, std::size_t size);
+
+//! @brief Read an encoded sdf-mapping.
+//!
+//! Throws a `nlohmann::json::exception` if the data is not a valid encoded sdf-mapping.
+//!
+//! @param data The encoded data.
+//! @param size The size of the encoded data.
+//! @return The resulting sdf-mapping.
+sdf::SdfMapping ReadSdfMapping(const char* data, std::size_t size);
+
+//! @brief Read an encoded device type.
+//!
+//! Throws a `nlohmann::json::exception` if the data is not a valid encoded device type.
+//!
+//! @param data The encoded data.
+//! @param size The size of the encoded data.
+//! @return The resulting device type.
+matter::Device ReadDevice(const char* data, std::size_t size);
+
+//! @brief Read an encoded cluster.
+//!
+//! Throws a `nlohmann::json::exception` if the data is not a valid encoded cluster.
+//!
+//! @param data The encoded data.
+//! @param size The size of the encoded data.
+//! @return The resulting cluster.
+matter::Cluster ReadCluster(const char* data, std::size_t size);
+
+} // namespace cbor
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_CBOR_H_
@@ -21,6 +21,8 @@
  * @section Description
  *
  * Functions to convert between sdf and matter.
+ * The state used while mapping is kept per thread, so independent conversions can run on different threads.
+ * A Converter session keeps a parsed cluster library, so it can be reused for many conversions.
  */
 
 #ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_CONVERTER_H_
@@ -28,8 +30,13 @@
 
 #include <nlohmann/json.hpp>
 #include <pugixml.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <optional>
+#include <string>
+#include <vector>
 #include "matter_to_sdf.h"
 #include "sdf_to_matter.h"
 
@@ -46,6 +53,32 @@ int ConvertSdfToMatter(nlohmann::ordered_json& sdf_model_json, nlohmann::ordered
                        std::optional<pugi::xml_document>& optional_device_xml,
                        std::list<pugi::xml_document>& cluster_xml_list);
 
+//! @brief Convert sdf to matter.
+//!
+//! This function converts an already parsed sdf-model and sdf-mapping into the matter format.
+//!
+//! @param sdf_model The input sdf-model.
+//! @param sdf_mapping The input sdf-mapping.
+//! @param device_xml The output device definition.
+//! @param cluster_xml The output cluster definition.
+//! @return 0 on success, negative on failure.
+int ConvertSdfToMatter(const sdf::SdfModel& sdf_model, const sdf::SdfMapping& sdf_mapping,
+                       std::optional<pugi::xml_document>& optional_device_xml,
+                       std::list<pugi::xml_document>& cluster_xml_list);
+
+//! @brief Convert sdf to matter.
+//!
+//! This function maps an already parsed sdf-model and sdf-mapping onto the matter data model without serializing it.
+//! The results can be streamed into files with matter::WriteDevice and matter::WriteCluster.
+//!
+//! @param sdf_model The input sdf-model.
+//! @param sdf_mapping The input sdf-mapping.
+//! @param device The output device.
+//! @param clusters The output clusters.
+//! @return 0 on success, negative on failure.
+int ConvertSdfToMatter(const sdf::SdfModel& sdf_model, const sdf::SdfMapping& sdf_mapping,
+                       std::optional<matter::Device>& device, std::list<matter::Cluster>& clusters);
+
 //! @brief Convert sdf to matter.
 //!
 //! This function converts a given sdf-model and sdf-mapping into the matter format.
@@ -59,4 +92,126 @@ int ConvertMatterToSdf(const std::optional<pugi::xml_document>& device_xml,
                        const std::list<pugi::xml_document>& cluster_xml_list,
                        nlohmann::ordered_json& sdf_model_json, nlohmann::ordered_json& sdf_mapping_json);
 
+//! @brief Convert matter to sdf.
+//!
+//! This function converts a given device type definition and cluster definitions into the sdf data model without
+//! serializing it, so the result can be streamed directly into a file.
+//!
+//! @param device_xml The input device type definition.
+//! @param cluster_xml_list The input cluster definitions.
+//! @param sdf_model The output sdf-model.
+//! @param sdf_mapping The output sdf-mapping.
+//! @return 0 on success, negative on failure.
+int ConvertMatterToSdf(const std::optional<pugi::xml_document>& device_xml,
+                       const std::list<pugi::xml_document>& cluster_xml_list,
+                       sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping);
+
+//! @brief Convert matter to sdf.
+//!
+//! This function converts a given device type definition and cluster definitions into the sdf data model and records
+//! the clusters the device type depends on. The result only changes if the device type definition or one of these
+//! clusters changes, which allows to skip the conversion otherwise.
+//!
+//! @param device_xml The input device type definition.
+//! @param cluster_xml_list The input cluster definitions.
+//! @param sdf_model The output sdf-model.
+//! @param sdf_mapping The output sdf-mapping.
+//! @param dependencies The clusters the device type depends on, empty without a device type definition.
+//! @return 0 on success, negative on failure.
+int ConvertMatterToSdf(const std::optional<pugi::xml_document>& device_xml,
+                       const std::list<pugi::xml_document>& cluster_xml_list,
+                       sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping, ClusterDependencies& dependencies);
+
+//! @brief Convert matter to sdf.
+//!
+//! This function maps an already parsed device type definition and cluster definitions onto the sdf data model and
+//! records the clusters the device type depends on.
+//!
+//! @param device The input device type definition.
+//! @param clusters The input cluster definitions.
+//! @param sdf_model The output sdf-model.
+//! @param sdf_mapping The output sdf-mapping.
+//! @param dependencies The clusters the device type depends on, empty without a device type definition.
+//! @return 0 on success, negative on failure.
+int ConvertMatterToSdf(const std::optional<matter::Device>& device, const std::list<matter::Cluster>& clusters,
+                       sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping, ClusterDependencies& dependencies);
+
+//! Function used to validate a converted file
+//! Gets the content and the name of the file and returns 0 if the file is valid, e.g. SdfSchema::Validate or
+//! MatterSchema::Validate of the validator library.
+using Validator = std::function<int(const char* data, std::size_t size, const char* name)>;
+
+//! Options of a converter session
+struct ConverterOptions {
+    //! Validator for the converted sdf-models and sdf-mappings, the results do not get validated if it is empty
+    Validator sdf_validator;
+    //! Validator for the converted device types and clusters, the results do not get validated if it is empty
+    Validator matter_validator;
+};
+
+//! Converter session
+//! The session gets created once with a cluster library and converts many inputs with it. The clusters only get
+//! parsed once and are indexed by their id and their aliases. The session does not change while converting, so it can
+//! be used by multiple threads at the same time.
+class Converter {
+public:
+    //! Constructor
+    //! Takes ownership of the given parsed clusters.
+    explicit Converter(std::list<matter::Cluster> clusters, ConverterOptions options = ConverterOptions());
+
+    //! Constructor
+    //! Parses the given cluster definitions once.
+    explicit Converter(const std::list<pugi::xml_document>& cluster_xml_list,
+                       ConverterOptions options = ConverterOptions());
+
+    Converter(const Converter&) = delete;
+    Converter& operator=(const Converter&) = delete;
+
+    Converter(Converter&&) = default;
+    Converter& operator=(Converter&&) = default;
+
+    //! Function used to get the clusters of the library
+    const std::list<matter::Cluster>& Clusters() const {
+        return clusters;
+    }
+
+    //! Function used to find the clusters with the given id
+    //! Returns an empty list if the library contains no such cluster.
+    const std::vector<const matter::Cluster*>& FindClusters(uint32_t id) const;
+
+    //! Function used to find the cluster with the given alias, e.g. the base cluster of a derived cluster
+    //! Returns the first cluster with the alias or nullptr if the library contains no such cluster.
+    const matter::Cluster* FindCluster(const std::string& alias) const;
+
+    //! @brief Convert matter to sdf.
+    //!
+    //! This function converts a device type definition with the clusters of the library, or every cluster of the
+    //! library if no device type definition is given.
+    //!
+    //! @param device The optional input device type definition.
+    //! @param sdf_model The output sdf-model.
+    //! @param sdf_mapping The output sdf-mapping.
+    //! @param dependencies The clusters the device type depends on, may be null.
+    //! @return 0 on success, negative on failure or if the result is not valid.
+    int ConvertMatterToSdf(const std::optional<matter::Device>& device, sdf::SdfModel& sdf_model,
+                           sdf::SdfMapping& sdf_mapping, ClusterDependencies* dependencies = nullptr) const;
+
+    //! @brief Convert sdf to matter.
+    //!
+    //! @param sdf_model The input sdf-model.
+    //! @param sdf_mapping The input sdf-mapping.
+    //! @param device The output device type definition.
+    //! @param cluster_list The output clusters.
+    //! @return 0 on success, negative on failure or if the result is not valid.
+    int ConvertSdfToMatter(const sdf::SdfModel& sdf_model, const sdf::SdfMapping& sdf_mapping,
+                           std::optional<matter::Device>& device, std::list<matter::Cluster>& cluster_list) const;
+
+private:
+    std::list<matter::Cluster> clusters;
+    ConverterOptions options;
+    //! Lookup tables of the clusters, used by every conversion
+    //! The clusters are kept in a list, so the tables stay valid if the session gets moved.
+    ClusterLookup lookup;
+};
+
 #endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_CONVERTER_H_
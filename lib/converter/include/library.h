@@ -0,0 +1,262 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Read-only flat buffer containing a parsed cluster library.
+ * The library consists of a header, tables of fixed size records and a shared string pool. Records refer to each
+ * other and to their strings by offsets instead of pointers, so a library file can be mapped into memory and used
+ * without parsing it. Processes mapping the same file share a single copy of it.
+ *
+ * The records only contain what is needed to select clusters by their id, name or aliases. The complete definition of
+ * every cluster is embedded in the CBOR format and only gets decoded once a cluster is loaded.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_LIBRARY_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_LIBRARY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string_view>
+#include "mapped_file.h"
+#include "matter.h"
+
+namespace library {
+
+//! Reference to a string inside of the string pool
+struct String {
+    uint32_t offset;
+    uint32_t size;
+};
+
+//! Reference to consecutive records of a table
+struct Range {
+    uint32_t offset;
+    uint32_t count;
+};
+
+//! Header at the start of a library
+//! All values are stored in the byte order of the host that created the library. The tables are referenced by their
+//! offset from the start of the library, records reference a range of a table by the index of its first record.
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t size;
+    Range clusters;
+    Range aliases;
+    //! Offset and size of the string pool
+    String strings;
+};
+
+struct ClusterRecord {
+    uint32_t id;
+    String name;
+    String side;
+    uint32_t revision;
+    String base_cluster;
+    Range aliases;
+    //! Offset of the encoded cluster from the start of the library and its size
+    String encoded;
+};
+
+struct AliasRecord {
+    uint32_t id;
+    String name;
+};
+
+//! @brief Check if the given data is a library.
+//!
+//! @param data The data to check.
+//! @param size The size of the data.
+//! @return True, if the data starts with the header of a library.
+bool IsLibrary(const char* data, std::size_t size);
+
+//! @brief Write a library.
+//!
+//! This function lays out the given clusters as a library and writes it into the given file descriptor.
+//!
+//! @param clusters The input clusters.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure, e.g. if the library would exceed 4 GiB.
+int WriteLibrary(const std::list<matter::Cluster>& clusters, int fd);
+
+class LibraryView;
+
+//! Range of records of a table, which can be iterated as views
+template <typename View, typename Record>
+class RecordRange {
+public:
+    class Iterator {
+    public:
+        Iterator(const LibraryView& library, const Record* record) : library(&library), record(record) {}
+
+        View operator*() const {
+            return View(*library, *record);
+        }
+
+        Iterator& operator++() {
+            record++;
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return record != other.record;
+        }
+
+    private:
+        const LibraryView* library;
+        const Record* record;
+    };
+
+    RecordRange(const LibraryView& library, const Record* records, std::size_t count)
+            : library(library), records(records), count(count) {}
+
+    Iterator begin() const {
+        return Iterator(library, records);
+    }
+
+    Iterator end() const {
+        return Iterator(library, records + count);
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    View operator[](std::size_t index) const {
+        return View(library, records[index]);
+    }
+
+private:
+    const LibraryView& library;
+    const Record* records;
+    std::size_t count;
+};
+
+//! View of a cluster alias
+class AliasView {
+public:
+    AliasView(const LibraryView& library, const AliasRecord& record) : library(library), record(record) {}
+
+    uint32_t Id() const {
+        return record.id;
+    }
+
+    std::string_view Name() const;
+
+private:
+    const LibraryView& library;
+    const AliasRecord& record;
+};
+
+//! View of a cluster, mirrors matter::Cluster
+class ClusterView {
+public:
+    ClusterView(const LibraryView& library, const ClusterRecord& record) : library(library), record(record) {}
+
+    uint32_t Id() const {
+        return record.id;
+    }
+
+    std::string_view Name() const;
+    std::string_view Side() const;
+
+    uint32_t Revision() const {
+        return record.revision;
+    }
+
+    //! Function used to get the name of the base cluster, empty if the cluster is not derived
+    std::string_view BaseCluster() const;
+
+    RecordRange<AliasView, AliasRecord> Aliases() const;
+
+    //! Function used to get the encoded definition of the cluster
+    std::string_view Encoded() const;
+
+    //! Function used to decode the complete definition of the cluster
+    //! Throws a `nlohmann::json::exception` if the embedded definition is invalid.
+    matter::Cluster Load() const;
+
+private:
+    const LibraryView& library;
+    const ClusterRecord& record;
+};
+
+//! View of a library
+//! The library gets mapped into memory, every view refers to the mapping and is only valid as long as the library is
+//! open.
+class LibraryView {
+public:
+    //! Constructor
+    LibraryView() = default;
+
+    LibraryView(const LibraryView&) = delete;
+    LibraryView& operator=(const LibraryView&) = delete;
+
+    //! Function used to open the library at the given path
+    //! The offsets of all records get checked once, so the views do not have to check them.
+    //! Returns 0 on success and negative on failure.
+    int Open(const char* path);
+
+    //! Function used to get the clusters of the library in their original order
+    RecordRange<ClusterView, ClusterRecord> Clusters() const;
+
+    //! Function used to load the clusters a device type depends on
+    //! These are the clusters with the ids used by the device type and all clusters they are derived from, in the
+    //! order of the library. Converting the device type with them gives the same result as with the whole library.
+    //! The views are only used to select the clusters, the mapping still needs the decoded matter::Cluster objects.
+    std::list<matter::Cluster> LoadClusters(const matter::Device& device) const;
+
+    //! Function used to load every cluster of the library
+    std::list<matter::Cluster> LoadClusters() const;
+
+    //! Function used to resolve a string of the string pool
+    std::string_view Resolve(const String& string) const {
+        return {mapped_file.Data() + header->strings.offset + string.offset, string.size};
+    }
+
+    //! Function used to resolve a range of a table
+    template <typename Record>
+    const Record* Resolve(const Range& table, const Range& range) const {
+        return reinterpret_cast<const Record*>(mapped_file.Data() + table.offset) + range.offset;
+    }
+
+    //! Function used to get the header of the library
+    const Header& GetHeader() const {
+        return *header;
+    }
+
+    //! Function used to get the data of the library
+    std::string_view Data() const {
+        return {mapped_file.Data(), mapped_file.Size()};
+    }
+
+private:
+    //! Function used to check that every offset of the library is inside of its bounds
+    bool Check() const;
+
+    MappedFile mapped_file;
+    const Header* header = nullptr;
+};
+
+} // namespace library
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_LIBRARY_H_
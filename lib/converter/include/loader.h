@@ -0,0 +1,79 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Bulk loader used to read many small input files, e.g. a folder of cluster definitions, in one batch.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_LOADER_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_LOADER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace loader {
+
+//! Backend used to load the files
+enum class Backend {
+    //! io_uring if it is supported, otherwise a pool of threads
+    kAutomatic,
+    //! Linux io_uring, which submits the system calls of all files in batches
+    kIoUring,
+    //! Pool of threads, which use blocking system calls
+    kThreads,
+};
+
+//! File loaded into memory
+struct LoadedFile {
+    std::string path;
+    //! Content of the file, writable so it can be parsed in place
+    std::unique_ptr<char[]> data;
+    std::size_t size = 0;
+    //! Error number of the failed system call, 0 if the file was loaded
+    int error = 0;
+};
+
+//! @brief Check if io_uring can be used.
+//!
+//! The result depends on the build, the kernel and the permissions of the process, it gets checked once.
+//!
+//! @return True if the files can be loaded with io_uring.
+bool IoUringSupported();
+
+//! @brief Load files in one batch.
+//!
+//! With io_uring, the opens, reads and closes of the files get submitted to the kernel in batches, so the latency of
+//! the individual system calls overlaps. The files get loaded in windows, so no more files are open at the same time
+//! than the limit of open descriptors allows. Files which are not regular files, e.g. pipes, files of system calls not
+//! supported by the kernel and files that ran out of descriptors get loaded with blocking system calls instead. Without io_uring, the files get loaded by a
+//! pool of threads.
+//!
+//! @param paths The paths of the files.
+//! @param backend The backend used to load the files, io_uring falls back to the pool of threads if not supported.
+//! @return The loaded files in the order of the paths, files that could not be loaded contain the error.
+std::vector<LoadedFile> LoadFiles(const std::vector<std::string>& paths, Backend backend = Backend::kAutomatic);
+
+} // namespace loader
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_LOADER_H_
@@ -0,0 +1,71 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Memory mapping used to load the input files without copying them into separate buffers.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_MAPPED_FILE_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_MAPPED_FILE_H_
+
+#include <cstddef>
+
+//! File mapped into memory
+//! The mapping is private and writable, changes to the data are not written back to the file. This allows parsers to
+//! modify the data in place, only the modified pages get copied.
+class MappedFile {
+public:
+    //! Constructor
+    MappedFile() = default;
+
+    //! Destructor, removes the mapping
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    //! Function used to map the file at the given path into memory
+    //! A previously mapped file gets unmapped. Returns 0 on success and negative on failure.
+    int Map(const char* path);
+
+    //! Function used to remove the mapping
+    void Unmap();
+
+    //! Function used to get the mapped data, null if the file is empty
+    char* Data() const {
+        return data;
+    }
+
+    //! Function used to get the size of the mapped data
+    std::size_t Size() const {
+        return size;
+    }
+
+private:
+    char* data = nullptr;
+    std::size_t size = 0;
+};
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_MAPPED_FILE_H_
@@ -57,7 +57,7 @@ public:
     //! Name of the node
     std::string name;
     //! List of attributes for the node
-    std::unordered_map<std::string, sdf::MappingValue> attributes;
+    OrderedMap<std::string, sdf::MappingValue> attributes;
     //! Pointer to the parent of the node
     ReferenceTreeNode* parent;
     //! List of pointers to the children of the node
@@ -101,9 +101,9 @@ public:
     }
 
     //! Function used to generate the complete map section of a sdf-mapping based on the contents of the tree
-    std::unordered_map<std::string, std::unordered_map<std::string, sdf::MappingValue>> GenerateMapping(
+    OrderedMap<std::string, OrderedMap<std::string, sdf::MappingValue>> GenerateMapping(
         ReferenceTreeNode* node) {
-        std::unordered_map<std::string, std::unordered_map<std::string, sdf::MappingValue>> map;
+        OrderedMap<std::string, OrderedMap<std::string, sdf::MappingValue>> map;
         ReferenceTreeNode* current = node;
         for (const auto& child : current->children) {
             if (!child->attributes.empty()) {
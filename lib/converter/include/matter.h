@@ -27,12 +27,12 @@
 
 #include <string>
 #include <map>
-#include <unordered_map>
 #include <list>
 #include <pugixml.hpp>
 #include <optional>
 #include <variant>
 #include "nlohmann/json.hpp"
+#include "ordered_map.h"
 
 //! Max and Min Type boundaries if value is not nullable
 //! For nullable values, max has to be decreased by one
@@ -216,7 +216,7 @@ struct Access {
 //! Struct which represents the common data.
 struct CommonQuality {
     //! Unique identifier.
-    u_int32_t id;
+    u_int32_t id = 0;
     //! CamelCase name of the element.
     std::string name;
     //! Defines dependencies.
@@ -337,7 +337,7 @@ struct Cluster : CommonQuality {
     std::list<Command> client_commands;
     //! Map of command names to their respective commands
     //! Improves the searching for server commands when matching them to their client commands
-    std::unordered_map<std::string, Command> server_commands;
+    OrderedMap<std::string, Command> server_commands;
     //! List of events
     std::list<Event> events;
     //! Map for globally defined enums
@@ -346,6 +346,13 @@ struct Cluster : CommonQuality {
     std::map<std::string, std::list<Bitfield>> bitmaps;
     //! Map for globally defined bitmaps
     std::map<std::string, Struct> structs;
+    //! Shared base cluster of a derived cluster, which is not owned by the cluster
+    //! The elements of the base cluster are layered below the elements of this cluster instead of being copied into it
+    //! Elements of this cluster shadow the elements of the base cluster with the same name
+    //! The pointer refers to an element of the cluster list given to MapMatterToSdf and is only set on the temporary
+    //! copies created while mapping, so it must not outlive that list. Copies of the cluster share the pointer, and
+    //! the parsers, serializers and the cbor codec neither set nor follow it.
+    const Cluster* base = nullptr;
 };
 
 //! Struct which contains device classification information.
@@ -405,6 +412,26 @@ void SerializeDevice(const Device& device, pugi::xml_document& device_document_x
 //! @return The resulting cluster xml.
 void SerializeCluster(const Cluster &cluster, pugi::xml_document& cluster_xml);
 
+//! @brief Write a device type into a file descriptor.
+//!
+//! This function streams a device object directly into a file descriptor without building a xml document first.
+//! It shares its writer functions with SerializeDevice, so the output equals the saved document created by it.
+//!
+//! @param device The input device object.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure.
+int WriteDevice(const Device& device, int fd);
+
+//! @brief Write a cluster into a file descriptor.
+//!
+//! This function streams a cluster object directly into a file descriptor without building a xml document first.
+//! It shares its writer functions with SerializeCluster, so the output equals the saved document created by it.
+//!
+//! @param cluster The input cluster object.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure.
+int WriteCluster(const Cluster& cluster, int fd);
+
 } // namespace matter
 
 #endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_MATTER_H_
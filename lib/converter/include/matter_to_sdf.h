@@ -28,9 +28,38 @@
 
 #include <optional>
 #include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "matter.h"
 #include "sdf.h"
 
+//! Clusters a device type depends on
+//! Recorded while the clusters get merged into the device type. Contains every cluster id the device type refers to
+//! and every base cluster the merged clusters are derived from, even if no cluster matched them, as adding such a
+//! cluster changes the result.
+struct ClusterDependencies {
+    std::set<uint32_t> cluster_ids;
+    std::set<std::string> base_clusters;
+};
+
+//! Lookup tables of a list of clusters
+//! Used to find the clusters of a device type and the base clusters of derived clusters without searching the list.
+//! The tables refer to the clusters of the list, so the list has to outlive them.
+struct ClusterLookup {
+    //! Clusters with the given id, in the order of the list
+    std::unordered_map<uint32_t, std::vector<const matter::Cluster*>> clusters_by_id;
+    //! First cluster of the list with the given alias
+    std::unordered_map<std::string, const matter::Cluster*> clusters_by_alias;
+};
+
+//! @brief Build the lookup tables of a list of clusters.
+//!
+//! @param cluster_list The input list of cluster definitions.
+//! @return The lookup tables referring to the clusters of the list.
+ClusterLookup BuildClusterLookup(const std::list<matter::Cluster>& cluster_list);
+
 //! @brief Map a device type definition to a sdf-object.
 //!
 //! This function maps a device and a list of clusters onto a sdf-model and sdf-mapping.
@@ -39,8 +68,11 @@
 //! @param cluster_list The input list of cluster definitions.
 //! @param sdf_model The resulting sdf-model.
 //! @param sdf_mapping The resulting sdf-mapping.
+//! @param dependencies Optional output for the clusters the device type depends on.
+//! @param lookup Optional lookup tables of the cluster list, which get built for every call if not given.
 //! @return 0 on success, negative on failure.
 int MapMatterToSdf(const std::optional<matter::Device>& optional_device, const std::list<matter::Cluster>& cluster_list,
-                   sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping);
+                   sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping,
+                   ClusterDependencies* dependencies = nullptr, const ClusterLookup* lookup = nullptr);
 
 #endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_MATTER_TO_SDF_H_
@@ -0,0 +1,253 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Flat map which keeps its elements in insertion order.
+ * Used for the named elements of the sdf types, so their serialization is deterministic.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_ORDERED_MAP_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_ORDERED_MAP_H_
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+//! Map which keeps its elements in insertion order
+//! The elements are stored in a single vector. Small maps are searched linearly, larger maps additionally get an open
+//! addressing index into the vector. Like a vector, inserting elements invalidates references to other elements.
+//! Erasing an element keeps the order of the remaining elements.
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class OrderedMap {
+public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<Key, T> value_type;
+    typedef std::size_t size_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    const_iterator cbegin() const { return entries.cbegin(); }
+    const_iterator cend() const { return entries.cend(); }
+
+    bool empty() const { return entries.empty(); }
+    size_type size() const { return entries.size(); }
+
+    void clear() {
+        entries.clear();
+        slots.clear();
+    }
+
+    void reserve(size_type count) {
+        entries.reserve(count);
+    }
+
+    //! Function used to find the element with the given key
+    iterator find(const Key& key) {
+        return entries.begin() + Position(key);
+    }
+
+    const_iterator find(const Key& key) const {
+        return entries.begin() + Position(key);
+    }
+
+    size_type count(const Key& key) const {
+        return Position(key) != entries.size() ? 1 : 0;
+    }
+
+    T& at(const Key& key) {
+        size_type position = Position(key);
+        if (position == entries.size()) {
+            throw std::out_of_range("OrderedMap::at");
+        }
+        return entries[position].second;
+    }
+
+    const T& at(const Key& key) const {
+        size_type position = Position(key);
+        if (position == entries.size()) {
+            throw std::out_of_range("OrderedMap::at");
+        }
+        return entries[position].second;
+    }
+
+    T& operator[](const Key& key) {
+        return try_emplace(key).first->second;
+    }
+
+    T& operator[](Key&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    //! Function used to append a new element, if no element with the given key exists
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        size_type position = Position(key);
+        if (position != entries.size()) {
+            return {entries.begin() + position, false};
+        }
+        entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        Indexed(entries.size() - 1);
+        return {entries.end() - 1, true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return try_emplace(std::move(value.first), std::move(value.second));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        return insert(value_type(std::forward<Args>(args)...));
+    }
+
+    //! Function used to erase an element, returns the iterator to the following element
+    iterator erase(const_iterator position) {
+        iterator next = entries.erase(position);
+        Rehash();
+        return next;
+    }
+
+    size_type erase(const Key& key) {
+        size_type position = Position(key);
+        if (position == entries.size()) {
+            return 0;
+        }
+        erase(entries.begin() + position);
+        return 1;
+    }
+
+    //! Function used to move all elements of the source whose key does not exist yet to the end of the map
+    //! Elements with an existing key stay in the source.
+    void merge(OrderedMap& source) {
+        OrderedMap remaining;
+        for (auto& entry : source.entries) {
+            if (count(entry.first) == 0) {
+                try_emplace(std::move(entry.first), std::move(entry.second));
+            } else {
+                remaining.try_emplace(std::move(entry.first), std::move(entry.second));
+            }
+        }
+        source = std::move(remaining);
+    }
+
+    void merge(OrderedMap&& source) {
+        merge(source);
+    }
+
+    //! Maps are equal if they contain the same elements, regardless of their order
+    friend bool operator==(const OrderedMap& lhs, const OrderedMap& rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (const auto& entry : lhs.entries) {
+            auto iter = rhs.find(entry.first);
+            if (iter == rhs.end() or !(iter->second == entry.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const OrderedMap& lhs, const OrderedMap& rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    //! Maps up to this size are searched without an index
+    static constexpr size_type kLinearSearchLimit = 8;
+
+    //! Function used to get the position of the element with the given key, or the size if there is none
+    template <typename K>
+    size_type Position(const K& key) const {
+        if (slots.empty()) {
+            for (size_type position = 0; position < entries.size(); position++) {
+                if (entries[position].first == key) {
+                    return position;
+                }
+            }
+            return entries.size();
+        }
+        size_type mask = slots.size() - 1;
+        for (size_type slot = Hash()(key) & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            if (entries[slots[slot] - 1].first == key) {
+                return slots[slot] - 1;
+            }
+        }
+        return entries.size();
+    }
+
+    //! Function used to add a newly appended element to the index
+    void Indexed(size_type position) {
+        if (entries.size() <= kLinearSearchLimit) {
+            return;
+        }
+        // Keep the load factor of the index at most one half
+        if (entries.size() * 2 > slots.size()) {
+            Rehash();
+            return;
+        }
+        size_type mask = slots.size() - 1;
+        size_type slot = Hash()(entries[position].first) & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = position + 1;
+    }
+
+    //! Function used to rebuild the index for all elements
+    void Rehash() {
+        slots.clear();
+        if (entries.size() <= kLinearSearchLimit) {
+            return;
+        }
+        size_type capacity = 16;
+        while (capacity < entries.size() * 4) {
+            capacity *= 2;
+        }
+        slots.assign(capacity, 0);
+        size_type mask = capacity - 1;
+        for (size_type position = 0; position < entries.size(); position++) {
+            size_type slot = Hash()(entries[position].first) & mask;
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = position + 1;
+        }
+    }
+
+    //! Elements in insertion order
+    std::vector<value_type> entries;
+    //! Open addressing index, holds the position of an element plus one or zero for an empty slot
+    std::vector<size_type> slots;
+};
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_ORDERED_MAP_H_
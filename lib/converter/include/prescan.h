@@ -0,0 +1,222 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Prescan of cluster definitions, used to parse only the clusters a device type depends on.
+ * The prescan only reads the header of a cluster definition, which contains the id, the name, the aliases and the
+ * classification of the cluster. The remaining definition only gets parsed once the cluster is needed.
+ * The headers of a folder of cluster definitions can be kept in an index file, which is reused as long as the files
+ * did not change, so the clusters can be looked up without opening any of them.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_PRESCAN_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_PRESCAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "loader.h"
+#include "matter.h"
+
+namespace prescan {
+
+//! Header of a cluster definition
+struct ClusterHeader {
+    uint32_t id = 0;
+    std::string name;
+    //! Ids and names of the cluster, like the cluster aliases of a parsed cluster
+    std::list<std::pair<uint32_t, std::string>> cluster_aliases;
+    //! Either base or derived, empty without classification
+    std::string hierarchy;
+    //! Cluster name of the base cluster, empty if the cluster is not derived
+    std::string base_cluster;
+};
+
+//! @brief Scan the header of a cluster definition.
+//!
+//! Only the part of the xml file in front of the first element following the header gets parsed.
+//!
+//! @param data The content of the xml file.
+//! @param size The size of the content.
+//! @param header The resulting header.
+//! @return 0 on success, negative if the content is not a xml cluster definition.
+int ScanCluster(const char* data, std::size_t size, ClusterHeader& header);
+
+//! Lookup tables of the headers of a cluster library
+struct HeaderLookup {
+    //! Indices of the clusters with the given id, in the order of the library
+    std::unordered_map<uint32_t, std::vector<std::size_t>> clusters_by_id;
+    //! Indices of the clusters with the given alias, in the order of the library
+    std::unordered_map<std::string, std::vector<std::size_t>> clusters_by_alias;
+};
+
+//! @brief Build the lookup tables of the headers of a cluster library.
+//!
+//! @param headers The headers of the cluster library.
+//! @return The lookup tables referring to the indices of the headers.
+HeaderLookup BuildHeaderLookup(const std::vector<const ClusterHeader*>& headers);
+
+//! @brief Select the clusters a device type depends on.
+//!
+//! These are the clusters with the ids of the clusters of the device type, as well as the base clusters of the derived
+//! ones, which are found by their aliases. Only the clusters found in the lookup tables get visited.
+//!
+//! @param device The device type.
+//! @param headers The headers of the cluster library.
+//! @param lookup The lookup tables of the headers.
+//! @return The indices of the selected clusters, in the order of the library.
+std::vector<std::size_t> SelectClusters(const matter::Device& device, const std::vector<const ClusterHeader*>& headers,
+                                        const HeaderLookup& lookup);
+
+//! Cluster definition of a cluster index
+struct IndexEntry {
+    std::string path;
+    //! Modification time of the file in nanoseconds and its size, used to detect changed files
+    int64_t mtime = 0;
+    uint64_t size = 0;
+    //! Hash of the content of the file, equals the cache key of the content
+    std::string hash;
+    ClusterHeader header;
+};
+
+//! Index of the headers of a folder of cluster definitions
+//! The index can be saved and gets reused by later runs, only files whose modification time or size changed get
+//! scanned again.
+class ClusterIndex {
+public:
+    //! @brief Load a saved index.
+    //!
+    //! @param path The path to the index file.
+    //! @return 0 on success, negative if the file does not exist or was saved by a different version.
+    int Load(const std::string& path);
+
+    //! @brief Save the index.
+    //!
+    //! The index gets written into a temporary file first, which replaces the index file once it is complete.
+    //!
+    //! @param path The path to the index file.
+    //! @return 0 on success, negative on failure.
+    int Save(const std::string& path) const;
+
+    //! @brief Update the index for the given cluster definitions.
+    //!
+    //! Entries of unchanged files are kept, new and changed files get loaded in one batch and scanned. The entries
+    //! follow the order of the paths afterwards.
+    //!
+    //! @param paths The paths of the cluster definitions.
+    //! @param failed_paths The paths of the files that could not be loaded or scanned.
+    //! @return True, if the index changed.
+    bool Update(const std::vector<std::string>& paths, std::vector<std::string>& failed_paths);
+
+    //! Function used to get every entry of the index
+    const std::vector<IndexEntry>& Entries() const {
+        return entries;
+    }
+
+private:
+    std::vector<IndexEntry> entries;
+};
+
+//! Cluster library whose clusters only get parsed once they are needed
+//! The files of the library get scanned on construction. Every cluster gets parsed at most once, the library can be
+//! used by multiple threads at the same time.
+class LazyClusterLibrary {
+public:
+    //! Constructor
+    //! Scans the given loaded files. Files in the binary CBOR format get decoded right away, files that could neither
+    //! be loaded nor scanned are not part of the library.
+    explicit LazyClusterLibrary(std::vector<loader::LoadedFile> files);
+
+    //! Constructor
+    //! Uses the headers of the index, the files only get loaded once their cluster gets parsed.
+    explicit LazyClusterLibrary(const ClusterIndex& index);
+
+    LazyClusterLibrary(const LazyClusterLibrary&) = delete;
+    LazyClusterLibrary& operator=(const LazyClusterLibrary&) = delete;
+
+    //! Function used to get the number of clusters of the library
+    std::size_t Size() const {
+        return entries.size();
+    }
+
+    //! Function used to get the header of a cluster
+    const ClusterHeader& Header(std::size_t index) const {
+        return entries[index].header;
+    }
+
+    //! Function used to get the path of the file of a cluster
+    const std::string& Path(std::size_t index) const {
+        return entries[index].file.path;
+    }
+
+    //! Function used to get the hash of the content of a cluster, which equals the cache key of the content
+    std::string Hash(std::size_t index) const;
+
+    //! Function used to get the files that could not be loaded or scanned
+    const std::vector<loader::LoadedFile>& FailedFiles() const {
+        return failed_files;
+    }
+
+    //! Function used to get the clusters the device type depends on
+    //! The clusters get selected through the lookup tables of the headers. Clusters get parsed the first time they are
+    //! needed, clusters that could not be parsed are skipped.
+    std::list<matter::Cluster> LoadClusters(const matter::Device& device) const;
+
+    //! Function used to get every cluster of the library
+    std::list<matter::Cluster> LoadClusters() const;
+
+private:
+    //! Cluster of the library
+    struct Entry {
+        //! The file does not get loaded for an entry of an index
+        loader::LoadedFile file;
+        ClusterHeader header;
+        //! Hash of an entry of an index, empty otherwise
+        std::string hash;
+        //! Guards the parsing of the cluster
+        mutable std::once_flag parsed;
+        mutable std::optional<matter::Cluster> cluster;
+    };
+
+    //! Function used to get the parsed cluster, parses it if needed
+    //! Returns null if the cluster could not be parsed.
+    const matter::Cluster* Parse(const Entry& entry) const;
+
+    //! Function used to build the lookup tables once every entry was added
+    void BuildLookup();
+
+    //! The entries do not move, as the once flags can neither be copied nor moved
+    std::deque<Entry> entries;
+    std::vector<const ClusterHeader*> headers;
+    HeaderLookup lookup;
+    std::vector<loader::LoadedFile> failed_files;
+};
+
+} // namespace prescan
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_PRESCAN_H_
@@ -0,0 +1,174 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Lightweight instrumentation used to profile the individual stages of a conversion.
+ * While the profiler is disabled, timers and counters only check a single flag.
+ * Additionally, the timers can be recorded as spans of a Chrome trace-event file.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_PROFILER_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace profiler {
+
+//! Set, if the profiler is enabled
+extern std::atomic<bool> enabled;
+
+//! Set, if the timers get recorded as trace events
+extern std::atomic<bool> tracing;
+
+//! Number of memory allocations counted while the profiler is enabled
+extern std::atomic<uint64_t> allocations;
+
+//! Function used to check if the profiler is enabled
+inline bool IsEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+//! @brief Enable or disable the profiler.
+//!
+//! @param value True to enable the profiler, false to disable it.
+void SetEnabled(bool value);
+
+//! @brief Enable or disable the recording of trace events.
+//!
+//! Enabling the recording of trace events also enables the profiler.
+//!
+//! @param value True to record trace events, false otherwise.
+void SetTracing(bool value);
+
+//! @brief Record the measurement of a timer.
+//!
+//! @param name The name of the timer.
+//! @param start The start of the measurement.
+//! @param end The end of the measurement.
+//! @param allocation_count The number of memory allocations during the measurement.
+//! @param detail Additional information shown for the trace event, may be empty.
+void RecordTimer(const char* name, std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end, uint64_t allocation_count, const std::string& detail);
+
+//! @brief Add a value to a counter.
+//!
+//! @param name The name of the counter.
+//! @param value The value added to the counter.
+void RecordCounter(const char* name, uint64_t value);
+
+//! Function used to increase a counter, if the profiler is enabled
+inline void Count(const char* name, uint64_t value = 1) {
+    if (IsEnabled()) {
+        RecordCounter(name, value);
+    }
+}
+
+//! @brief Record a sample of a gauge.
+//!
+//! Gauges keep the number of samples, their mean and their maximum, e.g. for the depth of a queue. While recording
+//! trace events, every sample also gets recorded as a counter event.
+//!
+//! @param name The name of the gauge.
+//! @param value The sampled value.
+void RecordGauge(const char* name, uint64_t value);
+
+//! Function used to sample a gauge, if the profiler is enabled
+inline void Sample(const char* name, uint64_t value) {
+    if (IsEnabled()) {
+        RecordGauge(name, value);
+    }
+}
+
+//! Function used to count a memory allocation, if the profiler is enabled
+//! Allocations only get counted if the executable replaces the global operator new with a version calling this.
+inline void CountAllocation() {
+    if (IsEnabled()) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+//! Timer that measures the time between its construction and its destruction
+//! Measurements with the same name get accumulated.
+class ScopedTimer {
+public:
+    //! Constructor
+    //! The name has to outlive the profiler, usually it is a string literal.
+    explicit ScopedTimer(const char* name) : name(IsEnabled() ? name : nullptr) {
+        if (this->name != nullptr) {
+            allocations_start = allocations.load(std::memory_order_relaxed);
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    //! Constructor
+    //! The detail, e.g. the name of the processed element, only gets kept while recording trace events.
+    ScopedTimer(const char* name, const std::string& detail) : ScopedTimer(name) {
+        if (this->name != nullptr and tracing.load(std::memory_order_relaxed)) {
+            this->detail = detail;
+        }
+    }
+
+    //! Destructor, records the measurement
+    ~ScopedTimer() {
+        if (name != nullptr) {
+            RecordTimer(name, start, std::chrono::steady_clock::now(),
+                        allocations.load(std::memory_order_relaxed) - allocations_start, detail);
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    //! Name of the timer, null if the profiler was disabled on construction
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+    uint64_t allocations_start = 0;
+    std::string detail;
+};
+
+//! @brief Generate a summary of all measurements.
+//!
+//! The summary contains the accumulated timers, the counters, the gauges and the total number of allocations.
+//!
+//! @return The summary in the json format.
+nlohmann::ordered_json Summary();
+
+//! @brief Write the recorded trace events into a file.
+//!
+//! The file uses the Chrome trace-event format, which can be opened with chrome://tracing or Perfetto.
+//! Every thread that recorded a measurement gets its own track.
+//!
+//! @param path The path to the file.
+//! @return 0 on success, negative on failure.
+int WriteTrace(const char* path);
+
+//! @brief Remove all measurements.
+void Reset();
+
+} // namespace profiler
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_PROFILER_H_
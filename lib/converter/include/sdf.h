@@ -26,13 +26,14 @@
 #ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_SDF_H_
 #define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_SDF_H_
 
+#include <istream>
 #include <string>
 #include <map>
-#include <unordered_map>
 #include <list>
 #include <variant>
 #include <optional>
 #include <nlohmann/json.hpp>
+#include "ordered_map.h"
 
 using json = nlohmann::ordered_json;
 
@@ -132,10 +133,10 @@ struct CommonQuality {
 struct DataQuality;
 
 //! Type definition for sdfChoice.
-typedef std::unordered_map<std::string, DataQuality> SdfChoice;
+typedef OrderedMap<std::string, DataQuality> SdfChoice;
 
 //! Type definition for sdfData.
-typedef std::unordered_map<std::string, DataQuality> SdfData;
+typedef OrderedMap<std::string, DataQuality> SdfData;
 
 //! JSO-Item Type definition.
 struct JsoItem {
@@ -156,7 +157,7 @@ struct JsoItem {
     //! Either date-time, date, time, uri, uri-reference or uuid
     std::string format;
     //! Object qualities
-    std::unordered_map<std::string, DataQuality> properties;
+    OrderedMap<std::string, DataQuality> properties;
     std::list<std::string> required;
 };
 
@@ -226,9 +227,9 @@ struct SdfProperty : DataQuality {
 
 //! Struct which contains sdfObject information.
 struct SdfObject : CommonQuality {
-    std::unordered_map<std::string, SdfProperty> sdf_property;
-    std::unordered_map<std::string, SdfAction> sdf_action;
-    std::unordered_map<std::string, SdfEvent> sdf_event;
+    OrderedMap<std::string, SdfProperty> sdf_property;
+    OrderedMap<std::string, SdfAction> sdf_action;
+    OrderedMap<std::string, SdfEvent> sdf_event;
     SdfData sdf_data;
     //! Array definition qualities
     std::optional<uint> min_items;
@@ -237,11 +238,11 @@ struct SdfObject : CommonQuality {
 
 //! Struct which contains sdfThing information.
 struct SdfThing : CommonQuality{
-    std::unordered_map<std::string, SdfThing> sdf_thing;
-    std::unordered_map<std::string, SdfObject> sdf_object;
-    std::unordered_map<std::string, SdfProperty> sdf_property;
-    std::unordered_map<std::string, SdfAction> sdf_action;
-    std::unordered_map<std::string, SdfEvent> sdf_event;
+    OrderedMap<std::string, SdfThing> sdf_thing;
+    OrderedMap<std::string, SdfObject> sdf_object;
+    OrderedMap<std::string, SdfProperty> sdf_property;
+    OrderedMap<std::string, SdfAction> sdf_action;
+    OrderedMap<std::string, SdfEvent> sdf_event;
     SdfData sdf_data;
     //! Array definition qualities
     std::optional<uint> min_items;
@@ -250,7 +251,7 @@ struct SdfThing : CommonQuality{
 
 //! Struct which contains namespace block information.
 struct NamespaceBlock {
-    std::unordered_map<std::string, std::string> namespaces;
+    OrderedMap<std::string, std::string> namespaces;
     std::string default_namespace;
 };
 
@@ -270,20 +271,21 @@ struct InformationBlock {
 struct SdfModel {
     std::optional<InformationBlock> information_block;
     std::optional<NamespaceBlock> namespace_block;
-    std::unordered_map<std::string, SdfThing> sdf_thing;
-    std::unordered_map<std::string, SdfObject> sdf_object;
+    OrderedMap<std::string, SdfThing> sdf_thing;
+    OrderedMap<std::string, SdfObject> sdf_object;
 };
 
 //! Struct which contains sdf-mapping information.
 struct SdfMapping {
     std::optional<InformationBlock> information_block;
     std::optional<NamespaceBlock> namespace_block;
-    std::unordered_map<std::string, std::unordered_map<std::string, MappingValue>> map;
+    OrderedMap<std::string, OrderedMap<std::string, MappingValue>> map;
 };
 
 //! @brief Parse a sdf-model.
 //!
-//! This functions parses a sdf-model into an object.
+//! This functions parses a sdf-model into an object. The json document gets handed to the same parser as in
+//! ReadSdfModel, so references via sdfRef get resolved the same way.
 //!
 //! @param sdf_model_json The input sdf-model.
 //! @return The parsed sdf-model.
@@ -291,12 +293,47 @@ SdfModel ParseSdfModel(json& sdf_model_json);
 
 //! @brief Parse a sdf-mapping.
 //!
-//! This function parses a sdf-mapping into an object.
+//! This function parses a sdf-mapping into an object with the same parser as ReadSdfMapping.
 //!
 //! @param sdf_mapping_json The input sdf-mapping.
 //! @return The parsed sdf-mapping.
 SdfMapping ParseSdfMapping(json& sdf_mapping_json);
 
+//! @brief Read a sdf-model.
+//!
+//! This function parses a sdf-model from an input stream directly into an object without creating a json object
+//! first. References via sdfRef get resolved after the whole sdf-model has been read.
+//!
+//! @param input The input stream containing the sdf-model.
+//! @return The parsed sdf-model.
+SdfModel ReadSdfModel(std::istream& input);
+
+//! @brief Read a sdf-mapping.
+//!
+//! This function parses a sdf-mapping from an input stream directly into an object without creating a json object
+//! first.
+//!
+//! @param input The input stream containing the sdf-mapping.
+//! @return The parsed sdf-mapping.
+SdfMapping ReadSdfMapping(std::istream& input);
+
+//! @brief Read a sdf-model from a contiguous buffer.
+//!
+//! This function works like ReadSdfModel for input streams, but reads the sdf-model from memory.
+//!
+//! @param data The buffer containing the sdf-model.
+//! @param size The size of the buffer.
+//! @return The parsed sdf-model.
+SdfModel ReadSdfModel(const char* data, std::size_t size);
+
+//! @brief Read a sdf-mapping from a contiguous buffer.
+//!
+//! This function works like ReadSdfMapping for input streams, but reads the sdf-mapping from memory.
+//!
+//! @param data The buffer containing the sdf-mapping.
+//! @param size The size of the buffer.
+//! @return The parsed sdf-mapping.
+SdfMapping ReadSdfMapping(const char* data, std::size_t size);
 
 //! @brief Serialize a sdf-model.
 //!
@@ -314,6 +351,28 @@ json SerializeSdfModel(const SdfModel& sdf_model);
 //! @return The serialized sdf-mapping.
 json SerializeSdfMapping(const SdfMapping& sdf_mapping);
 
+//! @brief Write a sdf-model.
+//!
+//! This function streams a sdf-model directly into a file descriptor without creating an intermediate json object.
+//! It shares its writer functions with SerializeSdfModel, so the output is identical to its pretty-printed output.
+//! Only strings with invalid UTF-8 differ, they get written unchanged while pretty-printing throws an exception.
+//!
+//! @param sdf_model The input sdf-model.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure.
+int WriteSdfModel(const SdfModel& sdf_model, int fd);
+
+//! @brief Write a sdf-mapping.
+//!
+//! This function streams a sdf-mapping directly into a file descriptor without creating an intermediate json object.
+//! It shares its writer functions with SerializeSdfMapping, so the output is identical to its pretty-printed output.
+//! Only strings with invalid UTF-8 differ, they get written unchanged while pretty-printing throws an exception.
+//!
+//! @param sdf_mapping The input sdf-mapping.
+//! @param fd The output file descriptor.
+//! @return 0 on success, negative on failure.
+int WriteSdfMapping(const SdfMapping& sdf_mapping, int fd);
+
 } // namespace sdf
 
 #endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_SDF_H_
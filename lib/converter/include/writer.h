@@ -0,0 +1,318 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Buffered writers used to stream the converted formats directly into a file descriptor, as well as builders with the
+ * same interface that create the corresponding json and xml documents instead.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_WRITER_H_
+#define SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_WRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <pugixml.hpp>
+
+//! Buffered writer for a file descriptor
+//! Collects the output in a fixed size buffer and only hands full buffers to the operating system.
+class BufferedWriter {
+public:
+    //! Constructor
+    //! The file descriptor is not owned by the writer and does not get closed.
+    explicit BufferedWriter(int fd, std::size_t buffer_size = 64 * 1024);
+
+    //! Destructor, flushes the remaining buffer
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    //! Function used to append data to the output
+    void Write(const char* data, std::size_t size);
+
+    //! Function used to append a string to the output
+    void Write(const std::string& str) {
+        Write(str.data(), str.size());
+    }
+
+    //! Function used to append a single character to the output
+    void Put(char ch) {
+        if (buffer.size() == capacity) {
+            Flush();
+        }
+        buffer.push_back(ch);
+    }
+
+    //! Function used to hand the buffered output to the file descriptor
+    //! Returns 0 on success and negative on failure.
+    int Flush();
+
+    //! Function used to check if a previous write to the file descriptor failed
+    bool Failed() const {
+        return failed;
+    }
+
+private:
+    //! The target file descriptor
+    int fd;
+    //! Maximal number of buffered bytes
+    std::size_t capacity;
+    //! Currently buffered bytes
+    std::vector<char> buffer;
+    //! Set, if writing to the file descriptor failed
+    bool failed = false;
+};
+
+//! Writer used to stream pretty-printed json into a BufferedWriter
+//! The output equals the output of `nlohmann::ordered_json::dump` with the given indentation, except for strings with
+//! invalid UTF-8, which get written unchanged instead of throwing an exception.
+//! Objects are opened lazily, an object without any member gets written as `null` like a default constructed json
+//! object would be.
+class JsonWriter {
+public:
+    //! Constructor
+    explicit JsonWriter(BufferedWriter& output, int indent = 4) : output(output), indent(indent) {}
+
+    //! Function used to start a new object
+    void BeginObject();
+
+    //! Function used to end the current object
+    //! If no member was written, the object gets written as `null` or as `{}` if null_if_empty is false.
+    void EndObject(bool null_if_empty = true);
+
+    //! Function used to start a new array
+    void BeginArray();
+
+    //! Function used to end the current array
+    void EndArray();
+
+    //! Function used to write the key of the next object member
+    void Key(const std::string& key);
+
+    //! Functions used to write values
+    void String(const std::string& value);
+    void Integer(int64_t value);
+    void Unsigned(uint64_t value);
+    void Float(double value);
+    void Boolean(bool value);
+    void Null();
+
+    //! Function used to write an already existing json value
+    void Json(const nlohmann::ordered_json& value);
+
+private:
+    //! Frame of a currently open object or array
+    struct Frame {
+        bool object;
+        bool opened;
+        std::size_t count;
+    };
+
+    //! Function used to write the separator in front of an array element
+    void BeforeValue();
+
+    //! Function used to write a newline followed by the indentation for the given depth
+    void NewLine(std::size_t depth);
+
+    //! Function used to write a escaped string
+    void WriteEscaped(const std::string& value);
+
+    BufferedWriter& output;
+    int indent;
+    std::vector<Frame> frames;
+};
+
+//! Writer used to stream indented xml into a BufferedWriter
+//! The output equals the output of `pugi::xml_document::save` with the default flags and tab indentation.
+//! Start tags are closed lazily, so all attributes of an element have to be written before its first child.
+class XmlWriter {
+public:
+    //! Constructor
+    explicit XmlWriter(BufferedWriter& output) : output(output) {}
+
+    //! Function used to write the xml declaration
+    void Declaration();
+
+    //! Function used to start a new element
+    //! The name has to outlive the element.
+    void StartElement(const char* name);
+
+    //! Function used to end the current element
+    //! If the element has no children, it gets written as an empty element.
+    void EndElement();
+
+    //! Functions used to write an attribute of the current element
+    //! The values get formatted like `pugi::xml_attribute::set_value` does.
+    void Attribute(const char* name, const char* value);
+    void Attribute(const char* name, const std::string& value) {
+        Attribute(name, value.c_str());
+    }
+    void Attribute(const char* name, int value) {
+        Attribute(name, static_cast<int64_t>(value));
+    }
+    void Attribute(const char* name, unsigned int value) {
+        Attribute(name, static_cast<uint64_t>(value));
+    }
+    void Attribute(const char* name, int64_t value);
+    void Attribute(const char* name, uint64_t value);
+    void Attribute(const char* name, double value);
+    void Attribute(const char* name, bool value);
+
+private:
+    //! Function used to write a newline followed by the indentation for the given depth
+    void NewLine(std::size_t depth);
+
+    //! Function used to write the name of an attribute including the opening quote
+    void BeginAttribute(const char* name);
+
+    //! Function used to write a escaped attribute value
+    void WriteEscaped(const char* value);
+
+    BufferedWriter& output;
+    //! Names of the currently open elements
+    std::vector<const char*> elements;
+    //! Set, while the start tag of the current element is not closed yet
+    bool start_tag_open = false;
+};
+
+//! Builder used to create a json document with the interface of the JsonWriter
+//! Allows to serialize a model into json with the same functions that stream it into a file, so both outputs are
+//! equal by construction.
+class JsonBuilder {
+public:
+    //! Function used to start a new object
+    void BeginObject();
+
+    //! Function used to end the current object
+    //! If no member was written, the object becomes `null` or stays `{}` if null_if_empty is false.
+    void EndObject(bool null_if_empty = true);
+
+    //! Function used to start a new array
+    void BeginArray();
+
+    //! Function used to end the current array
+    void EndArray();
+
+    //! Function used to set the key of the next object member
+    void Key(const std::string& key) {
+        next_key = key;
+    }
+
+    //! Functions used to add values
+    void String(const std::string& value) {
+        Value() = value;
+    }
+    void Integer(int64_t value) {
+        Value() = value;
+    }
+    void Unsigned(uint64_t value) {
+        Value() = value;
+    }
+    void Float(double value) {
+        Value() = value;
+    }
+    void Boolean(bool value) {
+        Value() = value;
+    }
+    void Null() {
+        Value() = nullptr;
+    }
+
+    //! Function used to add an already existing json value
+    void Json(const nlohmann::ordered_json& value) {
+        Value() = value;
+    }
+
+    //! Function used to take the created json document out of the builder
+    nlohmann::ordered_json Release() {
+        return std::move(root);
+    }
+
+private:
+    //! Function used to get the location of the next value
+    //! Either the root, a new element of the current array or the member of the current object with the last key.
+    nlohmann::ordered_json& Value();
+
+    nlohmann::ordered_json root;
+    //! The currently open objects and arrays
+    //! Only the innermost container grows, so the pointers to the outer containers stay valid.
+    std::vector<nlohmann::ordered_json*> containers;
+    std::string next_key;
+};
+
+//! Builder used to create a xml document with the interface of the XmlWriter
+//! Allows to serialize a model into a pugixml document with the same functions that stream it into a file, so both
+//! outputs are equal by construction.
+class XmlBuilder {
+public:
+    //! Constructor
+    //! The elements get appended to the given node, which has to outlive the builder.
+    explicit XmlBuilder(pugi::xml_node parent) : nodes{parent} {}
+
+    //! Function used to write the xml declaration
+    //! Does nothing, as `pugi::xml_document::save` adds the declaration itself.
+    void Declaration() {}
+
+    //! Function used to start a new element
+    void StartElement(const char* name) {
+        nodes.push_back(nodes.back().append_child(name));
+    }
+
+    //! Function used to end the current element
+    void EndElement() {
+        nodes.pop_back();
+    }
+
+    //! Functions used to add an attribute to the current element
+    void Attribute(const char* name, const char* value) {
+        nodes.back().append_attribute(name).set_value(value);
+    }
+    void Attribute(const char* name, const std::string& value) {
+        Attribute(name, value.c_str());
+    }
+    void Attribute(const char* name, int value) {
+        nodes.back().append_attribute(name).set_value(value);
+    }
+    void Attribute(const char* name, unsigned int value) {
+        nodes.back().append_attribute(name).set_value(value);
+    }
+    void Attribute(const char* name, int64_t value) {
+        nodes.back().append_attribute(name).set_value(static_cast<long long>(value));
+    }
+    void Attribute(const char* name, uint64_t value) {
+        nodes.back().append_attribute(name).set_value(static_cast<unsigned long long>(value));
+    }
+    void Attribute(const char* name, double value) {
+        nodes.back().append_attribute(name).set_value(value);
+    }
+    void Attribute(const char* name, bool value) {
+        nodes.back().append_attribute(name).set_value(value);
+    }
+
+private:
+    //! The parent node followed by the currently open elements
+    std::vector<pugi::xml_node> nodes;
+};
+
+#endif //SDF_MATTER_CONVERTER_LIB_CONVERTER_INCLUDE_WRITER_H_
@@ -0,0 +1,271 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+#include "bundle.h"
+#include "profiler.h"
+#include "writer.h"
+
+namespace bundle {
+
+const char* const kIndexName = "index.json";
+
+namespace {
+
+//! Size of a ustar block, headers and contents are aligned to it
+const std::size_t kBlockSize = 512;
+
+//! Offsets of the used ustar header fields
+const std::size_t kNameOffset = 0;
+const std::size_t kNameSize = 100;
+const std::size_t kModeOffset = 100;
+const std::size_t kUidOffset = 108;
+const std::size_t kGidOffset = 116;
+const std::size_t kSizeOffset = 124;
+const std::size_t kSizeSize = 12;
+const std::size_t kMtimeOffset = 136;
+const std::size_t kMtimeSize = 12;
+const std::size_t kChecksumOffset = 148;
+const std::size_t kChecksumSize = 8;
+const std::size_t kTypeOffset = 156;
+const std::size_t kMagicOffset = 257;
+
+//! Function used to round a size up to the next block
+std::size_t AlignToBlock(std::size_t size) {
+    return (size + kBlockSize - 1) / kBlockSize * kBlockSize;
+}
+
+//! Function used to write the given data completely at the given offset
+int WriteAt(int fd, const char* data, std::size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t written = pwrite(fd, data, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += written;
+        size -= written;
+        offset += written;
+    }
+    return 0;
+}
+
+//! Function used to write a zero padded octal number into a header field
+//! The last character of the field is the terminating null character.
+void WriteOctal(char* field, std::size_t field_size, unsigned long long value) {
+    std::snprintf(field, field_size, "%0*llo", static_cast<int>(field_size - 1), value);
+}
+
+//! Function used to calculate the checksum of a header
+//! The checksum field itself counts as spaces.
+unsigned int HeaderChecksum(const char* header) {
+    unsigned int checksum = 0;
+    for (std::size_t i = 0; i < kBlockSize; i++) {
+        if (i >= kChecksumOffset and i < kChecksumOffset + kChecksumSize) {
+            checksum += ' ';
+        } else {
+            checksum += static_cast<unsigned char>(header[i]);
+        }
+    }
+    return checksum;
+}
+
+//! Function used to fill the header of a regular file
+//! The modification time is always zero, so converting the same input results in the same bundle.
+void FillHeader(char* header, const std::string& name, std::size_t size) {
+    std::memset(header, 0, kBlockSize);
+    std::memcpy(header + kNameOffset, name.data(), name.size());
+    std::memcpy(header + kModeOffset, "0000644", 7);
+    std::memcpy(header + kUidOffset, "0000000", 7);
+    std::memcpy(header + kGidOffset, "0000000", 7);
+    WriteOctal(header + kSizeOffset, kSizeSize, size);
+    WriteOctal(header + kMtimeOffset, kMtimeSize, 0);
+    header[kTypeOffset] = '0';
+    std::memcpy(header + kMagicOffset, "ustar\0" "00", 8);
+    char checksum[kChecksumSize];
+    std::snprintf(checksum, sizeof(checksum), "%06o", HeaderChecksum(header));
+    std::memcpy(header + kChecksumOffset, checksum, 7);
+    header[kChecksumOffset + 7] = ' ';
+}
+
+//! Function used to parse a header
+//! Returns false if the block is not a valid ustar header.
+bool ParseHeader(const char* header, std::string& name, std::size_t& size) {
+    if (std::memcmp(header + kMagicOffset, "ustar", 5) != 0 or
+        std::strtoul(std::string(header + kChecksumOffset, kChecksumSize).c_str(), nullptr, 8) !=
+        HeaderChecksum(header)) {
+        return false;
+    }
+    name.assign(header + kNameOffset, strnlen(header + kNameOffset, kNameSize));
+    size = std::strtoull(std::string(header + kSizeOffset, kSizeSize).c_str(), nullptr, 8);
+    return true;
+}
+
+} // namespace
+
+BundleWriter::~BundleWriter() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+int BundleWriter::Open(const char* path) {
+    entries.clear();
+    failed = false;
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    return fd < 0 ? -1 : 0;
+}
+
+//! Function used to add a member to the bundle
+//! The space for the header gets reserved first and filled after the content was written.
+int BundleWriter::Add(const std::string& name, const std::function<int(int)>& write) {
+    profiler::ScopedTimer timer("BundleAdd", name);
+    if (fd < 0 or failed or name.empty() or name.size() >= kNameSize) {
+        failed = true;
+        return -1;
+    }
+    char header[kBlockSize] = {};
+    off_t header_offset = lseek(fd, 0, SEEK_CUR);
+    if (header_offset < 0 or WriteAt(fd, header, kBlockSize, header_offset) != 0 or
+        lseek(fd, header_offset + kBlockSize, SEEK_SET) < 0 or write(fd) != 0) {
+        failed = true;
+        return -1;
+    }
+
+    off_t end = lseek(fd, 0, SEEK_CUR);
+    std::size_t size = end - header_offset - kBlockSize;
+    std::size_t padding = AlignToBlock(size) - size;
+    FillHeader(header, name, size);
+    if (end < 0 or WriteAt(fd, header, kBlockSize, header_offset) != 0 or
+        WriteAt(fd, std::string(padding, '\0').data(), padding, end) != 0 or
+        lseek(fd, end + padding, SEEK_SET) < 0) {
+        failed = true;
+        return -1;
+    }
+    entries.push_back({name, static_cast<std::size_t>(header_offset) + kBlockSize, size});
+    return 0;
+}
+
+//! Function used to write the index and to close the bundle
+//! The archive ends with two empty blocks like every ustar archive.
+int BundleWriter::Close() {
+    if (fd < 0) {
+        return -1;
+    }
+    std::vector<Entry> members = entries;
+    Add(kIndexName, [&members](int index_fd) {
+        BufferedWriter output(index_fd);
+        JsonWriter writer(output);
+        writer.BeginObject();
+        writer.Key("files");
+        writer.BeginArray();
+        for (const auto& member : members) {
+            writer.BeginObject();
+            writer.Key("name");
+            writer.String(member.name);
+            writer.Key("offset");
+            writer.Unsigned(member.offset);
+            writer.Key("size");
+            writer.Unsigned(member.size);
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+        return output.Flush();
+    });
+    entries = std::move(members);
+
+    char end_of_archive[2 * kBlockSize] = {};
+    off_t end = lseek(fd, 0, SEEK_CUR);
+    if (end < 0 or WriteAt(fd, end_of_archive, sizeof(end_of_archive), end) != 0) {
+        failed = true;
+    }
+    if (close(fd) != 0) {
+        failed = true;
+    }
+    fd = -1;
+    return failed ? -1 : 0;
+}
+
+//! Function used to open the bundle at the given path
+//! The index gets searched backwards from the end of the bundle. If the bundle does not contain an index, e.g. because
+//! it was packed again by tar, the headers of all members get read instead.
+int BundleReader::Open(const char* path) {
+    profiler::ScopedTimer timer("BundleOpen", path);
+    entries.clear();
+    if (file.Map(path) != 0 or file.Size() % kBlockSize != 0) {
+        return -1;
+    }
+    const char* data = file.Data();
+    std::size_t size = file.Size();
+
+    std::string name;
+    std::size_t member_size;
+    for (std::size_t offset = size; offset >= kBlockSize; offset -= kBlockSize) {
+        const char* header = data + offset - kBlockSize;
+        if (!ParseHeader(header, name, member_size) or name != kIndexName) {
+            continue;
+        }
+        std::size_t content_offset = offset;
+        if (content_offset + member_size > size) {
+            break;
+        }
+        try {
+            auto index = nlohmann::json::parse(data + content_offset, data + content_offset + member_size);
+            for (const auto& member : index.at("files")) {
+                Entry& entry = entries.emplace_back();
+                member.at("name").get_to(entry.name);
+                member.at("offset").get_to(entry.offset);
+                member.at("size").get_to(entry.size);
+                if (entry.offset + entry.size > size) {
+                    entries.clear();
+                    return -1;
+                }
+            }
+            return 0;
+        }
+        catch (const nlohmann::json::exception&) {
+            entries.clear();
+            break;
+        }
+    }
+
+    // Fall back to reading every header
+    for (std::size_t offset = 0; offset + kBlockSize <= size;) {
+        const char* header = data + offset;
+        if (header[0] == '\0') {
+            return 0;
+        }
+        if (!ParseHeader(header, name, member_size) or offset + kBlockSize + member_size > size) {
+            entries.clear();
+            return -1;
+        }
+        if (name != kIndexName) {
+            entries.push_back({name, offset + kBlockSize, member_size});
+        }
+        offset += kBlockSize + AlignToBlock(member_size);
+    }
+    return 0;
+}
+
+} // namespace bundle
@@ -0,0 +1,312 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+#include "cache.h"
+#include "mapped_file.h"
+#include "profiler.h"
+
+namespace cache {
+
+namespace {
+
+//! Round constants of SHA-256
+const uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+//! Version of the layout of the cache entries
+const char* const kCacheFormat = "sdf-matter-converter-cache-1";
+
+//! Name of the manifest inside of an entry
+const char* const kManifest = "manifest";
+
+//! Function used to get the suffix of a temporary file
+//! The suffix is unique for every process and thread, as multiple threads may store the same entry.
+std::string TemporarySuffix() {
+    std::size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return ".tmp-" + std::to_string(getpid()) + "-" + std::to_string(thread);
+}
+
+inline uint32_t RotateRight(uint32_t value, int count) {
+    return (value >> count) | (value << (32 - count));
+}
+
+} // namespace
+
+Sha256::Sha256() : state({0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                          0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}), block() {}
+
+void Sha256::Transform(const unsigned char* data) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t(data[i * 4]) << 24) | (uint32_t(data[i * 4 + 1]) << 16) |
+               (uint32_t(data[i * 4 + 2]) << 8) | uint32_t(data[i * 4 + 3]);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+        uint32_t choice = (e & f) ^ (~e & g);
+        uint32_t temp1 = h + s1 + choice + kRoundConstants[i] + w[i];
+        uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+        uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t temp2 = s0 + majority;
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + temp2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void Sha256::Update(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    message_size += size;
+    // Complete a partially filled block first
+    if (block_size > 0) {
+        std::size_t count = std::min(size, block.size() - block_size);
+        std::copy(bytes, bytes + count, block.begin() + block_size);
+        block_size += count;
+        bytes += count;
+        size -= count;
+        if (block_size < block.size()) {
+            return;
+        }
+        Transform(block.data());
+        block_size = 0;
+    }
+    // Process full blocks without copying them
+    for (; size >= block.size(); bytes += block.size(), size -= block.size()) {
+        Transform(bytes);
+    }
+    std::copy(bytes, bytes + size, block.begin());
+    block_size = size;
+}
+
+std::string Sha256::HexDigest() {
+    uint64_t bit_size = message_size * 8;
+    // Pad the message with a one bit followed by zeros, so its size is congruent to 56 modulo 64
+    unsigned char padding[72] = {0x80};
+    std::size_t padding_size = (block_size < 56 ? 56 : 120) - block_size;
+    for (int i = 0; i < 8; i++) {
+        padding[padding_size + i] = static_cast<unsigned char>(bit_size >> (56 - i * 8));
+    }
+    Update(padding, padding_size + 8);
+
+    static const char hex_digits[] = "0123456789abcdef";
+    std::string digest;
+    for (uint32_t word : state) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            digest.push_back(hex_digits[(word >> shift) & 0x0F]);
+        }
+    }
+    return digest;
+}
+
+CacheKey::CacheKey() {
+    Add(kCacheFormat);
+    Add(SDF_MATTER_CONVERTER_VERSION);
+}
+
+void CacheKey::Add(const char* data, std::size_t size) {
+    uint64_t value_size = size;
+    hash.Update(&value_size, sizeof(value_size));
+    hash.Update(data, size);
+}
+
+//! Function used to add the content of a file to the key
+//! The file gets mapped into memory, with a fallback to reading it as a stream, e.g. for pipes.
+int CacheKey::AddFile(const char* path) {
+    profiler::ScopedTimer timer("HashFile", path);
+    MappedFile mapped_file;
+    if (mapped_file.Map(path) == 0) {
+        uint64_t size = mapped_file.Size();
+        hash.Update(&size, sizeof(size));
+        hash.Update(mapped_file.Data(), mapped_file.Size());
+        return 0;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return -1;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        return -1;
+    }
+    Add(content);
+    return 0;
+}
+
+std::string CacheKey::Digest() {
+    return hash.HexDigest();
+}
+
+//! Function used to get the directory of an entry
+//! The entries are spread over subdirectories named by the first two characters of their key.
+std::string ConversionCache::EntryDirectory(const std::string& key) const {
+    return (std::filesystem::path(directory) / key.substr(0, 2) / key).string();
+}
+
+int ConversionCache::Restore(const std::string& key, const std::string& output_prefix,
+                             std::vector<std::string>& output_paths) {
+    profiler::ScopedTimer timer("CacheRestore", key);
+    std::filesystem::path entry = EntryDirectory(key);
+    std::ifstream manifest(entry / kManifest);
+    if (!manifest) {
+        profiler::Count("cache_misses");
+        return -1;
+    }
+
+    output_paths.clear();
+    std::string name;
+    for (std::size_t index = 0; std::getline(manifest, name); index++) {
+        std::string output_path = output_prefix + name;
+        std::error_code error;
+        std::filesystem::copy_file(entry / std::to_string(index), output_path,
+                                   std::filesystem::copy_options::overwrite_existing, error);
+        if (error) {
+            profiler::Count("cache_misses");
+            return -1;
+        }
+        output_paths.push_back(output_path);
+    }
+    profiler::Count("cache_hits");
+    return 0;
+}
+
+int ConversionCache::Store(const std::string& key, const std::string& output_prefix,
+                           const std::vector<std::string>& output_paths) {
+    profiler::ScopedTimer timer("CacheStore", key);
+    std::filesystem::path entry = EntryDirectory(key);
+    std::error_code error;
+    if (std::filesystem::exists(entry, error)) {
+        return 0;
+    }
+
+    // Write the entry into a temporary directory next to its final location
+    std::filesystem::path temporary = entry;
+    temporary += TemporarySuffix();
+    std::filesystem::create_directories(temporary, error);
+    if (error) {
+        return -1;
+    }
+    std::ofstream manifest(temporary / kManifest);
+    for (std::size_t index = 0; index < output_paths.size() and !error; index++) {
+        const std::string& output_path = output_paths[index];
+        if (output_path.compare(0, output_prefix.size(), output_prefix) != 0) {
+            error = std::make_error_code(std::errc::invalid_argument);
+            break;
+        }
+        std::filesystem::copy_file(output_path, temporary / std::to_string(index), error);
+        manifest << output_path.substr(output_prefix.size()) << '\n';
+    }
+    manifest.close();
+    if (error or !manifest) {
+        std::filesystem::remove_all(temporary, error);
+        return -1;
+    }
+
+    std::filesystem::rename(temporary, entry, error);
+    if (error) {
+        std::filesystem::remove_all(temporary, error);
+        // If another run stored the same entry in the meantime, its entry is kept, otherwise the entry is missing
+        if (!std::filesystem::exists(entry, error)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+//! Function used to load the recorded dependencies of a device type
+//! The dependencies are stored as a json file next to the entries.
+int ConversionCache::LoadDependencies(const std::string& key, ClusterDependencies& dependencies) {
+    std::ifstream file(EntryDirectory(key) + ".dependencies.json");
+    if (!file) {
+        return -1;
+    }
+    try {
+        nlohmann::json record = nlohmann::json::parse(file);
+        dependencies.cluster_ids = record.at("clusterIds").get<std::set<uint32_t>>();
+        dependencies.base_clusters = record.at("baseClusters").get<std::set<std::string>>();
+    }
+    catch (const std::exception&) {
+        return -1;
+    }
+    return 0;
+}
+
+int ConversionCache::StoreDependencies(const std::string& key, const ClusterDependencies& dependencies) {
+    std::filesystem::path path = EntryDirectory(key) + ".dependencies.json";
+    std::filesystem::path temporary = path;
+    temporary += TemporarySuffix();
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error) {
+        return -1;
+    }
+
+    nlohmann::json record;
+    record["clusterIds"] = dependencies.cluster_ids;
+    record["baseClusters"] = dependencies.base_clusters;
+    std::ofstream file(temporary);
+    file << record.dump();
+    file.close();
+    if (!file) {
+        std::filesystem::remove(temporary, error);
+        return -1;
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return -1;
+    }
+    return 0;
+}
+
+} // namespace cache
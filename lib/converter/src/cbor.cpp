@@ -0,0 +1,654 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cstdint>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "cbor.h"
+#include "profiler.h"
+#include "writer.h"
+
+namespace cbor {
+
+using json = nlohmann::json;
+
+namespace {
+
+//! Self-described CBOR tag 55799, which prefixes every encoded file
+const unsigned char kMagic[] = {0xd9, 0xd9, 0xf7};
+
+//! Function used to encode a json value and append it to the given buffer
+template <typename Json>
+void AppendEncoded(const Json& value, std::vector<std::uint8_t>& output) {
+    output.insert(output.end(), std::begin(kMagic), std::end(kMagic));
+    Json::to_cbor(value, output);
+}
+
+//! Function used to encode a json value and write it into the given file descriptor
+template <typename Json>
+int WriteEncoded(const Json& value, int fd) {
+    std::vector<std::uint8_t> encoded;
+    AppendEncoded(value, encoded);
+    BufferedWriter output(fd);
+    output.Write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+    return output.Flush();
+}
+
+//! Function used to decode the given data into a json value
+template <typename Json>
+Json ReadEncoded(const char* data, std::size_t size) {
+    if (!IsEncoded(data, size)) {
+        throw Json::parse_error::create(112, 0, "missing self-described CBOR tag", nullptr);
+    }
+    const auto* begin = reinterpret_cast<const std::uint8_t*>(data) + sizeof(kMagic);
+    return Json::from_cbor(begin, reinterpret_cast<const std::uint8_t*>(data) + size);
+}
+
+//! Helper functions used to encode optional members, empty members are left out
+template <typename T>
+void SetOptional(json& object, const char* key, const std::optional<T>& value) {
+    if (value.has_value()) {
+        object[key] = value.value();
+    }
+}
+
+void SetString(json& object, const char* key, const std::string& value) {
+    if (!value.empty()) {
+        object[key] = value;
+    }
+}
+
+//! Helper functions used to decode optional members
+template <typename T>
+void GetOptional(const json& object, const char* key, std::optional<T>& value) {
+    auto it = object.find(key);
+    if (it != object.end()) {
+        value = it->template get<T>();
+    }
+}
+
+void GetString(const json& object, const char* key, std::string& value) {
+    auto it = object.find(key);
+    if (it != object.end()) {
+        it->get_to(value);
+    }
+}
+
+//! Function used to encode a variant as a pair of the index of the alternative and its value
+//! The index keeps signed and unsigned integers apart.
+template <typename Variant>
+json EncodeVariant(const Variant& value) {
+    json encoded = json::array({value.index()});
+    std::visit([&encoded](const auto& alternative) {
+        using T = std::decay_t<decltype(alternative)>;
+        if constexpr (std::is_same_v<T, std::optional<std::monostate>>) {
+            encoded.push_back(nullptr);
+        } else {
+            encoded.push_back(alternative);
+        }
+    }, value);
+    return encoded;
+}
+
+//! Function used to decode a variant encoded by EncodeVariant
+template <typename Variant, std::size_t Index = 0>
+Variant DecodeVariant(const json& encoded, std::size_t index) {
+    if constexpr (Index < std::variant_size_v<Variant>) {
+        if (index == Index) {
+            using T = std::variant_alternative_t<Index, Variant>;
+            if constexpr (std::is_same_v<T, std::optional<std::monostate>>) {
+                return Variant(std::in_place_index<Index>, std::nullopt);
+            } else {
+                return Variant(std::in_place_index<Index>, encoded.at(1).get<T>());
+            }
+        }
+        return DecodeVariant<Variant, Index + 1>(encoded, index);
+    } else {
+        throw json::out_of_range::create(401, "invalid variant index " + std::to_string(index), nullptr);
+    }
+}
+
+template <typename Variant>
+Variant DecodeVariant(const json& encoded) {
+    return DecodeVariant<Variant>(encoded, encoded.at(0).get<std::size_t>());
+}
+
+json EncodeOtherQuality(const matter::OtherQuality& other_quality) {
+    json encoded = json::object();
+    SetOptional(encoded, "nullable", other_quality.nullable);
+    SetOptional(encoded, "nonVolatile", other_quality.non_volatile);
+    SetOptional(encoded, "fixed", other_quality.fixed);
+    SetOptional(encoded, "scene", other_quality.scene);
+    SetOptional(encoded, "reportable", other_quality.reportable);
+    SetOptional(encoded, "changeOmitted", other_quality.change_omitted);
+    SetOptional(encoded, "singleton", other_quality.singleton);
+    SetOptional(encoded, "diagnostics", other_quality.diagnostics);
+    SetOptional(encoded, "largeMessage", other_quality.large_message);
+    SetOptional(encoded, "quieterReporting", other_quality.quieter_reporting);
+    return encoded;
+}
+
+matter::OtherQuality DecodeOtherQuality(const json& encoded) {
+    matter::OtherQuality other_quality;
+    GetOptional(encoded, "nullable", other_quality.nullable);
+    GetOptional(encoded, "nonVolatile", other_quality.non_volatile);
+    GetOptional(encoded, "fixed", other_quality.fixed);
+    GetOptional(encoded, "scene", other_quality.scene);
+    GetOptional(encoded, "reportable", other_quality.reportable);
+    GetOptional(encoded, "changeOmitted", other_quality.change_omitted);
+    GetOptional(encoded, "singleton", other_quality.singleton);
+    GetOptional(encoded, "diagnostics", other_quality.diagnostics);
+    GetOptional(encoded, "largeMessage", other_quality.large_message);
+    GetOptional(encoded, "quieterReporting", other_quality.quieter_reporting);
+    return other_quality;
+}
+
+json EncodeConstraint(const matter::Constraint& constraint) {
+    json encoded = json::object();
+    SetString(encoded, "type", constraint.type);
+    if (constraint.value.has_value()) {
+        encoded["value"] = EncodeVariant(constraint.value.value());
+    }
+    if (constraint.min.has_value()) {
+        encoded["min"] = EncodeVariant(constraint.min.value());
+    }
+    if (constraint.max.has_value()) {
+        encoded["max"] = EncodeVariant(constraint.max.value());
+    }
+    SetString(encoded, "entryType", constraint.entry_type);
+    if (constraint.entry_constraint != nullptr) {
+        encoded["entryConstraint"] = EncodeConstraint(*constraint.entry_constraint);
+    }
+    SetOptional(encoded, "byteSize", constraint.byte_size);
+    return encoded;
+}
+
+matter::Constraint DecodeConstraint(const json& encoded) {
+    matter::Constraint constraint;
+    GetString(encoded, "type", constraint.type);
+    if (encoded.contains("value")) {
+        constraint.value = DecodeVariant<matter::DefaultType>(encoded.at("value"));
+    }
+    if (encoded.contains("min")) {
+        constraint.min = DecodeVariant<matter::NumericType>(encoded.at("min"));
+    }
+    if (encoded.contains("max")) {
+        constraint.max = DecodeVariant<matter::NumericType>(encoded.at("max"));
+    }
+    GetString(encoded, "entryType", constraint.entry_type);
+    if (encoded.contains("entryConstraint")) {
+        // Like the mapping, the entry constraint is owned by the model for its whole lifetime
+        constraint.entry_constraint = new matter::Constraint(DecodeConstraint(encoded.at("entryConstraint")));
+    }
+    GetOptional(encoded, "byteSize", constraint.byte_size);
+    return constraint;
+}
+
+json EncodeConformance(const matter::Conformance& conformance) {
+    json encoded = json::object();
+    for (const auto& [key, value] : {std::pair{"mandatory", conformance.mandatory},
+                                     std::pair{"optional", conformance.optional},
+                                     std::pair{"provisional", conformance.provisional},
+                                     std::pair{"deprecated", conformance.deprecated},
+                                     std::pair{"disallowed", conformance.disallowed}}) {
+        if (value) {
+            encoded[key] = true;
+        }
+    }
+    if (!conformance.otherwise.empty()) {
+        json& otherwise = encoded["otherwise"] = json::array();
+        for (const auto& otherwise_conformance : conformance.otherwise) {
+            otherwise.push_back(EncodeConformance(otherwise_conformance));
+        }
+    }
+    SetString(encoded, "choice", conformance.choice);
+    SetOptional(encoded, "more", conformance.choice_more);
+    // An empty object is the default condition
+    if (!(conformance.condition.is_object() and conformance.condition.empty())) {
+        encoded["condition"] = conformance.condition;
+    }
+    return encoded;
+}
+
+matter::Conformance DecodeConformance(const json& encoded) {
+    matter::Conformance conformance;
+    conformance.mandatory = encoded.value("mandatory", false);
+    conformance.optional = encoded.value("optional", false);
+    conformance.provisional = encoded.value("provisional", false);
+    conformance.deprecated = encoded.value("deprecated", false);
+    conformance.disallowed = encoded.value("disallowed", false);
+    if (encoded.contains("otherwise")) {
+        for (const auto& otherwise_conformance : encoded.at("otherwise")) {
+            conformance.otherwise.push_back(DecodeConformance(otherwise_conformance));
+        }
+    }
+    GetString(encoded, "choice", conformance.choice);
+    GetOptional(encoded, "more", conformance.choice_more);
+    if (encoded.contains("condition")) {
+        conformance.condition = encoded.at("condition");
+    }
+    return conformance;
+}
+
+json EncodeAccess(const matter::Access& access) {
+    json encoded = json::object();
+    SetOptional(encoded, "read", access.read);
+    SetOptional(encoded, "write", access.write);
+    SetOptional(encoded, "fabricScoped", access.fabric_scoped);
+    SetOptional(encoded, "fabricSensitive", access.fabric_sensitive);
+    SetString(encoded, "readPrivilege", access.read_privilege);
+    SetString(encoded, "writePrivilege", access.write_privilege);
+    SetString(encoded, "invokePrivilege", access.invoke_privilege);
+    SetOptional(encoded, "timed", access.timed);
+    return encoded;
+}
+
+matter::Access DecodeAccess(const json& encoded) {
+    matter::Access access;
+    GetOptional(encoded, "read", access.read);
+    GetOptional(encoded, "write", access.write);
+    GetOptional(encoded, "fabricScoped", access.fabric_scoped);
+    GetOptional(encoded, "fabricSensitive", access.fabric_sensitive);
+    GetString(encoded, "readPrivilege", access.read_privilege);
+    GetString(encoded, "writePrivilege", access.write_privilege);
+    GetString(encoded, "invokePrivilege", access.invoke_privilege);
+    GetOptional(encoded, "timed", access.timed);
+    return access;
+}
+
+//! Function used to encode the members shared by all Matter elements
+void EncodeCommonQuality(const matter::CommonQuality& common_quality, json& encoded) {
+    encoded["id"] = common_quality.id;
+    encoded["name"] = common_quality.name;
+    if (common_quality.conformance.has_value()) {
+        encoded["conformance"] = EncodeConformance(common_quality.conformance.value());
+    }
+    if (common_quality.access.has_value()) {
+        encoded["access"] = EncodeAccess(common_quality.access.value());
+    }
+    SetString(encoded, "summary", common_quality.summary);
+}
+
+void DecodeCommonQuality(const json& encoded, matter::CommonQuality& common_quality) {
+    encoded.at("id").get_to(common_quality.id);
+    encoded.at("name").get_to(common_quality.name);
+    if (encoded.contains("conformance")) {
+        common_quality.conformance = DecodeConformance(encoded.at("conformance"));
+    }
+    if (encoded.contains("access")) {
+        common_quality.access = DecodeAccess(encoded.at("access"));
+    }
+    GetString(encoded, "summary", common_quality.summary);
+}
+
+//! Function used to encode the members of a data field or an attribute
+template <typename Element>
+void EncodeTypedElement(const Element& element, json& encoded) {
+    EncodeCommonQuality(element, encoded);
+    SetString(encoded, "type", element.type);
+    if (element.constraint.has_value()) {
+        encoded["constraint"] = EncodeConstraint(element.constraint.value());
+    }
+    if (element.quality.has_value()) {
+        encoded["quality"] = EncodeOtherQuality(element.quality.value());
+    }
+    if (element.default_.has_value()) {
+        encoded["default"] = EncodeVariant(element.default_.value());
+    }
+}
+
+template <typename Element>
+void DecodeTypedElement(const json& encoded, Element& element) {
+    DecodeCommonQuality(encoded, element);
+    GetString(encoded, "type", element.type);
+    if (encoded.contains("constraint")) {
+        element.constraint = DecodeConstraint(encoded.at("constraint"));
+    }
+    if (encoded.contains("quality")) {
+        element.quality = DecodeOtherQuality(encoded.at("quality"));
+    }
+    if (encoded.contains("default")) {
+        element.default_ = DecodeVariant<matter::DefaultType>(encoded.at("default"));
+    }
+}
+
+json EncodeStruct(const matter::Struct& data_fields) {
+    json encoded = json::array();
+    for (const auto& data_field : data_fields) {
+        EncodeTypedElement(data_field, encoded.emplace_back(json::object()));
+    }
+    return encoded;
+}
+
+matter::Struct DecodeStruct(const json& encoded) {
+    matter::Struct data_fields;
+    for (const auto& encoded_data_field : encoded) {
+        DecodeTypedElement(encoded_data_field, data_fields.emplace_back());
+    }
+    return data_fields;
+}
+
+json EncodeEvent(const matter::Event& event) {
+    json encoded = json::object();
+    EncodeCommonQuality(event, encoded);
+    encoded["priority"] = event.priority;
+    if (event.quality.has_value()) {
+        encoded["quality"] = EncodeOtherQuality(event.quality.value());
+    }
+    encoded["data"] = EncodeStruct(event.data);
+    return encoded;
+}
+
+matter::Event DecodeEvent(const json& encoded) {
+    matter::Event event;
+    DecodeCommonQuality(encoded, event);
+    encoded.at("priority").get_to(event.priority);
+    if (encoded.contains("quality")) {
+        event.quality = DecodeOtherQuality(encoded.at("quality"));
+    }
+    event.data = DecodeStruct(encoded.at("data"));
+    return event;
+}
+
+json EncodeCommand(const matter::Command& command) {
+    json encoded = json::object();
+    EncodeCommonQuality(command, encoded);
+    encoded["direction"] = command.direction;
+    SetString(encoded, "response", command.response);
+    encoded["fields"] = EncodeStruct(command.command_fields);
+    return encoded;
+}
+
+matter::Command DecodeCommand(const json& encoded) {
+    matter::Command command;
+    DecodeCommonQuality(encoded, command);
+    encoded.at("direction").get_to(command.direction);
+    GetString(encoded, "response", command.response);
+    command.command_fields = DecodeStruct(encoded.at("fields"));
+    return command;
+}
+
+//! Function used to encode a enum item or a bitfield, which only differ in the name of their value
+template <typename Element>
+json EncodeEnumerated(const Element& element, int value, const char* value_key) {
+    json encoded = json::object();
+    encoded[value_key] = value;
+    encoded["name"] = element.name;
+    SetString(encoded, "summary", element.summary);
+    if (element.conformance.has_value()) {
+        encoded["conformance"] = EncodeConformance(element.conformance.value());
+    }
+    return encoded;
+}
+
+template <typename Element>
+Element DecodeEnumerated(const json& encoded, const char* value_key, int& value) {
+    Element element;
+    encoded.at(value_key).get_to(value);
+    encoded.at("name").get_to(element.name);
+    GetString(encoded, "summary", element.summary);
+    if (encoded.contains("conformance")) {
+        element.conformance = DecodeConformance(encoded.at("conformance"));
+    }
+    return element;
+}
+
+json EncodeRevisionHistory(const matter::Revision& revision_history) {
+    json encoded = json::array();
+    for (const auto& revision : revision_history) {
+        encoded.push_back(json::array({revision.first, revision.second}));
+    }
+    return encoded;
+}
+
+matter::Revision DecodeRevisionHistory(const json& encoded) {
+    matter::Revision revision_history;
+    for (const auto& revision : encoded) {
+        revision_history.emplace(revision.at(0).get<u_int8_t>(), revision.at(1).get<std::string>());
+    }
+    return revision_history;
+}
+
+json EncodeCluster(const matter::Cluster& cluster) {
+    json encoded = json::object();
+    EncodeCommonQuality(cluster, encoded);
+    SetString(encoded, "side", cluster.side);
+    encoded["revision"] = cluster.revision;
+    encoded["revisionHistory"] = EncodeRevisionHistory(cluster.revision_history);
+
+    json& cluster_ids = encoded["clusterIds"] = json::array();
+    for (const auto& cluster_alias : cluster.cluster_aliases) {
+        cluster_ids.push_back(json::array({cluster_alias.first, cluster_alias.second}));
+    }
+
+    if (cluster.classification.has_value()) {
+        const matter::ClusterClassification& classification = cluster.classification.value();
+        json& encoded_classification = encoded["classification"] = json::object();
+        SetString(encoded_classification, "hierarchy", classification.hierarchy);
+        SetString(encoded_classification, "role", classification.role);
+        SetString(encoded_classification, "picsCode", classification.pics_code);
+        SetString(encoded_classification, "scope", classification.scope);
+        SetString(encoded_classification, "baseCluster", classification.base_cluster);
+        SetString(encoded_classification, "primaryTransaction", classification.primary_transaction);
+    }
+
+    json& features = encoded["features"] = json::array();
+    for (const auto& feature : cluster.feature_map) {
+        json& encoded_feature = features.emplace_back(EncodeEnumerated(feature, feature.bit, "bit"));
+        encoded_feature["code"] = feature.code;
+    }
+
+    json& attributes = encoded["attributes"] = json::array();
+    for (const auto& attribute : cluster.attributes) {
+        EncodeTypedElement(attribute, attributes.emplace_back(json::object()));
+    }
+
+    json& client_commands = encoded["clientCommands"] = json::array();
+    for (const auto& client_command : cluster.client_commands) {
+        client_commands.push_back(EncodeCommand(client_command));
+    }
+
+    // The server commands are keyed by their name, the key is stored together with the command
+    json& server_commands = encoded["serverCommands"] = json::array();
+    for (const auto& server_command : cluster.server_commands) {
+        server_commands.push_back(json::array({server_command.first, EncodeCommand(server_command.second)}));
+    }
+
+    json& events = encoded["events"] = json::array();
+    for (const auto& event : cluster.events) {
+        events.push_back(EncodeEvent(event));
+    }
+
+    json& enums = encoded["enums"] = json::object();
+    for (const auto& current_enum : cluster.enums) {
+        json& items = enums[current_enum.first] = json::array();
+        for (const auto& item : current_enum.second) {
+            items.push_back(EncodeEnumerated(item, item.value, "value"));
+        }
+    }
+
+    json& bitmaps = encoded["bitmaps"] = json::object();
+    for (const auto& bitmap : cluster.bitmaps) {
+        json& bitfields = bitmaps[bitmap.first] = json::array();
+        for (const auto& bitfield : bitmap.second) {
+            bitfields.push_back(EncodeEnumerated(bitfield, bitfield.bit, "bit"));
+        }
+    }
+
+    json& structs = encoded["structs"] = json::object();
+    for (const auto& current_struct : cluster.structs) {
+        structs[current_struct.first] = EncodeStruct(current_struct.second);
+    }
+    return encoded;
+}
+
+matter::Cluster DecodeCluster(const json& encoded) {
+    matter::Cluster cluster;
+    DecodeCommonQuality(encoded, cluster);
+    GetString(encoded, "side", cluster.side);
+    encoded.at("revision").get_to(cluster.revision);
+    cluster.revision_history = DecodeRevisionHistory(encoded.at("revisionHistory"));
+
+    for (const auto& cluster_alias : encoded.at("clusterIds")) {
+        cluster.cluster_aliases.emplace_back(cluster_alias.at(0).get<uint32_t>(),
+                                             cluster_alias.at(1).get<std::string>());
+    }
+
+    if (encoded.contains("classification")) {
+        const json& encoded_classification = encoded.at("classification");
+        matter::ClusterClassification& classification = cluster.classification.emplace();
+        GetString(encoded_classification, "hierarchy", classification.hierarchy);
+        GetString(encoded_classification, "role", classification.role);
+        GetString(encoded_classification, "picsCode", classification.pics_code);
+        GetString(encoded_classification, "scope", classification.scope);
+        GetString(encoded_classification, "baseCluster", classification.base_cluster);
+        GetString(encoded_classification, "primaryTransaction", classification.primary_transaction);
+    }
+
+    for (const auto& encoded_feature : encoded.at("features")) {
+        int bit;
+        matter::Feature& feature = cluster.feature_map.emplace_back(
+                DecodeEnumerated<matter::Feature>(encoded_feature, "bit", bit));
+        feature.bit = bit;
+        encoded_feature.at("code").get_to(feature.code);
+    }
+
+    for (const auto& encoded_attribute : encoded.at("attributes")) {
+        DecodeTypedElement(encoded_attribute, cluster.attributes.emplace_back());
+    }
+
+    for (const auto& client_command : encoded.at("clientCommands")) {
+        cluster.client_commands.push_back(DecodeCommand(client_command));
+    }
+
+    for (const auto& server_command : encoded.at("serverCommands")) {
+        cluster.server_commands.emplace(server_command.at(0).get<std::string>(),
+                                        DecodeCommand(server_command.at(1)));
+    }
+
+    for (const auto& event : encoded.at("events")) {
+        cluster.events.push_back(DecodeEvent(event));
+    }
+
+    for (const auto& current_enum : encoded.at("enums").items()) {
+        std::list<matter::Item>& items = cluster.enums[current_enum.key()];
+        for (const auto& encoded_item : current_enum.value()) {
+            int value;
+            items.push_back(DecodeEnumerated<matter::Item>(encoded_item, "value", value));
+            items.back().value = value;
+        }
+    }
+
+    for (const auto& bitmap : encoded.at("bitmaps").items()) {
+        std::list<matter::Bitfield>& bitfields = cluster.bitmaps[bitmap.key()];
+        for (const auto& encoded_bitfield : bitmap.value()) {
+            int bit;
+            bitfields.push_back(DecodeEnumerated<matter::Bitfield>(encoded_bitfield, "bit", bit));
+            bitfields.back().bit = bit;
+        }
+    }
+
+    for (const auto& current_struct : encoded.at("structs").items()) {
+        cluster.structs[current_struct.key()] = DecodeStruct(current_struct.value());
+    }
+    return cluster;
+}
+
+json EncodeDevice(const matter::Device& device) {
+    json encoded = json::object();
+    EncodeCommonQuality(device, encoded);
+    encoded["revision"] = device.revision;
+    encoded["revisionHistory"] = EncodeRevisionHistory(device.revision_history);
+    if (device.classification.has_value()) {
+        const matter::DeviceClassification& classification = device.classification.value();
+        json& encoded_classification = encoded["classification"] = json::object();
+        SetString(encoded_classification, "superset", classification.superset);
+        SetString(encoded_classification, "class", classification.class_);
+        SetString(encoded_classification, "scope", classification.scope);
+    }
+    encoded["conditions"] = device.conditions;
+    json& clusters = encoded["clusters"] = json::array();
+    for (const auto& cluster : device.clusters) {
+        clusters.push_back(EncodeCluster(cluster));
+    }
+    return encoded;
+}
+
+matter::Device DecodeDevice(const json& encoded) {
+    matter::Device device;
+    DecodeCommonQuality(encoded, device);
+    encoded.at("revision").get_to(device.revision);
+    device.revision_history = DecodeRevisionHistory(encoded.at("revisionHistory"));
+    if (encoded.contains("classification")) {
+        const json& encoded_classification = encoded.at("classification");
+        matter::DeviceClassification& classification = device.classification.emplace();
+        GetString(encoded_classification, "superset", classification.superset);
+        GetString(encoded_classification, "class", classification.class_);
+        GetString(encoded_classification, "scope", classification.scope);
+    }
+    encoded.at("conditions").get_to(device.conditions);
+    for (const auto& cluster : encoded.at("clusters")) {
+        device.clusters.push_back(DecodeCluster(cluster));
+    }
+    return device;
+}
+
+} // namespace
+
+bool IsEncoded(const char* data, std::size_t size) {
+    return size >= sizeof(kMagic) and std::equal(std::begin(kMagic), std::end(kMagic),
+                                                 reinterpret_cast<const unsigned char*>(data));
+}
+
+int WriteSdfModel(const sdf::SdfModel& sdf_model, int fd) {
+    return WriteEncoded(sdf::SerializeSdfModel(sdf_model), fd);
+}
+
+int WriteSdfMapping(const sdf::SdfMapping& sdf_mapping, int fd) {
+    return WriteEncoded(sdf::SerializeSdfMapping(sdf_mapping), fd);
+}
+
+int WriteDevice(const matter::Device& device, int fd) {
+    return WriteEncoded(EncodeDevice(device), fd);
+}
+
+int WriteCluster(const matter::Cluster& cluster, int fd) {
+    return WriteEncoded(EncodeCluster(cluster), fd);
+}
+
+void AppendCluster(const matter::Cluster& cluster, std::vector<std::uint8_t>& output) {
+    AppendEncoded(EncodeCluster(cluster), output);
+}
+
+sdf::SdfModel ReadSdfModel(const char* data, std::size_t size) {
+    auto sdf_model_json = ReadEncoded<nlohmann::ordered_json>(data, size);
+    return sdf::ParseSdfModel(sdf_model_json);
+}
+
+sdf::SdfMapping ReadSdfMapping(const char* data, std::size_t size) {
+    auto sdf_mapping_json = ReadEncoded<nlohmann::ordered_json>(data, size);
+    return sdf::ParseSdfMapping(sdf_mapping_json);
+}
+
+matter::Device ReadDevice(const char* data, std::size_t size) {
+    return DecodeDevice(ReadEncoded<json>(data, size));
+}
+
+matter::Cluster ReadCluster(const char* data, std::size_t size) {
+    return DecodeCluster(ReadEncoded<json>(data, size));
+}
+
+} // namespace cbor
@@ -14,11 +14,13 @@
  *  limitations under the License.
  */
 
+#include <sstream>
 #include <nlohmann/json.hpp>
 #include <pugixml.hpp>
 #include "matter.h"
 #include "sdf.h"
 #include "converter.h"
+#include "profiler.h"
 
 using json = nlohmann::ordered_json;
 
@@ -28,16 +30,32 @@ int ConvertSdfToMatter(json& sdf_model_json, json& sdf_mapping_json,
                        std::list<pugi::xml_document>& cluster_xml_list)
 {
     // Parse the sdf-model and the sdf-mapping
-    sdf::SdfModel sdf_model = sdf::ParseSdfModel(sdf_model_json);
-    sdf::SdfMapping sdf_mapping = sdf::ParseSdfMapping(sdf_mapping_json);
+    sdf::SdfModel sdf_model;
+    sdf::SdfMapping sdf_mapping;
+    {
+        profiler::ScopedTimer timer("ParseSdfModel");
+        sdf_model = sdf::ParseSdfModel(sdf_model_json);
+    }
+    {
+        profiler::ScopedTimer timer("ParseSdfMapping");
+        sdf_mapping = sdf::ParseSdfMapping(sdf_mapping_json);
+    }
 
+    return ConvertSdfToMatter(sdf_model, sdf_mapping, optional_device_xml, cluster_xml_list);
+}
+
+//! Function used to convert sdf to the matter data model
+int ConvertSdfToMatter(const sdf::SdfModel& sdf_model, const sdf::SdfMapping& sdf_mapping,
+                       std::optional<pugi::xml_document>& optional_device_xml,
+                       std::list<pugi::xml_document>& cluster_xml_list)
+{
     std::optional<matter::Device> device;
     std::list<matter::Cluster> clusters;
-    // Map sdf to the Matter data model
-    MapSdfToMatter(sdf_model, sdf_mapping, device, clusters);
+    ConvertSdfToMatter(sdf_model, sdf_mapping, device, clusters);
     // If the device type definition has a value, we can serialize it
     if (device.has_value()) {
         pugi::xml_document device_xml;
+        profiler::ScopedTimer timer("SerializeDevice");
         SerializeDevice(device.value(), device_xml);
         optional_device_xml = std::move(device_xml);
     } else {
@@ -47,6 +65,7 @@ int ConvertSdfToMatter(json& sdf_model_json, json& sdf_mapping_json,
     // Serialize all clusters from the cluster list
     for (const auto& cluster : clusters) {
         pugi::xml_document cluster_xml;
+        profiler::ScopedTimer timer("SerializeCluster", cluster.name);
         SerializeCluster(cluster, cluster_xml);
         cluster_xml_list.push_back(std::move(cluster_xml));
     }
@@ -54,33 +73,176 @@ int ConvertSdfToMatter(json& sdf_model_json, json& sdf_mapping_json,
     return 0;
 }
 
+//! Function used to map sdf onto the Matter data model without serializing the result
+int ConvertSdfToMatter(const sdf::SdfModel& sdf_model, const sdf::SdfMapping& sdf_mapping,
+                       std::optional<matter::Device>& device, std::list<matter::Cluster>& clusters)
+{
+    profiler::ScopedTimer timer("MapSdfToMatter");
+    return MapSdfToMatter(sdf_model, sdf_mapping, device, clusters);
+}
+
 //! Function used to convert the Matter data model to sdf
 int ConvertMatterToSdf(const std::optional<pugi::xml_document>& device_xml,
                        const std::list<pugi::xml_document>& cluster_xml_list,
-                       json& sdf_model_json, json& sdf_mapping_json)
+                       sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping)
+{
+    ClusterDependencies dependencies;
+    return ConvertMatterToSdf(device_xml, cluster_xml_list, sdf_model, sdf_mapping, dependencies);
+}
+
+//! Function used to convert the Matter data model to sdf and record the clusters the device type depends on
+int ConvertMatterToSdf(const std::optional<pugi::xml_document>& device_xml,
+                       const std::list<pugi::xml_document>& cluster_xml_list,
+                       sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping, ClusterDependencies& dependencies)
 {
     std::list<matter::Cluster> cluster_list;
     // Parse the list of given cluster definitions
     for (auto const& cluster_xml : cluster_xml_list) {
-        matter::Cluster cluster =  matter::ParseCluster(cluster_xml.document_element());
-        cluster_list.push_back(cluster);
+        profiler::ScopedTimer timer("ParseCluster", cluster_xml.document_element().attribute("name").value());
+        cluster_list.push_back(matter::ParseCluster(cluster_xml.document_element()));
     }
 
-    sdf::SdfModel sdf_model;
-    sdf::SdfMapping sdf_mapping;
-
+    std::optional<matter::Device> device;
     if (device_xml.has_value()) {
+        profiler::ScopedTimer timer("ParseDevice");
+        device = matter::ParseDevice(device_xml.value().document_element());
+    }
+
+    return ConvertMatterToSdf(device, cluster_list, sdf_model, sdf_mapping, dependencies);
+}
+
+//! Function used to convert the parsed Matter data model to sdf and record the clusters the device type depends on
+int ConvertMatterToSdf(const std::optional<matter::Device>& device, const std::list<matter::Cluster>& clusters,
+                       sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping, ClusterDependencies& dependencies)
+{
+    dependencies = ClusterDependencies();
+    profiler::ScopedTimer timer("MapMatterToSdf");
+    if (device.has_value()) {
         // If a device type definition was provided, convert it with the cluster definitions to sdf
-        matter::Device device = matter::ParseDevice(device_xml.value().document_element());
-        MapMatterToSdf(device, cluster_list, sdf_model, sdf_mapping);
+        MapMatterToSdf(device, clusters, sdf_model, sdf_mapping, &dependencies);
     } else {
         // Otherwise we just convert the list of clusters to sdf
-        MapMatterToSdf(std::nullopt, cluster_list, sdf_model, sdf_mapping);
+        MapMatterToSdf(std::nullopt, clusters, sdf_model, sdf_mapping);
+    }
+
+    return 0;
+}
+
+//! Function used to convert the Matter data model to sdf
+int ConvertMatterToSdf(const std::optional<pugi::xml_document>& device_xml,
+                       const std::list<pugi::xml_document>& cluster_xml_list,
+                       json& sdf_model_json, json& sdf_mapping_json)
+{
+    sdf::SdfModel sdf_model;
+    sdf::SdfMapping sdf_mapping;
+    int result = ConvertMatterToSdf(device_xml, cluster_xml_list, sdf_model, sdf_mapping);
+    if (result != 0) {
+        return result;
     }
 
     // Serialize the sdf-model as well as the sdf-mapping
-    sdf_model_json = sdf::SerializeSdfModel(sdf_model);
-    sdf_mapping_json = sdf::SerializeSdfMapping(sdf_mapping);
+    {
+        profiler::ScopedTimer timer("SerializeSdfModel");
+        sdf_model_json = sdf::SerializeSdfModel(sdf_model);
+    }
+    {
+        profiler::ScopedTimer timer("SerializeSdfMapping");
+        sdf_mapping_json = sdf::SerializeSdfMapping(sdf_mapping);
+    }
+
+    return 0;
+}
+
+Converter::Converter(std::list<matter::Cluster> clusters, ConverterOptions options)
+    : clusters(std::move(clusters)), options(std::move(options)) {
+    lookup = BuildClusterLookup(this->clusters);
+}
 
+Converter::Converter(const std::list<pugi::xml_document>& cluster_xml_list, ConverterOptions options)
+    : options(std::move(options)) {
+    for (const auto& cluster_xml : cluster_xml_list) {
+        profiler::ScopedTimer timer("ParseCluster", cluster_xml.document_element().attribute("name").value());
+        clusters.push_back(matter::ParseCluster(cluster_xml.document_element()));
+    }
+    lookup = BuildClusterLookup(clusters);
+}
+
+const std::vector<const matter::Cluster*>& Converter::FindClusters(uint32_t id) const {
+    static const std::vector<const matter::Cluster*> no_clusters;
+    auto it = lookup.clusters_by_id.find(id);
+    return it != lookup.clusters_by_id.end() ? it->second : no_clusters;
+}
+
+const matter::Cluster* Converter::FindCluster(const std::string& alias) const {
+    auto it = lookup.clusters_by_alias.find(alias);
+    return it != lookup.clusters_by_alias.end() ? it->second : nullptr;
+}
+
+namespace {
+
+//! Function used to validate a serialized file with the given validator
+int ValidateContent(const Validator& validator, const std::string& content, const char* name) {
+    profiler::ScopedTimer timer("Validate", name);
+    return validator(content.data(), content.size(), name) == 0 ? 0 : -1;
+}
+
+//! Function used to save a xml document into a string
+std::string SaveXml(const pugi::xml_document& xml_file) {
+    std::ostringstream stream;
+    xml_file.save(stream);
+    return stream.str();
+}
+
+} // namespace
+
+//! Function used to convert matter to sdf with the clusters of the session
+int Converter::ConvertMatterToSdf(const std::optional<matter::Device>& device, sdf::SdfModel& sdf_model,
+                                  sdf::SdfMapping& sdf_mapping, ClusterDependencies* dependencies) const {
+    if (dependencies != nullptr) {
+        *dependencies = ClusterDependencies();
+    }
+    {
+        profiler::ScopedTimer timer("MapMatterToSdf");
+        int result = MapMatterToSdf(device, clusters, sdf_model, sdf_mapping, dependencies, &lookup);
+        if (result != 0) {
+            return result;
+        }
+    }
+
+    if (options.sdf_validator) {
+        if (ValidateContent(options.sdf_validator, sdf::SerializeSdfModel(sdf_model).dump(4), "sdf-model.json") != 0 or
+            ValidateContent(options.sdf_validator, sdf::SerializeSdfMapping(sdf_mapping).dump(4),
+                            "sdf-mapping.json") != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+//! Function used to convert sdf to matter and validate the result with the validator of the session
+int Converter::ConvertSdfToMatter(const sdf::SdfModel& sdf_model, const sdf::SdfMapping& sdf_mapping,
+                                  std::optional<matter::Device>& device,
+                                  std::list<matter::Cluster>& cluster_list) const {
+    int result = ::ConvertSdfToMatter(sdf_model, sdf_mapping, device, cluster_list);
+    if (result != 0) {
+        return result;
+    }
+
+    if (options.matter_validator) {
+        int valid = 0;
+        if (device.has_value()) {
+            pugi::xml_document device_xml;
+            matter::SerializeDevice(device.value(), device_xml);
+            valid |= ValidateContent(options.matter_validator, SaveXml(device_xml), "device.xml");
+        }
+        for (const auto& cluster : cluster_list) {
+            pugi::xml_document cluster_xml;
+            matter::SerializeCluster(cluster, cluster_xml);
+            valid |= ValidateContent(options.matter_validator, SaveXml(cluster_xml), cluster.name.c_str());
+        }
+        if (valid != 0) {
+            return -1;
+        }
+    }
     return 0;
 }
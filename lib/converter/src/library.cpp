@@ -0,0 +1,263 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cstring>
+#include <limits>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "cbor.h"
+#include "library.h"
+#include "profiler.h"
+#include "writer.h"
+
+namespace library {
+
+namespace {
+
+const char kMagic[8] = {'S', 'D', 'F', 'M', 'L', 'I', 'B', '\0'};
+const uint32_t kVersion = 2;
+
+//! Pool of unique strings
+class StringPool {
+public:
+    //! Function used to add a string to the pool, equal strings are only stored once
+    String Add(const std::string& value) {
+        auto it = strings.find(value);
+        if (it != strings.end()) {
+            return it->second;
+        }
+        String string{static_cast<uint32_t>(data.size()), static_cast<uint32_t>(value.size())};
+        data.append(value);
+        strings.emplace(value, string);
+        return string;
+    }
+
+    const std::string& Data() const {
+        return data;
+    }
+
+private:
+    std::string data;
+    std::unordered_map<std::string, String> strings;
+};
+
+//! Function used to append the records of a table to the library and to reference them in the header
+template <typename Record>
+void AppendTable(const std::vector<Record>& records, std::vector<char>& library, Range& table) {
+    table.offset = library.size();
+    table.count = records.size();
+    const char* data = reinterpret_cast<const char*>(records.data());
+    library.insert(library.end(), data, data + records.size() * sizeof(Record));
+}
+
+//! Function used to check if a range of the given size lies within the given bounds
+bool InBounds(uint64_t offset, uint64_t size, uint64_t bound) {
+    return offset <= bound and size <= bound - offset;
+}
+
+//! Function used to check if a range of records lies within its table
+bool InTable(const Range& range, const Range& table) {
+    return InBounds(range.offset, range.count, table.count);
+}
+
+//! Function used to check if a table lies within the library
+template <typename Record>
+bool CheckTable(const Range& table, std::size_t size) {
+    return table.offset % alignof(Record) == 0 and
+           InBounds(table.offset, static_cast<uint64_t>(table.count) * sizeof(Record), size);
+}
+
+} // namespace
+
+bool IsLibrary(const char* data, std::size_t size) {
+    return size >= sizeof(Header) and std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+//! Function used to lay out the given clusters as a library and write it into the given file descriptor
+int WriteLibrary(const std::list<matter::Cluster>& clusters, int fd) {
+    profiler::ScopedTimer timer("WriteLibrary");
+    StringPool strings;
+    std::vector<ClusterRecord> cluster_records;
+    std::vector<AliasRecord> alias_records;
+    std::vector<std::uint8_t> encoded;
+
+    for (const auto& cluster : clusters) {
+        ClusterRecord& record = cluster_records.emplace_back();
+        record.id = cluster.id;
+        record.name = strings.Add(cluster.name);
+        record.side = strings.Add(cluster.side);
+        record.revision = cluster.revision;
+        // Only derived clusters get merged with their base cluster
+        bool derived = cluster.classification.has_value() and cluster.classification->hierarchy == "derived";
+        record.base_cluster = strings.Add(derived ? cluster.classification->base_cluster : "");
+
+        record.aliases = {static_cast<uint32_t>(alias_records.size()),
+                          static_cast<uint32_t>(cluster.cluster_aliases.size())};
+        for (const auto& cluster_alias : cluster.cluster_aliases) {
+            alias_records.push_back({cluster_alias.first, strings.Add(cluster_alias.second)});
+        }
+
+        // The offset gets relocated once the position of the encoded clusters is known
+        std::size_t offset = encoded.size();
+        cbor::AppendCluster(cluster, encoded);
+        record.encoded = {static_cast<uint32_t>(offset), static_cast<uint32_t>(encoded.size() - offset)};
+    }
+
+    // The tables follow the header, the encoded clusters and the string pool follow the tables
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    std::vector<char> library(sizeof(Header));
+    AppendTable(cluster_records, library, header.clusters);
+    AppendTable(alias_records, library, header.aliases);
+
+    uint64_t encoded_offset = library.size();
+    uint64_t strings_offset = encoded_offset + encoded.size();
+    uint64_t size = strings_offset + strings.Data().size();
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        return -1;
+    }
+    for (std::size_t i = 0; i < cluster_records.size(); i++) {
+        auto* record = reinterpret_cast<ClusterRecord*>(library.data() + header.clusters.offset) + i;
+        record->encoded.offset += encoded_offset;
+    }
+    header.strings = {static_cast<uint32_t>(strings_offset), static_cast<uint32_t>(strings.Data().size())};
+    header.size = size;
+    std::memcpy(library.data(), &header, sizeof(Header));
+
+    BufferedWriter output(fd);
+    output.Write(library.data(), library.size());
+    output.Write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+    output.Write(strings.Data());
+    return output.Flush();
+}
+
+std::string_view AliasView::Name() const {
+    return library.Resolve(record.name);
+}
+
+std::string_view ClusterView::Name() const {
+    return library.Resolve(record.name);
+}
+
+std::string_view ClusterView::Side() const {
+    return library.Resolve(record.side);
+}
+
+std::string_view ClusterView::BaseCluster() const {
+    return library.Resolve(record.base_cluster);
+}
+
+RecordRange<AliasView, AliasRecord> ClusterView::Aliases() const {
+    return {library, library.Resolve<AliasRecord>(library.GetHeader().aliases, record.aliases),
+            record.aliases.count};
+}
+
+std::string_view ClusterView::Encoded() const {
+    return library.Data().substr(record.encoded.offset, record.encoded.size);
+}
+
+matter::Cluster ClusterView::Load() const {
+    profiler::ScopedTimer timer("LoadCluster", std::string(Name()));
+    std::string_view encoded = Encoded();
+    return cbor::ReadCluster(encoded.data(), encoded.size());
+}
+
+int LibraryView::Open(const char* path) {
+    header = nullptr;
+    if (mapped_file.Map(path) != 0 or !IsLibrary(mapped_file.Data(), mapped_file.Size())) {
+        return -1;
+    }
+    header = reinterpret_cast<const Header*>(mapped_file.Data());
+    if (!Check()) {
+        header = nullptr;
+        mapped_file.Unmap();
+        return -1;
+    }
+    return 0;
+}
+
+//! Function used to check that every offset of the library is inside of its bounds
+bool LibraryView::Check() const {
+    std::size_t size = mapped_file.Size();
+    if (header->version != kVersion or header->size != size or
+        !CheckTable<ClusterRecord>(header->clusters, size) or !CheckTable<AliasRecord>(header->aliases, size) or
+        !InBounds(header->strings.offset, header->strings.size, size)) {
+        return false;
+    }
+    auto in_pool = [this](const String& string) {
+        return InBounds(string.offset, string.size, header->strings.size);
+    };
+
+    const auto* clusters = Resolve<ClusterRecord>(header->clusters, {0, 0});
+    for (std::size_t i = 0; i < header->clusters.count; i++) {
+        const ClusterRecord& record = clusters[i];
+        if (!in_pool(record.name) or !in_pool(record.side) or !in_pool(record.base_cluster) or
+            !InTable(record.aliases, header->aliases) or
+            !InBounds(record.encoded.offset, record.encoded.size, size)) {
+            return false;
+        }
+    }
+    const auto* aliases = Resolve<AliasRecord>(header->aliases, {0, 0});
+    for (std::size_t i = 0; i < header->aliases.count; i++) {
+        if (!in_pool(aliases[i].name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RecordRange<ClusterView, ClusterRecord> LibraryView::Clusters() const {
+    return {*this, Resolve<ClusterRecord>(header->clusters, {0, 0}), header->clusters.count};
+}
+
+//! Function used to load the clusters a device type depends on
+std::list<matter::Cluster> LibraryView::LoadClusters(const matter::Device& device) const {
+    std::set<uint32_t> cluster_ids;
+    for (const auto& device_cluster : device.clusters) {
+        cluster_ids.insert(device_cluster.id);
+    }
+    std::set<std::string_view> base_clusters;
+    for (const auto& cluster : Clusters()) {
+        if (cluster_ids.count(cluster.Id()) > 0 and !cluster.BaseCluster().empty()) {
+            base_clusters.insert(cluster.BaseCluster());
+        }
+    }
+
+    std::list<matter::Cluster> clusters;
+    for (const auto& cluster : Clusters()) {
+        bool dependency = cluster_ids.count(cluster.Id()) > 0;
+        for (const auto& alias : cluster.Aliases()) {
+            dependency = dependency or base_clusters.count(alias.Name()) > 0;
+        }
+        if (dependency) {
+            clusters.push_back(cluster.Load());
+        }
+    }
+    return clusters;
+}
+
+std::list<matter::Cluster> LibraryView::LoadClusters() const {
+    std::list<matter::Cluster> clusters;
+    for (const auto& cluster : Clusters()) {
+        clusters.push_back(cluster.Load());
+    }
+    return clusters;
+}
+
+} // namespace library
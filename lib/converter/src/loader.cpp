@@ -0,0 +1,452 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "loader.h"
+#include "profiler.h"
+
+// io_uring is only used on Linux, it can be disabled for the build with SDF_MATTER_CONVERTER_NO_IO_URING
+#if defined(__linux__) && defined(__has_include) && !defined(SDF_MATTER_CONVERTER_NO_IO_URING)
+#if __has_include(<linux/io_uring.h>)
+#define SDF_MATTER_CONVERTER_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace loader {
+
+namespace {
+
+//! Size of the chunks used to read files of unknown size
+const std::size_t kChunkSize = 64 * 1024;
+
+//! Function used to load a file with blocking system calls
+void ReadFile(LoadedFile& file) {
+    int fd = open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        file.error = errno;
+        return;
+    }
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) != 0) {
+        file.error = errno;
+        close(fd);
+        return;
+    }
+
+    // The size of regular files is known, everything else gets read in chunks until its end
+    std::size_t capacity = S_ISREG(file_stat.st_mode) ? file_stat.st_size : kChunkSize;
+    file.data.reset(new char[capacity]);
+    file.size = 0;
+    while (true) {
+        if (file.size == capacity) {
+            if (S_ISREG(file_stat.st_mode)) {
+                break;
+            }
+            std::unique_ptr<char[]> data(new char[capacity * 2]);
+            std::memcpy(data.get(), file.data.get(), file.size);
+            file.data = std::move(data);
+            capacity *= 2;
+        }
+        ssize_t result = read(fd, file.data.get() + file.size, capacity - file.size);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            file.error = errno;
+            break;
+        }
+        if (result == 0) {
+            break;
+        }
+        file.size += result;
+    }
+    close(fd);
+}
+
+//! Function used to load the files with a pool of threads
+//! The system calls mostly wait for the storage, so there are more threads than processors.
+void LoadWithThreads(std::vector<LoadedFile>& files) {
+    std::size_t thread_count = std::clamp<std::size_t>(2 * std::thread::hardware_concurrency(), 2, files.size());
+    std::atomic<std::size_t> next_file = 0;
+    auto worker = [&]() {
+        for (std::size_t i = next_file++; i < files.size(); i = next_file++) {
+            ReadFile(files[i]);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < thread_count; i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+#ifdef SDF_MATTER_CONVERTER_IO_URING
+
+//! Number of entries of the submission queue
+const unsigned kRingEntries = 256;
+
+//! Maximum number of files of a window, which are open at the same time
+const std::size_t kMaxOpenFiles = 1024;
+
+//! io_uring instance used with the raw system calls
+//! Only offers what the loader needs, submitting a list of operations and waiting for all of their results.
+class Ring {
+public:
+    Ring() = default;
+
+    //! Destructor, removes the mappings and closes the ring
+    ~Ring() {
+        if (sqes != nullptr) {
+            munmap(sqes, sqes_size);
+        }
+        if (cq_ring != nullptr and cq_ring != sq_ring) {
+            munmap(cq_ring, cq_ring_size);
+        }
+        if (sq_ring != nullptr) {
+            munmap(sq_ring, sq_ring_size);
+        }
+        if (ring_fd >= 0) {
+            close(ring_fd);
+        }
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    //! Function used to create the ring and map its queues
+    //! Returns 0 on success and negative if io_uring is not available.
+    int Setup(unsigned entries) {
+        io_uring_params params{};
+        ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd < 0) {
+            return -1;
+        }
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        }
+        sq_ring = Map(sq_ring_size, IORING_OFF_SQ_RING);
+        cq_ring = single_mmap ? sq_ring : Map(cq_ring_size, IORING_OFF_CQ_RING);
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(Map(sqes_size, IORING_OFF_SQES));
+        if (sq_ring == nullptr or cq_ring == nullptr or sqes == nullptr) {
+            return -1;
+        }
+
+        auto* sq = static_cast<char*>(sq_ring);
+        sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_entries = params.sq_entries;
+        auto* cq = static_cast<char*>(cq_ring);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        cq_entries = params.cq_entries;
+        return 0;
+    }
+
+    //! Function used to submit the operations and wait for all of their results
+    //! The user data of every operation has to be its index, its result gets stored at the same index. Returns 0 on
+    //! success and negative if the operations could not be submitted, operations without result are canceled.
+    int Run(const std::vector<io_uring_sqe>& operations, std::vector<int>& results) {
+        results.assign(operations.size(), -ECANCELED);
+        std::size_t submitted = 0;
+        std::size_t completed = 0;
+        while (completed < operations.size()) {
+            // Fill the submission queue, without having more operations in flight than the completion queue holds
+            unsigned tail = *sq_tail;
+            unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+            while (submitted < operations.size() and tail - head < sq_entries and
+                   submitted - completed < cq_entries) {
+                unsigned index = tail & sq_mask;
+                sqes[index] = operations[submitted];
+                sq_array[index] = index;
+                tail++;
+                submitted++;
+            }
+            __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+            // Interrupted or temporarily failed submissions get repeated, the unsubmitted operations stay queued
+            long entered = syscall(__NR_io_uring_enter, ring_fd, tail - head, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (entered < 0 and errno != EINTR and errno != EAGAIN and errno != EBUSY) {
+                return -1;
+            }
+
+            unsigned completion = *cq_head;
+            while (completion != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe& cqe = cqes[completion & cq_mask];
+                results[cqe.user_data] = cqe.res;
+                completion++;
+                completed++;
+            }
+            __atomic_store_n(cq_head, completion, __ATOMIC_RELEASE);
+        }
+        return 0;
+    }
+
+private:
+    //! Function used to map a part of the ring, returns null on failure
+    void* Map(std::size_t size, off_t offset) const {
+        void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+        return mapping == MAP_FAILED ? nullptr : mapping;
+    }
+
+    int ring_fd = -1;
+    void* sq_ring = nullptr;
+    std::size_t sq_ring_size = 0;
+    void* cq_ring = nullptr;
+    std::size_t cq_ring_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    std::size_t sqes_size = 0;
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cq_mask = 0;
+    unsigned cq_entries = 0;
+};
+
+//! Function used to prepare an operation
+io_uring_sqe PrepareOperation(uint8_t opcode, int fd, const void* address, uint32_t length, uint64_t offset,
+                              std::size_t index) {
+    io_uring_sqe sqe{};
+    sqe.opcode = opcode;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(address);
+    sqe.len = length;
+    sqe.off = offset;
+    sqe.user_data = index;
+    return sqe;
+}
+
+//! Function used to get the number of files that may be open at the same time
+//! The limit of open descriptors is shared with the rest of the process, so a window only uses half of it.
+std::size_t OpenFileWindow() {
+    std::size_t window = kMaxOpenFiles;
+    struct rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 and limit.rlim_cur != RLIM_INFINITY) {
+        window = std::min<std::size_t>(window, limit.rlim_cur / 2);
+    }
+    return std::max<std::size_t>(window, 1);
+}
+
+//! Function used to load a window of files with io_uring
+//! The files get opened and their size gets queried in the first batch, read in the second one and closed in the
+//! last one. Files that could not be opened because the process or the system ran out of descriptors get loaded with
+//! blocking system calls once the others are closed. Returns 0 on success and negative if the ring could not be used.
+int LoadWindowWithIoUring(Ring& ring, LoadedFile* files, std::size_t count) {
+    // Open every file and query its type and size
+    std::vector<io_uring_sqe> operations;
+    std::vector<struct statx> file_stats(count);
+    for (std::size_t i = 0; i < count; i++) {
+        io_uring_sqe open_sqe = PrepareOperation(IORING_OP_OPENAT, AT_FDCWD, files[i].path.c_str(), 0, 0,
+                                                 operations.size());
+        open_sqe.open_flags = O_RDONLY | O_CLOEXEC;
+        operations.push_back(open_sqe);
+        operations.push_back(PrepareOperation(IORING_OP_STATX, AT_FDCWD, files[i].path.c_str(),
+                                              STATX_TYPE | STATX_SIZE,
+                                              reinterpret_cast<uint64_t>(&file_stats[i]), operations.size()));
+    }
+    std::vector<int> results;
+    if (ring.Run(operations, results) != 0) {
+        for (std::size_t i = 0; i < count; i++) {
+            if (results[2 * i] >= 0) {
+                close(results[2 * i]);
+            }
+        }
+        return -1;
+    }
+
+    // Files that are not regular or whose operations are not supported by the kernel get loaded with blocking
+    // system calls, all other files get read in one piece
+    std::vector<int> fds(count, -1);
+    std::vector<std::size_t> pending;
+    std::vector<std::size_t> fallback;
+    for (std::size_t i = 0; i < count; i++) {
+        int open_result = results[2 * i];
+        int stat_result = results[2 * i + 1];
+        if (open_result >= 0) {
+            fds[i] = open_result;
+        }
+        if (open_result == -EINVAL or stat_result == -EINVAL or open_result == -EMFILE or open_result == -ENFILE or
+            (open_result >= 0 and stat_result == 0 and !S_ISREG(file_stats[i].stx_mode))) {
+            fallback.push_back(i);
+        } else if (open_result < 0 or stat_result < 0) {
+            files[i].error = open_result < 0 ? -open_result : -stat_result;
+        } else {
+            files[i].data.reset(new char[file_stats[i].stx_size]);
+            files[i].size = 0;
+            if (file_stats[i].stx_size > 0) {
+                pending.push_back(i);
+            }
+        }
+    }
+
+    // Short reads continue where they stopped, until every file is complete or at its end
+    std::vector<std::size_t> sizes(count);
+    for (std::size_t i : pending) {
+        sizes[i] = file_stats[i].stx_size;
+    }
+    while (!pending.empty()) {
+        operations.clear();
+        for (std::size_t i : pending) {
+            std::size_t length = std::min<std::size_t>(sizes[i] - files[i].size, 1u << 30);
+            operations.push_back(PrepareOperation(IORING_OP_READ, fds[i], files[i].data.get() + files[i].size,
+                                                  length, files[i].size, operations.size()));
+        }
+        if (ring.Run(operations, results) != 0) {
+            for (int fd : fds) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+            }
+            return -1;
+        }
+        std::vector<std::size_t> remaining;
+        for (std::size_t j = 0; j < pending.size(); j++) {
+            std::size_t i = pending[j];
+            if (results[j] == -EINVAL) {
+                fallback.push_back(i);
+            } else if (results[j] == -EINTR or results[j] == -EAGAIN) {
+                remaining.push_back(i);
+            } else if (results[j] < 0) {
+                files[i].error = -results[j];
+            } else if (results[j] > 0) {
+                files[i].size += results[j];
+                if (files[i].size < sizes[i]) {
+                    remaining.push_back(i);
+                }
+            }
+        }
+        pending = std::move(remaining);
+    }
+
+    // The descriptors get closed with blocking calls if the kernel does not support closing them with io_uring
+    operations.clear();
+    std::vector<int> open_fds;
+    for (int fd : fds) {
+        if (fd >= 0) {
+            operations.push_back(PrepareOperation(IORING_OP_CLOSE, fd, nullptr, 0, 0, operations.size()));
+            open_fds.push_back(fd);
+        }
+    }
+    if (ring.Run(operations, results) != 0) {
+        results.assign(open_fds.size(), -EINVAL);
+    }
+    for (std::size_t j = 0; j < open_fds.size(); j++) {
+        if (results[j] == -EINVAL) {
+            close(open_fds[j]);
+        }
+    }
+
+    for (std::size_t i : fallback) {
+        files[i].error = 0;
+        ReadFile(files[i]);
+    }
+    return 0;
+}
+
+//! Function used to load the files with io_uring
+//! The files get loaded in windows, so the number of open descriptors stays below the limit of the process however
+//! many files there are. Returns 0 on success and negative if the ring could not be used.
+int LoadWithIoUring(std::vector<LoadedFile>& files) {
+    Ring ring;
+    if (ring.Setup(kRingEntries) != 0) {
+        return -1;
+    }
+    std::size_t window = OpenFileWindow();
+    for (std::size_t first = 0; first < files.size(); first += window) {
+        if (LoadWindowWithIoUring(ring, files.data() + first, std::min(window, files.size() - first)) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+#endif // SDF_MATTER_CONVERTER_IO_URING
+
+} // namespace
+
+//! Function used to check if io_uring can be used
+bool IoUringSupported() {
+#ifdef SDF_MATTER_CONVERTER_IO_URING
+    static const bool supported = []() {
+        Ring ring;
+        return ring.Setup(1) == 0;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+//! Function used to load files in one batch
+std::vector<LoadedFile> LoadFiles(const std::vector<std::string>& paths, Backend backend) {
+    std::vector<LoadedFile> files(paths.size());
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        files[i].path = paths[i];
+    }
+    if (files.empty()) {
+        return files;
+    }
+
+#ifdef SDF_MATTER_CONVERTER_IO_URING
+    if (backend != Backend::kThreads and IoUringSupported()) {
+        profiler::ScopedTimer timer("LoadFiles", "io_uring");
+        if (LoadWithIoUring(files) == 0) {
+            profiler::Count("LoadedFiles", files.size());
+            return files;
+        }
+        // If the ring failed, every file gets loaded again
+        for (auto& file : files) {
+            file.data.reset();
+            file.size = 0;
+            file.error = 0;
+        }
+    }
+#endif
+
+    profiler::ScopedTimer timer("LoadFiles", "threads");
+    LoadWithThreads(files);
+    profiler::Count("LoadedFiles", files.size());
+    return files;
+}
+
+} // namespace loader
@@ -0,0 +1,78 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mapped_file.h"
+
+MappedFile::~MappedFile() {
+    Unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Unmap();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+//! Function used to map the file at the given path into memory
+int MappedFile::Map(const char* path) {
+    Unmap();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat file_stat{};
+    if (fstat(fd, &file_stat) != 0 or !S_ISREG(file_stat.st_mode)) {
+        close(fd);
+        return -1;
+    }
+    // Empty files cannot be mapped
+    if (file_stat.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    void* mapping = mmap(nullptr, file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after closing the file descriptor
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return -1;
+    }
+    // The input gets read from front to back
+    madvise(mapping, file_stat.st_size, MADV_SEQUENTIAL);
+    data = static_cast<char*>(mapping);
+    size = file_stat.st_size;
+    return 0;
+}
+
+//! Function used to remove the mapping
+void MappedFile::Unmap() {
+    if (data != nullptr) {
+        munmap(data, size);
+    }
+    data = nullptr;
+    size = 0;
+}
@@ -18,6 +18,7 @@
 #include <pugixml.hpp>
 #include <nlohmann/json.hpp>
 #include "matter.h"
+#include "writer.h"
 
 namespace matter {
 
@@ -670,648 +671,739 @@ Device ParseDevice(const pugi::xml_node& device_xml) {
     return device;
 }
 
-//! Function used to serialize a other quality object into a xml node and append it to the parent node.
-void SerializeOtherQuality(const OtherQuality& other_quality, pugi::xml_node& parent_node) {
-    pugi::xml_node quality_node = parent_node.append_child("quality");
+//! Function used to write a other quality object as a xml element.
+//! The following write functions stream the elements into a XmlWriter or build them with a XmlBuilder. As the start
+//! tag has to be complete before the first child, every element writes all of its attributes first.
+template <typename Writer>
+void WriteOtherQuality(const OtherQuality& other_quality, Writer& writer) {
+    writer.StartElement("quality");
 
     if (other_quality.nullable.has_value()) {
-        quality_node.append_attribute("nullable").set_value(other_quality.nullable.value());
+        writer.Attribute("nullable", other_quality.nullable.value());
     }
 
     if (other_quality.non_volatile.has_value()) {
         if (other_quality.non_volatile.value()) {
-            quality_node.append_attribute("persistence").set_value("nonVolatile");
+            writer.Attribute("persistence", "nonVolatile");
         } else {
-            quality_node.append_attribute("persistence").set_value("volatile");
+            writer.Attribute("persistence", "volatile");
         }
     } else if (other_quality.fixed.has_value()) {
-        quality_node.append_attribute("persistence").set_value("fixed");
+        writer.Attribute("persistence", "fixed");
     }
 
     if (other_quality.scene.has_value()) {
-        quality_node.append_attribute("scene").set_value(other_quality.scene.value());
+        writer.Attribute("scene", other_quality.scene.value());
     }
 
     if (other_quality.reportable.has_value()) {
-        quality_node.append_attribute("reportable").set_value(other_quality.reportable.value());
+        writer.Attribute("reportable", other_quality.reportable.value());
     }
 
     if (other_quality.change_omitted.has_value()) {
-        quality_node.append_attribute("changeOmitted").set_value(other_quality.change_omitted.value());
+        writer.Attribute("changeOmitted", other_quality.change_omitted.value());
     }
 
     if (other_quality.singleton.has_value()) {
-        quality_node.append_attribute("singleton").set_value(other_quality.singleton.value());
+        writer.Attribute("singleton", other_quality.singleton.value());
     }
 
     if (other_quality.diagnostics.has_value()) {
-        quality_node.append_attribute("diagnostics").set_value(other_quality.diagnostics.value());
+        writer.Attribute("diagnostics", other_quality.diagnostics.value());
     }
 
     if (other_quality.large_message.has_value()) {
-        quality_node.append_attribute("largeMessage").set_value(other_quality.large_message.value());
+        writer.Attribute("largeMessage", other_quality.large_message.value());
     }
 
     if (other_quality.quieter_reporting.has_value()) {
-        quality_node.append_attribute("quieterReporting").set_value(other_quality.quieter_reporting.value());
+        writer.Attribute("quieterReporting", other_quality.quieter_reporting.value());
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize the given default value into its actual contained datatype.
-void SerializeDefaultType(const DefaultType& value, const char* attribute_name, pugi::xml_node& target_node) {
+//! Function used to write the given default value as a attribute of its actual contained datatype.
+template <typename Writer>
+void WriteDefaultType(const DefaultType& value, const char* attribute_name, Writer& writer) {
     if (std::holds_alternative<double>(value)) {
-        target_node.append_attribute(attribute_name).set_value(std::get<double>(value));
+        writer.Attribute(attribute_name, std::get<double>(value));
     } else if (std::holds_alternative<int64_t>(value)) {
-        target_node.append_attribute(attribute_name).set_value(std::get<int64_t>(value));
+        writer.Attribute(attribute_name, std::get<int64_t>(value));
     } else if (std::holds_alternative<uint64_t>(value)) {
-        target_node.append_attribute(attribute_name).set_value(std::get<uint64_t>(value));
+        writer.Attribute(attribute_name, std::get<uint64_t>(value));
     } else if (std::holds_alternative<std::string>(value)) {
-        target_node.append_attribute(attribute_name).set_value(std::get<std::string>(value).c_str());
+        writer.Attribute(attribute_name, std::get<std::string>(value));
     } else if (std::holds_alternative<bool>(value)) {
-        target_node.append_attribute(attribute_name).set_value(std::get<bool>(value));
+        writer.Attribute(attribute_name, std::get<bool>(value));
     } else if (std::holds_alternative<std::optional<std::monostate>>(value)) {
-        target_node.append_attribute(attribute_name).set_value("null");
+        writer.Attribute(attribute_name, "null");
     }
 }
 
-//! Function used to serialize the given numeric value into its actual contained datatype.
-void SerializeNumericType(const NumericType& value, const char* attribute_name, pugi::xml_node& target_node) {
+//! Function used to write the given numeric value as a attribute of its actual contained datatype.
+template <typename Writer>
+void WriteNumericType(const NumericType& value, const char* attribute_name, Writer& writer) {
     if (std::holds_alternative<double>(value)) {
-        target_node.append_attribute(attribute_name).set_value(std::get<double>(value));
+        writer.Attribute(attribute_name, std::get<double>(value));
     } else if (std::holds_alternative<int64_t>(value)) {
-        target_node.append_attribute(attribute_name).set_value(std::get<int64_t>(value));
+        writer.Attribute(attribute_name, std::get<int64_t>(value));
     } else if (std::holds_alternative<uint64_t>(value)) {
-        target_node.append_attribute(attribute_name).set_value(std::get<uint64_t>(value));
+        writer.Attribute(attribute_name, std::get<uint64_t>(value));
     }
 }
 
-//! Function used to serialize a constraint object into a xml node and append it to the given parent node.
-void SerializeConstraint(const Constraint& constraint, pugi::xml_node& parent_node) {
+//! Function used to write a constraint object as xml elements.
+template <typename Writer>
+void WriteConstraint(const Constraint& constraint, Writer& writer) {
     // If the constraint is an entry constraint
     if (!constraint.entry_type.empty()) {
-        auto constraint_node = parent_node.append_child("entry");
-        constraint_node.append_attribute("type").set_value(constraint.entry_type.c_str());
+        writer.StartElement("entry");
+        writer.Attribute("type", constraint.entry_type);
         if (constraint.entry_constraint != nullptr) {
-            SerializeConstraint(*constraint.entry_constraint, constraint_node);
+            WriteConstraint(*constraint.entry_constraint, writer);
         }
+        writer.EndElement();
     }
     if (!constraint.type.empty()) {
-        auto constraint_node = parent_node.append_child("constraint");
+        writer.StartElement("constraint");
         // Constraint is defined in the description section
         if (constraint.type == "desc") {
-            constraint_node.append_attribute("type").set_value("desc");
+            writer.Attribute("type", "desc");
         }
 
         // Numeric constraints
         else if (constraint.type == "allowed") {
-            constraint_node.append_attribute("type").set_value("allowed");
-            SerializeDefaultType(constraint.value.value(), "value", constraint_node);
+            writer.Attribute("type", "allowed");
+            WriteDefaultType(constraint.value.value(), "value", writer);
         } else if (constraint.type == "between") {
-            constraint_node.append_attribute("type").set_value("between");
-            SerializeNumericType(constraint.min.value(), "from", constraint_node);
-            SerializeNumericType(constraint.max.value(), "to", constraint_node);
+            writer.Attribute("type", "between");
+            WriteNumericType(constraint.min.value(), "from", writer);
+            WriteNumericType(constraint.max.value(), "to", writer);
         } else if (constraint.type == "min") {
-            constraint_node.append_attribute("type").set_value("min");
-            SerializeNumericType(constraint.min.value(), "value", constraint_node);
+            writer.Attribute("type", "min");
+            WriteNumericType(constraint.min.value(), "value", writer);
         } else if (constraint.type == "max") {
-            constraint_node.append_attribute("type").set_value("max");
-            SerializeNumericType(constraint.max.value(), "value", constraint_node);
+            writer.Attribute("type", "max");
+            WriteNumericType(constraint.max.value(), "value", writer);
         }
 
         // Octet string constraints
         else if (constraint.type == "lengthBetween") {
-            constraint_node.append_attribute("type").set_value("lengthBetween");
-            SerializeNumericType(constraint.min.value(), "from", constraint_node);
-            SerializeNumericType(constraint.max.value(), "to", constraint_node);
+            writer.Attribute("type", "lengthBetween");
+            WriteNumericType(constraint.min.value(), "from", writer);
+            WriteNumericType(constraint.max.value(), "to", writer);
         } else if (constraint.type == "minLength") {
-            constraint_node.append_attribute("type").set_value("minLength");
-            SerializeNumericType(constraint.min.value(), "value", constraint_node);
+            writer.Attribute("type", "minLength");
+            WriteNumericType(constraint.min.value(), "value", writer);
         } else if (constraint.type == "maxLength") {
-            constraint_node.append_attribute("type").set_value("maxLength");
-            SerializeNumericType(constraint.max.value(), "value", constraint_node);
+            writer.Attribute("type", "maxLength");
+            WriteNumericType(constraint.max.value(), "value", writer);
         }
 
         // List constraints
         else if (constraint.type == "countBetween") {
-            constraint_node.append_attribute("type").set_value("countBetween");
-            SerializeNumericType(constraint.min.value(), "from", constraint_node);
-            SerializeNumericType(constraint.max.value(), "to", constraint_node);
+            writer.Attribute("type", "countBetween");
+            WriteNumericType(constraint.min.value(), "from", writer);
+            WriteNumericType(constraint.max.value(), "to", writer);
         } else if (constraint.type == "minCount") {
-            constraint_node.append_attribute("type").set_value("minCount");
-
-            SerializeNumericType(constraint.min.value(), "value", constraint_node);
+            writer.Attribute("type", "minCount");
+            WriteNumericType(constraint.min.value(), "value", writer);
         } else if (constraint.type == "maxCount") {
-            constraint_node.append_attribute("type").set_value("maxCount");
-            SerializeNumericType(constraint.max.value(), "value", constraint_node);
+            writer.Attribute("type", "maxCount");
+            WriteNumericType(constraint.max.value(), "value", writer);
         }
+        writer.EndElement();
     }
 }
 
-//! Function used to serialize a matter conformance logical term into nested xml nodes.
-//! This function is usually used in combination with SerializeConformance.
-void SerializeLogicalTerm(const nlohmann::json& condition, pugi::xml_node& parent_node)
+//! Function used to write a matter conformance logical term as nested xml elements.
+template <typename Writer>
+void WriteLogicalTerm(const nlohmann::json& condition, Writer& writer)
 {
+    const char* term = nullptr;
     if (condition.contains("orTerm")) {
-        auto or_node = parent_node.append_child("orTerm");
-        for (const auto& or_child : condition.at("orTerm")) {
-            SerializeLogicalTerm(or_child, or_node);
-        }
+        term = "orTerm";
     } else if (condition.contains("andTerm")) {
-        auto and_node = parent_node.append_child("andTerm");
-        for (const auto& and_child : condition.at("andTerm")) {
-            SerializeLogicalTerm(and_child, and_node);
-        }
+        term = "andTerm";
     } else if (condition.contains("xorTerm")) {
-        auto xor_node = parent_node.append_child("xorTerm");
-        for (const auto& xor_child : condition.at("xorTerm")) {
-            SerializeLogicalTerm(xor_child, xor_node);
-        }
+        term = "xorTerm";
     } else if (condition.contains("notTerm")) {
-        auto not_node = parent_node.append_child("notTerm");
-        for (const auto &not_child : condition.at("notTerm")) {
-            SerializeLogicalTerm(not_child, not_node);
+        term = "notTerm";
+    }
+    if (term != nullptr) {
+        writer.StartElement(term);
+        for (const auto& child : condition.at(term)) {
+            WriteLogicalTerm(child, writer);
+        }
+        writer.EndElement();
+        return;
+    }
+
+    for (const char* reference : {"feature", "condition", "attribute"}) {
+        if (condition.contains(reference)) {
+            std::string name;
+            condition.at(reference).at("name").get_to(name);
+            writer.StartElement(reference);
+            writer.Attribute("name", name);
+            writer.EndElement();
+            return;
         }
-    } else if (condition.contains("feature")) {
-        std::string name;
-        condition.at("feature").at("name").get_to(name);
-        parent_node.append_child("feature").append_attribute("name").set_value(name.c_str());
-    } else if (condition.contains("condition")) {
-        std::string name;
-        condition.at("condition").at("name").get_to(name);
-        parent_node.append_child("condition").append_attribute("name").set_value(name.c_str());
-    } else if (condition.contains("attribute")) {
-        std::string name;
-        condition.at("attribute").at("name").get_to(name);
-        parent_node.append_child("attribute").append_attribute("name").set_value(name.c_str());
     }
 }
 
-//! Function used to serialize a conformance object into a xml node and append it to the given parent node.
-void SerializeConformance(const Conformance& conformance, pugi::xml_node& parent_node) {
-    pugi::xml_node conformance_node;
+//! Function used to write a conformance object as a xml element.
+template <typename Writer>
+void WriteConformance(const Conformance& conformance, Writer& writer) {
     if (conformance.mandatory) {
-        conformance_node = parent_node.append_child("mandatoryConform");
+        writer.StartElement("mandatoryConform");
     } else if (conformance.optional) {
-        conformance_node = parent_node.append_child("optionalConform");
+        writer.StartElement("optionalConform");
         if (!conformance.choice.empty()) {
-            conformance_node.append_attribute("choice").set_value(conformance.choice.c_str());
+            writer.Attribute("choice", conformance.choice);
         }
         if (conformance.choice_more.has_value()) {
-            conformance_node.append_attribute("more").set_value(conformance.choice_more.value());
+            writer.Attribute("more", conformance.choice_more.value());
         }
     } else if (conformance.provisional) {
-        conformance_node = parent_node.append_child("provisionalConform");
+        writer.StartElement("provisionalConform");
     } else if (conformance.deprecated) {
-        conformance_node = parent_node.append_child("deprecateConform");
+        writer.StartElement("deprecateConform");
     } else if (conformance.disallowed) {
-        conformance_node = parent_node.append_child("disallowConform");
+        writer.StartElement("disallowConform");
     } else if (!conformance.otherwise.empty()) {
-        conformance_node = parent_node.append_child("otherwiseConform");
+        writer.StartElement("otherwiseConform");
         for (const auto& otherwise_conformance : conformance.otherwise) {
-            SerializeConformance(otherwise_conformance, conformance_node);
+            WriteConformance(otherwise_conformance, writer);
         }
+    } else {
+        // Without a conformance element, the condition does not get serialized either
+        return;
     }
     if (!conformance.condition.is_null()) {
-        SerializeLogicalTerm(conformance.condition, conformance_node);
+        WriteLogicalTerm(conformance.condition, writer);
     }
+    writer.EndElement();
 }
 
-//! Function used to serialize a access object into a xml node and append it to the given parent node.
-void SerializeAccess(const Access& access, pugi::xml_node& parent_node) {
-    auto access_node = parent_node.append_child("access");
+//! Function used to write a access object as a xml element.
+template <typename Writer>
+void WriteAccess(const Access& access, Writer& writer) {
+    writer.StartElement("access");
 
     if (access.read.has_value()) {
-        access_node.append_attribute("read").set_value(access.read.value());
+        writer.Attribute("read", access.read.value());
     }
 
     if (access.write.has_value()) {
-        access_node.append_attribute("write").set_value(access.write.value());
+        writer.Attribute("write", access.write.value());
     }
 
     if (access.fabric_scoped.has_value()) {
-        access_node.append_attribute("fabricScoped").set_value(access.fabric_scoped.value());
+        writer.Attribute("fabricScoped", access.fabric_scoped.value());
     }
 
     if (access.fabric_sensitive.has_value()) {
-        access_node.append_attribute("fabricSensitive").set_value(access.fabric_sensitive.value());
+        writer.Attribute("fabricSensitive", access.fabric_sensitive.value());
     }
 
     if (!access.read_privilege.empty()) {
-        access_node.append_attribute("readPrivilege").set_value(access.read_privilege.c_str());
+        writer.Attribute("readPrivilege", access.read_privilege);
     }
 
     if (!access.write_privilege.empty()) {
-        access_node.append_attribute("writePrivilege").set_value(access.write_privilege.c_str());
+        writer.Attribute("writePrivilege", access.write_privilege);
     }
 
     if (!access.invoke_privilege.empty()) {
-        access_node.append_attribute("invokePrivilege").set_value(access.invoke_privilege.c_str());
+        writer.Attribute("invokePrivilege", access.invoke_privilege);
     }
 
     if (access.timed.has_value()) {
-        access_node.append_attribute("timed").set_value(access.timed.value());
+        writer.Attribute("timed", access.timed.value());
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a data field object into a xml node and append it to the given parent node.
-void SerializeDataField(const DataField& data_field, pugi::xml_node& parent_node) {
-    auto data_field_node = parent_node.append_child("field");
+//! Function used to write a data field object as a xml element.
+template <typename Writer>
+void WriteDataField(const DataField& data_field, Writer& writer) {
+    writer.StartElement("field");
 
-    data_field_node.append_attribute("id").set_value(data_field.id);
-    data_field_node.append_attribute("name").set_value(data_field.name.c_str());
+    writer.Attribute("id", data_field.id);
+    writer.Attribute("name", data_field.name);
 
-    if (data_field.conformance.has_value()) {
-        SerializeConformance(data_field.conformance.value(), data_field_node);
+    if (!data_field.summary.empty()) {
+        writer.Attribute("summary", data_field.summary);
     }
 
-    if (data_field.access.has_value()) {
-        SerializeAccess(data_field.access.value(), data_field_node);
+    if (!data_field.type.empty()) {
+        writer.Attribute("type", data_field.type);
     }
 
-    if (!data_field.summary.empty()) {
-        data_field_node.append_attribute("summary").set_value(data_field.summary.c_str());
+    if (data_field.default_.has_value()) {
+        WriteDefaultType(data_field.default_.value(), "default", writer);
     }
 
-    if (!data_field.type.empty()) {
-        data_field_node.append_attribute("type").set_value(data_field.type.c_str());
+    if (data_field.conformance.has_value()) {
+        WriteConformance(data_field.conformance.value(), writer);
+    }
+
+    if (data_field.access.has_value()) {
+        WriteAccess(data_field.access.value(), writer);
     }
 
     if (data_field.constraint.has_value()) {
-        SerializeConstraint(data_field.constraint.value(), data_field_node);
+        WriteConstraint(data_field.constraint.value(), writer);
     }
 
     if (data_field.quality.has_value()) {
-        SerializeOtherQuality(data_field.quality.value(), data_field_node);
+        WriteOtherQuality(data_field.quality.value(), writer);
     }
 
-    if (data_field.default_.has_value()) {
-        SerializeDefaultType(data_field.default_.value(), "default", data_field_node);
-    }
+    writer.EndElement();
 }
 
-//! Function used to serialize a event object into a xml node and append it to the given parent node.
-void SerializeEvent(const Event& event, pugi::xml_node& events_node) {
-    auto event_node = events_node.append_child("event");
+//! Function used to write a event object as a xml element.
+template <typename Writer>
+void WriteEvent(const Event& event, Writer& writer) {
+    writer.StartElement("event");
 
-    event_node.append_attribute("id").set_value(IntToHex(event.id).c_str());
-    event_node.append_attribute("name").set_value(event.name.c_str());
+    writer.Attribute("id", IntToHex(event.id));
+    writer.Attribute("name", event.name);
 
-    if (event.conformance.has_value()) {
-        SerializeConformance(event.conformance.value(), event_node);
+    if (!event.summary.empty()) {
+        writer.Attribute("summary", event.summary);
     }
 
-    if (event.access.has_value()) {
-        SerializeAccess(event.access.value(), event_node);
-    }
+    writer.Attribute("priority", event.priority);
 
-    if (!event.summary.empty()) {
-        event_node.append_attribute("summary").set_value(event.summary.c_str());
+    if (event.conformance.has_value()) {
+        WriteConformance(event.conformance.value(), writer);
     }
 
-    event_node.append_attribute("priority").set_value(event.priority.c_str());
+    if (event.access.has_value()) {
+        WriteAccess(event.access.value(), writer);
+    }
 
     if (event.quality.has_value()) {
-        SerializeOtherQuality(event.quality.value(), event_node);
+        WriteOtherQuality(event.quality.value(), writer);
     }
 
     for (const auto& data_field : event.data) {
-        SerializeDataField(data_field, event_node);
+        WriteDataField(data_field, writer);
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a command object and into a xml node and append it to the given parent node.
-void SerializeCommand(const Command& command, pugi::xml_node& commands_node) {
-    auto command_node = commands_node.append_child("command");
+//! Function used to write a command object as a xml element.
+template <typename Writer>
+void WriteCommand(const Command& command, Writer& writer) {
+    writer.StartElement("command");
 
-    command_node.append_attribute("id").set_value(IntToHex(command.id).c_str());
-    command_node.append_attribute("name").set_value(command.name.c_str());
+    writer.Attribute("id", IntToHex(command.id));
+    writer.Attribute("name", command.name);
 
     if (!command.summary.empty()) {
-        command_node.append_attribute("summary").set_value(command.summary.c_str());
+        writer.Attribute("summary", command.summary);
     }
 
-    command_node.append_attribute("direction").set_value(command.direction.c_str());
+    writer.Attribute("direction", command.direction);
 
     if (!command.response.empty()) {
-        command_node.append_attribute("response").set_value(command.response.c_str());
+        writer.Attribute("response", command.response);
     }
 
     if (command.access.has_value()) {
-        SerializeAccess(command.access.value(), command_node);
+        WriteAccess(command.access.value(), writer);
     }
 
     if (command.conformance.has_value()) {
-        SerializeConformance(command.conformance.value(), command_node);
+        WriteConformance(command.conformance.value(), writer);
     }
 
-    // Serialize the command fields
+    // Write the command fields
     for (const auto &field: command.command_fields) {
-        SerializeDataField(field, command_node);
+        WriteDataField(field, writer);
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a attribute object into a xml node and append it to the given parent node.
-void SerializeAttribute(const Attribute& attribute, pugi::xml_node& attributes_node) {
-    auto attribute_node = attributes_node.append_child("attribute");
+//! Function used to write a attribute object as a xml element.
+template <typename Writer>
+void WriteAttribute(const Attribute& attribute, Writer& writer) {
+    writer.StartElement("attribute");
 
-    attribute_node.append_attribute("id").set_value(IntToHex(attribute.id).c_str());
-    attribute_node.append_attribute("name").set_value(attribute.name.c_str());
+    writer.Attribute("id", IntToHex(attribute.id));
+    writer.Attribute("name", attribute.name);
 
     if (!attribute.summary.empty()) {
-        attribute_node.append_attribute("summary").set_value(attribute.summary.c_str());
+        writer.Attribute("summary", attribute.summary);
     }
 
     if (!attribute.type.empty()) {
-        attribute_node.append_attribute("type").set_value(attribute.type.c_str());
+        writer.Attribute("type", attribute.type);
     }
 
     if (attribute.default_.has_value()) {
-        SerializeDefaultType(attribute.default_.value(), "default", attribute_node);
+        WriteDefaultType(attribute.default_.value(), "default", writer);
     }
 
     if (attribute.access.has_value()) {
-        SerializeAccess(attribute.access.value(), attribute_node);
+        WriteAccess(attribute.access.value(), writer);
     }
 
     if (attribute.quality.has_value()) {
-        SerializeOtherQuality(attribute.quality.value(), attribute_node);
+        WriteOtherQuality(attribute.quality.value(), writer);
     }
 
     if (attribute.conformance.has_value()) {
-        SerializeConformance(attribute.conformance.value(), attribute_node);
+        WriteConformance(attribute.conformance.value(), writer);
     }
 
     if (attribute.constraint.has_value()) {
-        SerializeConstraint(attribute.constraint.value(), attribute_node);
+        WriteConstraint(attribute.constraint.value(), writer);
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a enum item into a xml node.
-void SerializeItem(const Item& item, pugi::xml_node& enum_node) {
-    auto item_node = enum_node.append_child("item");
+//! Function used to write a enum item as a xml element.
+template <typename Writer>
+void WriteItem(const Item& item, Writer& writer) {
+    writer.StartElement("item");
 
-    item_node.append_attribute("value").set_value(item.value);
-    item_node.append_attribute("name").set_value(item.name.c_str());
+    writer.Attribute("value", item.value);
+    writer.Attribute("name", item.name);
 
     if (!item.summary.empty()) {
-        item_node.append_attribute("summary").set_value(item.summary.c_str());
+        writer.Attribute("summary", item.summary);
     }
 
     if (item.conformance.has_value()) {
-        SerializeConformance(item.conformance.value(), item_node);
+        WriteConformance(item.conformance.value(), writer);
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a bitfield into a xml node.
-void SerializeBitfield(const Bitfield& bitfield, pugi::xml_node& bitmap_node) {
-    auto bitfield_node = bitmap_node.append_child("bitfield");
+//! Function used to write a bitfield as a xml element.
+template <typename Writer>
+void WriteBitfield(const Bitfield& bitfield, Writer& writer) {
+    writer.StartElement("bitfield");
 
-    bitfield_node.append_attribute("name").set_value(bitfield.name.c_str());
-    bitfield_node.append_attribute("bit").set_value(bitfield.bit);
+    writer.Attribute("name", bitfield.name);
+    writer.Attribute("bit", bitfield.bit);
     if (!bitfield.summary.empty()) {
-        bitfield_node.append_attribute("summary").set_value(bitfield.summary.c_str());
+        writer.Attribute("summary", bitfield.summary);
     }
 
     if (bitfield.conformance.has_value()) {
-        SerializeConformance(bitfield.conformance.value(), bitfield_node);
+        WriteConformance(bitfield.conformance.value(), writer);
     }
-}
 
-//! Function used to serialize the data type section of the given cluster object into xml nodes and append them to the
-//! given parent node. The data type section contains globally defined cluster data types.
-void SerializeGlobalDataTypes(const Cluster& cluster, pugi::xml_node& cluster_xml) {
-    auto data_type_node = cluster_xml.append_child("dataTypes");
+    writer.EndElement();
+}
 
-    // number
+//! Function used to write the data type section of the given cluster object as xml elements.
+template <typename Writer>
+void WriteGlobalDataTypes(const Cluster& cluster, Writer& writer) {
+    writer.StartElement("dataTypes");
 
     for (const auto& current_struct : cluster.structs) {
-        pugi::xml_node struct_node = data_type_node.append_child("struct");
-        struct_node.append_attribute("name").set_value(current_struct.first.c_str());
+        writer.StartElement("struct");
+        writer.Attribute("name", current_struct.first);
         for (const auto& struct_field : current_struct.second) {
-            SerializeDataField(struct_field, struct_node);
+            WriteDataField(struct_field, writer);
         }
+        writer.EndElement();
     }
 
     for (const auto& current_enum: cluster.enums) {
-        pugi::xml_node enum_node = data_type_node.append_child("enum");
-        enum_node.append_attribute("name").set_value(current_enum.first.c_str());
+        writer.StartElement("enum");
+        writer.Attribute("name", current_enum.first);
         for (const auto &enum_item: current_enum.second) {
-            SerializeItem(enum_item, enum_node);
+            WriteItem(enum_item, writer);
         }
+        writer.EndElement();
     }
 
     for (const auto& bitmap: cluster.bitmaps) {
-        pugi::xml_node bitmap_node = data_type_node.append_child("bitmap");
-        bitmap_node.append_attribute("name").set_value(bitmap.first.c_str());
+        writer.StartElement("bitmap");
+        writer.Attribute("name", bitmap.first);
         for (const auto &bitfield: bitmap.second) {
-            SerializeBitfield(bitfield, bitmap_node);
+            WriteBitfield(bitfield, writer);
         }
+        writer.EndElement();
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a feature map into a list of xml nodes.
-void SerializeFeatureMap(const std::list<matter::Feature>& features_map, pugi::xml_node& cluster_node)
+//! Function used to write a feature map as xml elements.
+template <typename Writer>
+void WriteFeatureMap(const std::list<matter::Feature>& features_map, Writer& writer)
 {
-    auto features_node = cluster_node.append_child("features");
+    writer.StartElement("features");
 
     for (const auto& feature : features_map) {
-        auto feature_node = features_node.append_child("feature");
-        feature_node.append_attribute("bit").set_value(feature.bit);
-        feature_node.append_attribute("code").set_value(feature.code.c_str());
-        feature_node.append_attribute("name").set_value(feature.name.c_str());
+        writer.StartElement("feature");
+        writer.Attribute("bit", feature.bit);
+        writer.Attribute("code", feature.code);
+        writer.Attribute("name", feature.name);
         if (!feature.summary.empty()) {
-            feature_node.append_attribute("summary").set_value(feature.summary.c_str());
+            writer.Attribute("summary", feature.summary);
         }
 
         if (feature.conformance.has_value()) {
-            SerializeConformance(feature.conformance.value(), feature_node);
+            WriteConformance(feature.conformance.value(), writer);
         }
+        writer.EndElement();
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a cluster classification into a xml node and appends it to the given parent node.
-void SerializeClusterClassification(const ClusterClassification& cluster_classification, pugi::xml_node& cluster_node) {
-    auto classification_node = cluster_node.append_child("classification");
+//! Function used to write a cluster classification as a xml element.
+template <typename Writer>
+void WriteClusterClassification(const ClusterClassification& cluster_classification, Writer& writer) {
+    writer.StartElement("classification");
 
     if (!cluster_classification.hierarchy.empty()) {
-        classification_node.append_attribute("hierarchy").set_value(cluster_classification.hierarchy.c_str());
+        writer.Attribute("hierarchy", cluster_classification.hierarchy);
     }
 
     if (!cluster_classification.role.empty()) {
-        classification_node.append_attribute("role").set_value(cluster_classification.role.c_str());
+        writer.Attribute("role", cluster_classification.role);
     }
 
     if (!cluster_classification.pics_code.empty()) {
-        classification_node.append_attribute("picsCode").set_value(cluster_classification.pics_code.c_str());
+        writer.Attribute("picsCode", cluster_classification.pics_code);
     }
 
     if (!cluster_classification.scope.empty()) {
-        classification_node.append_attribute("scope").set_value(cluster_classification.scope.c_str());
+        writer.Attribute("scope", cluster_classification.scope);
     }
 
     if (!cluster_classification.base_cluster.empty()) {
-        classification_node.append_attribute("baseCluster").set_value(cluster_classification.base_cluster.c_str());
+        writer.Attribute("baseCluster", cluster_classification.base_cluster);
     }
 
     if (!cluster_classification.primary_transaction.empty()) {
-        classification_node.append_attribute("primaryTransaction").set_value(
-            cluster_classification.primary_transaction.c_str());
+        writer.Attribute("primaryTransaction", cluster_classification.primary_transaction);
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a cluster object into a xml document.
-void SerializeCluster(const Cluster &cluster, pugi::xml_document& cluster_xml)
+//! Function used to write a cluster object as a xml document.
+template <typename Writer>
+void WriteClusterDocument(const Cluster& cluster, Writer& writer)
 {
-    // Create the cluster node
-    auto cluster_node = cluster_xml.append_child("cluster");
+    writer.Declaration();
+
+    writer.StartElement("cluster");
     // Set some meta information for the document
-    cluster_node.append_attribute("xmlns:xsi").set_value("http://www.w3.org/2001/XMLSchema-instance");
-    cluster_node.append_attribute("xsi:schemaLocation").set_value("types types.xsd cluster cluster.xsd");
+    writer.Attribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+    writer.Attribute("xsi:schemaLocation", "types types.xsd cluster cluster.xsd");
 
-    cluster_node.append_attribute("id").set_value(IntToHex(cluster.id).c_str());
-    cluster_node.append_attribute("name").set_value(cluster.name.c_str());
-    cluster_node.append_attribute("revision").set_value(cluster.revision);
+    writer.Attribute("id", IntToHex(cluster.id));
+    writer.Attribute("name", cluster.name);
+    writer.Attribute("revision", cluster.revision);
 
-    if (cluster.access.has_value()) {
-        SerializeAccess(cluster.access.value(), cluster_node);
+    if (!cluster.summary.empty()) {
+        writer.Attribute("summary", cluster.summary);
     }
 
-    if (!cluster.summary.empty()) {
-        cluster_node.append_attribute("summary").set_value(cluster.summary.c_str());
+    if (cluster.access.has_value()) {
+        WriteAccess(cluster.access.value(), writer);
     }
 
-    // Iterate through all revisions and serialize them individually
-    auto revision_history_node = cluster_node.append_child("revisionHistory");
+    // Iterate through all revisions and write them individually
+    writer.StartElement("revisionHistory");
     for (const auto &revision: cluster.revision_history) {
-        auto revision_node = revision_history_node.append_child("revision");
-        revision_node.append_attribute("revision").set_value(revision.first);
-        revision_node.append_attribute("summary").set_value(revision.second.c_str());
+        writer.StartElement("revision");
+        writer.Attribute("revision", revision.first);
+        writer.Attribute("summary", revision.second);
+        writer.EndElement();
     }
+    writer.EndElement();
 
-    // Iterate through all cluster aliases and serialize them individually
-    auto cluster_aliases_node = cluster_node.append_child("clusterIds");
+    // Iterate through all cluster aliases and write them individually
+    writer.StartElement("clusterIds");
     for (const auto& cluster_alias : cluster.cluster_aliases) {
-        auto cluster_alias_node = cluster_aliases_node.append_child("clusterId");
-        cluster_alias_node.append_attribute("id").set_value(IntToHex(cluster_alias.first).c_str());
-        cluster_alias_node.append_attribute("name").set_value(cluster_alias.second.c_str());
+        writer.StartElement("clusterId");
+        writer.Attribute("id", IntToHex(cluster_alias.first));
+        writer.Attribute("name", cluster_alias.second);
+        writer.EndElement();
     }
+    writer.EndElement();
 
     if (cluster.classification.has_value()) {
-        SerializeClusterClassification(cluster.classification.value(), cluster_node);
+        WriteClusterClassification(cluster.classification.value(), writer);
     }
 
     if (!cluster.feature_map.empty()) {
-        SerializeFeatureMap(cluster.feature_map, cluster_node);
+        WriteFeatureMap(cluster.feature_map, writer);
     }
 
-    // Serialize the custom data types
-    // These are a list of globally defined data types
-    SerializeGlobalDataTypes(cluster, cluster_node);
+    WriteGlobalDataTypes(cluster, writer);
 
     if (!cluster.attributes.empty()) {
-        // Iterate through all attributes and serialize them individually
-        auto attributes_node = cluster_node.append_child("attributes");
+        writer.StartElement("attributes");
         for (const auto &attribute: cluster.attributes) {
-            SerializeAttribute(attribute, attributes_node);
+            WriteAttribute(attribute, writer);
         }
+        writer.EndElement();
     }
 
     if (!cluster.client_commands.empty()) {
-        // Iterate through all client and server commands and serialize them individually
-        auto commands_node = cluster_node.append_child("commands");
+        writer.StartElement("commands");
         for (const auto& client_command : cluster.client_commands) {
-            SerializeCommand(client_command, commands_node);
+            WriteCommand(client_command, writer);
         }
         for (const auto& server_command : cluster.server_commands) {
-            SerializeCommand(server_command.second, commands_node);
+            WriteCommand(server_command.second, writer);
         }
+        writer.EndElement();
     }
 
     if (!cluster.events.empty()) {
-        // Iterate through all events and serialize them individually
-        auto events_node = cluster_node.append_child("events");
+        writer.StartElement("events");
         for (const auto &event: cluster.events) {
-            SerializeEvent(event, events_node);
+            WriteEvent(event, writer);
         }
+        writer.EndElement();
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a device type classification object into a xml node and appends it to the given parent
-//! node.
-void SerializeDeviceClassification(const DeviceClassification& device_classification, pugi::xml_node& device_node) {
-    auto classification_node = device_node.append_child("classification");
+//! Function used to serialize a cluster object into a xml document.
+void SerializeCluster(const Cluster &cluster, pugi::xml_document& cluster_xml)
+{
+    XmlBuilder builder(cluster_xml);
+    WriteClusterDocument(cluster, builder);
+}
+
+//! Function used to write a cluster object directly into a file descriptor.
+int WriteCluster(const Cluster& cluster, int fd)
+{
+    BufferedWriter output(fd);
+    XmlWriter writer(output);
+    WriteClusterDocument(cluster, writer);
+    return output.Flush();
+}
+
+//! Function used to write a device type classification object as a xml element.
+template <typename Writer>
+void WriteDeviceClassification(const DeviceClassification& device_classification, Writer& writer) {
+    writer.StartElement("classification");
 
     if (!device_classification.superset.empty()) {
-        classification_node.append_attribute("superset").set_value(device_classification.superset.c_str());
+        writer.Attribute("superset", device_classification.superset);
     }
 
     if (!device_classification.class_.empty()) {
-        classification_node.append_attribute("class").set_value(device_classification.class_.c_str());
+        writer.Attribute("class", device_classification.class_);
     }
 
     if (!device_classification.scope.empty()) {
-        classification_node.append_attribute("scope").set_value(device_classification.scope.c_str());
+        writer.Attribute("scope", device_classification.scope);
     }
+
+    writer.EndElement();
 }
 
-//! Function used to serialize a device type object into a xml document.
-void SerializeDevice(const Device& device, pugi::xml_document& device_xml)
+//! Function used to write a device type object as a xml document.
+template <typename Writer>
+void WriteDeviceDocument(const Device& device, Writer& writer)
 {
-    auto device_node = device_xml.append_child("deviceType");
+    writer.Declaration();
+
+    writer.StartElement("deviceType");
     // Set some meta information for the document
-    device_node.append_attribute("xmlns:xsi").set_value("http://www.w3.org/2001/XMLSchema-instance");
-    device_node.append_attribute("xsi:schemaLocation").set_value("types types.xsd devicetype devicetype.xsd");
+    writer.Attribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+    writer.Attribute("xsi:schemaLocation", "types types.xsd devicetype devicetype.xsd");
 
-    device_node.append_attribute("id").set_value(IntToHex(device.id).c_str());
-    device_node.append_attribute("name").set_value(device.name.c_str());
-    device_node.append_attribute("revision").set_value(device.revision);
+    writer.Attribute("id", IntToHex(device.id));
+    writer.Attribute("name", device.name);
+    writer.Attribute("revision", device.revision);
 
     if (!device.summary.empty()) {
-        device_node.append_attribute("summary").set_value(device.summary.c_str());
+        writer.Attribute("summary", device.summary);
     }
 
     if (device.conformance.has_value()) {
-        SerializeConformance(device.conformance.value(), device_node);
+        WriteConformance(device.conformance.value(), writer);
     }
 
     if (device.access.has_value()) {
-        SerializeAccess(device.access.value(), device_node);
+        WriteAccess(device.access.value(), writer);
     }
 
-    // Iterate through all revisions and serialize them individually
-    auto revision_history_node = device_node.append_child("revisionHistory");
+    // Iterate through all revisions and write them individually
+    writer.StartElement("revisionHistory");
     for (const auto &revision: device.revision_history) {
-        auto revision_node = revision_history_node.append_child("revision");
-        revision_node.append_attribute("revision").set_value(revision.first);
-        revision_node.append_attribute("summary").set_value(revision.second.c_str());
+        writer.StartElement("revision");
+        writer.Attribute("revision", revision.first);
+        writer.Attribute("summary", revision.second);
+        writer.EndElement();
     }
+    writer.EndElement();
 
     if (device.classification.has_value()) {
-        SerializeDeviceClassification(device.classification.value(), device_node);
+        WriteDeviceClassification(device.classification.value(), writer);
     }
 
-    // Iterate through all conditions and serialize them individually
-    auto condition_node = device_node.append_child("conditions");
+    // Iterate through all conditions and write them individually
+    writer.StartElement("conditions");
     for (const auto& condition : device.conditions) {
-        condition_node.append_child("condition").append_attribute("name").set_value(condition.c_str());
+        writer.StartElement("condition");
+        writer.Attribute("name", condition);
+        writer.EndElement();
     }
+    writer.EndElement();
 
-    // Iterate through all clusters and serialize them individually
-    auto clusters_node = device_node.append_child("clusters");
+    // Iterate through all clusters and write them individually
+    writer.StartElement("clusters");
     for (const auto &cluster: device.clusters) {
-        auto cluster_node = clusters_node.append_child("cluster");
-        cluster_node.append_attribute("id").set_value(IntToHex(cluster.id).c_str());
-        cluster_node.append_attribute("name").set_value(cluster.name.c_str());
+        writer.StartElement("cluster");
+        writer.Attribute("id", IntToHex(cluster.id));
+        writer.Attribute("name", cluster.name);
         if (!cluster.side.empty()) {
-            cluster_node.append_attribute("side").set_value(cluster.side.c_str());
+            writer.Attribute("side", cluster.side);
         } else {
             // If no side is given, we default to server
-            cluster_node.append_attribute("side").set_value("server");
+            writer.Attribute("side", "server");
         }
         if (cluster.conformance.has_value()) {
-            SerializeConformance(cluster.conformance.value(), cluster_node);
+            WriteConformance(cluster.conformance.value(), writer);
         }
+        writer.EndElement();
     }
+    writer.EndElement();
+
+    writer.EndElement();
+}
+
+//! Function used to serialize a device type object into a xml document.
+void SerializeDevice(const Device& device, pugi::xml_document& device_xml)
+{
+    XmlBuilder builder(device_xml);
+    WriteDeviceDocument(device, builder);
+}
+
+//! Function used to write a device type object directly into a file descriptor.
+int WriteDevice(const Device& device, int fd)
+{
+    BufferedWriter output(fd);
+    XmlWriter writer(output);
+    WriteDeviceDocument(device, writer);
+    return output.Flush();
 }
 
 } // namespace matter
@@ -18,27 +18,28 @@
 #include <limits>
 #include "matter_to_sdf.h"
 #include "mapping.h"
+#include "profiler.h"
 
 //! This is a global pointer to the quality name current node
 //! This is designed to point at the top level sdf element like
 //! for example the `sdfThing` node, not a specific sdfThing
-static ReferenceTreeNode* current_quality_name_node = nullptr;
+static thread_local ReferenceTreeNode* current_quality_name_node = nullptr;
 
 //! This is a global pointer to the given name current node
 //! This is designed to point at the given name of an element
 //! for example the `OnOff` node, not a top level sdf element
-static ReferenceTreeNode* current_given_name_node = nullptr;
+static thread_local ReferenceTreeNode* current_given_name_node = nullptr;
 
 //! Set containing the supported features
 //! Contains their short code for usage with conformance's
-static std::set<std::string> supported_features;
+static thread_local std::set<std::string> supported_features;
 
 //! List containing required sdf elements
 //! This list gets filled while mapping and afterward appended to the corresponding sdfModel
-static std::list<std::string> sdf_required_list;
+static thread_local std::list<std::string> sdf_required_list;
 
 //! Location of the sdfData for the currently mapped structure
-static std::string sdf_data_location;
+static thread_local std::string sdf_data_location;
 
 namespace matter {
 
@@ -1334,9 +1335,90 @@ sdf::DataQuality MapMatterDataField(const std::list<matter::DataField>& data_fie
     return data_quality;
 }
 
+//! Function used to iterate through a list of elements of a layered cluster.
+//! The elements of the cluster itself get visited first, followed by the elements of its base clusters.
+//! Elements of a base cluster that are shadowed by an element with the same name of an upper layer are skipped.
+template <typename T, typename Function>
+void ForEachLayeredElement(const matter::Cluster& cluster, std::list<T> matter::Cluster::* elements, Function function) {
+    std::set<std::string> visited;
+    for (const matter::Cluster* layer = &cluster; layer != nullptr; layer = layer->base) {
+        for (const auto& element : layer->*elements) {
+            if (visited.insert(element.name).second) {
+                function(element);
+            }
+        }
+    }
+}
+
+//! Function used to iterate through a map of elements of a layered cluster.
+//! Works like ForEachLayeredElement, but for the elements that are stored as name value pairs.
+template <typename Map, typename Function>
+void ForEachLayeredEntry(const matter::Cluster& cluster, Map matter::Cluster::* entries, Function function) {
+    std::set<std::string> visited;
+    for (const matter::Cluster* layer = &cluster; layer != nullptr; layer = layer->base) {
+        for (const auto& entry : layer->*entries) {
+            if (visited.insert(entry.first).second) {
+                function(entry);
+            }
+        }
+    }
+}
+
+//! Function used to search for a server command inside all layers of a cluster.
+//! Returns a null pointer if none of the layers contains the server command.
+const matter::Command* FindLayeredServerCommand(const matter::Cluster& cluster, const std::string& name) {
+    for (const matter::Cluster* layer = &cluster; layer != nullptr; layer = layer->base) {
+        auto server_command = layer->server_commands.find(name);
+        if (server_command != layer->server_commands.end()) {
+            return &server_command->second;
+        }
+    }
+    return nullptr;
+}
+
+//! Function used to get a writable element of a layered cluster.
+//! If the element only exists inside one of the base clusters, it gets copied into the given cluster first, so the
+//! shared base cluster stays untouched.
+//! Returns a null pointer if none of the layers contains an element with the given name.
+template <typename T>
+T* FindWritableLayeredElement(matter::Cluster& cluster, std::list<T> matter::Cluster::* elements,
+                              const std::string& name) {
+    for (auto& element : cluster.*elements) {
+        if (element.name == name) {
+            return &element;
+        }
+    }
+    for (const matter::Cluster* layer = cluster.base; layer != nullptr; layer = layer->base) {
+        for (const auto& element : layer->*elements) {
+            if (element.name == name) {
+                (cluster.*elements).push_back(element);
+                return &(cluster.*elements).back();
+            }
+        }
+    }
+    return nullptr;
+}
+
+//! Function used to get a writable server command of a layered cluster.
+//! Works like FindWritableLayeredElement, but for the map of server commands.
+matter::Command* FindWritableServerCommand(matter::Cluster& cluster, const std::string& name) {
+    auto server_command = cluster.server_commands.find(name);
+    if (server_command != cluster.server_commands.end()) {
+        return &server_command->second;
+    }
+    if (cluster.base != nullptr) {
+        const matter::Command* base_command = FindLayeredServerCommand(*cluster.base, name);
+        if (base_command != nullptr) {
+            return &cluster.server_commands.insert({name, *base_command}).first->second;
+        }
+    }
+    return nullptr;
+}
+
 //! Function used to map a Matter event onto a sdfEvent.
 //! The function returns the created event.
 sdf::SdfEvent MapMatterEvent(const matter::Event& event) {
+    profiler::Count("events_mapped");
     sdf::SdfEvent sdf_event;
     // Append the event node to the tree
     auto* event_reference = new ReferenceTreeNode(event.name);
@@ -1365,9 +1447,9 @@ sdf::SdfEvent MapMatterEvent(const matter::Event& event) {
 }
 
 //! Function used to map a Matter client command onto a sdfAction.
-//! This list of server commands is used to map the response of the command onto the sdfOutputData.
-sdf::SdfAction MapMatterCommand(const matter::Command& client_command, const std::unordered_map<std::string,
-                                matter::Command>& server_commands) {
+//! The server commands of the given cluster are used to map the response of the command onto the sdfOutputData.
+sdf::SdfAction MapMatterCommand(const matter::Command& client_command, const matter::Cluster& cluster) {
+    profiler::Count("commands_mapped");
     sdf::SdfAction sdf_action;
     // Append the client_command node to the tree
     auto* command_reference = new ReferenceTreeNode(client_command.name);
@@ -1415,8 +1497,9 @@ sdf::SdfAction MapMatterCommand(const matter::Command& client_command, const std
             client_command_response.end());
 
         // Check if the server client_command exists
-        if (server_commands.find(client_command_response) != server_commands.end()) {
-            sdf_action.sdf_output_data = MapMatterDataField(server_commands.at(client_command_response).command_fields);
+        const matter::Command* server_command = FindLayeredServerCommand(cluster, client_command_response);
+        if (server_command != nullptr) {
+            sdf_action.sdf_output_data = MapMatterDataField(server_command->command_fields);
         } else {
             std::cerr << "Response Command: " << client_command_response << " not found for Client Command: " << client_command.name << std::endl;
         }
@@ -1428,6 +1511,7 @@ sdf::SdfAction MapMatterCommand(const matter::Command& client_command, const std
 //! Function used to map a Matter attribute onto a sdfProperty.
 //! The function returns the created sdfProperty.
 sdf::SdfProperty MapMatterAttribute(const matter::Attribute& attribute) {
+    profiler::Count("attributes_mapped");
     sdf::SdfProperty sdf_property;
     // Append the attribute node to the tree
     auto* attribute_reference = new ReferenceTreeNode(attribute.name);
@@ -1470,10 +1554,10 @@ sdf::SdfProperty MapMatterAttribute(const matter::Attribute& attribute) {
 //! This function servers two purposes.
 //! Firstly, evaluates for each feature, if it is supported and adds it to the global list of supported features.
 //! Secondly, it generates a JSON structure and exports this structure to the sdf-mapping.
-void MapFeatureMap(const std::list<matter::Feature>& feature_map) {
-    // Evaluate the features while also exporting them to the mapping
+void MapFeatureMap(const matter::Cluster& cluster) {
+    // Evaluate the features of all cluster layers while also exporting them to the mapping
     json feature_map_json;
-    for (const auto& feature : feature_map) {
+    ForEachLayeredElement(cluster, &matter::Cluster::feature_map, [&](const matter::Feature& feature) {
         json feature_json;
         bool condition;
         feature_json["bit"] = feature.bit;
@@ -1492,7 +1576,7 @@ void MapFeatureMap(const std::list<matter::Feature>& feature_map) {
             }
         }
         feature_map_json["feature"].push_back(feature_json);
-    }
+    });
     // If the feature map is not empty, export it to the mapping
     if (!feature_map_json.is_null()) {
         current_given_name_node->AddAttribute("features", feature_map_json);
@@ -1534,6 +1618,8 @@ void MapClusterClassification(const matter::ClusterClassification& cluster_class
 //! Function used to map a Matter cluster onto a sdfObject.
 //! The function returns the created sdfObject.
 sdf::SdfObject MapMatterCluster(const matter::Cluster& cluster) {
+    profiler::ScopedTimer timer("MapMatterCluster", cluster.name);
+    profiler::Count("clusters_mapped");
     sdf::SdfObject sdf_object;
     ReferenceTreeNode* cluster_reference;
     // When combined with a device type definition, we have to differentiate between server and client clusters, as they
@@ -1599,59 +1685,59 @@ sdf::SdfObject MapMatterCluster(const matter::Cluster& cluster) {
         MapClusterClassification(cluster.classification.value());
     }
 
-    MapFeatureMap(cluster.feature_map);
+    MapFeatureMap(cluster);
 
-    // Iterate through the attributes and map them
+    // Iterate through the attributes of all cluster layers and map them
     auto* sdf_property_node = new ReferenceTreeNode("sdfProperty");
     cluster_reference->AddChild(sdf_property_node);
     current_quality_name_node = sdf_property_node;
-    for (const auto& attribute : cluster.attributes){
+    ForEachLayeredElement(cluster, &matter::Cluster::attributes, [&](const matter::Attribute& attribute) {
         if (CheckElementAllowedConformance(attribute.conformance)) {
             sdf::SdfProperty sdf_property = MapMatterAttribute(attribute);
             sdf_object.sdf_property.insert({attribute.name, sdf_property});
         }
-    }
+    });
 
-    // Iterate through the commands and map them
+    // Iterate through the commands of all cluster layers and map them
     auto* sdf_action_node = new ReferenceTreeNode("sdfAction");
     cluster_reference->AddChild(sdf_action_node);
     current_quality_name_node = sdf_action_node;
-    for (const auto& command : cluster.client_commands){
+    ForEachLayeredElement(cluster, &matter::Cluster::client_commands, [&](const matter::Command& command) {
         if (CheckElementAllowedConformance(command.conformance)) {
-            sdf::SdfAction sdf_action = MapMatterCommand(command, cluster.server_commands);
+            sdf::SdfAction sdf_action = MapMatterCommand(command, cluster);
             sdf_object.sdf_action.insert({command.name, sdf_action});
         }
-    }
+    });
 
-    // Iterate through the events and map them
+    // Iterate through the events of all cluster layers and map them
     auto* sdf_event_node = new ReferenceTreeNode("sdfEvent");
     cluster_reference->AddChild(sdf_event_node);
     current_quality_name_node = sdf_event_node;
-    for (const auto& event : cluster.events){
+    ForEachLayeredElement(cluster, &matter::Cluster::events, [&](const matter::Event& event) {
         if (CheckElementAllowedConformance(event.conformance)) {
             sdf::SdfEvent sdf_event = MapMatterEvent(event);
             sdf_object.sdf_event.insert({event.name, sdf_event});
         }
-    }
+    });
 
     auto* sdf_data_node = new ReferenceTreeNode("sdfData");
     cluster_reference->AddChild(sdf_data_node);
     current_quality_name_node = sdf_data_node;
 
     // Iterate through the structs and map them individually
-    for (const auto& struct_pair : cluster.structs) {
+    ForEachLayeredEntry(cluster, &matter::Cluster::structs, [&](const auto& struct_pair) {
         sdf_object.sdf_data.insert(MapMatterStruct(struct_pair));
-    }
+    });
 
     // Iterate through the enums and map them individually
-    for (const auto& enum_pair : cluster.enums) {
+    ForEachLayeredEntry(cluster, &matter::Cluster::enums, [&](const auto& enum_pair) {
         sdf_object.sdf_data.insert(MapMatterEnum(enum_pair));
-    }
+    });
 
     // Iterate through bitmaps and map them individually
-    for (const auto& bitmap_pair : cluster.bitmaps) {
+    ForEachLayeredEntry(cluster, &matter::Cluster::bitmaps, [&](const auto& bitmap_pair) {
         sdf_object.sdf_data.insert(MapMatterBitmap(bitmap_pair));
-    }
+    });
 
     sdf_object.sdf_required = sdf_required_list;
 
@@ -1769,29 +1855,126 @@ sdf::SdfThing MapMatterDevice(const matter::Device& device) {
     return sdf_thing;
 }
 
+//! Function used to check, if a conformance defines any kind of conformance.
+//! Conformance's of derived clusters and device types are always parsed, even if the element does not define one.
+bool CheckConformanceDefined(const std::optional<matter::Conformance>& conformance) {
+    if (!conformance.has_value()) {
+        return false;
+    }
+    return conformance->mandatory or conformance->optional or conformance->provisional or conformance->deprecated or
+           conformance->disallowed or !conformance->otherwise.empty();
+}
+
+//! Function used to fill the qualities of a derived attribute that are not defined by the derived cluster with the
+//! qualities of the attribute of the base cluster.
+void InheritAttribute(matter::Attribute& attribute, const matter::Attribute& base_attribute) {
+    if (!CheckConformanceDefined(attribute.conformance)) {
+        attribute.conformance = base_attribute.conformance;
+    }
+    if (!attribute.access.has_value()) {
+        attribute.access = base_attribute.access;
+    }
+    if (attribute.summary.empty()) {
+        attribute.summary = base_attribute.summary;
+    }
+    if (attribute.type.empty()) {
+        attribute.type = base_attribute.type;
+    }
+    if (!attribute.constraint.has_value()) {
+        attribute.constraint = base_attribute.constraint;
+    }
+    if (!attribute.quality.has_value()) {
+        attribute.quality = base_attribute.quality;
+    }
+    if (!attribute.default_.has_value()) {
+        attribute.default_ = base_attribute.default_;
+    }
+}
+
+//! Function used to fill the qualities of a derived command that are not defined by the derived cluster with the
+//! qualities of the command of the base cluster.
+void InheritCommand(matter::Command& command, const matter::Command& base_command) {
+    if (!CheckConformanceDefined(command.conformance)) {
+        command.conformance = base_command.conformance;
+    }
+    if (!command.access.has_value()) {
+        command.access = base_command.access;
+    }
+    if (command.summary.empty()) {
+        command.summary = base_command.summary;
+    }
+    if (command.response.empty()) {
+        command.response = base_command.response;
+    }
+    if (command.command_fields.empty()) {
+        command.command_fields = base_command.command_fields;
+    }
+}
+
+//! Function used to fill the qualities of a derived event that are not defined by the derived cluster with the
+//! qualities of the event of the base cluster.
+void InheritEvent(matter::Event& event, const matter::Event& base_event) {
+    if (!CheckConformanceDefined(event.conformance)) {
+        event.conformance = base_event.conformance;
+    }
+    if (!event.access.has_value()) {
+        event.access = base_event.access;
+    }
+    if (event.summary.empty()) {
+        event.summary = base_event.summary;
+    }
+    if (event.priority.empty()) {
+        event.priority = base_event.priority;
+    }
+    if (!event.quality.has_value()) {
+        event.quality = base_event.quality;
+    }
+    if (event.data.empty()) {
+        event.data = base_event.data;
+    }
+}
+
 //! Function used to merge a derived cluster with its base.
-//! This function searches for the base cluster of the given derived cluster in the list of clusters and merges the
-//! elements of the base cluster into the elements of the derived cluster.
-void MergeDerivedCluster(matter::Cluster derived_cluster, const std::list<matter::Cluster>& cluster_list) {
-    std::string base_cluster = derived_cluster.classification.value().base_cluster;
-    // Search for the base cluster
-    for (const auto& cluster : cluster_list) {
-        // Iterate through all aliases of the cluster and compare them to the base cluster
-        for (const auto& alias : cluster.cluster_aliases) {
-            if (alias.second == base_cluster) {
-                // Merge the information of the base cluster into the derived cluster
-                derived_cluster.feature_map.insert(derived_cluster.feature_map.end(), cluster.feature_map.begin(),
-                                                   cluster.feature_map.end());
-                derived_cluster.attributes.insert(derived_cluster.attributes.end(), cluster.attributes.begin(),
-                                                  cluster.attributes.end());
-                derived_cluster.client_commands.insert(derived_cluster.client_commands.end(),
-                                                       cluster.client_commands.begin(), cluster.client_commands.end());
-                derived_cluster.server_commands.insert(cluster.server_commands.begin(), cluster.server_commands.end());
-                derived_cluster.events.insert(derived_cluster.events.end(), cluster.events.begin(),
-                                              cluster.events.end());
-                derived_cluster.enums.insert(cluster.enums.begin(), cluster.enums.end());
-                derived_cluster.bitmaps.insert(cluster.bitmaps.begin(), cluster.bitmaps.end());
-                derived_cluster.structs.insert(cluster.structs.begin(), cluster.structs.end());
+//! This function looks up the base cluster of the given derived cluster by its alias and layers the
+//! derived cluster on top of it. The elements of the base cluster are not copied, instead they are shared between all
+//! clusters derived from the same base. Only elements redefined by the derived cluster get completed with the
+//! qualities of the base cluster.
+//! The derived cluster refers to the base cluster of the lookup afterwards, so it must not outlive the cluster list
+//! the lookup was built from.
+void MergeDerivedCluster(matter::Cluster& derived_cluster, const ClusterLookup& lookup) {
+    // Look up the base cluster by its alias
+    auto base_cluster = lookup.clusters_by_alias.find(derived_cluster.classification.value().base_cluster);
+    if (base_cluster == lookup.clusters_by_alias.end()) {
+        return;
+    }
+    const matter::Cluster& cluster = *base_cluster->second;
+    // Reference the shared base cluster instead of copying its elements
+    derived_cluster.base = &cluster;
+    // Complete the elements that the derived cluster redefines
+    for (auto& attribute : derived_cluster.attributes) {
+        for (const auto& base_attribute : cluster.attributes) {
+            if (attribute.name == base_attribute.name) {
+                InheritAttribute(attribute, base_attribute);
+            }
+        }
+    }
+    for (auto& client_command : derived_cluster.client_commands) {
+        for (const auto& base_client_command : cluster.client_commands) {
+            if (client_command.name == base_client_command.name) {
+                InheritCommand(client_command, base_client_command);
+            }
+        }
+    }
+    for (auto& server_command : derived_cluster.server_commands) {
+        auto base_server_command = cluster.server_commands.find(server_command.first);
+        if (base_server_command != cluster.server_commands.end()) {
+            InheritCommand(server_command.second, base_server_command->second);
+        }
+    }
+    for (auto& event : derived_cluster.events) {
+        for (const auto& base_event : cluster.events) {
+            if (event.name == base_event.name) {
+                InheritEvent(event, base_event);
             }
         }
     }
@@ -1812,114 +1995,148 @@ bool CheckIfDerived(const matter::Cluster& cluster) {
 }
 
 //! Function used to merge device and cluster specifications together.
-//! This function takes the device type definition as well as a list of all clusters.
+//! This function takes the device type definition as well as the lookup tables of all clusters.
 //! It merges the cluster definitions from the list of clusters into their respective spot in the device type definition
-//! while optionally overwriting their elements.
-void MergeDeviceCluster(matter::Device& device, const std::list<matter::Cluster>& cluster_list) {
+//! while optionally overwriting their elements. The ids and base clusters that were looked up get recorded in the
+//! dependencies.
+void MergeDeviceCluster(matter::Device& device, const ClusterLookup& lookup, ClusterDependencies& dependencies) {
     for (auto& device_cluster : device.clusters) {
-        for (const auto& cluster: cluster_list) {
-            if (device_cluster.id == cluster.id) {
-                matter::Cluster temp_cluster = cluster;
-                // Overwrite the conformance for the cluster
-                temp_cluster.conformance = device_cluster.conformance;
-                // Set the side of the cluster
-                temp_cluster.side = device_cluster.side;
-                // Overwrite the feature conformance's
-                for (auto &device_feature: device_cluster.feature_map) {
-                    for (auto &cluster_feature: temp_cluster.feature_map) {
-                        if (device_feature.name == cluster_feature.name) {
-                            cluster_feature.conformance = device_feature.conformance;
-                        }
-                    }
+        dependencies.cluster_ids.insert(device_cluster.id);
+        auto clusters = lookup.clusters_by_id.find(device_cluster.id);
+        if (clusters == lookup.clusters_by_id.end()) {
+            continue;
+        }
+        for (const auto* cluster_pointer : clusters->second) {
+            const matter::Cluster& cluster = *cluster_pointer;
+            profiler::ScopedTimer timer("MergeCluster", cluster.name);
+            matter::Cluster temp_cluster = cluster;
+            // If the cluster is derived from a base cluster, we layer it on top of the shared base cluster
+            // Elements of the base cluster only get copied into the cluster, if the device type overwrites them
+            if (CheckIfDerived(temp_cluster)) {
+                dependencies.base_clusters.insert(temp_cluster.classification.value().base_cluster);
+                MergeDerivedCluster(temp_cluster, lookup);
+            }
+            // Overwrite the conformance for the cluster
+            temp_cluster.conformance = device_cluster.conformance;
+            // Set the side of the cluster
+            temp_cluster.side = device_cluster.side;
+            // Overwrite the feature conformance's
+            for (auto &device_feature: device_cluster.feature_map) {
+                matter::Feature* cluster_feature = FindWritableLayeredElement(
+                    temp_cluster, &matter::Cluster::feature_map, device_feature.name);
+                if (cluster_feature != nullptr) {
+                    cluster_feature->conformance = device_feature.conformance;
                 }
+            }
 
-                // Overwrite certain attributes
-                for (auto &device_attribute: device_cluster.attributes) {
-                    for (auto &cluster_attribute: temp_cluster.attributes) {
-                        if (device_attribute.name == cluster_attribute.name) {
-                            if (device_attribute.access.has_value()) {
-                                cluster_attribute.access = device_attribute.access;
-                            }
-                            if (device_attribute.constraint.has_value()) {
-                                cluster_attribute.constraint = device_attribute.constraint;
-                            }
-                            if (device_attribute.conformance.has_value()) {
-                                cluster_attribute.conformance = device_attribute.conformance;
-                            }
-                            if (device_attribute.quality.has_value()) {
-                                cluster_attribute.quality = device_attribute.quality;
-                            }
-                            if (device_attribute.default_.has_value()) {
-                                cluster_attribute.default_ = device_attribute.default_;
-                            }
-                            if (!device_attribute.type.empty()) {
-                                cluster_attribute.type = device_attribute.type;
-                            }
-                        }
-                    }
+            // Overwrite certain attributes
+            for (auto &device_attribute: device_cluster.attributes) {
+                matter::Attribute* cluster_attribute = FindWritableLayeredElement(
+                    temp_cluster, &matter::Cluster::attributes, device_attribute.name);
+                if (cluster_attribute == nullptr) {
+                    continue;
+                }
+                if (device_attribute.access.has_value()) {
+                    cluster_attribute->access = device_attribute.access;
                 }
-                // Overwrite certain commands
-                for (auto &device_command: device_cluster.server_commands) {
-                    for (auto& cluster_client_command : temp_cluster.client_commands) {
-                        if (device_command.second.name == cluster_client_command.name) {
-                            if (device_command.second.access.has_value()) {
-                                cluster_client_command.access = device_command.second.access;
-                            }
-                            if (device_command.second.conformance.has_value()) {
-                                cluster_client_command.conformance = device_command.second.conformance;
-                            }
-                            if (!device_command.second.response.empty()) {
-                                cluster_client_command.response = device_command.second.response;
-                            }
-                        }
+                if (device_attribute.constraint.has_value()) {
+                    cluster_attribute->constraint = device_attribute.constraint;
+                }
+                if (device_attribute.conformance.has_value()) {
+                    cluster_attribute->conformance = device_attribute.conformance;
+                }
+                if (device_attribute.quality.has_value()) {
+                    cluster_attribute->quality = device_attribute.quality;
+                }
+                if (device_attribute.default_.has_value()) {
+                    cluster_attribute->default_ = device_attribute.default_;
+                }
+                if (!device_attribute.type.empty()) {
+                    cluster_attribute->type = device_attribute.type;
+                }
+            }
+            // Overwrite certain commands
+            for (auto &device_command: device_cluster.server_commands) {
+                matter::Command* cluster_client_command = FindWritableLayeredElement(
+                    temp_cluster, &matter::Cluster::client_commands, device_command.second.name);
+                if (cluster_client_command != nullptr) {
+                    if (device_command.second.access.has_value()) {
+                        cluster_client_command->access = device_command.second.access;
                     }
-                    for (auto& cluster_server_command : temp_cluster.server_commands) {
-                        if (device_command.second.name == cluster_server_command.second.name) {
-                            if (device_command.second.access.has_value()) {
-                                cluster_server_command.second.access = device_command.second.access;
-                            }
-                            if (device_command.second.conformance.has_value()) {
-                                cluster_server_command.second.conformance = device_command.second.conformance;
-                            }
-                            if (!device_command.second.response.empty()) {
-                                cluster_server_command.second.response = device_command.second.response;
-                            }
-                        }
+                    if (device_command.second.conformance.has_value()) {
+                        cluster_client_command->conformance = device_command.second.conformance;
+                    }
+                    if (!device_command.second.response.empty()) {
+                        cluster_client_command->response = device_command.second.response;
                     }
                 }
-                // Overwrite certain events
-                for (auto &device_event: device_cluster.events) {
-                    for (auto &cluster_event: temp_cluster.events) {
-                        if (device_event.name == cluster_event.name) {
-                            if (device_event.access.has_value()) {
-                                cluster_event.access = device_event.access;
-                            }
-                            if (device_event.conformance.has_value()) {
-                                cluster_event.conformance = device_event.conformance;
-                            }
-                            if (device_event.quality.has_value()) {
-                                cluster_event.quality = device_event.quality;
-                            }
-                            if (!device_event.priority.empty()) {
-                                cluster_event.priority = device_event.priority;
-                            }
-                        }
+                matter::Command* cluster_server_command = FindWritableServerCommand(
+                    temp_cluster, device_command.second.name);
+                if (cluster_server_command != nullptr) {
+                    if (device_command.second.access.has_value()) {
+                        cluster_server_command->access = device_command.second.access;
+                    }
+                    if (device_command.second.conformance.has_value()) {
+                        cluster_server_command->conformance = device_command.second.conformance;
+                    }
+                    if (!device_command.second.response.empty()) {
+                        cluster_server_command->response = device_command.second.response;
                     }
                 }
-                // If the cluster is derived from a base cluster, we have to merge them together
-                if (CheckIfDerived(temp_cluster)) {
-                    MergeDerivedCluster(temp_cluster, cluster_list);
+            }
+            // Overwrite certain events
+            for (auto &device_event: device_cluster.events) {
+                matter::Event* cluster_event = FindWritableLayeredElement(
+                    temp_cluster, &matter::Cluster::events, device_event.name);
+                if (cluster_event == nullptr) {
+                    continue;
+                }
+                if (device_event.access.has_value()) {
+                    cluster_event->access = device_event.access;
+                }
+                if (device_event.conformance.has_value()) {
+                    cluster_event->conformance = device_event.conformance;
+                }
+                if (device_event.quality.has_value()) {
+                    cluster_event->quality = device_event.quality;
+                }
+                if (!device_event.priority.empty()) {
+                    cluster_event->priority = device_event.priority;
                 }
-                device_cluster = temp_cluster;
             }
+            device_cluster = temp_cluster;
+        }
+    }
+}
+
+//! Function used to build the lookup tables of a list of clusters
+ClusterLookup BuildClusterLookup(const std::list<matter::Cluster>& cluster_list) {
+    ClusterLookup lookup;
+    for (const auto& cluster : cluster_list) {
+        lookup.clusters_by_id[cluster.id].push_back(&cluster);
+        for (const auto& cluster_alias : cluster.cluster_aliases) {
+            lookup.clusters_by_alias.emplace(cluster_alias.second, &cluster);
         }
     }
+    return lookup;
 }
 
 //! Main mapping function used to map an optional device type as well as a list of clusters onto a sdf-model and a
 //! sdf-mapping.
 int MapMatterToSdf(const std::optional<matter::Device>& optional_device, const std::list<matter::Cluster>& cluster_list,
-                   sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping) {
+                   sdf::SdfModel& sdf_model, sdf::SdfMapping& sdf_mapping, ClusterDependencies* dependencies,
+                   const ClusterLookup* lookup) {
+    // The state of a previous conversion on this thread must not leak into this one
+    current_quality_name_node = nullptr;
+    current_given_name_node = nullptr;
+    supported_features.clear();
+    sdf_required_list.clear();
+    sdf_data_location.clear();
+    // Without lookup tables of the session, the clusters get indexed for this conversion
+    std::optional<ClusterLookup> conversion_lookup;
+    if (lookup == nullptr) {
+        lookup = &conversion_lookup.emplace(BuildClusterLookup(cluster_list));
+    }
     // Create a new ReferenceTree
     ReferenceTree reference_tree;
     // Check if a device type is given
@@ -1934,7 +2151,14 @@ int MapMatterToSdf(const std::optional<matter::Device>& optional_device, const s
         sdf_model.information_block = GenerateInformationBlock(device);
         sdf_mapping.information_block = GenerateInformationBlock(device);
         // Merge the clusters from the cluster list into the specified clusters for the device type
-        MergeDeviceCluster(device, cluster_list);
+        {
+            profiler::ScopedTimer timer("MergeDeviceCluster");
+            ClusterDependencies device_dependencies;
+            MergeDeviceCluster(device, *lookup, device_dependencies);
+            if (dependencies != nullptr) {
+                *dependencies = std::move(device_dependencies);
+            }
+        }
         // Map the device type onto a sdfThing
         sdf::SdfThing sdf_thing = MapMatterDevice(device);
         sdf_model.sdf_thing.insert({sdf_thing.label, sdf_thing});
@@ -1950,7 +2174,7 @@ int MapMatterToSdf(const std::optional<matter::Device>& optional_device, const s
                 // If the cluster is derived from a base cluster, we have to merge them together
                 if (CheckIfDerived(cluster)) {
                     matter::Cluster merged_cluster = cluster;
-                    MergeDerivedCluster(merged_cluster, cluster_list);
+                    MergeDerivedCluster(merged_cluster, *lookup);
                     // Generate the information block based on the given cluster
                     sdf_model.information_block = GenerateInformationBlock(merged_cluster);
                     sdf_mapping.information_block = GenerateInformationBlock(merged_cluster);
@@ -1976,7 +2200,11 @@ int MapMatterToSdf(const std::optional<matter::Device>& optional_device, const s
     }
 
     // Generate the sdf-mapping map section based on the reference tree
-    sdf_mapping.map = reference_tree.GenerateMapping(reference_tree.root);
+    {
+        profiler::ScopedTimer timer("GenerateMapping");
+        sdf_mapping.map = reference_tree.GenerateMapping(reference_tree.root);
+    }
+    profiler::Count("mapping_entries", sdf_mapping.map.size());
 
     return 0;
 }
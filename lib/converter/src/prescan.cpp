@@ -0,0 +1,425 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+#include <pugixml.hpp>
+#include "cache.h"
+#include "cbor.h"
+#include "mapped_file.h"
+#include "prescan.h"
+#include "profiler.h"
+
+namespace prescan {
+
+namespace {
+
+//! Elements of a cluster definition which follow the header
+const char* const kBodyElements[] = {"features", "dataTypes", "attributes", "commands", "events"};
+
+//! Elements of the header, which are expected in front of the body
+const char* const kHeaderElements[] = {"<clusterIds", "<classification"};
+
+//! Function used to find the end of the header of a cluster definition
+//! Returns the start of the first element of the body, or the end of the data if there is none. Comments and CDATA
+//! sections are skipped, as they might contain element names.
+const char* FindHeaderEnd(const char* data, std::size_t size) {
+    const char* end = data + size;
+    const char* position = data;
+    while ((position = static_cast<const char*>(std::memchr(position, '<', end - position))) != nullptr) {
+        std::string_view rest(position, end - position);
+        if (rest.compare(0, 4, "<!--") == 0 or rest.compare(0, 9, "<![CDATA[") == 0) {
+            std::size_t close = rest.find(rest[2] == '-' ? "-->" : "]]>");
+            if (close == std::string_view::npos) {
+                return end;
+            }
+            position += close + 3;
+            continue;
+        }
+        for (const char* element : kBodyElements) {
+            std::size_t length = std::strlen(element);
+            if (rest.size() > length + 1 and rest.compare(1, length, element) == 0) {
+                char next = rest[length + 1];
+                if (next == '>' or next == '/' or next == ' ' or next == '\t' or next == '\r' or next == '\n') {
+                    return position;
+                }
+            }
+        }
+        position++;
+    }
+    return end;
+}
+
+//! Version of the index file, has to be increased whenever its layout changes
+const int kIndexVersion = 1;
+
+//! Function used to scan the header of a loaded cluster definition
+//! Files in the binary CBOR format do not have a header that could be scanned, so they get decoded instead. Returns 0
+//! on success and negative on failure.
+int ScanFile(const loader::LoadedFile& file, ClusterHeader& header, std::optional<matter::Cluster>& cluster) {
+    if (file.error != 0) {
+        return -1;
+    }
+    if (ScanCluster(file.data.get(), file.size, header) == 0) {
+        return 0;
+    }
+    if (!cbor::IsEncoded(file.data.get(), file.size)) {
+        return -1;
+    }
+    try {
+        cluster = cbor::ReadCluster(file.data.get(), file.size);
+    }
+    catch (const std::exception&) {
+        return -1;
+    }
+    header.id = cluster->id;
+    header.name = cluster->name;
+    header.cluster_aliases = cluster->cluster_aliases;
+    if (cluster->classification.has_value()) {
+        header.hierarchy = cluster->classification->hierarchy;
+        header.base_cluster = cluster->classification->base_cluster;
+    }
+    return 0;
+}
+
+//! Function used to hash the content of a file like the cache does
+std::string HashContent(const char* data, std::size_t size) {
+    cache::CacheKey key;
+    key.Add(data, size);
+    return key.Digest();
+}
+
+} // namespace
+
+int ScanCluster(const char* data, std::size_t size, ClusterHeader& header) {
+    if (cbor::IsEncoded(data, size)) {
+        return -1;
+    }
+
+    // Only parse the header, unless an element of the header follows the body, which is unusual but allowed
+    const char* header_end = FindHeaderEnd(data, size);
+    std::string_view body(header_end, data + size - header_end);
+    for (const char* element : kHeaderElements) {
+        if (body.find(element) != std::string_view::npos) {
+            header_end = data + size;
+            break;
+        }
+    }
+
+    // The root element of the header is not closed, pugixml keeps the partially parsed document in that case
+    pugi::xml_document xml_file;
+    xml_file.load_buffer(data, header_end - data);
+    pugi::xml_node cluster_node = xml_file.document_element();
+    if (cluster_node.empty()) {
+        return -1;
+    }
+
+    header.id = cluster_node.attribute("id").as_int();
+    header.name = cluster_node.attribute("name").value();
+    header.cluster_aliases.clear();
+    for (const auto& cluster_alias_node : cluster_node.child("clusterIds").children()) {
+        header.cluster_aliases.emplace_back(cluster_alias_node.attribute("id").as_uint(),
+                                            cluster_alias_node.attribute("name").value());
+    }
+    pugi::xml_node classification_node = cluster_node.child("classification");
+    header.hierarchy = classification_node.attribute("hierarchy").value();
+    header.base_cluster = classification_node.attribute("baseCluster").value();
+    return 0;
+}
+
+HeaderLookup BuildHeaderLookup(const std::vector<const ClusterHeader*>& headers) {
+    HeaderLookup lookup;
+    for (std::size_t i = 0; i < headers.size(); i++) {
+        lookup.clusters_by_id[headers[i]->id].push_back(i);
+        for (const auto& cluster_alias : headers[i]->cluster_aliases) {
+            std::vector<std::size_t>& clusters = lookup.clusters_by_alias[cluster_alias.second];
+            // A cluster may list the same alias more than once
+            if (clusters.empty() or clusters.back() != i) {
+                clusters.push_back(i);
+            }
+        }
+    }
+    return lookup;
+}
+
+std::vector<std::size_t> SelectClusters(const matter::Device& device, const std::vector<const ClusterHeader*>& headers,
+                                        const HeaderLookup& lookup) {
+    std::set<std::size_t> selected;
+    for (const auto& device_cluster : device.clusters) {
+        auto clusters = lookup.clusters_by_id.find(device_cluster.id);
+        if (clusters == lookup.clusters_by_id.end()) {
+            continue;
+        }
+        for (std::size_t index : clusters->second) {
+            selected.insert(index);
+            // Derived clusters also depend on their base cluster
+            if (headers[index]->base_cluster.empty()) {
+                continue;
+            }
+            auto base_clusters = lookup.clusters_by_alias.find(headers[index]->base_cluster);
+            if (base_clusters != lookup.clusters_by_alias.end()) {
+                selected.insert(base_clusters->second.begin(), base_clusters->second.end());
+            }
+        }
+    }
+    return {selected.begin(), selected.end()};
+}
+
+int ClusterIndex::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return -1;
+    }
+    std::vector<IndexEntry> loaded_entries;
+    try {
+        nlohmann::json index = nlohmann::json::parse(file);
+        // The hashes depend on the version of the converter, like every cache key
+        if (index.at("version").get<int>() != kIndexVersion or
+            index.at("converter").get<std::string>() != SDF_MATTER_CONVERTER_VERSION) {
+            return -1;
+        }
+        for (const auto& cluster : index.at("clusters")) {
+            IndexEntry& entry = loaded_entries.emplace_back();
+            entry.path = cluster.at("path").get<std::string>();
+            entry.mtime = cluster.at("mtime").get<int64_t>();
+            entry.size = cluster.at("size").get<uint64_t>();
+            entry.hash = cluster.at("hash").get<std::string>();
+            entry.header.id = cluster.at("id").get<uint32_t>();
+            entry.header.name = cluster.at("name").get<std::string>();
+            for (const auto& cluster_alias : cluster.at("clusterIds")) {
+                entry.header.cluster_aliases.emplace_back(cluster_alias.at("id").get<uint32_t>(),
+                                                          cluster_alias.at("name").get<std::string>());
+            }
+            entry.header.hierarchy = cluster.at("hierarchy").get<std::string>();
+            entry.header.base_cluster = cluster.at("baseCluster").get<std::string>();
+        }
+    }
+    catch (const std::exception&) {
+        return -1;
+    }
+    entries = std::move(loaded_entries);
+    return 0;
+}
+
+int ClusterIndex::Save(const std::string& path) const {
+    nlohmann::json index;
+    index["version"] = kIndexVersion;
+    index["converter"] = SDF_MATTER_CONVERTER_VERSION;
+    index["clusters"] = nlohmann::json::array();
+    for (const auto& entry : entries) {
+        nlohmann::json cluster;
+        cluster["path"] = entry.path;
+        cluster["mtime"] = entry.mtime;
+        cluster["size"] = entry.size;
+        cluster["hash"] = entry.hash;
+        cluster["id"] = entry.header.id;
+        cluster["name"] = entry.header.name;
+        cluster["clusterIds"] = nlohmann::json::array();
+        for (const auto& cluster_alias : entry.header.cluster_aliases) {
+            cluster["clusterIds"].push_back({{"id", cluster_alias.first}, {"name", cluster_alias.second}});
+        }
+        cluster["hierarchy"] = entry.header.hierarchy;
+        cluster["baseCluster"] = entry.header.base_cluster;
+        index["clusters"].push_back(std::move(cluster));
+    }
+
+    std::filesystem::path temporary = path + ".tmp-" + std::to_string(getpid());
+    std::error_code error;
+    std::ofstream file(temporary);
+    file << index.dump();
+    file.close();
+    if (!file) {
+        std::filesystem::remove(temporary, error);
+        return -1;
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return -1;
+    }
+    return 0;
+}
+
+bool ClusterIndex::Update(const std::vector<std::string>& paths, std::vector<std::string>& failed_paths) {
+    profiler::ScopedTimer timer("UpdateClusterIndex");
+    std::unordered_map<std::string, std::size_t> indexed;
+    std::vector<std::string> indexed_paths;
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        indexed.emplace(entries[i].path, i);
+        indexed_paths.push_back(entries[i].path);
+    }
+
+    // Keep the entries of unchanged files, only compare their status
+    std::vector<std::optional<IndexEntry>> updated_entries(paths.size());
+    std::vector<std::string> changed_paths;
+    std::vector<std::size_t> changed_indices;
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        struct stat status{};
+        if (stat(paths[i].c_str(), &status) != 0 or !S_ISREG(status.st_mode)) {
+            failed_paths.push_back(paths[i]);
+            continue;
+        }
+        IndexEntry entry;
+        entry.path = paths[i];
+        entry.mtime = static_cast<int64_t>(status.st_mtim.tv_sec) * 1000000000 + status.st_mtim.tv_nsec;
+        entry.size = status.st_size;
+        auto it = indexed.find(paths[i]);
+        if (it != indexed.end() and entries[it->second].mtime == entry.mtime and
+            entries[it->second].size == entry.size) {
+            updated_entries[i] = std::move(entries[it->second]);
+            continue;
+        }
+        updated_entries[i] = std::move(entry);
+        changed_paths.push_back(paths[i]);
+        changed_indices.push_back(i);
+    }
+
+    // New and changed files get loaded in one batch
+    std::vector<loader::LoadedFile> files = loader::LoadFiles(changed_paths);
+    for (std::size_t i = 0; i < files.size(); i++) {
+        std::optional<IndexEntry>& entry = updated_entries[changed_indices[i]];
+        std::optional<matter::Cluster> cluster;
+        if (ScanFile(files[i], entry->header, cluster) != 0) {
+            failed_paths.push_back(files[i].path);
+            entry.reset();
+            continue;
+        }
+        // The status might have changed while the file was loaded, the size always matches the loaded content
+        entry->size = files[i].size;
+        entry->hash = HashContent(files[i].data.get(), files[i].size);
+    }
+
+    // The index changed if a file got scanned or the indexed files are not the same anymore
+    entries.clear();
+    for (auto& entry : updated_entries) {
+        if (entry.has_value()) {
+            entries.push_back(std::move(entry.value()));
+        }
+    }
+    bool changed = !changed_paths.empty() or entries.size() != indexed_paths.size();
+    for (std::size_t i = 0; i < entries.size() and !changed; i++) {
+        changed = entries[i].path != indexed_paths[i];
+    }
+    return changed;
+}
+
+LazyClusterLibrary::LazyClusterLibrary(std::vector<loader::LoadedFile> files) {
+    profiler::ScopedTimer timer("ScanClusterLibrary");
+    for (auto& file : files) {
+        Entry& entry = entries.emplace_back();
+        if (ScanFile(file, entry.header, entry.cluster) != 0) {
+            entries.pop_back();
+            failed_files.push_back(std::move(file));
+            continue;
+        }
+        // Decoded CBOR files do not have to be parsed anymore
+        if (entry.cluster.has_value()) {
+            std::call_once(entry.parsed, []() {});
+        }
+        entry.file = std::move(file);
+    }
+    BuildLookup();
+}
+
+LazyClusterLibrary::LazyClusterLibrary(const ClusterIndex& index) {
+    for (const auto& index_entry : index.Entries()) {
+        Entry& entry = entries.emplace_back();
+        entry.file.path = index_entry.path;
+        entry.header = index_entry.header;
+        entry.hash = index_entry.hash;
+    }
+    BuildLookup();
+}
+
+void LazyClusterLibrary::BuildLookup() {
+    for (const auto& entry : entries) {
+        headers.push_back(&entry.header);
+    }
+    lookup = BuildHeaderLookup(headers);
+}
+
+std::string LazyClusterLibrary::Hash(std::size_t index) const {
+    const Entry& entry = entries[index];
+    return entry.hash.empty() ? HashContent(entry.file.data.get(), entry.file.size) : entry.hash;
+}
+
+const matter::Cluster* LazyClusterLibrary::Parse(const Entry& entry) const {
+    std::call_once(entry.parsed, [&entry]() {
+        profiler::ScopedTimer timer("ParseCluster", entry.header.name);
+        try {
+            // The file of an entry of an index only gets loaded now
+            const char* data = entry.file.data.get();
+            std::size_t size = entry.file.size;
+            MappedFile mapped_file;
+            if (data == nullptr) {
+                if (mapped_file.Map(entry.file.path.c_str()) != 0) {
+                    std::cerr << "Failed to load Matter file: " << entry.file.path << std::endl;
+                    return;
+                }
+                data = mapped_file.Data();
+                size = mapped_file.Size();
+            }
+            if (cbor::IsEncoded(data, size)) {
+                entry.cluster = cbor::ReadCluster(data, size);
+                return;
+            }
+            // The content gets copied by the parser, so the loaded file stays unmodified and can still be hashed
+            pugi::xml_document xml_file;
+            if (!xml_file.load_buffer(data, size)) {
+                std::cerr << "Failed to load XML file: " << entry.file.path << std::endl;
+                return;
+            }
+            entry.cluster = matter::ParseCluster(xml_file.document_element());
+        }
+        catch (const std::exception& err) {
+            std::cerr << "Failed to load Matter file: " << entry.file.path << std::endl;
+            std::cerr << err.what() << std::endl;
+        }
+    });
+    return entry.cluster.has_value() ? &entry.cluster.value() : nullptr;
+}
+
+std::list<matter::Cluster> LazyClusterLibrary::LoadClusters(const matter::Device& device) const {
+    std::list<matter::Cluster> clusters;
+    for (std::size_t index : SelectClusters(device, headers, lookup)) {
+        if (const matter::Cluster* cluster = Parse(entries[index])) {
+            clusters.push_back(*cluster);
+        }
+    }
+    return clusters;
+}
+
+std::list<matter::Cluster> LazyClusterLibrary::LoadClusters() const {
+    std::list<matter::Cluster> clusters;
+    for (const auto& entry : entries) {
+        if (const matter::Cluster* cluster = Parse(entry)) {
+            clusters.push_back(*cluster);
+        }
+    }
+    return clusters;
+}
+
+} // namespace prescan
@@ -0,0 +1,232 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "profiler.h"
+
+namespace profiler {
+
+std::atomic<bool> enabled = false;
+
+std::atomic<bool> tracing = false;
+
+std::atomic<uint64_t> allocations = 0;
+
+namespace {
+
+//! Accumulated measurements of a timer
+struct TimerStatistic {
+    uint64_t count = 0;
+    uint64_t total_nanoseconds = 0;
+    uint64_t max_nanoseconds = 0;
+    uint64_t allocations = 0;
+};
+
+//! Mutex guarding the measurements, as the stages may run on multiple threads
+std::mutex mutex;
+
+std::map<std::string, TimerStatistic> timers;
+
+std::map<std::string, uint64_t> counters;
+
+//! Accumulated samples of a gauge
+struct GaugeStatistic {
+    uint64_t samples = 0;
+    uint64_t total = 0;
+    uint64_t max = 0;
+};
+
+std::map<std::string, GaugeStatistic> gauges;
+
+//! Span of a single measurement
+struct TraceEvent {
+    const char* name;
+    std::string detail;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    std::size_t track;
+};
+
+std::vector<TraceEvent> trace_events;
+
+//! Sample of a gauge
+struct TraceCounter {
+    const char* name;
+    std::chrono::steady_clock::time_point time;
+    uint64_t value;
+};
+
+std::vector<TraceCounter> trace_counters;
+
+//! Tracks of the threads, numbered in the order of their first measurement
+std::map<std::thread::id, std::size_t> tracks;
+
+//! Start of the trace, every timestamp is relative to it
+std::chrono::steady_clock::time_point trace_start = std::chrono::steady_clock::now();
+
+//! Function used to convert nanoseconds into milliseconds
+double ToMilliseconds(uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+
+} // namespace
+
+//! Function used to enable or disable the profiler
+void SetEnabled(bool value) {
+    enabled.store(value, std::memory_order_relaxed);
+}
+
+//! Function used to enable or disable the recording of trace events
+void SetTracing(bool value) {
+    tracing.store(value, std::memory_order_relaxed);
+    if (value) {
+        SetEnabled(true);
+    }
+}
+
+//! Function used to record the measurement of a timer
+void RecordTimer(const char* name, std::chrono::steady_clock::time_point start,
+                 std::chrono::steady_clock::time_point end, uint64_t allocation_count, const std::string& detail) {
+    uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tracing.load(std::memory_order_relaxed)) {
+        std::size_t track = tracks.emplace(std::this_thread::get_id(), tracks.size()).first->second;
+        trace_events.push_back({name, detail, start, end, track});
+    }
+    TimerStatistic& timer = timers[name];
+    timer.count++;
+    timer.total_nanoseconds += nanoseconds;
+    timer.max_nanoseconds = std::max(timer.max_nanoseconds, nanoseconds);
+    timer.allocations += allocation_count;
+}
+
+//! Function used to add a value to a counter
+void RecordCounter(const char* name, uint64_t value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters[name] += value;
+}
+
+//! Function used to record a sample of a gauge
+void RecordGauge(const char* name, uint64_t value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (tracing.load(std::memory_order_relaxed)) {
+        trace_counters.push_back({name, std::chrono::steady_clock::now(), value});
+    }
+    GaugeStatistic& gauge = gauges[name];
+    gauge.samples++;
+    gauge.total += value;
+    gauge.max = std::max(gauge.max, value);
+}
+
+//! Function used to generate a summary of all measurements
+nlohmann::ordered_json Summary() {
+    std::lock_guard<std::mutex> lock(mutex);
+    nlohmann::ordered_json summary;
+    summary["timers"] = nlohmann::ordered_json::object();
+    for (const auto& timer : timers) {
+        nlohmann::ordered_json timer_json;
+        timer_json["count"] = timer.second.count;
+        timer_json["total_ms"] = ToMilliseconds(timer.second.total_nanoseconds);
+        timer_json["max_ms"] = ToMilliseconds(timer.second.max_nanoseconds);
+        timer_json["allocations"] = timer.second.allocations;
+        summary["timers"][timer.first] = timer_json;
+    }
+    summary["counters"] = nlohmann::ordered_json::object();
+    for (const auto& counter : counters) {
+        summary["counters"][counter.first] = counter.second;
+    }
+    summary["gauges"] = nlohmann::ordered_json::object();
+    for (const auto& gauge : gauges) {
+        nlohmann::ordered_json gauge_json;
+        gauge_json["samples"] = gauge.second.samples;
+        gauge_json["mean"] = static_cast<double>(gauge.second.total) / static_cast<double>(gauge.second.samples);
+        gauge_json["max"] = gauge.second.max;
+        summary["gauges"][gauge.first] = gauge_json;
+    }
+    summary["allocations"] = allocations.load(std::memory_order_relaxed);
+    return summary;
+}
+
+//! Function used to write the recorded trace events into a file
+int WriteTrace(const char* path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    nlohmann::ordered_json trace_json;
+    nlohmann::ordered_json trace_events_json = nlohmann::ordered_json::array();
+    // Name the tracks, the thread with the first measurement is usually the main thread
+    for (const auto& track : tracks) {
+        nlohmann::ordered_json metadata_json;
+        metadata_json["name"] = "thread_name";
+        metadata_json["ph"] = "M";
+        metadata_json["pid"] = 1;
+        metadata_json["tid"] = track.second;
+        metadata_json["args"]["name"] = track.second == 0 ? "main" : "worker " + std::to_string(track.second);
+        trace_events_json.push_back(metadata_json);
+    }
+    // Complete events contain their start and their duration in microseconds
+    for (const auto& trace_event : trace_events) {
+        nlohmann::ordered_json trace_event_json;
+        trace_event_json["name"] = trace_event.name;
+        trace_event_json["cat"] = "converter";
+        trace_event_json["ph"] = "X";
+        trace_event_json["ts"] = std::chrono::duration<double, std::micro>(trace_event.start - trace_start).count();
+        trace_event_json["dur"] = std::chrono::duration<double, std::micro>(trace_event.end - trace_event.start).count();
+        trace_event_json["pid"] = 1;
+        trace_event_json["tid"] = trace_event.track;
+        if (!trace_event.detail.empty()) {
+            trace_event_json["args"]["detail"] = trace_event.detail;
+        }
+        trace_events_json.push_back(trace_event_json);
+    }
+    // Counter events get drawn as a graph of their values
+    for (const auto& trace_counter : trace_counters) {
+        nlohmann::ordered_json trace_counter_json;
+        trace_counter_json["name"] = trace_counter.name;
+        trace_counter_json["cat"] = "converter";
+        trace_counter_json["ph"] = "C";
+        trace_counter_json["ts"] = std::chrono::duration<double, std::micro>(trace_counter.time - trace_start).count();
+        trace_counter_json["pid"] = 1;
+        trace_counter_json["args"][trace_counter.name] = trace_counter.value;
+        trace_events_json.push_back(trace_counter_json);
+    }
+    trace_json["traceEvents"] = trace_events_json;
+    trace_json["displayTimeUnit"] = "ms";
+
+    std::ofstream f(path);
+    f << trace_json;
+    return f.good() ? 0 : -1;
+}
+
+//! Function used to remove all measurements
+void Reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    timers.clear();
+    counters.clear();
+    gauges.clear();
+    trace_events.clear();
+    trace_counters.clear();
+    tracks.clear();
+    trace_start = std::chrono::steady_clock::now();
+    allocations.store(0, std::memory_order_relaxed);
+}
+
+} // namespace profiler
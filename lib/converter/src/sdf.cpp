@@ -14,1059 +14,1796 @@
  *  limitations under the License.
  */
 
+#include <cstring>
+#include <map>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
+#include "profiler.h"
 #include "sdf.h"
+#include "writer.h"
 
 using json = nlohmann::ordered_json;
 
 namespace sdf {
 
-//! Reference to the SDF-Model used for resolving sdfRef-Elements.
-json global_sdf_model = {};
-
-//! Function used to resolve sdfRef qualities.
-//! This function implements the procedure described in section 4.4 of the sdf specification.
-void ResolveSdfRef(json& sdf_ref_qualities_json) {
-    std::string sdf_ref = sdf_ref_qualities_json.at("sdfRef");
-    // Create the patch variable
-    json patch = sdf_ref_qualities_json;
-    // Remove the sdfRef member in patch
-    patch.erase("sdfRef");
-    // Check if the model contains the target structure
-    if (global_sdf_model.contains(json::json_pointer(sdf_ref.substr(1)))) {
-        // Dereference the pointer
-        json original = global_sdf_model.at(json::json_pointer(sdf_ref.substr(1)));
-        // Apply the Merge Patch Algorithm [RFC7396]
-        original.merge_patch(patch);
-        // Use the result in place of the original JSON map
-        sdf_ref_qualities_json = original;
+//! Function used to visit the qualities of a sdf element or an information block together with their json keys.
+//! The visitor gets called with the key and the field of every quality until it returns true, which allows to look up
+//! a quality by its key. Jso items do not keep their sdfRef, as it only gets resolved.
+template <typename T, typename Visitor>
+bool VisitQualities(T& element, Visitor&& visitor) {
+    using Type = std::remove_const_t<T>;
+    if constexpr (std::is_same_v<Type, InformationBlock>) {
+        return visitor("title", element.title) or visitor("description", element.description) or
+               visitor("version", element.version) or visitor("modified", element.modified) or
+               visitor("copyright", element.copyright) or visitor("license", element.license) or
+               visitor("features", element.features) or visitor("$comment", element.comment);
+    } else if constexpr (std::is_same_v<Type, JsoItem>) {
+        return visitor("description", element.description) or visitor("$comment", element.comment) or
+               visitor("type", element.type) or visitor("sdfChoice", element.sdf_choice) or
+               visitor("enum", element.enum_) or visitor("minimum", element.minimum) or
+               visitor("maximum", element.maximum) or visitor("format", element.format) or
+               visitor("minLength", element.min_length) or visitor("maxLength", element.max_length) or
+               visitor("properties", element.properties) or visitor("required", element.required);
+    } else {
+        // Common qualities
+        if (visitor("sdfRef", element.sdf_ref) or visitor("description", element.description) or
+            visitor("label", element.label) or visitor("$comment", element.comment) or
+            visitor("sdfRequired", element.sdf_required)) {
+            return true;
+        }
+        // Data qualities
+        if constexpr (std::is_base_of_v<DataQuality, Type>) {
+            if (visitor("type", element.type) or visitor("sdfChoice", element.sdf_choice) or
+                visitor("enum", element.enum_) or visitor("const", element.const_) or
+                visitor("default", element.default_) or visitor("minimum", element.minimum) or
+                visitor("maximum", element.maximum) or visitor("exclusiveMinimum", element.exclusive_minimum) or
+                visitor("exclusiveMaximum", element.exclusive_maximum) or
+                visitor("multipleOf", element.multiple_of) or visitor("minLength", element.min_length) or
+                visitor("maxLength", element.max_length) or visitor("pattern", element.pattern) or
+                visitor("format", element.format) or visitor("minItems", element.min_items) or
+                visitor("maxItems", element.max_items) or visitor("uniqueItems", element.unique_items) or
+                visitor("items", element.items) or visitor("properties", element.properties) or
+                visitor("required", element.required) or visitor("unit", element.unit) or
+                visitor("nullable", element.nullable) or visitor("sdfType", element.sdf_type) or
+                visitor("contentFormat", element.content_format)) {
+                return true;
+            }
+        }
+        if constexpr (std::is_same_v<Type, SdfProperty>) {
+            return visitor("readable", element.readable) or visitor("writable", element.writable) or
+                   visitor("observable", element.observable);
+        } else if constexpr (std::is_same_v<Type, SdfAction>) {
+            return visitor("sdfInputData", element.sdf_input_data) or
+                   visitor("sdfOutputData", element.sdf_output_data) or visitor("sdfData", element.sdf_data);
+        } else if constexpr (std::is_same_v<Type, SdfEvent>) {
+            return visitor("sdfOutputData", element.sdf_output_data) or visitor("sdfData", element.sdf_data);
+        } else if constexpr (std::is_same_v<Type, SdfThing> or std::is_same_v<Type, SdfObject>) {
+            if constexpr (std::is_same_v<Type, SdfThing>) {
+                if (visitor("sdfThing", element.sdf_thing) or visitor("sdfObject", element.sdf_object)) {
+                    return true;
+                }
+            }
+            return visitor("sdfProperty", element.sdf_property) or visitor("sdfAction", element.sdf_action) or
+                   visitor("sdfEvent", element.sdf_event) or visitor("sdfData", element.sdf_data) or
+                   visitor("minItems", element.min_items) or visitor("maxItems", element.max_items);
+        }
+        return false;
     }
 }
 
-//! Function used to parse common qualities from json into a CommonQuality object.
-void ParseCommonQualities(json& common_quality_json, CommonQuality& common_quality) {
-    // If a sdfRef-Element exists, resolve it
-    // Furthermore, set the fill the sdfRef field for later processing
-    if (common_quality_json.contains("sdfRef")) {
-        common_quality_json.at("sdfRef").get_to(common_quality.sdf_ref);
-        // Additionally to setting sdfRef, we resolve sdfRef
-        ResolveSdfRef(common_quality_json);
-    }
+//! Function used to check if a quality is absent, in which case it is not part of a merge patch.
+template <typename T>
+bool IsEmptyQuality(const T& quality) {
+    return quality.empty();
+}
 
-    if (common_quality_json.contains("description")) {
-        common_quality_json.at("description").get_to(common_quality.description);
-    }
+template <typename T>
+bool IsEmptyQuality(const std::optional<T>& quality) {
+    return !quality.has_value();
+}
 
-    if (common_quality_json.contains("label")) {
-        common_quality_json.at("label").get_to(common_quality.label);
-    }
+//! Function used to parse the value of a quality from json.
+template <typename T>
+void ParseQuality(const json& quality_json, T& quality) {
+    quality_json.get_to(quality);
+}
 
-    if (common_quality_json.contains("$comment")) {
-        common_quality_json.at("$comment").get_to(common_quality.comment);
-    }
+//! Sdf elements are read as nested objects, any other value does not describe them and is ignored.
+template <typename T>
+void ParseQuality(const json&, OrderedMap<std::string, T>&) {}
 
-    if (common_quality_json.contains("sdfRequired")) {
-        common_quality_json.at("sdfRequired").get_to(common_quality.sdf_required);
-    }
-}
+void ParseQuality(const json&, std::optional<DataQuality>&) {}
 
-//! Function prototype for ParseDataQualities.
-void ParseDataQualities(json& data_qualities_json, DataQuality& data_qualities);
+void ParseQuality(const json&, std::optional<JsoItem>&) {}
 
-//! Function used to parse data qualities from json to a DataQuality object.
-DataQuality ParseDataQualities(json& data_qualities_json) {
-    DataQuality data_quality;
-    ParseDataQualities(data_qualities_json, data_quality);
-    return data_quality;
+//! Function used to assign a json value to the quality with the given key.
+//! Unknown keys are ignored.
+template <typename T>
+void AssignQuality(const std::string& key, const json& value, T& element) {
+    VisitQualities(element, [&key, &value](const char* quality_key, auto& quality) {
+        if (key != quality_key) {
+            return false;
+        }
+        ParseQuality(value, quality);
+        return true;
+    });
 }
 
-//! Function used to parse a sdfChoice from json into a DataQuality map.
-SdfChoice ParseSdfChoice(json& sdf_choice_json) {
-    SdfChoice sdf_choice;
-    // Iterate through all sdf_choice items and parse them individually
-    for (const auto& data_quality_json : sdf_choice_json.items()){
-        sdf_choice[data_quality_json.key()] = ParseDataQualities(data_quality_json.value());
-    }
-
-    return sdf_choice;
+//! Function used to replace the quality with the given key by a json value.
+//! Like a null value in a merge patch, null removes the quality. Returns true if the quality was set before, as a
+//! repeated key replaces the previous value like in a json object.
+template <typename T>
+bool ReplaceQuality(const std::string& key, const json& value, T& element) {
+    bool replaced = false;
+    VisitQualities(element, [&key, &value, &replaced](const char* quality_key, auto& quality) {
+        if (key != quality_key) {
+            return false;
+        }
+        replaced = !IsEmptyQuality(quality);
+        if (replaced or value.is_null()) {
+            quality = std::remove_reference_t<decltype(quality)>();
+        }
+        if (!value.is_null()) {
+            ParseQuality(value, quality);
+        }
+        return true;
+    });
+    return replaced;
 }
 
-//! Function used to parse a Jso item type from json into a JsoItemType object.
-JsoItem ParseJsoItem(json& jso_item_json) {
-    JsoItem jso_item;
-    // Parse the common qualities
-    if (jso_item_json.contains("sdfRef")) {
-        ResolveSdfRef(jso_item_json);
+//! Function used to write a numeric variant into the json writer.
+template <typename Writer>
+void WriteNumericVariant(const std::variant<double, int64_t, uint64_t>& value, Writer& writer) {
+    if (std::holds_alternative<double>(value)) {
+        writer.Float(std::get<double>(value));
+    } else if (std::holds_alternative<int64_t>(value)) {
+        writer.Integer(std::get<int64_t>(value));
+    } else {
+        writer.Unsigned(std::get<uint64_t>(value));
     }
+}
 
-    if (jso_item_json.contains("description")) {
-        jso_item_json.at("description").get_to(jso_item.description);
+//! Function used to write an array item into the json writer.
+template <typename Writer>
+void WriteArrayItem(const ArrayItem& value, Writer& writer) {
+    if (std::holds_alternative<uint64_t>(value)) {
+        writer.Unsigned(std::get<uint64_t>(value));
+    } else if (std::holds_alternative<int64_t>(value)) {
+        writer.Integer(std::get<int64_t>(value));
+    } else if (std::holds_alternative<double>(value)) {
+        writer.Float(std::get<double>(value));
+    } else if (std::holds_alternative<std::string>(value)) {
+        writer.String(std::get<std::string>(value));
+    } else {
+        writer.Boolean(std::get<bool>(value));
     }
+}
 
-    if (jso_item_json.contains("$comment")) {
-        jso_item_json.at("$comment").get_to(jso_item.comment);
+//! Function used to write a variable type into the json writer.
+template <typename Writer>
+void WriteVariableType(const VariableType& value, Writer& writer) {
+    if (std::holds_alternative<std::list<ArrayItem>>(value)) {
+        writer.BeginArray();
+        for (const auto& array_item : std::get<std::list<ArrayItem>>(value)) {
+            WriteArrayItem(array_item, writer);
+        }
+        writer.EndArray();
+    } else if (std::holds_alternative<std::optional<std::monostate>>(value)) {
+        writer.Null();
+    } else if (std::holds_alternative<uint64_t>(value)) {
+        writer.Unsigned(std::get<uint64_t>(value));
+    } else if (std::holds_alternative<int64_t>(value)) {
+        writer.Integer(std::get<int64_t>(value));
+    } else if (std::holds_alternative<double>(value)) {
+        writer.Float(std::get<double>(value));
+    } else if (std::holds_alternative<std::string>(value)) {
+        writer.String(std::get<std::string>(value));
+    } else {
+        writer.Boolean(std::get<bool>(value));
     }
+}
 
-    // Parse general qualities
-    if (jso_item_json.contains("type")) {
-        jso_item_json.at("type").get_to(jso_item.type);
+//! Function used to write a mapping value into the json writer.
+template <typename Writer>
+void WriteMappingValue(const MappingValue& value, Writer& writer) {
+    if (std::holds_alternative<uint64_t>(value)) {
+        writer.Unsigned(std::get<uint64_t>(value));
+    } else if (std::holds_alternative<int64_t>(value)) {
+        writer.Integer(std::get<int64_t>(value));
+    } else if (std::holds_alternative<double>(value)) {
+        writer.Float(std::get<double>(value));
+    } else if (std::holds_alternative<std::string>(value)) {
+        writer.String(std::get<std::string>(value));
+    } else if (std::holds_alternative<bool>(value)) {
+        writer.Boolean(std::get<bool>(value));
+    } else {
+        writer.Json(std::get<json>(value));
     }
+}
 
-    if (jso_item_json.contains("sdfChoice")) {
-        jso_item.sdf_choice = ParseSdfChoice(jso_item_json.at("sdfChoice"));
+//! Function used to write a list of strings into the json writer.
+template <typename Writer>
+void WriteStringList(const std::list<std::string>& string_list, Writer& writer) {
+    writer.BeginArray();
+    for (const auto& str : string_list) {
+        writer.String(str);
     }
+    writer.EndArray();
+}
 
-    if (jso_item_json.contains("enum")) {
-        jso_item_json.at("enum").get_to(jso_item.enum_);
+//! Function used to write common qualities into the json writer.
+template <typename Writer>
+void WriteCommonQualities(const CommonQuality& common_quality, Writer& writer) {
+    if (!common_quality.description.empty()) {
+        writer.Key("description");
+        writer.String(common_quality.description);
     }
 
-    // Parse number and integer qualities
-    if (jso_item_json.contains("minimum")) {
-        jso_item_json.at("minimum").get_to(jso_item.minimum);
+    if (!common_quality.label.empty()) {
+        writer.Key("label");
+        writer.String(common_quality.label);
     }
 
-    if (jso_item_json.contains("maximum")) {
-        jso_item_json.at("maximum").get_to(jso_item.maximum);
+    if (!common_quality.comment.empty()) {
+        writer.Key("$comment");
+        writer.String(common_quality.comment);
     }
 
-    // Parse string qualities
-    if (jso_item_json.contains("format")) {
-        jso_item_json.at("format").get_to(jso_item.format);
+    if (!common_quality.sdf_ref.empty()) {
+        writer.Key("sdfRef");
+        writer.String(common_quality.sdf_ref);
     }
 
-    if (jso_item_json.contains("minLength")) {
-        jso_item_json.at("minLength").get_to(jso_item.min_length);
+    if (!common_quality.sdf_required.empty()) {
+        writer.Key("sdfRequired");
+        WriteStringList(common_quality.sdf_required, writer);
     }
+}
 
-    if (jso_item_json.contains("maxLength")) {
-        jso_item_json.at("maxLength").get_to(jso_item.max_length);
-    }
+//! Function prototype used for recursive calls.
+template <typename Writer>
+void WriteDataQualities(const DataQuality& data_quality, Writer& writer);
+
+//! Function used to write a sdfChoice into the json writer.
+//! Empty choices are written as empty objects.
+template <typename Writer>
+void WriteSdfChoice(const SdfChoice& sdf_choice, Writer& writer) {
+    writer.BeginObject();
+    for (const auto& sdf_choice_pair : sdf_choice) {
+        writer.Key(sdf_choice_pair.first);
+        writer.BeginObject();
+        WriteDataQualities(sdf_choice_pair.second, writer);
+        writer.EndObject(false);
+    }
+    writer.EndObject();
+}
 
-    // Parse object qualities
-    // Iterate through all items inside properties and parse them individually
-    if (jso_item_json.contains("properties")){
-        for (const auto& data_qualities_json : jso_item_json.at("properties").items()) {
-            jso_item.properties[data_qualities_json.key()] = ParseDataQualities(data_qualities_json.value());
-        }
-    }
-    if (jso_item_json.contains("required")) {
-        jso_item_json.at("required").get_to(jso_item.required);
+//! Function used to write a map of data qualities into the json writer.
+template <typename Writer>
+void WriteSdfData(const SdfData& sdf_data, Writer& writer) {
+    writer.BeginObject();
+    for (const auto& data_quality_pair : sdf_data) {
+        writer.Key(data_quality_pair.first);
+        writer.BeginObject();
+        WriteDataQualities(data_quality_pair.second, writer);
+        writer.EndObject();
     }
-
-    return jso_item;
+    writer.EndObject();
 }
 
-//! Function used to parse data qualities from json into a DataQuality object.
-void ParseDataQualities(json& data_qualities_json, DataQuality& data_quality) {
-    // Parse the common qualities
-    ParseCommonQualities(data_qualities_json, data_quality);
-
-    // Parse general qualities
-    if (data_qualities_json.contains("type")) {
-        data_qualities_json.at("type").get_to(data_quality.type);
+//! Function used to write jso items into the json writer.
+template <typename Writer>
+void WriteJsoItem(const JsoItem& jso_item, Writer& writer) {
+    if (!jso_item.sdf_ref.empty()) {
+        writer.Key("sdfRef");
+        writer.String(jso_item.sdf_ref);
     }
 
-    if (data_qualities_json.contains("sdfChoice")) {
-        data_quality.sdf_choice = ParseSdfChoice(data_qualities_json.at("sdfChoice"));
+    if (!jso_item.description.empty()) {
+        writer.Key("description");
+        writer.String(jso_item.description);
     }
 
-    if (data_qualities_json.contains("enum")) {
-        data_qualities_json.at("enum").get_to(data_quality.enum_);
+    if (!jso_item.comment.empty()) {
+        writer.Key("$comment");
+        writer.String(jso_item.comment);
     }
 
-    if (data_qualities_json.contains("const")) {
-        data_qualities_json.at("const").get_to(data_quality.const_);
+    if (!jso_item.type.empty()) {
+        writer.Key("type");
+        writer.String(jso_item.type);
     }
 
-    if (data_qualities_json.contains("default")) {
-        data_qualities_json.at("default").get_to(data_quality.default_);
+    if (!jso_item.sdf_choice.empty()) {
+        writer.Key("sdfChoice");
+        WriteSdfChoice(jso_item.sdf_choice, writer);
     }
 
-    // Parse number and integer qualities
-    if (data_qualities_json.contains("minimum")) {
-        data_qualities_json.at("minimum").get_to(data_quality.minimum);
+    if (!jso_item.enum_.empty()) {
+        writer.Key("enum");
+        WriteStringList(jso_item.enum_, writer);
     }
 
-    if (data_qualities_json.contains("maximum")) {
-        data_qualities_json.at("maximum").get_to(data_quality.maximum);
+    if (jso_item.minimum.has_value()) {
+        writer.Key("minimum");
+        WriteNumericVariant(jso_item.minimum.value(), writer);
     }
 
-    if (data_qualities_json.contains("exclusiveMinimum")) {
-        data_qualities_json.at("exclusiveMinimum").get_to(data_quality.exclusive_minimum);
+    if (jso_item.maximum.has_value()) {
+        writer.Key("maximum");
+        WriteNumericVariant(jso_item.maximum.value(), writer);
     }
 
-    if (data_qualities_json.contains("exclusiveMaximum")) {
-        data_qualities_json.at("exclusiveMaximum").get_to(data_quality.exclusive_maximum);
+    if (!jso_item.format.empty()) {
+        writer.Key("format");
+        writer.String(jso_item.format);
     }
 
-    if (data_qualities_json.contains("multipleOf")) {
-        data_qualities_json.at("multipleOf").get_to(data_quality.multiple_of);
+    if (jso_item.min_length.has_value()) {
+        writer.Key("minLength");
+        writer.Unsigned(jso_item.min_length.value());
     }
 
-    // Parse string qualities
-    if (data_qualities_json.contains("minLength")) {
-        data_qualities_json.at("minLength").get_to(data_quality.min_length);
+    if (jso_item.max_length.has_value()) {
+        writer.Key("maxLength");
+        writer.Unsigned(jso_item.max_length.value());
     }
 
-    if (data_qualities_json.contains("maxLength")) {
-        data_qualities_json.at("maxLength").get_to(data_quality.max_length);
+    if (!jso_item.properties.empty()) {
+        writer.Key("properties");
+        WriteSdfData(jso_item.properties, writer);
     }
 
-    if (data_qualities_json.contains("pattern")) {
-        data_qualities_json.at("pattern").get_to(data_quality.pattern);
+    if (!jso_item.required.empty()) {
+        writer.Key("required");
+        WriteStringList(jso_item.required, writer);
     }
+}
 
-    if (data_qualities_json.contains("format")) {
-        data_qualities_json.at("format").get_to(data_quality.format);
-    }
+//! Function used to write data qualities into the json writer.
+template <typename Writer>
+void WriteDataQualities(const DataQuality& data_quality, Writer& writer) {
+    // Write common qualities
+    WriteCommonQualities(data_quality, writer);
 
-    // Parse array qualities
-    if (data_qualities_json.contains("minItems")) {
-        data_qualities_json.at("minItems").get_to(data_quality.min_items);
+    // Write the remaining fields
+    if (!data_quality.type.empty()) {
+        writer.Key("type");
+        writer.String(data_quality.type);
     }
 
-    if (data_qualities_json.contains("maxItems")) {
-        data_qualities_json.at("maxItems").get_to(data_quality.max_items);
+    if (!data_quality.sdf_choice.empty()) {
+        writer.Key("sdfChoice");
+        WriteSdfChoice(data_quality.sdf_choice, writer);
     }
 
-    if (data_qualities_json.contains("uniqueItems")) {
-        data_qualities_json.at("uniqueItems").get_to(data_quality.unique_items);
+    if (!data_quality.enum_.empty()) {
+        writer.Key("enum");
+        WriteStringList(data_quality.enum_, writer);
     }
 
-    if (data_qualities_json.contains("items")) {
-        data_quality.items = ParseJsoItem(data_qualities_json.at("items"));
+    if (data_quality.const_.has_value()) {
+        writer.Key("const");
+        WriteVariableType(data_quality.const_.value(), writer);
     }
 
-    // Parse object qualities
-    // Iterate through all items inside properties and parse them individually
-    if (data_qualities_json.contains("properties")){
-        for (const auto& data_quality_json : data_qualities_json.at("properties").items()) {
-            data_quality.properties[data_quality_json.key()] = ParseDataQualities(data_quality_json.value());
-        }
+    if (data_quality.default_.has_value()) {
+        writer.Key("default");
+        WriteVariableType(data_quality.default_.value(), writer);
     }
-    if (data_qualities_json.contains("required")) {
-        data_qualities_json.at("required").get_to(data_quality.required);
+
+    if (data_quality.minimum.has_value()) {
+        writer.Key("minimum");
+        WriteNumericVariant(data_quality.minimum.value(), writer);
     }
 
-    // Parse additional qualities
-    if (data_qualities_json.contains("unit")) {
-        data_qualities_json.at("unit").get_to(data_quality.unit);
+    if (data_quality.maximum.has_value()) {
+        writer.Key("maximum");
+        WriteNumericVariant(data_quality.maximum.value(), writer);
     }
 
-    if (data_qualities_json.contains("nullable")) {
-        data_qualities_json.at("nullable").get_to(data_quality.nullable);
+    if (data_quality.exclusive_minimum.has_value()) {
+        writer.Key("exclusiveMinimum");
+        WriteNumericVariant(data_quality.exclusive_minimum.value(), writer);
     }
 
-    if (data_qualities_json.contains("sdfType")) {
-        data_qualities_json.at("sdfType").get_to(data_quality.sdf_type);
+    if (data_quality.exclusive_maximum.has_value()) {
+        writer.Key("exclusiveMaximum");
+        WriteNumericVariant(data_quality.exclusive_maximum.value(), writer);
     }
 
-    if (data_qualities_json.contains("contentFormat")) {
-        data_qualities_json.at("contentFormat").get_to(data_quality.content_format);
+    if (data_quality.multiple_of.has_value()) {
+        writer.Key("multipleOf");
+        WriteNumericVariant(data_quality.multiple_of.value(), writer);
     }
-}
 
-//! Function used to parse a sdfEvent from json into a SdfEvent object.
-SdfEvent ParseSdfEvent(json& sdf_event_json) {
-    SdfEvent sdf_event;
-    // Parse the common qualities
-    ParseCommonQualities(sdf_event_json, sdf_event);
+    if (data_quality.min_length.has_value()) {
+        writer.Key("minLength");
+        writer.Unsigned(data_quality.min_length.value());
+    }
 
-    // Parse the remaining fields
-    if (sdf_event_json.contains("sdfOutputData")) {
-        sdf_event.sdf_output_data = ParseDataQualities(sdf_event_json.at("sdfOutputData"));
+    if (data_quality.max_length.has_value()) {
+        writer.Key("maxLength");
+        writer.Unsigned(data_quality.max_length.value());
     }
 
-    // Iterate through all items inside sdf_data and parse them individually
-    if (sdf_event_json.contains("sdfData")){
-        for (const auto& sdf_data_json : sdf_event_json.at("sdfData").items()) {
-            sdf_event.sdf_data[sdf_data_json.key()] = ParseDataQualities(sdf_data_json.value());
-        }
+    if (!data_quality.pattern.empty()) {
+        writer.Key("pattern");
+        writer.String(data_quality.pattern);
     }
 
-    return sdf_event;
-}
+    if (!data_quality.format.empty()) {
+        writer.Key("format");
+        writer.String(data_quality.format);
+    }
 
-//! Function used to parse a sdfAction from json into a SdfAction object.
-SdfAction ParseSdfAction(json& sdf_action_json) {
-    SdfAction sdf_action;
-    // Parse the common qualities
-    ParseCommonQualities(sdf_action_json, sdf_action);
+    if (data_quality.min_items.has_value()) {
+        writer.Key("minItems");
+        writer.Unsigned(data_quality.min_items.value());
+    }
 
-    // Parse the remaining fields
-    if (sdf_action_json.contains("sdfInputData")) {
-        sdf_action.sdf_input_data = ParseDataQualities(sdf_action_json.at("sdfInputData"));
+    if (data_quality.max_items.has_value()) {
+        writer.Key("maxItems");
+        writer.Unsigned(data_quality.max_items.value());
     }
 
-    if (sdf_action_json.contains("sdfOutputData")) {
-        sdf_action.sdf_output_data =  ParseDataQualities(sdf_action_json.at("sdfOutputData"));
+    if (data_quality.unique_items.has_value()) {
+        writer.Key("uniqueItems");
+        writer.Boolean(data_quality.unique_items.value());
     }
 
-    // Iterate through all items inside sdf_data and parse them individually
-    if (sdf_action_json.contains("sdfData")){
-        for (const auto& sdf_data_json : sdf_action_json.at("sdfData").items()) {
-            sdf_action.sdf_data[sdf_data_json.key()] = ParseDataQualities(sdf_data_json.value());
-        }
+    if (data_quality.items.has_value()) {
+        writer.Key("items");
+        writer.BeginObject();
+        WriteJsoItem(data_quality.items.value(), writer);
+        writer.EndObject();
     }
 
-    return sdf_action;
-}
+    if (!data_quality.properties.empty()) {
+        writer.Key("properties");
+        WriteSdfData(data_quality.properties, writer);
+    }
 
-//! Function used to parse a sdfProperty from json into a SdfProperty object.
-SdfProperty ParseSdfProperty(json& sdf_property_json) {
-    SdfProperty sdf_property;
-    // Parse the data qualities
-    ParseDataQualities(sdf_property_json, sdf_property);
+    if (!data_quality.required.empty()) {
+        writer.Key("required");
+        WriteStringList(data_quality.required, writer);
+    }
 
-    // Parse the remaining fields
-    if (sdf_property_json.contains("readable")) {
-        sdf_property_json.at("readable").get_to(sdf_property.readable);
+    if (!data_quality.unit.empty()) {
+        writer.Key("unit");
+        writer.String(data_quality.unit);
     }
 
-    if (sdf_property_json.contains("writable")) {
-        sdf_property_json.at("writable").get_to(sdf_property.writable);
+    if (data_quality.nullable.has_value()) {
+        writer.Key("nullable");
+        writer.Boolean(data_quality.nullable.value());
     }
 
-    if (sdf_property_json.contains("observable")) {
-        sdf_property_json.at("observable").get_to(sdf_property.observable);
+    if (!data_quality.sdf_type.empty()) {
+        writer.Key("sdfType");
+        writer.String(data_quality.sdf_type);
     }
 
-    return sdf_property;
+    if (!data_quality.content_format.empty()) {
+        writer.Key("contentFormat");
+        writer.String(data_quality.content_format);
+    }
 }
 
-//! Function used to parse a sdfObject from json into a SdfObject object.
-SdfObject ParseSdfObject(json& sdf_object_json) {
-    SdfObject sdf_object;
-    // Parse the common qualities
-    ParseCommonQualities(sdf_object_json, sdf_object);
+//! Function used to write a sdfEvent into the json writer.
+template <typename Writer>
+void WriteSdfEvent(const SdfEvent& sdf_event, Writer& writer) {
+    writer.BeginObject();
+    WriteCommonQualities(sdf_event, writer);
 
-    // Iterate through all sdfProperties and parse them individually
-    if (sdf_object_json.contains("sdfProperty")){
-        for (const auto& sdf_property_json : sdf_object_json.at("sdfProperty").items()) {
-            sdf_object.sdf_property[sdf_property_json.key()] = ParseSdfProperty(sdf_property_json.value());
-        }
+    if (sdf_event.sdf_output_data.has_value()) {
+        writer.Key("sdfOutputData");
+        writer.BeginObject();
+        WriteDataQualities(sdf_event.sdf_output_data.value(), writer);
+        writer.EndObject();
     }
 
-    // Iterate through all sdfActions and parse them individually
-    if (sdf_object_json.contains("sdfAction")){
-        for (const auto& sdf_action_json : sdf_object_json.at("sdfAction").items()) {
-            sdf_object.sdf_action[sdf_action_json.key()] = ParseSdfAction(sdf_action_json.value());
-        }
+    if (!sdf_event.sdf_data.empty()) {
+        writer.Key("sdfData");
+        WriteSdfData(sdf_event.sdf_data, writer);
     }
+    writer.EndObject();
+}
 
-    // Iterate through all sdfEvents and parse them individually
-    if (sdf_object_json.contains("sdfEvent")){
-        for (const auto& sdf_event_node : sdf_object_json.at("sdfEvent").items()) {
-            sdf_object.sdf_event[sdf_event_node.key()] = ParseSdfEvent(sdf_event_node.value());
-        }
-    }
+//! Function used to write a sdfAction into the json writer.
+template <typename Writer>
+void WriteSdfAction(const SdfAction& sdf_action, Writer& writer) {
+    writer.BeginObject();
+    WriteCommonQualities(sdf_action, writer);
 
-    // Iterate through all items inside sdf_data and parse them individually
-    if (sdf_object_json.contains("sdfData")){
-        for (const auto& data_quality_json : sdf_object_json.at("sdfData").items()) {
-            sdf_object.sdf_data[data_quality_json.key()] = ParseDataQualities(data_quality_json.value());
-        }
+    if (sdf_action.sdf_input_data.has_value()) {
+        writer.Key("sdfInputData");
+        writer.BeginObject();
+        WriteDataQualities(sdf_action.sdf_input_data.value(), writer);
+        writer.EndObject();
     }
 
-    // Parse the remaining fields
-    if (sdf_object_json.contains("minItems")) {
-        sdf_object_json.at("minItems").get_to(sdf_object.min_items);
+    if (sdf_action.sdf_output_data.has_value()) {
+        writer.Key("sdfOutputData");
+        writer.BeginObject();
+        WriteDataQualities(sdf_action.sdf_output_data.value(), writer);
+        writer.EndObject();
     }
 
-    if (sdf_object_json.contains("maxItems")) {
-        sdf_object_json.at("maxItems").get_to(sdf_object.max_items);
+    if (!sdf_action.sdf_data.empty()) {
+        writer.Key("sdfData");
+        WriteSdfData(sdf_action.sdf_data, writer);
     }
-
-    return sdf_object;
+    writer.EndObject();
 }
 
-//! Function used to parse a sdfThing from json into a SdfThing object.
-SdfThing ParseSdfThing(json& sdf_thing_json) {
-    SdfThing sdf_thing;
+//! Function used to write a sdfProperty into the json writer.
+template <typename Writer>
+void WriteSdfProperty(const SdfProperty& sdf_property, Writer& writer) {
+    writer.BeginObject();
+    WriteDataQualities(sdf_property, writer);
 
-    ParseCommonQualities(sdf_thing_json, sdf_thing);
+    if (sdf_property.readable.has_value()) {
+        writer.Key("readable");
+        writer.Boolean(sdf_property.readable.value());
+    }
 
-    // Iterate through all sdfThings and parse them individually
-    if (sdf_thing_json.contains("sdfThing")){
-        for (const auto& nested_sdf_thing_json : sdf_thing_json.at("sdfThing").items()) {
-            sdf_thing.sdf_thing[nested_sdf_thing_json.key()] = ParseSdfThing(nested_sdf_thing_json.value());
-        }
+    if (sdf_property.writable.has_value()) {
+        writer.Key("writable");
+        writer.Boolean(sdf_property.writable.value());
     }
 
-    // Iterate through all sdfObjects and parse them individually
-    if (sdf_thing_json.contains("sdfObject")){
-        for (const auto& sdf_object_json : sdf_thing_json.at("sdfObject").items()) {
-            sdf_thing.sdf_object[sdf_object_json.key()] = ParseSdfObject(sdf_object_json.value());
-        }
+    if (sdf_property.observable.has_value()) {
+        writer.Key("observable");
+        writer.Boolean(sdf_property.observable.value());
     }
+    writer.EndObject();
+}
 
-    // Iterate through all sdfProperties and parse them individually
-    if (sdf_thing_json.contains("sdfProperty")){
-        for (const auto& sdf_property_json : sdf_thing_json.at("sdfProperty").items()) {
-            sdf_thing.sdf_property[sdf_property_json.key()] = ParseSdfProperty(sdf_property_json.value());
+//! Function used to write the sdfProperties, sdfActions and sdfEvents of a sdfObject or sdfThing into the json writer.
+template <typename T, typename Writer>
+void WriteAffordances(const T& sdf_element, Writer& writer) {
+    if (!sdf_element.sdf_property.empty()) {
+        writer.Key("sdfProperty");
+        writer.BeginObject();
+        for (const auto& sdf_property_pair : sdf_element.sdf_property) {
+            writer.Key(sdf_property_pair.first);
+            WriteSdfProperty(sdf_property_pair.second, writer);
         }
+        writer.EndObject();
     }
 
-    // Iterate through all sdfActions and parse them individually
-    if (sdf_thing_json.contains("sdfAction")){
-        for (const auto& sdf_action_json : sdf_thing_json.at("sdfAction").items()) {
-            sdf_thing.sdf_action[sdf_action_json.key()] = ParseSdfAction(sdf_action_json.value());
+    if (!sdf_element.sdf_action.empty()) {
+        writer.Key("sdfAction");
+        writer.BeginObject();
+        for (const auto& sdf_action_pair : sdf_element.sdf_action) {
+            writer.Key(sdf_action_pair.first);
+            WriteSdfAction(sdf_action_pair.second, writer);
         }
+        writer.EndObject();
     }
 
-    // Iterate through all sdfEvents and parse them individually
-    if (sdf_thing_json.contains("sdfEvent")){
-        for (const auto& sdf_event_json : sdf_thing_json.at("sdfEvent").items()) {
-            sdf_thing.sdf_event[sdf_event_json.key()] = ParseSdfEvent(sdf_event_json.value());
+    if (!sdf_element.sdf_event.empty()) {
+        writer.Key("sdfEvent");
+        writer.BeginObject();
+        for (const auto& sdf_event_pair : sdf_element.sdf_event) {
+            writer.Key(sdf_event_pair.first);
+            WriteSdfEvent(sdf_event_pair.second, writer);
         }
+        writer.EndObject();
     }
 
-    // Iterate through all items inside sdf_data and parse them individually
-    if (sdf_thing_json.contains("sdfData")){
-        for (const auto& data_quality_json : sdf_thing_json.at("sdfData").items()) {
-            sdf_thing.sdf_data[data_quality_json.key()] = ParseDataQualities(data_quality_json.value());
-        }
+    if (!sdf_element.sdf_data.empty()) {
+        writer.Key("sdfData");
+        WriteSdfData(sdf_element.sdf_data, writer);
     }
 
-    // Parse the remaining fields
-    if (sdf_thing_json.contains("minItems")) {
-        sdf_thing_json.at("minItems").get_to(sdf_thing.min_items);
+    if (sdf_element.min_items.has_value()) {
+        writer.Key("minItems");
+        writer.Unsigned(sdf_element.min_items.value());
     }
 
-    if (sdf_thing_json.contains("maxItems")) {
-        sdf_thing_json.at("maxItems").get_to(sdf_thing.max_items);
+    if (sdf_element.max_items.has_value()) {
+        writer.Key("maxItems");
+        writer.Unsigned(sdf_element.max_items.value());
     }
+}
 
-    return sdf_thing;
+//! Function used to write a sdfObject into the json writer.
+template <typename Writer>
+void WriteSdfObject(const SdfObject& sdf_object, Writer& writer) {
+    writer.BeginObject();
+    WriteCommonQualities(sdf_object, writer);
+    WriteAffordances(sdf_object, writer);
+    writer.EndObject();
 }
 
-//! Function used to parse a namespace block from json into a NamespaceBlock object.
-NamespaceBlock ParseNamespaceBlock(json& namespace_block_json) {
-    NamespaceBlock namespace_block;
+//! Function used to write a sdfThing into the json writer.
+template <typename Writer>
+void WriteSdfThing(const SdfThing& sdf_thing, Writer& writer) {
+    writer.BeginObject();
+    WriteCommonQualities(sdf_thing, writer);
 
-    // Iterate through all namespace items and parse them individually
-    for (const auto& namespace_item_json : namespace_block_json.at("namespace").items()) {
-        namespace_block.namespaces[namespace_item_json.key()] = namespace_item_json.value();
+    if (!sdf_thing.sdf_thing.empty()) {
+        writer.Key("sdfThing");
+        writer.BeginObject();
+        for (const auto& sdf_thing_pair : sdf_thing.sdf_thing) {
+            writer.Key(sdf_thing_pair.first);
+            WriteSdfThing(sdf_thing_pair.second, writer);
+        }
+        writer.EndObject();
+    }
+
+    if (!sdf_thing.sdf_object.empty()) {
+        writer.Key("sdfObject");
+        writer.BeginObject();
+        for (const auto& sdf_object_pair : sdf_thing.sdf_object) {
+            writer.Key(sdf_object_pair.first);
+            WriteSdfObject(sdf_object_pair.second, writer);
+        }
+        writer.EndObject();
     }
-    namespace_block_json.at("defaultNamespace").get_to(namespace_block.default_namespace);
 
-    return namespace_block;
+    WriteAffordances(sdf_thing, writer);
+    writer.EndObject();
 }
 
-//! Function used to parse an information block from json into a InformationBlock object.
-InformationBlock ParseInformationBlock(json& info_block_json) {
-    InformationBlock information_block;
+//! Function used to write the members of a namespace block into the json writer.
+template <typename Writer>
+void WriteNamespaceBlock(const NamespaceBlock& namespace_block, Writer& writer) {
+    if (!namespace_block.namespaces.empty()) {
+        writer.Key("namespace");
+        writer.BeginObject();
+        for (const auto& namespace_pair : namespace_block.namespaces) {
+            writer.Key(namespace_pair.first);
+            writer.String(namespace_pair.second);
+        }
+        writer.EndObject();
+    }
 
-    if (info_block_json.contains("title")) {
-        info_block_json.at("title").get_to(information_block.title);
+    if (!namespace_block.default_namespace.empty()) {
+        writer.Key("default_namespace");
+        writer.String(namespace_block.default_namespace);
     }
+}
 
-    if (info_block_json.contains("description")) {
-        info_block_json.find("description").value().get_to(information_block.description);
+//! Function used to write an information block into the json writer.
+template <typename Writer>
+void WriteInformationBlock(const InformationBlock& information_block, Writer& writer) {
+    writer.BeginObject();
+    if (!information_block.title.empty()) {
+        writer.Key("title");
+        writer.String(information_block.title);
     }
 
-    if (info_block_json.contains("version")) {
-        info_block_json.at("version").get_to(information_block.version);
+    if (!information_block.description.empty()) {
+        writer.Key("description");
+        writer.String(information_block.description);
     }
 
-    if (info_block_json.contains("modified")) {
-        info_block_json.at("modified").get_to(information_block.modified);
+    if (!information_block.version.empty()) {
+        writer.Key("version");
+        writer.String(information_block.version);
     }
 
-    if (info_block_json.contains("copyright")) {
-        info_block_json.at("copyright").get_to(information_block.copyright);
+    if (!information_block.modified.empty()) {
+        writer.Key("modified");
+        writer.String(information_block.modified);
     }
 
-    if (info_block_json.contains("license")) {
-        info_block_json.at("license").get_to(information_block.license);
+    if (!information_block.copyright.empty()) {
+        writer.Key("copyright");
+        writer.String(information_block.copyright);
     }
 
-    if (info_block_json.contains("features")) {
-        info_block_json.at("features").get_to(information_block.features);
+    if (!information_block.license.empty()) {
+        writer.Key("license");
+        writer.String(information_block.license);
     }
 
-    if (info_block_json.contains("$comment")) {
-        info_block_json.at("$comment").get_to(information_block.comment);
+    if (!information_block.features.empty()) {
+        writer.Key("features");
+        writer.String(information_block.features);
     }
 
-    return information_block;
+    if (!information_block.comment.empty()) {
+        writer.Key("comment");
+        writer.String(information_block.comment);
+    }
+    writer.EndObject();
 }
 
-//! Function used to parse a sdf-model from json into a SdfModel object.
-SdfModel ParseSdfModel(json& sdf_model_json) {
-    SdfModel sdf_model;
-    // Set the global sdf_model reference
-    global_sdf_model = sdf_model_json;
-
-    // Parse the information block
-    if (sdf_model_json.contains("info")) {
-        sdf_model.information_block = ParseInformationBlock(sdf_model_json.at("info"));
+//! Function used to write a SdfModel object into the json writer.
+template <typename Writer>
+void WriteSdfModelObject(const SdfModel& sdf_model, Writer& writer) {
+    writer.BeginObject();
+    // Write the information block
+    if (sdf_model.information_block.has_value()) {
+        writer.Key("info");
+        WriteInformationBlock(sdf_model.information_block.value(), writer);
     }
 
-    // Parse the namespace block
-    if (sdf_model_json.contains("namespace")) {
-        sdf_model.namespace_block = ParseNamespaceBlock(sdf_model_json);
+    // Write the namespace block
+    if (sdf_model.namespace_block.has_value()) {
+        WriteNamespaceBlock(sdf_model.namespace_block.value(), writer);
     }
 
-    // Parse the sdfThings
-    if (sdf_model_json.contains("sdfThing")) {
-        for (const auto& thing : sdf_model_json.at("sdfThing").items()) {
-            sdf_model.sdf_thing[thing.key()] = ParseSdfThing(thing.value());
+    // Write the sdfThing, if one is present
+    if (!sdf_model.sdf_thing.empty()) {
+        writer.Key("sdfThing");
+        writer.BeginObject();
+        for (const auto& sdf_thing_pair : sdf_model.sdf_thing) {
+            writer.Key(sdf_thing_pair.first);
+            WriteSdfThing(sdf_thing_pair.second, writer);
         }
+        writer.EndObject();
     }
 
-    // Parse the sdfObjects
-    else if (sdf_model_json.contains("sdfObject")) {
-        for (const auto &object: sdf_model_json.at("sdfObject").items()) {
-            sdf_model.sdf_object[object.key()] = ParseSdfObject(object.value());
+    // Otherwise write the sdfObject
+    else if (!sdf_model.sdf_object.empty()) {
+        writer.Key("sdfObject");
+        writer.BeginObject();
+        for (const auto& sdf_object_pair : sdf_model.sdf_object) {
+            writer.Key(sdf_object_pair.first);
+            WriteSdfObject(sdf_object_pair.second, writer);
         }
+        writer.EndObject();
     }
-    // As described in Section 3.4 [https://datatracker.ietf.org/doc/draft-ietf-asdf-sdf/], SDF grants the possibility
-    // to have sdf_property, sdf_action or sdf_event as a top level affordance. But as these are meant to be used as
-    // re-usable definitions for usage via sdfRef, these are meaningless for the converter, hence they're ignored.
-
-    return sdf_model;
+    writer.EndObject();
 }
 
-//! Function used to parse a sdf-mapping from json into a SdfMapping object.
-SdfMapping ParseSdfMapping(json& sdf_mapping_json) {
-    SdfMapping sdf_mapping;
-    // Parse the information block
-    if (sdf_mapping_json.contains("info")) {
-        sdf_mapping.information_block = ParseInformationBlock(sdf_mapping_json.at("info"));
-    }
-
-    // Parse the namespace block
-    if (sdf_mapping_json.contains("namespace")) {
-        sdf_mapping.namespace_block = ParseNamespaceBlock(sdf_mapping_json);
+//! Function used to write a SdfMapping object into the json writer.
+template <typename Writer>
+void WriteSdfMappingObject(const SdfMapping& sdf_mapping, Writer& writer) {
+    writer.BeginObject();
+    // Write the information block
+    if (sdf_mapping.information_block.has_value()) {
+        writer.Key("info");
+        WriteInformationBlock(sdf_mapping.information_block.value(), writer);
     }
 
-    // Parse the map section
-    if (sdf_mapping_json.contains("map")) {
-        for (const auto& reference : sdf_mapping_json.at("map").items()) {
-            for (const auto& field : reference.value().items()) {
-                sdf_mapping.map[reference.key()][field.key()] = field.value();
-            }
+    // Write the namespace block
+    if (sdf_mapping.namespace_block.has_value()) {
+        WriteNamespaceBlock(sdf_mapping.namespace_block.value(), writer);
+    }
+
+    // Write the mapping section
+    writer.Key("map");
+    writer.BeginObject();
+    for (const auto& reference : sdf_mapping.map) {
+        writer.Key(reference.first);
+        writer.BeginObject();
+        for (const auto& field : reference.second) {
+            writer.Key(field.first);
+            WriteMappingValue(field.second, writer);
         }
+        writer.EndObject(false);
     }
-
-    return sdf_mapping;
+    writer.EndObject(false);
+    writer.EndObject();
 }
 
-//! Function used to serialize common qualities into the json format.
-void SerializeCommonQualities(const CommonQuality& common_quality, json& common_quality_json) {
-    if (!common_quality.description.empty()) {
-        common_quality_json["description"] = common_quality.description;
-    }
-
-    if (!common_quality.label.empty()) {
-        common_quality_json["label"] = common_quality.label;
-    }
-
-    if (!common_quality.comment.empty()) {
-        common_quality_json["$comment"] = common_quality.comment;
-    }
-
-    if (!common_quality.sdf_ref.empty()) {
-        common_quality_json["sdfRef"] = common_quality.sdf_ref;
-    }
-
-    if (!common_quality.sdf_required.empty()) {
-        common_quality_json["sdfRequired"] = common_quality.sdf_required;
-    }
-
+//! Function used to serialize a SdfModel object into the json format.
+json SerializeSdfModel(const SdfModel& sdf_model) {
+    JsonBuilder builder;
+    WriteSdfModelObject(sdf_model, builder);
+    return builder.Release();
 }
 
-//! Function prototype used for recursive calls.
-json SerializeDataQualities(const DataQuality& data_quality);
-
-//! Function used to serialize jso items into the json format.
-json SerializeJsoItemType(const JsoItem& jso_item) {
-    json jso_item_type_json;
-
-    if (!jso_item.sdf_ref.empty()) {
-        jso_item_type_json["sdfRef"] = jso_item.sdf_ref;
-    }
+//! Function used to serialize a SdfMapping object into the json format.
+json SerializeSdfMapping(const SdfMapping& sdf_mapping) {
+    JsonBuilder builder;
+    WriteSdfMappingObject(sdf_mapping, builder);
+    return builder.Release();
+}
 
-    if (!jso_item.description.empty()) {
-        jso_item_type_json["description"] = jso_item.description;
-    }
+//! Function used to write a SdfModel object directly into a file descriptor.
+int WriteSdfModel(const SdfModel& sdf_model, int fd) {
+    BufferedWriter output(fd);
+    JsonWriter writer(output);
+    WriteSdfModelObject(sdf_model, writer);
+    return output.Flush();
+}
 
-    if (!jso_item.comment.empty()) {
-        jso_item_type_json["$comment"] = jso_item.comment;
-    }
+//! Function used to write a SdfMapping object directly into a file descriptor.
+int WriteSdfMapping(const SdfMapping& sdf_mapping, int fd) {
+    BufferedWriter output(fd);
+    JsonWriter writer(output);
+    WriteSdfMappingObject(sdf_mapping, writer);
+    return output.Flush();
+}
 
-    if (!jso_item.type.empty()) {
-        jso_item_type_json["type"] = jso_item.type;
+//! Kinds of json objects the sdf reader walks through.
+enum class SdfReaderFrame {
+    kModel,
+    kMapping,
+    kInformationBlock,
+    kNamespace,
+    kSdfThings,
+    kSdfObjects,
+    kSdfProperties,
+    kSdfActions,
+    kSdfEvents,
+    kDataQualities,
+    kSdfThing,
+    kSdfObject,
+    kSdfProperty,
+    kSdfAction,
+    kSdfEvent,
+    kDataQuality,
+    kJsoItem,
+    kMap,
+    kMapEntry,
+};
+
+//! Pointer to an element of a sdf-model that can be the target of a sdfRef.
+typedef std::variant<std::monostate, SdfThing*, SdfObject*, SdfProperty*, SdfAction*, SdfEvent*, DataQuality*,
+                     JsoItem*> SdfElement;
+
+//! Function used to escape a key for the usage inside a json pointer.
+std::string EscapeJsonPointerToken(const std::string& token) {
+    std::string escaped;
+    for (char ch : token) {
+        if (ch == '~') {
+            escaped.append("~0");
+        } else if (ch == '/') {
+            escaped.append("~1");
+        } else {
+            escaped.push_back(ch);
+        }
     }
+    return escaped;
+}
 
-    // Iterate through all fields and serialize them individually
-    if (!jso_item.sdf_choice.empty()){
-        json sdf_choice_json;
-        for (const auto& sdf_choice_pair : jso_item.sdf_choice) {
-            sdf_choice_json[sdf_choice_pair.first] = SerializeDataQualities(sdf_choice_pair.second);
-            if (sdf_choice_json.at(sdf_choice_pair.first).empty())
-                sdf_choice_json[sdf_choice_pair.first] = json::object();
+//! Function used to split a json pointer into its unescaped tokens.
+std::list<std::string> SplitJsonPointer(const std::string& pointer) {
+    std::list<std::string> tokens;
+    std::size_t start = 1;
+    while (start <= pointer.size()) {
+        std::size_t end = pointer.find('/', start);
+        if (end == std::string::npos) {
+            end = pointer.size();
+        }
+        std::string token;
+        for (std::size_t i = start; i < end; i++) {
+            if (pointer[i] == '~' and i + 1 < end) {
+                token.push_back(pointer[i + 1] == '1' ? '/' : '~');
+                i++;
+            } else {
+                token.push_back(pointer[i]);
+            }
         }
-        jso_item_type_json["sdfChoice"] = sdf_choice_json;
+        tokens.push_back(token);
+        start = end + 1;
     }
+    return tokens;
+}
 
-    if (!jso_item.enum_.empty()) {
-        jso_item_type_json["enum"] = jso_item.enum_;
+//! Helper function used to turn a possibly missing element into a SdfElement.
+template <typename T>
+SdfElement ToSdfElement(T* element) {
+    if (element == nullptr) {
+        return {};
     }
+    return element;
+}
 
-    if (jso_item.minimum.has_value()) {
-        jso_item_type_json["minimum"] = jso_item.minimum.value();
+//! Helper function used to find a named element inside of a map.
+template <typename T>
+SdfElement FindSdfElement(OrderedMap<std::string, T>& elements, const std::string& name) {
+    auto iter = elements.find(name);
+    if (iter == elements.end()) {
+        return {};
     }
+    return &iter->second;
+}
 
-    if (jso_item.maximum.has_value()) {
-        jso_item_type_json["maximum"] = jso_item.maximum.value();
+//! Helper function used to find a named element inside of an optional.
+template <typename T>
+SdfElement FindSdfElement(std::optional<T>& element) {
+    if (!element.has_value()) {
+        return {};
     }
+    return &element.value();
+}
 
-    if (!jso_item.format.empty()) {
-        jso_item_type_json["format"] = jso_item.format;
-    }
+//! Helper function used to find a named element inside the affordance maps of a sdfThing or sdfObject.
+template <typename T>
+SdfElement FindSdfAffordance(T& sdf_element, const std::string& quality, const std::string& name) {
+    if (quality == "sdfProperty") {
+        return FindSdfElement(sdf_element.sdf_property, name);
+    } else if (quality == "sdfAction") {
+        return FindSdfElement(sdf_element.sdf_action, name);
+    } else if (quality == "sdfEvent") {
+        return FindSdfElement(sdf_element.sdf_event, name);
+    } else if (quality == "sdfData") {
+        return FindSdfElement(sdf_element.sdf_data, name);
+    }
+    return {};
+}
 
-    if (jso_item.min_length.has_value()) {
-        jso_item_type_json["minLength"] = jso_item.min_length.value();
-    }
+//! Function prototype used for recursive calls.
+template <typename T, typename U>
+void MergeQualities(T& target, const U& patch);
 
-    if (jso_item.max_length.has_value()) {
-        jso_item_type_json["maxLength"] = jso_item.max_length.value();
+//! Function used to merge a quality of a merge patch into the quality of the target.
+//! Values and lists replace the quality of the target, qualities of a different type are ignored.
+template <typename T, typename U>
+void MergeQuality(T& target, const U& patch) {
+    if constexpr (std::is_assignable_v<T&, const U&>) {
+        target = patch;
     }
+}
 
-    if (!jso_item.properties.empty()) {
-        json sdf_properties_json;
-        for (const auto& data_quality_pair : jso_item.properties) {
-            sdf_properties_json[data_quality_pair.first] = SerializeDataQualities(data_quality_pair.second);
-        }
-        jso_item_type_json["properties"] = sdf_properties_json;
+//! Function used to merge a map of sdf elements into the map of the target.
+template <typename T, typename U>
+void MergeQuality(OrderedMap<std::string, T>& target, const OrderedMap<std::string, U>& patch) {
+    for (const auto& element : patch) {
+        MergeQualities(target[element.first], element.second);
     }
+}
 
-    if (!jso_item.required.empty()) {
-        jso_item_type_json["required"] = jso_item.required;
+//! Function used to merge a single sdf element like sdfInputData or items into the element of the target.
+template <typename T>
+void MergeElementQuality(std::optional<T>& target, const std::optional<T>& patch) {
+    if (!target.has_value()) {
+        target.emplace();
     }
-
-    return jso_item_type_json;
+    MergeQualities(target.value(), patch.value());
 }
 
-//! Function used to serialize data qualities into the json format.
-void SerializeDataQualities(const DataQuality& data_quality, json& data_quality_json) {
-    // Serialize common qualities
-    SerializeCommonQualities(data_quality, data_quality_json);
+void MergeQuality(std::optional<DataQuality>& target, const std::optional<DataQuality>& patch) {
+    MergeElementQuality(target, patch);
+}
 
-    // Serialize the remaining fields
-    if (!data_quality.type.empty()) {
-        data_quality_json["type"] = data_quality.type;
-    }
+void MergeQuality(std::optional<JsoItem>& target, const std::optional<JsoItem>& patch) {
+    MergeElementQuality(target, patch);
+}
 
-    // Iterate through all fields and serialize them individually
-    if (!data_quality.sdf_choice.empty()){
-        json sdf_choice_json;
-        for (const auto& sdf_choice_pair : data_quality.sdf_choice) {
-            sdf_choice_json[sdf_choice_pair.first] = SerializeDataQualities(sdf_choice_pair.second);
-            if (sdf_choice_json.at(sdf_choice_pair.first).empty())
-                sdf_choice_json[sdf_choice_pair.first] = json::object();
+//! Function used to apply the qualities of a sdf element as a merge patch [RFC7396] to another sdf element.
+//! Both elements can be of a different kind, in which case only the qualities with the same key get merged.
+template <typename T, typename U>
+void MergeQualities(T& target, const U& patch) {
+    VisitQualities(patch, [&target](const char* key, const auto& patch_quality) {
+        if (!IsEmptyQuality(patch_quality)) {
+            VisitQualities(target, [key, &patch_quality](const char* target_key, auto& target_quality) {
+                if (std::strcmp(key, target_key) != 0) {
+                    return false;
+                }
+                MergeQuality(target_quality, patch_quality);
+                return true;
+            });
         }
-        data_quality_json["sdfChoice"] = sdf_choice_json;
-    }
-
-    if (!data_quality.enum_.empty()) {
-        data_quality_json["enum"] = data_quality.enum_;
-    }
-
-    if (data_quality.const_.has_value()) {
-        data_quality_json["const"] = data_quality.const_;
-    }
+        return false;
+    });
+}
 
-    if (data_quality.default_.has_value()) {
-        data_quality_json["default"] = data_quality.default_.value();
-    }
+//! Function used to replace a sdf element with the resolution of its sdfRef.
+//! The qualities of the target get merged into an empty element of the same kind as the referencing element, which
+//! then gets the qualities of the referencing element merged into it. As the referencing element has a sdfRef, the
+//! sdfRef of the target gets replaced.
+template <typename T, typename U>
+void ApplySdfRef(T& element, const U& target) {
+    T resolved;
+    MergeQualities(resolved, target);
+    MergeQualities(resolved, element);
+    element = std::move(resolved);
+}
 
-    if (data_quality.minimum.has_value()) {
-        data_quality_json["minimum"] = data_quality.minimum.value();
-    }
+//! Function used to remove a quality from a sdf element, as a null value in a merge patch does.
+void ClearQuality(const SdfElement& element, const std::string& key) {
+    std::visit([&key](auto sdf_element) {
+        if constexpr (!std::is_same_v<decltype(sdf_element), std::monostate>) {
+            VisitQualities(*sdf_element, [&key](const char* quality_key, auto& quality) {
+                if (key != quality_key) {
+                    return false;
+                }
+                quality = std::remove_reference_t<decltype(quality)>();
+                return true;
+            });
+        }
+    }, element);
+}
 
-    if (data_quality.maximum.has_value()) {
-        data_quality_json["maximum"] = data_quality.maximum.value();
-    }
+//! Function used to remove a named element from a quality, which only applies to maps of sdf elements.
+template <typename T>
+void EraseQualityElement(T&, const std::string&) {}
 
-    if (data_quality.exclusive_minimum.has_value()) {
-        data_quality_json["exclusiveMinimum"] = data_quality.exclusive_minimum.value();
-    }
+template <typename T>
+void EraseQualityElement(OrderedMap<std::string, T>& elements, const std::string& name) {
+    elements.erase(name);
+}
 
-    if (data_quality.exclusive_maximum.has_value()) {
-        data_quality_json["exclusiveMaximum"] = data_quality.exclusive_maximum.value();
-    }
+//! Function used to remove a named element from a map quality of a sdf element, as a null value in a merge patch does.
+void ClearQualityElement(const SdfElement& element, const std::string& key, const std::string& name) {
+    std::visit([&key, &name](auto sdf_element) {
+        if constexpr (!std::is_same_v<decltype(sdf_element), std::monostate>) {
+            VisitQualities(*sdf_element, [&key, &name](const char* quality_key, auto& quality) {
+                if (key != quality_key) {
+                    return false;
+                }
+                EraseQualityElement(quality, name);
+                return true;
+            });
+        }
+    }, element);
+}
 
-    if (data_quality.multiple_of.has_value()) {
-        data_quality_json["multipleOf"] = data_quality.multiple_of.value();
-    }
+//! Event based parser which fills SdfModel and SdfMapping objects directly without creating a json object first.
+//! Elements with a sdfRef get recorded while parsing and are resolved in a post-pass once the complete model is known.
+//! Already parsed json documents get handed to the same parser, so both ways of parsing give the same objects.
+class SdfSaxHandler : public nlohmann::json_sax<json> {
+public:
+    //! Constructor for parsing a sdf-model
+    explicit SdfSaxHandler(SdfModel& sdf_model) : sdf_model(&sdf_model) {}
 
-    if (data_quality.min_length.has_value()) {
-        data_quality_json["minLength"] = data_quality.min_length.value();
-    }
+    //! Constructor for parsing a sdf-mapping
+    explicit SdfSaxHandler(SdfMapping& sdf_mapping) : sdf_mapping(&sdf_mapping) {}
 
-    if (data_quality.max_length.has_value()) {
-        data_quality_json["maxLength"] = data_quality.max_length.value();
+    bool null() override {
+        return Value(nullptr);
     }
 
-    if (!data_quality.pattern.empty()) {
-        data_quality_json["pattern"] = data_quality.pattern;
+    bool boolean(bool value) override {
+        return Value(value);
     }
 
-    if (!data_quality.format.empty()) {
-        data_quality_json["format"] = data_quality.format;
+    bool number_integer(number_integer_t value) override {
+        return Value(value);
     }
 
-    if (data_quality.min_items.has_value()) {
-        data_quality_json["minItems"] = data_quality.min_items.value();
+    bool number_unsigned(number_unsigned_t value) override {
+        return Value(value);
     }
 
-    if (data_quality.max_items.has_value()) {
-        data_quality_json["maxItems"] = data_quality.max_items.value();
+    bool number_float(number_float_t value, const string_t&) override {
+        return Value(value);
     }
 
-    if (data_quality.unique_items.has_value()) {
-        data_quality_json["uniqueItems"] = data_quality.unique_items.value();
+    bool string(string_t& value) override {
+        return Value(std::move(value));
     }
 
-    if (data_quality.items.has_value()) {
-        data_quality_json["items"] = SerializeJsoItemType(data_quality.items.value());
+    bool binary(binary_t& value) override {
+        return Value(json::binary(std::move(value)));
     }
 
-    if (!data_quality.properties.empty()) {
-        json sdf_properties_json;
-        for (const auto& data_quality_pair : data_quality.properties) {
-            sdf_properties_json[data_quality_pair.first] = SerializeDataQualities(data_quality_pair.second);
+    bool start_object(std::size_t) override {
+        if (frames.empty() and capture_stack.empty()) {
+            frames.push_back({sdf_model != nullptr ? SdfReaderFrame::kModel : SdfReaderFrame::kMapping, nullptr, "", 0});
+            return true;
         }
-        data_quality_json["properties"] = sdf_properties_json;
+        // Everything that is not a sdf element gets captured as json and assigned as a whole
+        if (!capture_stack.empty() or frames.empty() or !StartChildFrame()) {
+            return StartCapture(json::object());
+        }
+        return true;
     }
 
-    if (!data_quality.required.empty()) {
-        data_quality_json["required"] = data_quality.required;
+    bool key(string_t& key) override {
+        if (!capture_stack.empty()) {
+            capture_key = std::move(key);
+        } else {
+            frames.back().key = std::move(key);
+        }
+        return true;
     }
 
-    if (!data_quality.unit.empty()) {
-        data_quality_json["unit"] = data_quality.unit;
+    bool end_object() override {
+        if (!capture_stack.empty()) {
+            return EndCapture();
+        }
+        pointer.resize(frames.back().pointer_length);
+        frames.pop_back();
+        if (frames.empty()) {
+            Finish();
+        }
+        return true;
     }
 
-    if (data_quality.nullable.has_value()) {
-        data_quality_json["nullable"] = data_quality.nullable.value();
+    bool start_array(std::size_t) override {
+        return StartCapture(json::array());
     }
 
-    if (!data_quality.sdf_type.empty()) {
-        data_quality_json["sdfType"] = data_quality.sdf_type;
+    bool end_array() override {
+        return EndCapture();
     }
 
-    if (!data_quality.content_format.empty()) {
-        data_quality_json["contentFormat"] = data_quality.content_format;
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+        error = ex.what();
+        return false;
     }
-}
 
-//! Function used to serialize data qualities into the json format.
-json SerializeDataQualities(const DataQuality& data_quality) {
-    json data_quality_json;
-    SerializeDataQualities(data_quality, data_quality_json);
-    return data_quality_json;
-}
+    //! Message of the parse error, if one occurred
+    std::string error;
 
-//! Function used to serialize sdfData into the json format.
-json SerializeSdfData(const SdfData& sdf_data) {
-    json sdf_data_json;
-    // Iterate through all elements and serialize them individually
-    for (const auto& data_quality_pair : sdf_data) {
-        sdf_data_json[data_quality_pair.first] = SerializeDataQualities(data_quality_pair.second);
-    }
-
-    return sdf_data_json;
-}
-
-//! Function used to serialize a sdf_event into the json format.
-json SerializeSdfEvent(const SdfEvent& sdf_event) {
-    json sdf_event_json;
-    // Serialize common qualities
-    SerializeCommonQualities(sdf_event, sdf_event_json);
+private:
+    //! Currently open json object
+    struct Frame {
+        SdfReaderFrame kind;
+        void* element;
+        std::string key;
+        std::size_t pointer_length;
+    };
 
-    // Serialize the sdfOutputData
-    if (sdf_event.sdf_output_data.has_value()) {
-        sdf_event_json["sdfOutputData"] = SerializeDataQualities(sdf_event.sdf_output_data.value());
-    }
+    //! Resolution state of an element with a sdfRef
+    struct SdfRefSite {
+        std::string sdf_ref;
+        bool resolving = false;
+        bool resolved = false;
+    };
 
-    // Serialize the sdfData elements
-    if (!sdf_event.sdf_data.empty()) {
-        sdf_event_json["sdfData"] = SerializeSdfData(sdf_event.sdf_data);
+    //! Function used to get the json pointer of the value with the given key inside of the current frame
+    std::string QualityPointer(const std::string& key) const {
+        return pointer + "/" + EscapeJsonPointerToken(key);
     }
 
-    return sdf_event_json;
-}
-
-//! Function used to serialize a sdf_action into the json format.
-json SerializeSdfAction(const SdfAction& sdf_action) {
-    json sdf_action_json;
-    // Serialize common qualities
-    SerializeCommonQualities(sdf_action, sdf_action_json);
-
-    // Serialize the sdfInputData
-    if (sdf_action.sdf_input_data.has_value()) {
-        sdf_action_json["sdfInputData"] = SerializeDataQualities(sdf_action.sdf_input_data.value());
+    //! Function used to drop the sdfRefs and null values recorded at and below the given json pointer.
+    template <typename Container>
+    static void EraseSubtree(Container& container, const std::string& subtree_pointer) {
+        container.erase(subtree_pointer);
+        // The json pointers below start with the pointer followed by '/', which sort before the pointer followed by '0'
+        container.erase(container.lower_bound(subtree_pointer + "/"), container.lower_bound(subtree_pointer + "0"));
     }
 
-    // Serialize the sdfOutputData
-    if (sdf_action.sdf_output_data.has_value()) {
-        sdf_action_json["sdfOutputData"] = SerializeDataQualities(sdf_action.sdf_output_data.value());
-    }
-
-    // Serialize the sdfData elements
-    if (!sdf_action.sdf_data.empty()) {
-        sdf_action_json["sdfData"] = SerializeSdfData(sdf_action.sdf_data);
-    }
-
-    return sdf_action_json;
-}
-
-//! Function used to serialize a sdf_property into the json format.
-json SerializeSdfProperty(const SdfProperty& sdf_property) {
-    json sdf_property_json;
-    // Serialize data qualities
-    SerializeDataQualities(sdf_property, sdf_property_json);
-
-    // Serialize the remaining fields
-    if (sdf_property.readable.has_value()) {
-        sdf_property_json["readable"] = sdf_property.readable.value();
+    //! Function used to forget everything recorded for a previous value with the same key inside of the current frame.
+    //! A repeated key replaces the previous value like in a json object, so only the last value is used.
+    void ReplacedValue(bool replaced, const std::string& key) {
+        if (replaced) {
+            std::string value_pointer = QualityPointer(key);
+            EraseSubtree(null_qualities, value_pointer);
+            EraseSubtree(sdf_ref_sites, value_pointer);
+        } else if (!null_qualities.empty()) {
+            null_qualities.erase(QualityPointer(key));
+        }
     }
 
-    if (sdf_property.writable.has_value()) {
-        sdf_property_json["writable"] = sdf_property.writable.value();
+    //! Function used to enter a frame for an element inside of a map
+    template <typename T>
+    void* Emplace(void* elements, const std::string& name) {
+        auto entry = static_cast<OrderedMap<std::string, T>*>(elements)->try_emplace(name);
+        if (!entry.second) {
+            entry.first->second = T();
+        }
+        ReplacedValue(!entry.second, name);
+        return &entry.first->second;
     }
 
-    if (sdf_property.observable.has_value()) {
-        sdf_property_json["observable"] = sdf_property.observable.value();
+    //! Function used to remove an element from a map, as the value of its key does not describe an element
+    template <typename T>
+    void EraseElement(void* elements, const std::string& name) {
+        ReplacedValue(static_cast<OrderedMap<std::string, T>*>(elements)->erase(name) != 0, name);
     }
 
-    return sdf_property_json;
-}
-
-//! Function used to serialize a sdf_object into the json format
-json SerializeSdfObject(const SdfObject& sdf_object) {
-     json sdf_object_json;
-    // Serialize the common qualities
-    SerializeCommonQualities(sdf_object, sdf_object_json);
-
-    // Serialize the sdfProperties
-    if (!sdf_object.sdf_property.empty()) {
-        json sdf_property_json;
-        for (const auto& sdf_property_pair: sdf_object.sdf_property) {
-            sdf_property_json[sdf_property_pair.first] = SerializeSdfProperty(sdf_property_pair.second);
+    //! Function used to enter a quality of the current frame that contains sdf elements
+    template <typename T>
+    T& StartQuality(T& quality) {
+        bool replaced = !IsEmptyQuality(quality);
+        if (replaced) {
+            quality = T();
         }
-        sdf_object_json["sdfProperty"] = sdf_property_json;
-    }
-
-    // Serialize the sdfActions
-    if (!sdf_object.sdf_action.empty()) {
-        json sdf_action_json;
-        for (const auto& sdf_action_pair: sdf_object.sdf_action) {
-            sdf_action_json[sdf_action_pair.first] = SerializeSdfAction(sdf_action_pair.second);
+        ReplacedValue(replaced, frames.back().key);
+        return quality;
+    }
+
+    //! Function used to enter the affordance maps that are shared between sdfThing and sdfObject
+    template <typename T>
+    bool StartAffordanceMap(const std::string& key, T& sdf_element, SdfReaderFrame& kind, void*& element) {
+        if (key == "sdfProperty") {
+            kind = SdfReaderFrame::kSdfProperties;
+            element = &StartQuality(sdf_element.sdf_property);
+        } else if (key == "sdfAction") {
+            kind = SdfReaderFrame::kSdfActions;
+            element = &StartQuality(sdf_element.sdf_action);
+        } else if (key == "sdfEvent") {
+            kind = SdfReaderFrame::kSdfEvents;
+            element = &StartQuality(sdf_element.sdf_event);
+        } else if (key == "sdfData") {
+            kind = SdfReaderFrame::kDataQualities;
+            element = &StartQuality(sdf_element.sdf_data);
+        } else {
+            return false;
         }
-        sdf_object_json["sdfAction"] = sdf_action_json;
-    }
-
-    // Serialize the sdfEvents
-    if (!sdf_object.sdf_event.empty()) {
-        json sdf_event_json;
-        for (const auto& sdf_event_pair: sdf_object.sdf_event) {
-            sdf_event_json[sdf_event_pair.first] = SerializeSdfEvent(sdf_event_pair.second);
+        return true;
+    }
+
+    //! Function used to enter the frame for the object value of the current key
+    //! Returns false if the value does not describe a sdf element.
+    bool StartChildFrame() {
+        Frame& parent = frames.back();
+        const std::string& key = parent.key;
+        SdfReaderFrame kind;
+        void* element = nullptr;
+        switch (parent.kind) {
+            case SdfReaderFrame::kModel:
+                if (key == "info") {
+                    kind = SdfReaderFrame::kInformationBlock;
+                    element = &sdf_model->information_block.emplace();
+                } else if (key == "namespace") {
+                    kind = SdfReaderFrame::kNamespace;
+                    element = &sdf_model->namespace_block.emplace().namespaces;
+                } else if (key == "sdfThing") {
+                    kind = SdfReaderFrame::kSdfThings;
+                    element = &StartQuality(sdf_model->sdf_thing);
+                } else if (key == "sdfObject") {
+                    kind = SdfReaderFrame::kSdfObjects;
+                    element = &StartQuality(sdf_model->sdf_object);
+                } else if (!StartAffordanceMap(key, definitions, kind, element)) {
+                    // Top level affordances are only kept as definitions for sdfRef
+                    return false;
+                }
+                break;
+            case SdfReaderFrame::kMapping:
+                if (key == "info") {
+                    kind = SdfReaderFrame::kInformationBlock;
+                    element = &sdf_mapping->information_block.emplace();
+                } else if (key == "namespace") {
+                    kind = SdfReaderFrame::kNamespace;
+                    element = &sdf_mapping->namespace_block.emplace().namespaces;
+                } else if (key == "map") {
+                    kind = SdfReaderFrame::kMap;
+                    element = &StartQuality(sdf_mapping->map);
+                } else {
+                    return false;
+                }
+                break;
+            case SdfReaderFrame::kSdfThings:
+                kind = SdfReaderFrame::kSdfThing;
+                element = Emplace<SdfThing>(parent.element, key);
+                break;
+            case SdfReaderFrame::kSdfObjects:
+                kind = SdfReaderFrame::kSdfObject;
+                element = Emplace<SdfObject>(parent.element, key);
+                break;
+            case SdfReaderFrame::kSdfProperties:
+                kind = SdfReaderFrame::kSdfProperty;
+                element = Emplace<SdfProperty>(parent.element, key);
+                break;
+            case SdfReaderFrame::kSdfActions:
+                kind = SdfReaderFrame::kSdfAction;
+                element = Emplace<SdfAction>(parent.element, key);
+                break;
+            case SdfReaderFrame::kSdfEvents:
+                kind = SdfReaderFrame::kSdfEvent;
+                element = Emplace<SdfEvent>(parent.element, key);
+                break;
+            case SdfReaderFrame::kDataQualities:
+                kind = SdfReaderFrame::kDataQuality;
+                element = Emplace<DataQuality>(parent.element, key);
+                break;
+            case SdfReaderFrame::kSdfThing: {
+                auto* sdf_thing = static_cast<SdfThing*>(parent.element);
+                if (key == "sdfThing") {
+                    kind = SdfReaderFrame::kSdfThings;
+                    element = &StartQuality(sdf_thing->sdf_thing);
+                } else if (key == "sdfObject") {
+                    kind = SdfReaderFrame::kSdfObjects;
+                    element = &StartQuality(sdf_thing->sdf_object);
+                } else if (!StartAffordanceMap(key, *sdf_thing, kind, element)) {
+                    return false;
+                }
+                break;
+            }
+            case SdfReaderFrame::kSdfObject:
+                if (!StartAffordanceMap(key, *static_cast<SdfObject*>(parent.element), kind, element)) {
+                    return false;
+                }
+                break;
+            case SdfReaderFrame::kSdfAction: {
+                auto* sdf_action = static_cast<SdfAction*>(parent.element);
+                if (key == "sdfInputData") {
+                    kind = SdfReaderFrame::kDataQuality;
+                    element = &StartQuality(sdf_action->sdf_input_data).emplace();
+                } else if (key == "sdfOutputData") {
+                    kind = SdfReaderFrame::kDataQuality;
+                    element = &StartQuality(sdf_action->sdf_output_data).emplace();
+                } else if (key == "sdfData") {
+                    kind = SdfReaderFrame::kDataQualities;
+                    element = &StartQuality(sdf_action->sdf_data);
+                } else {
+                    return false;
+                }
+                break;
+            }
+            case SdfReaderFrame::kSdfEvent: {
+                auto* sdf_event = static_cast<SdfEvent*>(parent.element);
+                if (key == "sdfOutputData") {
+                    kind = SdfReaderFrame::kDataQuality;
+                    element = &StartQuality(sdf_event->sdf_output_data).emplace();
+                } else if (key == "sdfData") {
+                    kind = SdfReaderFrame::kDataQualities;
+                    element = &StartQuality(sdf_event->sdf_data);
+                } else {
+                    return false;
+                }
+                break;
+            }
+            case SdfReaderFrame::kSdfProperty:
+            case SdfReaderFrame::kDataQuality: {
+                // SdfProperty frames point to the SdfProperty, which is a DataQuality as well
+                auto* data_quality = parent.kind == SdfReaderFrame::kSdfProperty ?
+                        static_cast<SdfProperty*>(parent.element) : static_cast<DataQuality*>(parent.element);
+                if (key == "sdfChoice") {
+                    kind = SdfReaderFrame::kDataQualities;
+                    element = &StartQuality(data_quality->sdf_choice);
+                } else if (key == "properties") {
+                    kind = SdfReaderFrame::kDataQualities;
+                    element = &StartQuality(data_quality->properties);
+                } else if (key == "items") {
+                    kind = SdfReaderFrame::kJsoItem;
+                    element = &StartQuality(data_quality->items).emplace();
+                } else {
+                    return false;
+                }
+                break;
+            }
+            case SdfReaderFrame::kJsoItem: {
+                auto* jso_item = static_cast<JsoItem*>(parent.element);
+                if (key == "sdfChoice") {
+                    kind = SdfReaderFrame::kDataQualities;
+                    element = &StartQuality(jso_item->sdf_choice);
+                } else if (key == "properties") {
+                    kind = SdfReaderFrame::kDataQualities;
+                    element = &StartQuality(jso_item->properties);
+                } else {
+                    return false;
+                }
+                break;
+            }
+            case SdfReaderFrame::kMap:
+                kind = SdfReaderFrame::kMapEntry;
+                element = Emplace<OrderedMap<std::string, MappingValue>>(parent.element, key);
+                break;
+            default:
+                return false;
         }
-        sdf_object_json["sdfEvent"] = sdf_event_json;
-    }
 
-    // Serialize the sdf_data
-    if (!sdf_object.sdf_data.empty()) {
-        sdf_object_json["sdfData"] = SerializeSdfData(sdf_object.sdf_data);
+        std::size_t pointer_length = pointer.size();
+        pointer.append("/").append(EscapeJsonPointerToken(key));
+        frames.push_back({kind, element, "", pointer_length});
+        return true;
+    }
+
+    //! Function used to start capturing a json value that does not describe a sdf element
+    bool StartCapture(json value) {
+        if (capture_stack.empty()) {
+            captured = std::move(value);
+            capture_stack.push_back(&captured);
+        } else if (capture_stack.back()->is_array()) {
+            capture_stack.back()->push_back(std::move(value));
+            capture_stack.push_back(&capture_stack.back()->back());
+        } else {
+            json& member = (*capture_stack.back())[capture_key];
+            member = std::move(value);
+            capture_stack.push_back(&member);
+        }
+        return true;
     }
 
-    // Serialize the remaining fields
-    if (sdf_object.min_items.has_value()) {
-        sdf_object_json["minItems"] = sdf_object.min_items.value();
+    //! Function used to end the currently captured json object or array
+    bool EndCapture() {
+        capture_stack.pop_back();
+        if (capture_stack.empty() and !frames.empty()) {
+            AssignValue(frames.back(), captured);
+        }
+        return true;
     }
 
-    if (sdf_object.max_items.has_value()) {
-        sdf_object_json["maxItems"] = sdf_object.max_items.value();
+    //! Function used to hand a primitive value to the current capture or frame
+    bool Value(json value) {
+        if (!capture_stack.empty()) {
+            if (capture_stack.back()->is_array()) {
+                capture_stack.back()->push_back(std::move(value));
+            } else {
+                (*capture_stack.back())[capture_key] = std::move(value);
+            }
+        } else if (!frames.empty()) {
+            AssignValue(frames.back(), value);
+        }
+        return true;
     }
 
-    return sdf_object_json;
-}
-
-//! Function used to serialize a sdfThing into the json format.
-json SerializeSdfThing(const SdfThing& sdf_thing) {
-    json sdf_thing_json;
-    // Serialize the common qualities
-    SerializeCommonQualities(sdf_thing, sdf_thing_json);
-
-    // Serialize the sdfThings
-    if (!sdf_thing.sdf_thing.empty()) {
-        json nested_sdf_thing_json;
-        for (const auto& sdf_thing_pair: sdf_thing.sdf_thing) {
-            nested_sdf_thing_json[sdf_thing_pair.first] = SerializeSdfThing(sdf_thing_pair.second);
+    //! Function used to record the sdfRef of the element at the current position
+    void RecordSdfRef(const json& value) {
+        if (value.is_null()) {
+            sdf_ref_sites.erase(pointer);
+        } else {
+            sdf_ref_sites[pointer].sdf_ref = value.get<std::string>();
         }
-        sdf_thing_json["sdfThing"] = nested_sdf_thing_json;
     }
 
-    // Serialize the sdfObjects
-    if (!sdf_thing.sdf_object.empty()) {
-        json sdf_object_json;
-        for (const auto& sdf_object_pair: sdf_thing.sdf_object) {
-            sdf_object_json[sdf_object_pair.first] = SerializeSdfObject(sdf_object_pair.second);
+    //! Function used to assign a value to the field of the current frame with the same key.
+    void AssignValue(Frame& frame, json& value) {
+        const std::string& key = frame.key;
+        switch (frame.kind) {
+            case SdfReaderFrame::kModel:
+            case SdfReaderFrame::kMapping:
+                if (key == "defaultNamespace") {
+                    value.get_to(default_namespace);
+                }
+                break;
+            case SdfReaderFrame::kInformationBlock:
+                AssignQuality(key, value, *static_cast<InformationBlock*>(frame.element));
+                break;
+            case SdfReaderFrame::kNamespace:
+                (*static_cast<OrderedMap<std::string, std::string>*>(frame.element))[key] = value;
+                break;
+            // Values that are not objects do not describe elements, but still replace an element with the same name
+            case SdfReaderFrame::kSdfThings:
+                EraseElement<SdfThing>(frame.element, key);
+                break;
+            case SdfReaderFrame::kSdfObjects:
+                EraseElement<SdfObject>(frame.element, key);
+                break;
+            case SdfReaderFrame::kSdfProperties:
+                EraseElement<SdfProperty>(frame.element, key);
+                break;
+            case SdfReaderFrame::kSdfActions:
+                EraseElement<SdfAction>(frame.element, key);
+                break;
+            case SdfReaderFrame::kSdfEvents:
+                EraseElement<SdfEvent>(frame.element, key);
+                break;
+            case SdfReaderFrame::kDataQualities:
+                EraseElement<DataQuality>(frame.element, key);
+                break;
+            case SdfReaderFrame::kSdfThing:
+                ReplacedValue(ReplaceQuality(key, value, *static_cast<SdfThing*>(frame.element)), key);
+                break;
+            case SdfReaderFrame::kSdfObject:
+                ReplacedValue(ReplaceQuality(key, value, *static_cast<SdfObject*>(frame.element)), key);
+                break;
+            case SdfReaderFrame::kSdfProperty:
+                ReplacedValue(ReplaceQuality(key, value, *static_cast<SdfProperty*>(frame.element)), key);
+                break;
+            case SdfReaderFrame::kSdfAction:
+                ReplacedValue(ReplaceQuality(key, value, *static_cast<SdfAction*>(frame.element)), key);
+                break;
+            case SdfReaderFrame::kSdfEvent:
+                ReplacedValue(ReplaceQuality(key, value, *static_cast<SdfEvent*>(frame.element)), key);
+                break;
+            case SdfReaderFrame::kDataQuality:
+                ReplacedValue(ReplaceQuality(key, value, *static_cast<DataQuality*>(frame.element)), key);
+                break;
+            case SdfReaderFrame::kJsoItem:
+                ReplacedValue(ReplaceQuality(key, value, *static_cast<JsoItem*>(frame.element)), key);
+                break;
+            case SdfReaderFrame::kMapEntry:
+                (*static_cast<OrderedMap<std::string, MappingValue>*>(frame.element))[key] = value;
+                break;
+            default:
+                break;
         }
-        sdf_thing_json["sdfObject"] = sdf_object_json;
-    }
 
-    // Serialize the sdfProperties
-    if (!sdf_thing.sdf_property.empty()) {
-        json sdf_property_json;
-        for (const auto& sdf_property_pair: sdf_thing.sdf_property) {
-            sdf_property_json[sdf_property_pair.first] = SerializeSdfProperty(sdf_property_pair.second);
+        if (frame.kind >= SdfReaderFrame::kSdfThings and frame.kind <= SdfReaderFrame::kJsoItem) {
+            // Null values remove qualities and elements in a merge patch, which the parsed objects cannot express
+            if (value.is_null()) {
+                null_qualities.insert(QualityPointer(key));
+            }
+            if (key == "sdfRef" and frame.kind >= SdfReaderFrame::kSdfThing) {
+                RecordSdfRef(value);
+            }
         }
-        sdf_thing_json["sdfProperty"] = sdf_property_json;
     }
 
-    // Serialize the sdfActions
-    if (!sdf_thing.sdf_action.empty()) {
-        json sdf_action_json;
-        for (const auto& sdf_action_pair: sdf_thing.sdf_action) {
-            sdf_action_json[sdf_action_pair.first] = SerializeSdfAction(sdf_action_pair.second);
+    //! Function used to find the element a json pointer points to.
+    //! The lookup walks the parsed objects, as elements get replaced while resolving.
+    SdfElement FindElement(const std::string& element_pointer) {
+        std::list<std::string> tokens = SplitJsonPointer(element_pointer);
+        if (tokens.size() < 2) {
+            return {};
         }
-        sdf_thing_json["sdfAction"] = sdf_action_json;
-    }
 
-    // Serialize the sdfEvents
-    if (!sdf_thing.sdf_event.empty()) {
-        json sdf_event_json;
-        for (const auto& sdf_event_pair: sdf_thing.sdf_event) {
-            sdf_event_json[sdf_event_pair.first] = SerializeSdfEvent(sdf_event_pair.second);
+        // Top level affordances are kept as definitions
+        std::string quality = tokens.front();
+        tokens.pop_front();
+        std::string name = tokens.front();
+        tokens.pop_front();
+        SdfElement element;
+        if (quality == "sdfThing") {
+            element = FindSdfElement(sdf_model->sdf_thing, name);
+        } else if (quality == "sdfObject") {
+            element = FindSdfElement(sdf_model->sdf_object, name);
+        } else {
+            element = FindSdfAffordance(definitions, quality, name);
         }
-        sdf_thing_json["sdfEvent"] = sdf_event_json;
-    }
 
-    // Serialize the sdfData
-    if (!sdf_thing.sdf_data.empty())
-        sdf_thing_json["sdfData"] = SerializeSdfData(sdf_thing.sdf_data);;
+        while (!tokens.empty() and !std::holds_alternative<std::monostate>(element)) {
+            quality = tokens.front();
+            tokens.pop_front();
+            DataQuality* data_quality = nullptr;
+            if (std::holds_alternative<SdfProperty*>(element)) {
+                data_quality = std::get<SdfProperty*>(element);
+            } else if (std::holds_alternative<DataQuality*>(element)) {
+                data_quality = std::get<DataQuality*>(element);
+            }
 
-    // Serialize the remaining fields
-    if (sdf_thing.min_items.has_value()) {
-        sdf_thing_json["minItems"] = sdf_thing.min_items.value();
-    }
+            // Qualities that contain a single element
+            if (quality == "sdfInputData" and std::holds_alternative<SdfAction*>(element)) {
+                element = FindSdfElement(std::get<SdfAction*>(element)->sdf_input_data);
+            } else if (quality == "sdfOutputData" and std::holds_alternative<SdfAction*>(element)) {
+                element = FindSdfElement(std::get<SdfAction*>(element)->sdf_output_data);
+            } else if (quality == "sdfOutputData" and std::holds_alternative<SdfEvent*>(element)) {
+                element = FindSdfElement(std::get<SdfEvent*>(element)->sdf_output_data);
+            } else if (quality == "items" and data_quality != nullptr) {
+                element = FindSdfElement(data_quality->items);
+            }
+            // Qualities that contain a map of elements
+            else if (tokens.empty()) {
+                return {};
+            } else {
+                name = tokens.front();
+                tokens.pop_front();
+                if (std::holds_alternative<SdfThing*>(element)) {
+                    auto* sdf_thing = std::get<SdfThing*>(element);
+                    if (quality == "sdfThing") {
+                        element = FindSdfElement(sdf_thing->sdf_thing, name);
+                    } else if (quality == "sdfObject") {
+                        element = FindSdfElement(sdf_thing->sdf_object, name);
+                    } else {
+                        element = FindSdfAffordance(*sdf_thing, quality, name);
+                    }
+                } else if (std::holds_alternative<SdfObject*>(element)) {
+                    element = FindSdfAffordance(*std::get<SdfObject*>(element), quality, name);
+                } else if (quality == "sdfData" and std::holds_alternative<SdfAction*>(element)) {
+                    element = FindSdfElement(std::get<SdfAction*>(element)->sdf_data, name);
+                } else if (quality == "sdfData" and std::holds_alternative<SdfEvent*>(element)) {
+                    element = FindSdfElement(std::get<SdfEvent*>(element)->sdf_data, name);
+                } else if (quality == "sdfChoice" and data_quality != nullptr) {
+                    element = FindSdfElement(data_quality->sdf_choice, name);
+                } else if (quality == "properties" and data_quality != nullptr) {
+                    element = FindSdfElement(data_quality->properties, name);
+                } else if (quality == "sdfChoice" and std::holds_alternative<JsoItem*>(element)) {
+                    element = FindSdfElement(std::get<JsoItem*>(element)->sdf_choice, name);
+                } else if (quality == "properties" and std::holds_alternative<JsoItem*>(element)) {
+                    element = FindSdfElement(std::get<JsoItem*>(element)->properties, name);
+                } else {
+                    return {};
+                }
+            }
+        }
 
-    if (sdf_thing.max_items.has_value()) {
-        sdf_thing_json["maxItems"] = sdf_thing.max_items.value();
+        return element;
+    }
+
+    //! Function used to remove the qualities and elements below the given json pointer that are null in the model.
+    //! The null values are only part of the first merge, afterwards they are removed like in the merged json.
+    void ClearNullQualities(const std::string& site_pointer) {
+        std::string prefix = site_pointer + "/";
+        auto iter = null_qualities.lower_bound(prefix);
+        while (iter != null_qualities.end() and iter->compare(0, prefix.size(), prefix) == 0) {
+            std::size_t separator = iter->rfind('/');
+            std::string parent_pointer = iter->substr(0, separator);
+            std::string key = SplitJsonPointer(iter->substr(separator)).back();
+            SdfElement parent = FindElement(parent_pointer);
+            if (!std::holds_alternative<std::monostate>(parent)) {
+                ClearQuality(parent, key);
+            } else {
+                // The null value replaces an element inside of a map quality
+                std::size_t map_separator = parent_pointer.rfind('/');
+                ClearQualityElement(FindElement(parent_pointer.substr(0, map_separator)),
+                                    SplitJsonPointer(parent_pointer.substr(map_separator)).back(), key);
+            }
+            iter = null_qualities.erase(iter);
+        }
     }
 
-    return sdf_thing_json;
-}
-
-//! Function used to serialize a namespace block into the json format.
-json SerializeNamespaceBlock(const NamespaceBlock& namespace_block) {
-    json namespace_block_json;
-    if (!namespace_block.namespaces.empty()) {
-        namespace_block_json["namespace"] = namespace_block.namespaces;
+    //! Function used to resolve all sdfRefs that affect the element at the given json pointer.
+    //! Enclosing elements get resolved first, as their resolution can replace the element, followed by the element
+    //! itself and everything below it.
+    void ResolveSdfRefPath(const std::string& element_pointer) {
+        for (std::size_t pos = element_pointer.find('/', 1); pos != std::string::npos;
+             pos = element_pointer.find('/', pos + 1)) {
+            ResolveSdfRefSite(element_pointer.substr(0, pos));
+        }
+        ResolveSdfRefSite(element_pointer);
+        ResolveSdfRefSubtree(element_pointer);
     }
 
-    if (!namespace_block.default_namespace.empty()) {
-        namespace_block_json["default_namespace"] = namespace_block.default_namespace;
+    //! Function used to resolve all sdfRefs below the given json pointer.
+    //! The sites are ordered by their json pointer, so enclosing elements are resolved first.
+    void ResolveSdfRefSubtree(const std::string& subtree_pointer) {
+        std::string prefix = subtree_pointer + "/";
+        for (auto iter = sdf_ref_sites.lower_bound(prefix);
+             iter != sdf_ref_sites.end() and iter->first.compare(0, prefix.size(), prefix) == 0; iter++) {
+            ResolveSdfRefSite(iter->first);
+        }
     }
 
-    return namespace_block_json;
-}
-
-//! Function used to serialize an information block into the json format.
-json SerializeInformationBlock(const InformationBlock& information_block) {
-    json info_block_json;
-    if (!information_block.title.empty()) {
-        info_block_json["title"] = information_block.title;
-    }
+    //! Function used to resolve the sdfRef of the element at the given json pointer.
+    //! This function implements the procedure described in section 4.4 of the sdf specification on the parsed
+    //! objects. The target gets resolved completely before it is merged, so a chain of sdfRefs ends at the qualities
+    //! of its last target. The merge happens before the nested sdfRefs of the element get resolved.
+    void ResolveSdfRefSite(const std::string& site_pointer) {
+        auto site = sdf_ref_sites.find(site_pointer);
+        if (site == sdf_ref_sites.end() or site->second.resolving or site->second.resolved) {
+            return;
+        }
+        site->second.resolving = true;
+        for (std::size_t pos = site_pointer.find('/', 1); pos != std::string::npos;
+             pos = site_pointer.find('/', pos + 1)) {
+            ResolveSdfRefSite(site_pointer.substr(0, pos));
+        }
 
-    if (!information_block.description.empty()) {
-        info_block_json["description"] = information_block.description;
-    }
+        const std::string& sdf_ref = site->second.sdf_ref;
+        if (sdf_ref.rfind("#/", 0) == 0) {
+            std::string target_pointer = sdf_ref.substr(1);
+            ResolveSdfRefPath(target_pointer);
+
+            SdfElement target = FindElement(target_pointer);
+            SdfElement element = FindElement(site_pointer);
+            if (!std::holds_alternative<std::monostate>(target) and !std::holds_alternative<std::monostate>(element)) {
+                profiler::Count("sdf_ref_resolutions");
+                // Apply the Merge Patch Algorithm [RFC7396] with the referencing element as the patch
+                std::visit([](auto sdf_element, auto sdf_target) {
+                    if constexpr (!std::is_same_v<decltype(sdf_element), std::monostate> and
+                                  !std::is_same_v<decltype(sdf_target), std::monostate>) {
+                        ApplySdfRef(*sdf_element, *sdf_target);
+                    }
+                }, element, target);
+                ClearNullQualities(site_pointer);
+            }
+        }
 
-    if (!information_block.version.empty()) {
-        info_block_json["version"] = information_block.version;
+        site->second.resolving = false;
+        site->second.resolved = true;
+        ResolveSdfRefSubtree(site_pointer);
     }
 
-    if (!information_block.modified.empty()) {
-        info_block_json["modified"] = information_block.modified;
-    }
+    //! Function used to complete the parsed objects after the end of the document.
+    void Finish() {
+        if (sdf_mapping != nullptr) {
+            if (sdf_mapping->namespace_block.has_value()) {
+                sdf_mapping->namespace_block->default_namespace = default_namespace;
+            }
+            // References without any field are not part of the mapping
+            for (auto iter = sdf_mapping->map.begin(); iter != sdf_mapping->map.end();) {
+                iter = iter->second.empty() ? sdf_mapping->map.erase(iter) : std::next(iter);
+            }
+            return;
+        }
 
-    if (!information_block.copyright.empty()) {
-        info_block_json["copyright"] = information_block.copyright;
-    }
+        if (sdf_model->namespace_block.has_value()) {
+            sdf_model->namespace_block->default_namespace = default_namespace;
+        }
 
-    if (!information_block.license.empty()) {
-        info_block_json["license"] = information_block.license;
-    }
+        // Definitions only get resolved if they are referenced
+        for (const auto& site : sdf_ref_sites) {
+            if (site.first.rfind("/sdfThing/", 0) == 0 or site.first.rfind("/sdfObject/", 0) == 0) {
+                ResolveSdfRefSite(site.first);
+            }
+        }
 
-    if (!information_block.features.empty()) {
-        info_block_json["features"] = information_block.features;
+        // As in ParseSdfModel, the sdfObjects are only used if no sdfThing exists
+        if (!sdf_model->sdf_thing.empty()) {
+            sdf_model->sdf_object.clear();
+        }
     }
 
-    if (!information_block.comment.empty()) {
-        info_block_json["comment"] = information_block.comment;
+    //! Output objects, only one of them is set
+    SdfModel* sdf_model = nullptr;
+    SdfMapping* sdf_mapping = nullptr;
+    //! Top level affordances which are only used as targets for sdfRef
+    SdfThing definitions;
+    //! The defaultNamespace quality of the namespace block
+    std::string default_namespace;
+    //! Stack of the currently open sdf elements
+    std::vector<Frame> frames;
+    //! Json pointer to the element of the current frame
+    std::string pointer;
+    //! Value that is currently captured, with the stack of its open objects and arrays
+    json captured;
+    std::vector<json*> capture_stack;
+    std::string capture_key;
+    //! Elements with a sdfRef ordered by their json pointer
+    std::map<std::string, SdfRefSite> sdf_ref_sites;
+    //! Json pointers of all qualities of sdf elements and elements of maps with a null value
+    std::set<std::string> null_qualities;
+};
+
+//! Function used to hand a json value to a sax parser as if it was read from a file.
+bool EmitSaxEvents(const json& value, nlohmann::json_sax<json>& handler) {
+    switch (value.type()) {
+        case json::value_t::object:
+            if (!handler.start_object(value.size())) {
+                return false;
+            }
+            for (const auto& item : value.items()) {
+                std::string key = item.key();
+                if (!handler.key(key) or !EmitSaxEvents(item.value(), handler)) {
+                    return false;
+                }
+            }
+            return handler.end_object();
+        case json::value_t::array:
+            if (!handler.start_array(value.size())) {
+                return false;
+            }
+            for (const auto& element : value) {
+                if (!EmitSaxEvents(element, handler)) {
+                    return false;
+                }
+            }
+            return handler.end_array();
+        case json::value_t::string: {
+            std::string str = value.get<std::string>();
+            return handler.string(str);
+        }
+        case json::value_t::boolean:
+            return handler.boolean(value.get<bool>());
+        case json::value_t::number_integer:
+            return handler.number_integer(value.get<json::number_integer_t>());
+        case json::value_t::number_unsigned:
+            return handler.number_unsigned(value.get<json::number_unsigned_t>());
+        case json::value_t::number_float:
+            return handler.number_float(value.get<json::number_float_t>(), "");
+        case json::value_t::binary: {
+            json::binary_t binary = value.get_binary();
+            return handler.binary(binary);
+        }
+        default:
+            return handler.null();
     }
-
-    return info_block_json;
 }
 
-//! Function used to serialize a SdfModel object into the json format.
-json SerializeSdfModel(const SdfModel& sdf_model) {
-    json sdf_model_json;
-    // Serialize the information block
-    if (sdf_model.information_block.has_value()) {
-        sdf_model_json["info"] = SerializeInformationBlock(sdf_model.information_block.value());
-    }
+//! Function used to parse a sdf-model from json into a SdfModel object.
+SdfModel ParseSdfModel(json& sdf_model_json) {
+    SdfModel sdf_model;
+    SdfSaxHandler handler(sdf_model);
+    EmitSaxEvents(sdf_model_json, handler);
+    return sdf_model;
+}
 
-    // Serialize the namespace block
-    if (sdf_model.namespace_block.has_value()) {
-        sdf_model_json.push_back(SerializeNamespaceBlock(sdf_model.namespace_block.value()));
-    }
+//! Function used to parse a sdf-mapping from json into a SdfMapping object.
+SdfMapping ParseSdfMapping(json& sdf_mapping_json) {
+    SdfMapping sdf_mapping;
+    SdfSaxHandler handler(sdf_mapping);
+    EmitSaxEvents(sdf_mapping_json, handler);
+    return sdf_mapping;
+}
 
-    // Serialize the sdfThing, if one is present
-    if (!sdf_model.sdf_thing.empty()){
-        json sdf_thing_json;
-        for (const auto& sdf_thing_pair : sdf_model.sdf_thing) {
-            sdf_thing_json[sdf_thing_pair.first] = SerializeSdfThing(sdf_thing_pair.second);
-        }
-        sdf_model_json["sdfThing"] = sdf_thing_json;
+//! Function used to read a sdf-model from an input stream into a SdfModel object.
+SdfModel ReadSdfModel(std::istream& input) {
+    SdfModel sdf_model;
+    SdfSaxHandler handler(sdf_model);
+    if (!json::sax_parse(input, &handler)) {
+        throw std::runtime_error(handler.error);
     }
+    return sdf_model;
+}
 
-    // Otherwise serialize the sdfObject
-    else if (!sdf_model.sdf_object.empty()){
-        json sdf_object_json;
-        for (const auto& sdf_object_pair : sdf_model.sdf_object) {
-            sdf_object_json[sdf_object_pair.first] = SerializeSdfObject(sdf_object_pair.second);
-        }
-        sdf_model_json["sdfObject"] = sdf_object_json;
+//! Function used to read a sdf-mapping from an input stream into a SdfMapping object.
+SdfMapping ReadSdfMapping(std::istream& input) {
+    SdfMapping sdf_mapping;
+    SdfSaxHandler handler(sdf_mapping);
+    if (!json::sax_parse(input, &handler)) {
+        throw std::runtime_error(handler.error);
     }
-
-    return sdf_model_json;
+    return sdf_mapping;
 }
 
-//! Function used to serialize a SdfMapping object into the json format.
-json SerializeSdfMapping(const SdfMapping& sdf_mapping) {
-    json sdf_mapping_json;
-    // Serialize the information block
-    if (sdf_mapping.information_block.has_value()) {
-        sdf_mapping_json["info"] = SerializeInformationBlock(sdf_mapping.information_block.value());
+//! Function used to read a sdf-model from a contiguous buffer into a SdfModel object.
+SdfModel ReadSdfModel(const char* data, std::size_t size) {
+    SdfModel sdf_model;
+    SdfSaxHandler handler(sdf_model);
+    if (!json::sax_parse(data, data + size, &handler)) {
+        throw std::runtime_error(handler.error);
     }
+    return sdf_model;
+}
 
-    // Serialize the namespace block
-    if (sdf_mapping.namespace_block.has_value()) {
-        sdf_mapping_json.push_back(SerializeNamespaceBlock(sdf_mapping.namespace_block.value()));
+//! Function used to read a sdf-mapping from a contiguous buffer into a SdfMapping object.
+SdfMapping ReadSdfMapping(const char* data, std::size_t size) {
+    SdfMapping sdf_mapping;
+    SdfSaxHandler handler(sdf_mapping);
+    if (!json::sax_parse(data, data + size, &handler)) {
+        throw std::runtime_error(handler.error);
     }
-
-    // Serialize the mapping section
-    sdf_mapping_json["map"] = sdf_mapping.map;
-    return sdf_mapping_json;
+    return sdf_mapping;
 }
 
 } // namespace sdf
@@ -17,36 +17,37 @@
 #include <limits>
 #include "sdf_to_matter.h"
 #include "mapping.h"
+#include "profiler.h"
 
 //! This is a global pointer to the quality name current node
 //! This is designed to point at the top level sdf element like
 //! for example the `sdfThing` node, not a specific sdfThing
-static ReferenceTreeNode* current_quality_name_node = nullptr;
+static thread_local ReferenceTreeNode* current_quality_name_node = nullptr;
 
 //! This is a global pointer to the given name current node
 //! This is designed to point at the given name of an element
 //! for example the `OnOff` node, not a top level sdf element
-static ReferenceTreeNode* current_given_name_node = nullptr;
+static thread_local ReferenceTreeNode* current_given_name_node = nullptr;
 
 //! List containing required sdf elements
 //! This list gets filled while mapping and afterward appended to the corresponding sdfModel
-static std::list<std::string> sdf_required_list;
+static thread_local std::list<std::string> sdf_required_list;
 
 //! Map containing enums
 //! This map is used when the sdf enum quality gets translated into a Matter enum
-static std::map<std::string, std::list<matter::Item>> global_enum_map;
+static thread_local std::map<std::string, std::list<matter::Item>> global_enum_map;
 
 //! Map containing structs
 //! This map is used when an object type data quality gets translated into a global struct
-static std::map<std::string, matter::Struct> global_struct_map;
+static thread_local std::map<std::string, matter::Struct> global_struct_map;
 
 //! Map containing bitmaps
 //! This map is used when a bitfield compatible set of data qualities gets translated
-static std::map<std::string, std::list<matter::Bitfield>> global_bitmap_map;
+static thread_local std::map<std::string, std::list<matter::Bitfield>> global_bitmap_map;
 
 //! Map containing the elements of the sdf mapping
 //! This map is used to resolve the elements outsourced into the map
-static json reference_map;
+static thread_local json reference_map;
 
 //! Function used to check, if the given pointer is part of a sdfRequired element.
 //! This function works with a JSON pointer as well as the name of the structure.
@@ -1327,6 +1328,7 @@ std::list<matter::DataField> MapSdfChoice(const sdf::DataQuality& data_quality)
 //! This function also maps the sdfOutputData to a list of Matter data fields.
 //! The function returns the created Matter event.
 matter::Event MapSdfEvent(const std::pair<std::string, sdf::SdfEvent>& sdf_event_pair) {
+    profiler::Count("sdf_events_mapped");
     matter::Event event;
     auto* sdf_event_reference = new ReferenceTreeNode(sdf_event_pair.first);
     current_quality_name_node->AddChild(sdf_event_reference);
@@ -1372,6 +1374,7 @@ matter::Event MapSdfEvent(const std::pair<std::string, sdf::SdfEvent>& sdf_event
 //! The function return a pair of a client command and an optional server command.
 std::pair<matter::Command, std::optional<matter::Command>> MapSdfAction(const std::pair<std::string,
                                                                         sdf::SdfAction>& sdf_action_pair) {
+    profiler::Count("sdf_actions_mapped");
     matter::Command client_command;
     auto* sdf_action_reference = new ReferenceTreeNode(sdf_action_pair.first);
     current_quality_name_node->AddChild(sdf_action_reference);
@@ -1502,6 +1505,7 @@ std::pair<matter::Command, std::optional<matter::Command>> MapSdfAction(const st
 //! Function used to map a sdfProperty onto a Matter attribute.
 //! The function returns the generated Matter attribute.
 matter::Attribute MapSdfProperty(const std::pair<std::string, sdf::SdfProperty>& sdf_property_pair) {
+    profiler::Count("sdf_properties_mapped");
     matter::Attribute attribute;
     auto* sdf_property_reference = new ReferenceTreeNode(sdf_property_pair.first);
     current_quality_name_node->AddChild(sdf_property_reference);
@@ -1688,6 +1692,8 @@ matter::ClusterClassification GenerateClusterClassification() {
 //! Function used to map a sdfObject onto a Matter cluster.
 //! The function returns the generated Matter cluster.
 matter::Cluster MapSdfObject(const std::pair<std::string, sdf::SdfObject>& sdf_object_pair) {
+    profiler::ScopedTimer timer("MapSdfObject", sdf_object_pair.first);
+    profiler::Count("sdf_objects_mapped");
     matter::Cluster cluster;
     auto* sdf_object_reference = new ReferenceTreeNode(sdf_object_pair.first);
     current_quality_name_node->AddChild(sdf_object_reference);
@@ -1929,11 +1935,18 @@ matter::Device MapSdfThing(const std::pair<std::string, sdf::SdfThing>& sdf_thin
 //! If the sdf-model does not contain a sdfThing, no device type gets created.
 int MapSdfToMatter(const sdf::SdfModel& sdf_model, const sdf::SdfMapping& sdf_mapping,
                    std::optional<matter::Device>& optional_device, std::list<matter::Cluster>& cluster_list) {
+    // The state of a previous conversion on this thread must not leak into this one
+    current_quality_name_node = nullptr;
+    current_given_name_node = nullptr;
+    sdf_required_list.clear();
+    global_enum_map.clear();
+    global_struct_map.clear();
+    global_bitmap_map.clear();
+
     // Make the mapping a global variable
     // This will be used to import information from the mapping
-    if (!sdf_mapping.map.empty()) {
-        reference_map = sdf_mapping.map;
-    }
+    reference_map = sdf_mapping.map;
+    profiler::Count("mapping_entries", sdf_mapping.map.size());
 
     // Initialize a reference tree used to generate json pointer
     // This is used in combination with the mapping
@@ -0,0 +1,448 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <charconv>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include "writer.h"
+
+BufferedWriter::BufferedWriter(int fd, std::size_t buffer_size) : fd(fd), capacity(buffer_size) {
+    buffer.reserve(capacity);
+}
+
+BufferedWriter::~BufferedWriter() {
+    Flush();
+}
+
+//! Function used to append data to the output
+//! Data that is larger than the buffer gets handed to the file descriptor directly.
+void BufferedWriter::Write(const char* data, std::size_t size) {
+    if (buffer.size() + size > capacity) {
+        Flush();
+        if (size >= capacity) {
+            while (size > 0 and !failed) {
+                ssize_t written = ::write(fd, data, size);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    failed = true;
+                    return;
+                }
+                data += written;
+                size -= written;
+            }
+            return;
+        }
+    }
+    buffer.insert(buffer.end(), data, data + size);
+}
+
+//! Function used to hand the buffered output to the file descriptor
+int BufferedWriter::Flush() {
+    const char* data = buffer.data();
+    std::size_t size = buffer.size();
+    while (size > 0 and !failed) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        data += written;
+        size -= written;
+    }
+    buffer.clear();
+    return failed ? -1 : 0;
+}
+
+void JsonWriter::NewLine(std::size_t depth) {
+    output.Put('\n');
+    for (std::size_t i = 0; i < depth * indent; i++) {
+        output.Put(' ');
+    }
+}
+
+void JsonWriter::BeforeValue() {
+    if (!frames.empty() and !frames.back().object) {
+        if (frames.back().count > 0) {
+            output.Put(',');
+        }
+        frames.back().count++;
+        NewLine(frames.size());
+    }
+}
+
+void JsonWriter::BeginObject() {
+    BeforeValue();
+    // The opening bracket gets written together with the first member
+    frames.push_back({true, false, 0});
+}
+
+void JsonWriter::EndObject(bool null_if_empty) {
+    Frame frame = frames.back();
+    frames.pop_back();
+    if (!frame.opened) {
+        output.Write(null_if_empty ? "null" : "{}", null_if_empty ? 4 : 2);
+        return;
+    }
+    NewLine(frames.size());
+    output.Put('}');
+}
+
+void JsonWriter::BeginArray() {
+    BeforeValue();
+    output.Put('[');
+    frames.push_back({false, true, 0});
+}
+
+void JsonWriter::EndArray() {
+    Frame frame = frames.back();
+    frames.pop_back();
+    if (frame.count > 0) {
+        NewLine(frames.size());
+    }
+    output.Put(']');
+}
+
+void JsonWriter::Key(const std::string& key) {
+    Frame& frame = frames.back();
+    if (!frame.opened) {
+        output.Put('{');
+        frame.opened = true;
+    } else {
+        output.Put(',');
+    }
+    frame.count++;
+    NewLine(frames.size());
+    WriteEscaped(key);
+    output.Write(": ", 2);
+}
+
+//! Function used to write a escaped string
+//! Escapes the same characters as the json library does without ensuring ascii output. Unlike the json library, the
+//! string does not get checked for valid UTF-8. Invalid bytes are written unchanged instead of throwing type_error.316.
+void JsonWriter::WriteEscaped(const std::string& value) {
+    static const char hex_digits[] = "0123456789abcdef";
+    output.Put('"');
+    for (char ch : value) {
+        switch (ch) {
+            case '"': output.Write("\\\"", 2); break;
+            case '\\': output.Write("\\\\", 2); break;
+            case '\b': output.Write("\\b", 2); break;
+            case '\f': output.Write("\\f", 2); break;
+            case '\n': output.Write("\\n", 2); break;
+            case '\r': output.Write("\\r", 2); break;
+            case '\t': output.Write("\\t", 2); break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char escaped[6] = {'\\', 'u', '0', '0', hex_digits[(ch >> 4) & 0x0F], hex_digits[ch & 0x0F]};
+                    output.Write(escaped, 6);
+                } else {
+                    output.Put(ch);
+                }
+        }
+    }
+    output.Put('"');
+}
+
+void JsonWriter::String(const std::string& value) {
+    BeforeValue();
+    WriteEscaped(value);
+}
+
+void JsonWriter::Integer(int64_t value) {
+    BeforeValue();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    output.Write(digits, result.ptr - digits);
+}
+
+void JsonWriter::Unsigned(uint64_t value) {
+    BeforeValue();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    output.Write(digits, result.ptr - digits);
+}
+
+//! Function used to write a floating point number
+//! Uses the shortest representation that round-trips and formats it like the json library, which prints numbers
+//! with a decimal exponent between -4 and 15 without exponent and always adds a fraction.
+void JsonWriter::Float(double value) {
+    BeforeValue();
+    if (!std::isfinite(value)) {
+        output.Write("null", 4);
+        return;
+    }
+    if (value == 0) {
+        if (std::signbit(value)) {
+            output.Write("-0.0", 4);
+        } else {
+            output.Write("0.0", 3);
+        }
+        return;
+    }
+    if (value < 0) {
+        output.Put('-');
+        value = -value;
+    }
+
+    // Split the scientific representation into its digits and the decimal exponent
+    char scientific[32];
+    auto result = std::to_chars(scientific, scientific + sizeof(scientific), value, std::chars_format::scientific);
+    std::string digits;
+    const char* position = scientific;
+    for (; position != result.ptr and *position != 'e'; position++) {
+        if (*position != '.') {
+            digits.push_back(*position);
+        }
+    }
+    int exponent = 0;
+    std::from_chars(position + 1 + (position[1] == '+'), result.ptr, exponent);
+
+    int k = static_cast<int>(digits.size());
+    int n = exponent + 1;
+    std::string formatted;
+    if (k <= n and n <= 15) {
+        // digits[000].0
+        formatted = digits + std::string(n - k, '0') + ".0";
+    } else if (0 < n and n <= 15) {
+        // dig.its
+        formatted = digits.substr(0, n) + "." + digits.substr(n);
+    } else if (-4 < n and n <= 0) {
+        // 0.[000]digits
+        formatted = "0." + std::string(-n, '0') + digits;
+    } else {
+        // d.igitsE+123
+        formatted = digits.substr(0, 1);
+        if (k > 1) {
+            formatted += "." + digits.substr(1);
+        }
+        int e = n - 1;
+        formatted += e < 0 ? "e-" : "e+";
+        e = std::abs(e);
+        if (e < 10) {
+            formatted += "0";
+        }
+        formatted += std::to_string(e);
+    }
+    output.Write(formatted);
+}
+
+void JsonWriter::Boolean(bool value) {
+    BeforeValue();
+    if (value) {
+        output.Write("true", 4);
+    } else {
+        output.Write("false", 5);
+    }
+}
+
+void JsonWriter::Null() {
+    BeforeValue();
+    output.Write("null", 4);
+}
+
+//! Function used to write an already existing json value
+//! Used for the parts of the sdf-mapping that are kept as json.
+void JsonWriter::Json(const nlohmann::ordered_json& value) {
+    switch (value.type()) {
+        case nlohmann::ordered_json::value_t::object:
+            BeginObject();
+            for (const auto& item : value.items()) {
+                Key(item.key());
+                Json(item.value());
+            }
+            EndObject(false);
+            break;
+        case nlohmann::ordered_json::value_t::array:
+            BeginArray();
+            for (const auto& item : value) {
+                Json(item);
+            }
+            EndArray();
+            break;
+        case nlohmann::ordered_json::value_t::string:
+            String(value.get_ref<const std::string&>());
+            break;
+        case nlohmann::ordered_json::value_t::boolean:
+            Boolean(value.get<bool>());
+            break;
+        case nlohmann::ordered_json::value_t::number_integer:
+            Integer(value.get<int64_t>());
+            break;
+        case nlohmann::ordered_json::value_t::number_unsigned:
+            Unsigned(value.get<uint64_t>());
+            break;
+        case nlohmann::ordered_json::value_t::number_float:
+            Float(value.get<double>());
+            break;
+        default:
+            Null();
+    }
+}
+
+nlohmann::ordered_json& JsonBuilder::Value() {
+    if (containers.empty()) {
+        return root;
+    }
+    nlohmann::ordered_json& container = *containers.back();
+    if (container.is_array()) {
+        container.push_back(nullptr);
+        return container.back();
+    }
+    return container[next_key];
+}
+
+void JsonBuilder::BeginObject() {
+    nlohmann::ordered_json& value = Value();
+    value = nlohmann::ordered_json::object();
+    containers.push_back(&value);
+}
+
+void JsonBuilder::EndObject(bool null_if_empty) {
+    nlohmann::ordered_json& value = *containers.back();
+    containers.pop_back();
+    if (null_if_empty and value.empty()) {
+        value = nullptr;
+    }
+}
+
+void JsonBuilder::BeginArray() {
+    nlohmann::ordered_json& value = Value();
+    value = nlohmann::ordered_json::array();
+    containers.push_back(&value);
+}
+
+void JsonBuilder::EndArray() {
+    containers.pop_back();
+}
+
+void XmlWriter::Declaration() {
+    output.Write("<?xml version=\"1.0\"?>\n", 22);
+}
+
+void XmlWriter::NewLine(std::size_t depth) {
+    output.Put('\n');
+    for (std::size_t i = 0; i < depth; i++) {
+        output.Put('\t');
+    }
+}
+
+void XmlWriter::StartElement(const char* name) {
+    if (start_tag_open) {
+        output.Put('>');
+    }
+    if (!elements.empty()) {
+        NewLine(elements.size());
+    }
+    output.Put('<');
+    output.Write(name, std::strlen(name));
+    elements.push_back(name);
+    start_tag_open = true;
+}
+
+void XmlWriter::EndElement() {
+    const char* name = elements.back();
+    elements.pop_back();
+    if (start_tag_open) {
+        output.Write(" />", 3);
+        start_tag_open = false;
+    } else {
+        NewLine(elements.size());
+        output.Write("</", 2);
+        output.Write(name, std::strlen(name));
+        output.Put('>');
+    }
+    // The document ends with a newline after the root element
+    if (elements.empty()) {
+        output.Put('\n');
+    }
+}
+
+void XmlWriter::BeginAttribute(const char* name) {
+    output.Put(' ');
+    output.Write(name, std::strlen(name));
+    output.Write("=\"", 2);
+}
+
+//! Function used to write a escaped attribute value
+//! Escapes the same characters as pugixml does for double quoted attributes, including all control characters.
+void XmlWriter::WriteEscaped(const char* value) {
+    for (; *value != '\0'; value++) {
+        auto ch = static_cast<unsigned char>(*value);
+        switch (ch) {
+            case '&': output.Write("&amp;", 5); break;
+            case '<': output.Write("&lt;", 4); break;
+            case '>': output.Write("&gt;", 4); break;
+            case '"': output.Write("&quot;", 6); break;
+            default:
+                if (ch < 32) {
+                    char escaped[5] = {'&', '#', static_cast<char>('0' + ch / 10), static_cast<char>('0' + ch % 10), ';'};
+                    output.Write(escaped, 5);
+                } else {
+                    output.Put(*value);
+                }
+        }
+    }
+}
+
+void XmlWriter::Attribute(const char* name, const char* value) {
+    BeginAttribute(name);
+    WriteEscaped(value);
+    output.Put('"');
+}
+
+void XmlWriter::Attribute(const char* name, int64_t value) {
+    BeginAttribute(name);
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    output.Write(digits, result.ptr - digits);
+    output.Put('"');
+}
+
+void XmlWriter::Attribute(const char* name, uint64_t value) {
+    BeginAttribute(name);
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    output.Write(digits, result.ptr - digits);
+    output.Put('"');
+}
+
+//! Function used to write a floating point attribute
+//! Uses the same format and precision as pugixml.
+void XmlWriter::Attribute(const char* name, double value) {
+    BeginAttribute(name);
+    char digits[64];
+    int size = std::snprintf(digits, sizeof(digits), "%.17g", value);
+    output.Write(digits, size);
+    output.Put('"');
+}
+
+void XmlWriter::Attribute(const char* name, bool value) {
+    BeginAttribute(name);
+    if (value) {
+        output.Write("true", 4);
+    } else {
+        output.Write("false", 5);
+    }
+    output.Put('"');
+}
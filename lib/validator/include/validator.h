@@ -21,11 +21,22 @@
  * @section Description
  *
  * Functions validate sdf and matter against a schema.
+ * Schemas that are used for many files can be compiled once with SdfSchema and MatterSchema.
  */
 
 #ifndef SDF_MATTER_CONVERTER_LIB_VALIDATOR_INCLUDE_VALIDATOR_H_
 #define SDF_MATTER_CONVERTER_LIB_VALIDATOR_INCLUDE_VALIDATOR_H_
 
+#include <cstddef>
+#include <memory>
+
+namespace nlohmann::json_schema {
+class json_validator;
+}
+
+struct _xmlSchema;
+struct _xmlDoc;
+
 //! @brief Check compliance for sdf file against schema_path.
 //!
 //! This function checks, if a given file complies with the given schema_path.
@@ -44,4 +55,63 @@ int ValidateSdf(const char* path, const char* schema_path);
 //! @return 0 on success, negative on failure.
 int ValidateMatter(const char* path, const char* schema_path);
 
+//! @brief Check compliance for a matter file in memory against schema_file.
+//!
+//! This function checks, if the given content of a file complies with the given schema_file.
+//!
+//! @param data The content of the file.
+//! @param size The size of the content.
+//! @param name Name of the file used in messages.
+//! @param schema_file Path to the schema_file.
+//! @return 0 on success, negative on failure.
+int ValidateMatterBuffer(const char* data, std::size_t size, const char* name, const char* schema_path);
+
+//! Compiled json schema used to validate sdf files
+//! Validating does not modify the schema, so a loaded schema can be used by multiple threads.
+class SdfSchema {
+public:
+    SdfSchema();
+    ~SdfSchema();
+
+    SdfSchema(const SdfSchema&) = delete;
+    SdfSchema& operator=(const SdfSchema&) = delete;
+
+    //! Function used to load and compile the schema at the given path
+    //! Returns 0 on success and negative on failure.
+    int Load(const char* schema_path);
+
+    //! Function used to validate the content of a sdf file
+    //! The name of the file is used in messages. Returns 0 if the file is valid and negative otherwise.
+    int Validate(const char* data, std::size_t size, const char* name) const;
+
+private:
+    std::unique_ptr<nlohmann::json_schema::json_validator> validator;
+};
+
+//! Compiled xsd schema used to validate matter files
+//! Validating does not modify the schema, so a loaded schema can be used by multiple threads.
+class MatterSchema {
+public:
+    MatterSchema() = default;
+    ~MatterSchema();
+
+    MatterSchema(const MatterSchema&) = delete;
+    MatterSchema& operator=(const MatterSchema&) = delete;
+
+    //! Function used to load and compile the schema at the given path
+    //! Returns 0 on success and negative on failure.
+    int Load(const char* schema_path);
+
+    //! Function used to validate the content of a matter file
+    //! The name of the file is used in messages. Returns 0 if the file is valid and negative otherwise.
+    int Validate(const char* data, std::size_t size, const char* name) const;
+
+    //! Function used to validate a parsed xml document
+    //! Returns 0 if the document is valid, positive if it is not valid and negative on internal errors.
+    int ValidateDocument(_xmlDoc* doc) const;
+
+private:
+    _xmlSchema* schema = nullptr;
+};
+
 #endif //SDF_MATTER_CONVERTER_LIB_VALIDATOR_INCLUDE_VALIDATOR_H_
@@ -19,6 +19,7 @@
 #include <libxml/xmlschemas.h>
 #include <fstream>
 #include <iostream>
+#include "validator.h"
 
 using nlohmann::ordered_json;
 using nlohmann::json_schema::json_validator;
@@ -38,6 +39,43 @@ int LoadJsonFile(const char* path, nlohmann::ordered_json& json_file)
     return 0;
 }
 
+SdfSchema::SdfSchema() = default;
+
+SdfSchema::~SdfSchema() = default;
+
+//! Function used to load and compile a json schema
+int SdfSchema::Load(const char* schema_path) {
+    nlohmann::ordered_json json_schema;
+    if (LoadJsonFile(schema_path, json_schema) != 0) {
+        return -1;
+    }
+    // Create a new validator and set its schema_path
+    auto schema_validator = std::make_unique<json_validator>();
+    try {
+        schema_validator->set_root_schema(json_schema);
+    } catch (const std::exception &e) {
+        std::cerr << "Validation of schema_path failed: " << e.what() << "\n";
+        return -1;
+    }
+    validator = std::move(schema_validator);
+    return 0;
+}
+
+//! Function used to validate the content of a json file against the compiled schema
+int SdfSchema::Validate(const char* data, std::size_t size, const char* name) const {
+    if (validator == nullptr) {
+        return -1;
+    }
+    try {
+        nlohmann::ordered_json json_file = nlohmann::ordered_json::parse(data, data + size);
+        auto default_patch = validator->validate(json_file);
+    } catch (const std::exception &e) {
+        std::cerr << "Validation of " << name << " failed: " << e.what() << "\n";
+        return -1;
+    }
+    return 0;
+}
+
 //! Function used to validate a json file against a json schema
 int ValidateSdf(const char* path, const char* schema_path)
 {
@@ -66,40 +104,49 @@ int ValidateSdf(const char* path, const char* schema_path)
     return 0;
 }
 
-//! Function used to validate a xml file against a xsd schema
-int ValidateMatter(const char* path, const char* schema_path) {
-    // Try to load the xml file
-    xmlDocPtr doc = xmlReadFile(path, NULL, 0);
-    if (doc == nullptr) {
-        std::cerr << "Failed to parse " << path << std::endl;
-        return false;
+MatterSchema::~MatterSchema() {
+    if (schema != nullptr) {
+        xmlSchemaFree(schema);
     }
+}
 
+//! Function used to load and compile a xsd schema
+int MatterSchema::Load(const char* schema_path) {
     // Create a new schema parser context from the xsd schema file
     xmlSchemaParserCtxtPtr parser_ctxt = xmlSchemaNewParserCtxt(schema_path);
     if (parser_ctxt == nullptr) {
         std::cerr << "Could not create XML Schema parser context for " << schema_path << std::endl;
-        xmlFreeDoc(doc);
-        return false;
+        return -1;
     }
 
     // Create a new schema from the schema parser context
-    xmlSchemaPtr schema = xmlSchemaParse(parser_ctxt);
+    xmlSchemaPtr parsed_schema = xmlSchemaParse(parser_ctxt);
+    xmlSchemaFreeParserCtxt(parser_ctxt);
+    if (parsed_schema == nullptr) {
+        std::cerr << "Failed to parse XML Schema " << schema_path << std::endl;
+        return -1;
+    }
+    if (schema != nullptr) {
+        xmlSchemaFree(schema);
+    }
+    schema = parsed_schema;
+    return 0;
+}
+
+//! Function used to validate a parsed xml document against the compiled schema
+//! The document gets freed afterwards.
+int MatterSchema::ValidateDocument(xmlDocPtr doc) const {
     if (schema == nullptr) {
-        std::cerr << "Failed to parse XML Schema " << schema << std::endl;
-        xmlSchemaFreeParserCtxt(parser_ctxt);
         xmlFreeDoc(doc);
-        return false;
+        return -1;
     }
 
-    // Create a new schema validation context
+    // Create a new schema validation context, every validation uses its own context
     xmlSchemaValidCtxtPtr valid_ctxt = xmlSchemaNewValidCtxt(schema);
     if (valid_ctxt == nullptr) {
         std::cerr << "Could not create XML Schema validation context" << std::endl;
-        xmlSchemaFree(schema);
-        xmlSchemaFreeParserCtxt(parser_ctxt);
         xmlFreeDoc(doc);
-        return false;
+        return -1;
     }
 
     // Validate the file against the schema using the validation context
@@ -114,9 +161,51 @@ int ValidateMatter(const char* path, const char* schema_path) {
 
     // Cleanup
     xmlSchemaFreeValidCtxt(valid_ctxt);
-    xmlSchemaFree(schema);
-    xmlSchemaFreeParserCtxt(parser_ctxt);
     xmlFreeDoc(doc);
 
     return ret;
 }
+
+//! Function used to validate the content of a xml file against the compiled schema
+int MatterSchema::Validate(const char* data, std::size_t size, const char* name) const {
+    // Try to parse the xml file
+    xmlDocPtr doc = xmlReadMemory(data, static_cast<int>(size), name, NULL, 0);
+    if (doc == nullptr) {
+        std::cerr << "Failed to parse " << name << std::endl;
+        return -1;
+    }
+    return ValidateDocument(doc) == 0 ? 0 : -1;
+}
+
+//! Function used to validate a parsed xml document against a xsd schema
+//! The document gets freed afterwards.
+int ValidateMatterDocument(xmlDocPtr doc, const char* schema_path) {
+    MatterSchema schema;
+    if (schema.Load(schema_path) != 0) {
+        xmlFreeDoc(doc);
+        return false;
+    }
+    return schema.ValidateDocument(doc);
+}
+
+//! Function used to validate a xml file against a xsd schema
+int ValidateMatter(const char* path, const char* schema_path) {
+    // Try to load the xml file
+    xmlDocPtr doc = xmlReadFile(path, NULL, 0);
+    if (doc == nullptr) {
+        std::cerr << "Failed to parse " << path << std::endl;
+        return false;
+    }
+    return ValidateMatterDocument(doc, schema_path);
+}
+
+//! Function used to validate a xml file in memory against a xsd schema
+int ValidateMatterBuffer(const char* data, std::size_t size, const char* name, const char* schema_path) {
+    // Try to parse the xml file
+    xmlDocPtr doc = xmlReadMemory(data, static_cast<int>(size), name, NULL, 0);
+    if (doc == nullptr) {
+        std::cerr << "Failed to parse " << name << std::endl;
+        return false;
+    }
+    return ValidateMatterDocument(doc, schema_path);
+}
@@ -14,14 +14,26 @@
  *  limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <optional>
+#include <thread>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include <pugixml.hpp>
 #include <argparse/argparse.hpp>
 #include <converter.h>
+#include <cache.h>
+#include <cbor.h>
+#include <library.h>
+#include <prescan.h>
 #include "main.h"
+#include "ndjson.h"
+#include "queue.h"
 
 using json = nlohmann::ordered_json;
 using recursive_directory_iterator = std::filesystem::recursive_directory_iterator;
@@ -54,6 +66,363 @@ void GenerateMatterFilenames(const std::string& input, std::string& device_xml_n
     cluster_xml_name.append(input.substr(last_dot));
 }
 
+//! Helper function that generates the key of a cached conversion
+//! The key covers the given options and the content of every input file. Returns an empty string if an input file
+//! could not be read.
+std::string GenerateCacheKey(const std::vector<std::string>& options, const std::vector<std::string>& input_paths) {
+    cache::CacheKey key;
+    for (const auto& option : options) {
+        key.Add(option);
+    }
+    for (const auto& path : input_paths) {
+        if (key.AddFile(path.c_str()) != 0) {
+            return "";
+        }
+    }
+    return key.Digest();
+}
+
+//! Helper function that generates the key of a cached conversion of an already loaded file
+//! The key is the same as the one generated for the path of the file. Returns an empty string if the file could not
+//! be loaded.
+std::string GenerateLoadedCacheKey(const std::vector<std::string>& options, const loader::LoadedFile& input_file) {
+    if (input_file.error != 0) {
+        return "";
+    }
+    cache::CacheKey key;
+    for (const auto& option : options) {
+        key.Add(option);
+    }
+    key.Add(input_file.data.get(), input_file.size);
+    return key.Digest();
+}
+
+//! Helper function that validates the output files restored from the cache
+//! Returns true if every file is valid.
+bool ValidateOutputFiles(const std::vector<std::string>& output_paths, bool sdf_output, bool bundle,
+                         const Validator& validator) {
+    bool valid = true;
+    for (const auto& path : output_paths) {
+        int result;
+        if (sdf_output) {
+            result = ValidateSdfFile(path.c_str(), validator);
+        } else if (bundle) {
+            result = ValidateMatterBundleFile(path.c_str(), validator);
+        } else {
+            result = ValidateMatterFile(path.c_str(), validator);
+        }
+        if (result == 0) {
+            std::cout << path << " valid!..." << std::endl;
+        } else {
+            std::cout << path << " not valid!..." << std::endl;
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+//! Cluster definition of the cluster library
+//! Used to find the clusters a device type depends on without parsing them.
+struct LibraryCluster {
+    uint32_t id;
+    std::vector<std::string> aliases;
+    std::string hash;
+};
+
+//! Helper function that collects the ids, aliases and content hashes of the cluster library
+std::vector<LibraryCluster> ScanClusterLibrary(const std::vector<std::string>& cluster_paths,
+                                               const std::list<matter::Cluster>& clusters) {
+    std::vector<LibraryCluster> library;
+    auto cluster = clusters.begin();
+    for (const auto& path : cluster_paths) {
+        LibraryCluster& library_cluster = library.emplace_back();
+        library_cluster.id = cluster->id;
+        for (const auto& cluster_alias : cluster->cluster_aliases) {
+            library_cluster.aliases.push_back(cluster_alias.second);
+        }
+        library_cluster.hash = GenerateCacheKey({}, {path});
+        cluster++;
+    }
+    return library;
+}
+
+//! Helper function that collects the ids, aliases and content hashes of a flat cluster library
+//! The clusters are hashed by their embedded definition, so they do not have to be decoded.
+std::vector<LibraryCluster> ScanClusterLibrary(const library::LibraryView& cluster_library) {
+    std::vector<LibraryCluster> library;
+    for (const auto& cluster : cluster_library.Clusters()) {
+        LibraryCluster& library_cluster = library.emplace_back();
+        library_cluster.id = cluster.Id();
+        for (const auto& alias : cluster.Aliases()) {
+            library_cluster.aliases.emplace_back(alias.Name());
+        }
+        cache::CacheKey key;
+        key.Add(std::string(cluster.Encoded()));
+        library_cluster.hash = key.Digest();
+    }
+    return library;
+}
+
+//! Helper function that collects the ids, aliases and content hashes of a scanned cluster library
+//! The clusters are hashed by the content of their files, so they do not have to be parsed.
+std::vector<LibraryCluster> ScanClusterLibrary(const prescan::LazyClusterLibrary& cluster_library) {
+    std::vector<LibraryCluster> library;
+    for (std::size_t i = 0; i < cluster_library.Size(); i++) {
+        LibraryCluster& library_cluster = library.emplace_back();
+        library_cluster.id = cluster_library.Header(i).id;
+        for (const auto& cluster_alias : cluster_library.Header(i).cluster_aliases) {
+            library_cluster.aliases.push_back(cluster_alias.second);
+        }
+        library_cluster.hash = cluster_library.Hash(i);
+    }
+    return library;
+}
+
+//! Helper function that loads the given cluster definitions
+//! All files get loaded in one batch before they are parsed. Cluster definitions that could not be loaded are
+//! skipped, the paths of the loaded ones get collected.
+std::list<matter::Cluster> LoadClusterFiles(const std::vector<std::string>& cluster_paths,
+                                            std::vector<std::string>& loaded_cluster_paths) {
+    std::list<matter::Cluster> clusters;
+    for (auto& cluster_file : loader::LoadFiles(cluster_paths)) {
+        matter::Cluster cluster;
+        if (ParseClusterFile(cluster_file, cluster) == 0) {
+            loaded_cluster_paths.push_back(cluster_file.path);
+            clusters.push_back(std::move(cluster));
+        }
+    }
+    return clusters;
+}
+
+//! Helper function that generates the key of a device type conversion
+//! The key covers the device type definition and the content of all clusters of the library that match the
+//! dependencies of the device type, in the order of the library.
+std::string GenerateDependencyKey(const std::string& device_key, const ClusterDependencies& dependencies,
+                                  const std::vector<LibraryCluster>& library) {
+    cache::CacheKey key;
+    key.Add(device_key);
+    for (const auto& cluster : library) {
+        bool dependency = dependencies.cluster_ids.count(cluster.id) > 0;
+        for (const auto& alias : cluster.aliases) {
+            dependency = dependency or dependencies.base_clusters.count(alias) > 0;
+        }
+        if (dependency) {
+            key.Add(cluster.hash);
+        }
+    }
+    return key.Digest();
+}
+
+//! Helper function that saves the result of a conversion to Matter
+//! The device type and the clusters either get saved as separate xml files or as a single bundle at the output path.
+//! With cbor, the files get saved in the binary CBOR format instead of xml. Returns true if all output files were saved
+//! and, with a validator, are valid.
+bool SaveMatterFiles(const std::string& output, const std::optional<matter::Device>& device,
+                     const std::list<matter::Cluster>& clusters, bool bundle, bool cbor,
+                     const Validator& validator, std::vector<std::string>& output_paths) {
+    bool saved = true;
+    if (bundle) {
+        std::cout << "Saving Bundle..." << std::endl;
+        saved &= SaveMatterBundle(output.c_str(), device, clusters, cbor) == 0;
+        output_paths.push_back(output);
+        if (validator) {
+            if (ValidateMatterBundleFile(output.c_str(), validator) == 0) {
+                std::cout << "Bundle valid!..." << std::endl;
+            } else {
+                std::cout << "Bundle not valid!..." << std::endl;
+                saved = false;
+            }
+        }
+        return saved;
+    }
+
+    // Generate the output file paths
+    std::string path_device_xml;
+    std::string path_cluster_xml;
+    GenerateMatterFilenames(output, path_device_xml, path_cluster_xml);
+
+    if (device.has_value()) {
+        std::cout << "Saving Device XML..." << std::endl;
+        saved &= SaveDeviceFile(path_device_xml.c_str(), device.value(), cbor) == 0;
+        output_paths.push_back(path_device_xml);
+        if (validator) {
+            if (ValidateMatterFile(path_device_xml.c_str(), validator) == 0) {
+                std::cout << "Device XML valid!..." << std::endl;
+            } else {
+                std::cout << "Device not valid!..." << std::endl;
+                saved = false;
+            }
+        }
+    }
+
+    std::cout << "Saving Cluster XML..." << std::endl;
+    int counter = 0;
+    for (const auto& cluster : clusters) {
+        // Generate a filename for each cluster by numbering them
+        std::string path = path_cluster_xml + "_" + std::to_string(counter) + (cbor ? ".cbor" : ".xml");
+        saved &= SaveClusterFile(path.c_str(), cluster, cbor) == 0;
+        output_paths.push_back(path);
+        // If the validation flag was set we try to validate the xml against a xsd schema
+        if (validator) {
+            if (ValidateMatterFile(path.c_str(), validator) == 0) {
+                std::cout << "Cluster XML" << path << "valid!..." << std::endl;
+            } else {
+                std::cout << "Cluster XML" << path << "not valid!..." << std::endl;
+                saved = false;
+            }
+        }
+        counter++;
+    }
+    return saved;
+}
+
+//! Result of a conversion from Matter to sdf
+//! With round-tripping, the result also contains the Matter data model converted back from sdf.
+struct MatterConversion {
+    sdf::SdfModel sdf_model;
+    sdf::SdfMapping sdf_mapping;
+    std::optional<matter::Device> roundtrip_device;
+    std::list<matter::Cluster> roundtrip_clusters;
+};
+
+//! Helper function that converts Matter to sdf with the clusters of the given session
+//! With round-tripping, the result gets converted back to Matter. Returns true if every conversion succeeded.
+bool ConvertMatter(const Converter& converter, const std::optional<matter::Device>& device, bool roundtrip,
+                   MatterConversion& conversion, ClusterDependencies& dependencies) {
+    std::cout << "Converting Matter to SDF" << std::endl;
+    if (converter.ConvertMatterToSdf(device, conversion.sdf_model, conversion.sdf_mapping, &dependencies) != 0) {
+        std::cerr << "Failed to convert Matter to SDF" << std::endl;
+        return false;
+    }
+
+    // Check if round-tripping was selected
+    if (roundtrip) {
+        std::cout << "Round-tripping flag was set!" << std::endl;
+        std::cout << "Converting SDF to Matter..." << std::endl;
+
+        // Convert SDF back to the Matter data model
+        json sdf_model_json = sdf::SerializeSdfModel(conversion.sdf_model);
+        json sdf_mapping_json = sdf::SerializeSdfMapping(conversion.sdf_mapping);
+        if (converter.ConvertSdfToMatter(sdf::ParseSdfModel(sdf_model_json), sdf::ParseSdfMapping(sdf_mapping_json),
+                                         conversion.roundtrip_device, conversion.roundtrip_clusters) != 0) {
+            std::cerr << "Failed to convert SDF to Matter" << std::endl;
+            return false;
+        }
+        std::cout << "Successfully converted SDF to Matter!" << std::endl;
+    }
+    return true;
+}
+
+//! Helper function that saves the result of a conversion from Matter to sdf
+//! With round-tripping, the Matter data model converted back from sdf gets saved. Returns true if all output files
+//! were saved and, with a validator, are valid.
+bool SaveMatterConversion(const MatterConversion& conversion, const std::string& output, bool roundtrip, bool bundle,
+                          bool cbor, const Validator& validator, std::vector<std::string>& output_paths) {
+    bool saved = true;
+    if (roundtrip) {
+        saved &= SaveMatterFiles(output, conversion.roundtrip_device, conversion.roundtrip_clusters, bundle, cbor,
+                                 validator, output_paths);
+        std::cout << "Successfully saved Matter!" << std::endl;
+    }
+    // If the round-tripping flag was not set, we can just save the result
+    else {
+        // Generate filenames for SDF based on the output path
+        std::string path_sdf_model;
+        std::string path_sdf_mapping;
+        GenerateSdfFilenames(output, path_sdf_model, path_sdf_mapping);
+
+        std::cout << "Saving JSON files...." << std::endl;
+        saved &= SaveSdfModelFile(path_sdf_model.c_str(), conversion.sdf_model, cbor) == 0;
+        output_paths.push_back(path_sdf_model);
+        std::cout << "Successfully saved SDF-Model!" << std::endl;
+        if (validator) {
+            if (ValidateSdfFile(path_sdf_model.c_str(), validator) == 0) {
+                std::cout << "SDF-model valid!..." << std::endl;
+            } else {
+                std::cout << "SDF-model not valid!..." << std::endl;
+                saved = false;
+            }
+        }
+
+        saved &= SaveSdfMappingFile(path_sdf_mapping.c_str(), conversion.sdf_mapping, cbor) == 0;
+        output_paths.push_back(path_sdf_mapping);
+        std::cout << "Successfully saved SDF-Mapping!" << std::endl;
+        if (validator) {
+            if (ValidateSdfFile(path_sdf_mapping.c_str(), validator) == 0) {
+                std::cout << "SDF-mapping valid!..." << std::endl;
+            } else {
+                std::cout << "SDF-mapping not valid!..." << std::endl;
+                saved = false;
+            }
+        }
+    }
+    return saved;
+}
+
+//! Device type of a batch conversion, which gets passed through the stages of the pipeline
+struct DeviceJob {
+    std::string path_device_xml;
+    std::string output_path;
+    std::string output_prefix;
+    //! Key of the device type inside the cache, empty if the cache is not used
+    std::string device_key;
+    std::optional<matter::Device> device;
+    //! Session with only the clusters the device type depends on, used unless every cluster was parsed up front
+    std::optional<Converter> converter;
+    MatterConversion conversion;
+    ClusterDependencies dependencies;
+    std::vector<std::string> output_paths;
+};
+
+//! Helper function that starts the threads of a pipeline stage
+std::vector<std::thread> StartStage(std::size_t threads, const std::function<void()>& stage) {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; i++) {
+        workers.emplace_back(stage);
+    }
+    return workers;
+}
+
+//! Helper function that waits until every thread of a pipeline stage is done
+void JoinStage(std::vector<std::thread>& workers) {
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+//! Helper function that loads every cluster definition of the given cluster folder, file or flat cluster library
+std::list<matter::Cluster> LoadClusterLibrary(const std::string& path_cluster_xml) {
+    library::LibraryView cluster_library;
+    if (!std::filesystem::is_directory(path_cluster_xml) and cluster_library.Open(path_cluster_xml.c_str()) == 0) {
+        return cluster_library.LoadClusters();
+    }
+    std::vector<std::string> cluster_paths;
+    if (std::filesystem::is_directory(path_cluster_xml)) {
+        for (const auto &dir_entry: recursive_directory_iterator(path_cluster_xml)) {
+            if (dir_entry.is_regular_file()) {
+                cluster_paths.push_back(dir_entry.path().string());
+            }
+        }
+        std::sort(cluster_paths.begin(), cluster_paths.end());
+    } else {
+        cluster_paths.push_back(path_cluster_xml);
+    }
+    std::vector<std::string> loaded_cluster_paths;
+    return LoadClusterFiles(cluster_paths, loaded_cluster_paths);
+}
+
+//! Helper function that prints the profile summary and writes the trace file, if they were requested
+void ReportProfile(const argparse::ArgumentParser& program, std::ostream& output) {
+    if (program.is_used("--profile")) {
+        output << profiler::Summary().dump(4) << std::endl;
+    }
+    if (program.is_used("--trace")) {
+        if (profiler::WriteTrace(program.get<std::string>("--trace").c_str()) < 0) {
+            std::cerr << "Failed to write trace file" << std::endl;
+        }
+    }
+}
+
 //! Main function
 int main(int argc, char *argv[]) {
     // Define the program name
@@ -90,8 +459,66 @@ int main(int argc, char *argv[]) {
             .help("Validate the output files\n"
                   "Requires the path to the schema for the output files as an input");
 
+    program.add_argument("--profile")
+            .help("Print a JSON summary of the time spent in the individual stages of the conversion")
+            .default_value(false)
+            .implicit_value(true);
+
+    program.add_argument("--trace")
+            .help("Write a Chrome trace-event file with a span for every stage of the conversion\n"
+                  "Requires the path to the trace file as an input");
+
+    program.add_argument("--cache-dir")
+            .help("Cache the output files of conversions inside the given directory\n"
+                  "A conversion of unchanged input files copies the cached output files instead");
+
+    program.add_argument("--bundle")
+            .help("Save all converted Matter files into a single bundle at the output path\n"
+                  "The bundle is a tar archive with an index of its members")
+            .default_value(false)
+            .implicit_value(true);
+
+    program.add_argument("--cbor")
+            .help("Save the converted files in the binary CBOR format instead of JSON or XML\n"
+                  "CBOR files are also accepted as input files")
+            .default_value(false)
+            .implicit_value(true);
+
+    program.add_argument("--save-library")
+            .help("Save the loaded cluster definitions into a flat cluster library at the given path\n"
+                  "A cluster library can be passed to -cluster-xml and gets used without parsing it");
+
+    program.add_argument("--cluster-index")
+            .help("Keep an index of the cluster definitions of -cluster-xml at the given path\n"
+                  "Later runs reuse the index for every unchanged file instead of scanning it again");
+
+    program.add_argument("--load-threads")
+            .help("Number of threads loading the device type definitions of a batch")
+            .default_value(2)
+            .scan<'i', int>();
+
+    program.add_argument("--convert-threads")
+            .help("Number of threads converting the device types of a batch, defaults to the number of processors")
+            .default_value(0)
+            .scan<'i', int>();
+
+    program.add_argument("--write-threads")
+            .help("Number of threads saving and validating the converted files of a batch")
+            .default_value(2)
+            .scan<'i', int>();
+
+    program.add_argument("--queue-depth")
+            .help("Number of device types of a batch that can wait between two stages")
+            .default_value(4)
+            .scan<'i', int>();
+
+    program.add_argument("--ndjson")
+            .help("Read newline-delimited JSON conversion requests from stdin and write the results to stdout\n"
+                  "The clusters of -cluster-xml get loaded once and are used for every request")
+            .default_value(false)
+            .implicit_value(true);
+
     program.add_argument("-o", "-output")
-            .required()
             .help("Specify the output file\n"
                   "For the Matter to SDF conversion, this will get split up into -model and -mapping\n"
                   "For the SDF to Matter conversion, this will get split up into -device and -clusters");
@@ -105,142 +532,363 @@ int main(int argc, char *argv[]) {
         std::exit(1);
     }
 
+    // Enable the profiler before the first stage
+    if (program.is_used("--profile")) {
+        profiler::SetEnabled(true);
+    }
+    if (program.is_used("--trace")) {
+        profiler::SetTracing(true);
+    }
+
+    // The service keeps running until stdin gets closed, stdout only contains the responses
+    if (program.is_used("--ndjson")) {
+        std::list<matter::Cluster> clusters;
+        if (program.is_used("-cluster-xml")) {
+            clusters = LoadClusterLibrary(program.get<std::string>("-cluster-xml"));
+        }
+        Converter converter(std::move(clusters));
+        bool served = ndjson::Serve(converter, std::cin, STDOUT_FILENO) == 0;
+        if (!served) {
+            std::cerr << "Not every request could be converted" << std::endl;
+        }
+        ReportProfile(program, std::cerr);
+        return served ? 0 : 1;
+    }
+
+    if (!program.is_used("-output")) {
+        std::cerr << "-output: required." << std::endl;
+        std::cerr << program;
+        std::exit(1);
+    }
+
+    // Output files of the conversion, all of them start with the output path without its extension
+    std::string output_path = program.get<std::string>("-output");
+    std::string output_prefix = output_path.substr(0, output_path.find_last_of('.'));
+    std::vector<std::string> output_paths;
+    // Becomes false if a conversion, the saving or the validation of an output file fails
+    bool succeeded = true;
+    bool bundle = program.is_used("--bundle");
+    bool cbor = program.is_used("--cbor");
+
+    // The schemas only describe the JSON and XML formats
+    if (cbor and program.is_used("-validate")) {
+        std::cerr << "The CBOR output can not be validated" << std::endl;
+        std::exit(1);
+    }
+
+    // Key of the conversion inside the cache, empty if the cache is not used
+    std::optional<cache::ConversionCache> conversion_cache;
+    std::string cache_key;
+    bool restored = false;
+    if (program.is_used("--cache-dir")) {
+        conversion_cache.emplace(program.get<std::string>("--cache-dir"));
+    }
+
     // Check if the conversion direction is matter to sdf
     if (program.is_used("--matter-to-sdf")) {
-        // Check if the result should be validated
+        bool roundtrip = program.is_used("--roundtrip");
+        // Check if the result should be validated, the schema gets compiled once for every output file
         bool validate = program.is_used("-validate");
+        Validator validator;
+        if (validate and LoadOutputSchema(program.get<std::string>("-validate").c_str(), !roundtrip, validator) != 0) {
+            std::cerr << "Failed to load schema: " << program.get<std::string>("-validate") << std::endl;
+            std::exit(1);
+        }
 
-        // Check if the path to a device type definition was given
-        std::string path_device_xml;
+        // Threads of the individual stages of a batch conversion
+        std::size_t load_threads = std::max(program.get<int>("--load-threads"), 1);
+        std::size_t convert_threads = program.get<int>("--convert-threads") > 0
+                                      ? program.get<int>("--convert-threads") : std::thread::hardware_concurrency();
+        convert_threads = std::max<std::size_t>(convert_threads, 1);
+        std::size_t write_threads = std::max(program.get<int>("--write-threads"), 1);
+        std::size_t queue_depth = std::max(program.get<int>("--queue-depth"), 1);
+
+        // Collect the paths of the device type definitions, a folder of device type definitions gets converted as a
+        // batch with one output per device type
+        std::vector<std::string> device_paths;
+        bool batch = false;
         if (program.is_used("-device-xml")) {
-            path_device_xml = program.get<std::string>("-device-xml");
+            auto path_device_xml = program.get<std::string>("-device-xml");
+            if (std::filesystem::is_directory(path_device_xml)) {
+                batch = true;
+                for (const auto &dir_entry: recursive_directory_iterator(path_device_xml)) {
+                    if (dir_entry.is_regular_file()) {
+                        device_paths.push_back(dir_entry.path().string());
+                    }
+                }
+                std::sort(device_paths.begin(), device_paths.end());
+            } else {
+                device_paths.push_back(path_device_xml);
+            }
         }
 
-        // Check if the path to one or more cluster definitions was given
+        // Collect the paths of the cluster definitions
+        std::string path_cluster_xml;
+        std::vector<std::string> cluster_paths;
         if (program.is_used("-cluster-xml")) {
-            auto path_cluster_xml = program.get<std::string>("-cluster-xml");
-            std::list<pugi::xml_document> cluster_xml_list;
-            // Check if the given path points onto a folder or a file
-            json sdf_model;
-            json sdf_mapping;
-            // Check if the given -cluster-xml value is a path or a file
+            path_cluster_xml = program.get<std::string>("-cluster-xml");
             if (std::filesystem::is_directory(path_cluster_xml)) {
-                std::cout << "Loading and Parsing every Cluster XML of the given path" << std::endl;
                 for (const auto &dir_entry: recursive_directory_iterator(path_cluster_xml)) {
-                    pugi::xml_document cluster_xml;
-                    LoadXmlFile(dir_entry.path().c_str(), cluster_xml);
-                    cluster_xml_list.push_back(std::move(cluster_xml));
+                    if (dir_entry.is_regular_file()) {
+                        cluster_paths.push_back(dir_entry.path().string());
+                    }
                 }
+                // The directory order is unspecified, the sorted paths keep the cache key of the same files stable
+                std::sort(cluster_paths.begin(), cluster_paths.end());
             } else {
-                std::cout << "Loading Cluster XML" << std::endl;
-                pugi::xml_document cluster_xml;
-                LoadXmlFile(path_cluster_xml.c_str(), cluster_xml);
-                cluster_xml_list.push_back(std::move(cluster_xml));
-            }
-            // If a device type definition was loaded, convert both of the files
-            if (!path_device_xml.empty()) {
-                std::cout << "Loading Device XML" << std::endl;
-                pugi::xml_document device_xml;
-                LoadXmlFile(path_device_xml.c_str(), device_xml);
-                std::cout << "Converting Matter to SDF" << std::endl;
-                ConvertMatterToSdf(std::move(device_xml), cluster_xml_list, sdf_model, sdf_mapping);
+                cluster_paths.push_back(path_cluster_xml);
             }
-            // Otherwise we just convert the list of clusters
-            else {
-                std::cout << "Converting Matter to SDF" << std::endl;
-                ConvertMatterToSdf(std::nullopt, cluster_xml_list, sdf_model, sdf_mapping);
+        }
+
+        // If no path to one or more cluster definitions is given we exit the program
+        if (cluster_paths.empty()) {
+            std::cerr << "No valid combination of input parameters used" << std::endl;
+            std::exit(1);
+        }
+
+        // A cluster library gets mapped into memory, its clusters only get decoded once they are needed
+        std::optional<library::LibraryView> cluster_library;
+        if (cluster_paths.size() == 1 and cluster_library.emplace().Open(cluster_paths.front().c_str()) != 0) {
+            cluster_library.reset();
+        }
+
+        // The cluster definitions only get loaded if they are needed
+        std::optional<prescan::LazyClusterLibrary> scanned_library;
+        std::vector<std::string> loaded_cluster_paths;
+        std::list<matter::Cluster> clusters;
+        bool clusters_loaded = false;
+        if (program.is_used("--save-library")) {
+            clusters = cluster_library.has_value() ? cluster_library->LoadClusters()
+                                                   : LoadClusterFiles(cluster_paths, loaded_cluster_paths);
+            clusters_loaded = true;
+            auto path_library = program.get<std::string>("--save-library");
+            std::cout << "Saving Cluster Library..." << std::endl;
+            if (SaveLibraryFile(path_library.c_str(), clusters) != 0) {
+                succeeded = false;
             }
+        }
 
-            // Check if round-tripping was selected
-            if (program.is_used("--roundtrip")) {
-                std::cout << "Round-tripping flag was set!" << std::endl;
-                std::cout << "Converting SDF to Matter..." << std::endl;
+        // Options which are part of every cache key
+        std::vector<std::string> cache_options = {"--matter-to-sdf", roundtrip ? "--roundtrip" : "",
+                                                  bundle ? "--bundle" : "", cbor ? "--cbor" : "",
+                                                  output_path.substr(output_prefix.size())};
 
-                std::optional<pugi::xml_document> optional_device_xml;
-                cluster_xml_list.clear();
-
-                // Convert SDF back to the Matter data model
-                ConvertSdfToMatter(sdf_model, sdf_mapping, optional_device_xml, cluster_xml_list);
-                std::cout << "Successfully converted SDF to Matter!" << std::endl;
-
-                // Generate the output file path
-                std::string path_output_device_xml;
-                std::string path_output_cluster_xml;
-                GenerateMatterFilenames(program.get<std::string>("-output"), path_output_device_xml,
-                                        path_output_cluster_xml);
-
-                if (optional_device_xml.has_value()) {
-                    std::cout << "Saving Device XML..." << std::endl;
-                    SaveXmlFile(path_output_device_xml.c_str(), optional_device_xml.value());
-                    std::cout << "Successfully saved Device XML!" << std::endl;
-                    if (validate) {
-                        if (ValidateMatter(path_device_xml.c_str(), program.get<std::string>("-validate").c_str()) ==
-                            0) {
-                            std::cout << "Device XML valid!..." << std::endl;
-                        } else {
-                            std::cout << "Device not valid!..." << std::endl;
-                        }
-                    }
-                }
+        // Without a device type definition, the result depends on every cluster, so it only gets restored from the
+        // cache if none of them changed
+        if (device_paths.empty() and conversion_cache.has_value()) {
+            cache_key = GenerateCacheKey(cache_options, cluster_paths);
+            restored = !cache_key.empty() and conversion_cache->Restore(cache_key, output_prefix, output_paths) == 0;
+        }
 
-                std::cout << "Saving Cluster XML..." << std::endl;
-                int counter = 0;
-                for (const auto &cluster_xml: cluster_xml_list) {
-                    // Generate a filename for each cluster by numbering them
-                    std::string path = path_output_cluster_xml + "_" + std::to_string(counter) + ".xml";
-                    SaveXmlFile(path.c_str(), cluster_xml);
-                    // If the validation flag was set we try to validate the xml against a xsd schema
-                    if (validate) {
-                        if (ValidateMatter(path.c_str(), program.get<std::string>("-validate").c_str())) {
-                            std::cout << "Cluster XML" << path << "valid!..." << std::endl;
-                        } else {
-                            std::cout << "Cluster XML" << path << "not valid!..." << std::endl;
+        if (restored) {
+            std::cout << "Restored the converted files from the cache" << std::endl;
+            if (validate) {
+                succeeded &= ValidateOutputFiles(output_paths, !roundtrip, bundle, validator);
+            }
+        } else {
+            // The cluster definitions are either xml files or CBOR files, the clusters of a library only get decoded
+            // if every cluster is needed
+            if (cluster_library.has_value()) {
+                std::cout << "Using the Cluster Library" << std::endl;
+                if (device_paths.empty() and !clusters_loaded) {
+                    clusters = cluster_library->LoadClusters();
+                }
+            } else if (!device_paths.empty() and !clusters_loaded) {
+                // A device type only depends on some clusters, so only the headers of the cluster definitions get
+                // scanned and the clusters get parsed once a device type needs them
+                if (std::filesystem::is_directory(path_cluster_xml)) {
+                    std::cout << "Scanning every Cluster XML of the given path" << std::endl;
+                } else {
+                    std::cout << "Scanning Cluster XML" << std::endl;
+                }
+                if (program.is_used("--cluster-index")) {
+                    // Only the files that changed since the index was saved get scanned
+                    auto path_cluster_index = program.get<std::string>("--cluster-index");
+                    prescan::ClusterIndex cluster_index;
+                    cluster_index.Load(path_cluster_index);
+                    std::vector<std::string> failed_paths;
+                    if (cluster_index.Update(cluster_paths, failed_paths) and
+                        cluster_index.Save(path_cluster_index) != 0) {
+                        std::cerr << "Failed to save the cluster index: " << path_cluster_index << std::endl;
+                    }
+                    for (const auto& path : failed_paths) {
+                        std::cerr << "Failed to load Matter file: " << path << std::endl;
+                    }
+                    scanned_library.emplace(cluster_index);
+                } else {
+                    scanned_library.emplace(loader::LoadFiles(cluster_paths));
+                    for (const auto& cluster_file : scanned_library->FailedFiles()) {
+                        std::cerr << "Failed to load Matter file: " << cluster_file.path << std::endl;
+                        if (cluster_file.error != 0) {
+                            std::cerr << std::strerror(cluster_file.error) << std::endl;
                         }
                     }
-                    counter++;
                 }
+            } else if (!clusters_loaded) {
+                // Check if the given -cluster-xml value is a path or a file
+                if (std::filesystem::is_directory(path_cluster_xml)) {
+                    std::cout << "Loading and Parsing every Cluster XML of the given path" << std::endl;
+                } else {
+                    std::cout << "Loading Cluster XML" << std::endl;
+                }
+                clusters = LoadClusterFiles(cluster_paths, loaded_cluster_paths);
+            }
 
-                std::cout << "Successfully saved Cluster XML!" << std::endl;
+            // The session keeps the parsed clusters for every device type
+            Converter converter(std::move(clusters));
 
+            // If no device type definition was given, we just convert the list of clusters
+            if (device_paths.empty()) {
+                MatterConversion conversion;
+                ClusterDependencies dependencies;
+                if (ConvertMatter(converter, std::nullopt, roundtrip, conversion, dependencies)) {
+                    succeeded &= SaveMatterConversion(conversion, output_path, roundtrip, bundle, cbor, validator,
+                                                      output_paths);
+                } else {
+                    succeeded = false;
+                }
             }
-            // If the round-tripping flag was not set, we can just save the result
-            else {
-                // Generate filenames for SDF based on the -output parameter
-                std::string path_sdf_model;
-                std::string path_sdf_mapping;
-                GenerateSdfFilenames(program.get<std::string>("-output"), path_sdf_model, path_sdf_mapping);
 
-                std::cout << "Saving JSON files...." << std::endl;
-                SaveJsonFile(path_sdf_model.c_str(), sdf_model);
-                std::cout << "Successfully saved SDF-Model!" << std::endl;
-                if (validate) {
-                    if (ValidateSdf(path_sdf_model.c_str(), program.get<std::string>("-validate").c_str()) == 0) {
-                        std::cout << "SDF-model valid!..." << std::endl;
-                    } else {
-                        std::cout << "SDF-model not valid!..." << std::endl;
+            // A device type only depends on some clusters of the library, so it only gets converted again, if its
+            // definition or one of these clusters changed
+            std::vector<LibraryCluster> library;
+            if (!device_paths.empty() and conversion_cache.has_value()) {
+                if (cluster_library.has_value()) {
+                    library = ScanClusterLibrary(cluster_library.value());
+                } else if (scanned_library.has_value()) {
+                    library = ScanClusterLibrary(scanned_library.value());
+                } else {
+                    library = ScanClusterLibrary(loaded_cluster_paths, converter.Clusters());
+                }
+            }
+
+            // The device types pass through a pipeline of stages connected by bounded queues, so loading the next
+            // device types and saving the previous ones overlaps with the conversion of the current one
+            BoundedQueue<DeviceJob> loaded_devices(queue_depth, "LoadedDeviceQueue");
+            BoundedQueue<DeviceJob> converted_devices(queue_depth, "ConvertedDeviceQueue");
+            std::atomic<std::size_t> next_device = 0;
+            std::atomic<bool> devices_succeeded = true;
+
+            // Loads windows of device type definitions in one batch each, then restores the device types from the cache
+            // or parses their loaded definition
+            // Every load thread only keeps one window of the size of the queues in memory, so loading does not run
+            // further ahead of the conversion than the queues allow.
+            auto load_stage = [&]() {
+                for (std::size_t first = next_device.fetch_add(queue_depth); first < device_paths.size();
+                     first = next_device.fetch_add(queue_depth)) {
+                    std::size_t last = std::min(first + queue_depth, device_paths.size());
+                    std::vector<loader::LoadedFile> device_files = loader::LoadFiles(
+                            std::vector<std::string>(device_paths.begin() + first, device_paths.begin() + last));
+                    for (std::size_t i = first; i < last; i++) {
+                        DeviceJob job;
+                        job.path_device_xml = device_paths[i];
+                        job.output_path = output_path;
+                        if (batch) {
+                            job.output_path = output_prefix + "_" +
+                                              std::filesystem::path(job.path_device_xml).stem().string() +
+                                              output_path.substr(output_prefix.size());
+                        }
+                        job.output_prefix = job.output_path.substr(0, job.output_path.find_last_of('.'));
+
+                        loader::LoadedFile& device_file = device_files[i - first];
+                        if (conversion_cache.has_value()) {
+                            job.device_key = GenerateLoadedCacheKey(cache_options, device_file);
+                            if (!job.device_key.empty() and
+                                conversion_cache->LoadDependencies(job.device_key, job.dependencies) == 0 and
+                                conversion_cache->Restore(
+                                        GenerateDependencyKey(job.device_key, job.dependencies, library),
+                                        job.output_prefix, job.output_paths) == 0) {
+                                std::cout << "Restored the converted files of " << job.path_device_xml
+                                          << " from the cache" << std::endl;
+                                if (validate and
+                                    !ValidateOutputFiles(job.output_paths, !roundtrip, bundle, validator)) {
+                                    devices_succeeded = false;
+                                }
+                                continue;
+                            }
+                        }
+
+                        std::cout << "Loading Device XML" << std::endl;
+                        int parsed = ParseDeviceFile(device_file, job.device.emplace());
+                        device_file.data.reset();
+                        if (parsed != 0) {
+                            devices_succeeded = false;
+                            continue;
+                        }
+                        // Only the clusters the device type depends on get decoded from a library or parsed
+                        if (cluster_library.has_value()) {
+                            job.converter.emplace(cluster_library->LoadClusters(job.device.value()));
+                        } else if (scanned_library.has_value()) {
+                            job.converter.emplace(scanned_library->LoadClusters(job.device.value()));
+                        }
+                        loaded_devices.Push(std::move(job));
                     }
                 }
+            };
+
+            // Converts the device types with the clusters of the session
+            auto convert_stage = [&]() {
+                while (auto job = loaded_devices.Pop()) {
+                    bool converted = ConvertMatter(job->converter.has_value() ? *job->converter : converter,
+                                                   job->device, roundtrip, job->conversion, job->dependencies);
+                    // The clusters of the device type are not needed anymore
+                    job->converter.reset();
+                    // A failed conversion does not get saved
+                    if (!converted) {
+                        std::cerr << "Failed to convert " << job->path_device_xml << std::endl;
+                        devices_succeeded = false;
+                        continue;
+                    }
+                    converted_devices.Push(std::move(*job));
+                }
+            };
+
+            // Saves and validates the converted files and adds them to the cache
+            auto write_stage = [&]() {
+                while (auto job = converted_devices.Pop()) {
+                    bool device_saved = SaveMatterConversion(job->conversion, job->output_path, roundtrip, bundle,
+                                                             cbor, validator, job->output_paths);
+                    if (!device_saved) {
+                        devices_succeeded = false;
+                    }
 
-                SaveJsonFile(path_sdf_mapping.c_str(), sdf_mapping);
-                std::cout << "Successfully saved SDF-Mapping!" << std::endl;
-                if (validate) {
-                    if (ValidateSdf(path_sdf_mapping.c_str(), program.get<std::string>("-validate").c_str()) == 0) {
-                        std::cout << "SDF-mapping valid!..." << std::endl;
-                    } else {
-                        std::cout << "SDF-mapping not valid!..." << std::endl;
+                    // Record the outputs before the dependencies, so recorded dependencies always refer to a stored
+                    // entry
+                    if (!job->device_key.empty() and device_saved) {
+                        if (conversion_cache->Store(GenerateDependencyKey(job->device_key, job->dependencies, library),
+                                                    job->output_prefix, job->output_paths) != 0 or
+                            conversion_cache->StoreDependencies(job->device_key, job->dependencies) != 0) {
+                            std::cerr << "Failed to add the converted files to the cache" << std::endl;
+                        }
                     }
                 }
+            };
+
+            if (!device_paths.empty()) {
+                // No stage needs more threads than there are device types
+                auto load_workers = StartStage(std::min(load_threads, device_paths.size()), load_stage);
+                auto convert_workers = StartStage(std::min(convert_threads, device_paths.size()), convert_stage);
+                auto write_workers = StartStage(std::min(write_threads, device_paths.size()), write_stage);
+                // Every stage ends once the stage in front of it is done and its queue is empty
+                JoinStage(load_workers);
+                loaded_devices.Close();
+                JoinStage(convert_workers);
+                converted_devices.Close();
+                JoinStage(write_workers);
+                succeeded &= devices_succeeded;
             }
         }
-        // If no path to one or more cluster definitions is given we exit the program
-        else {
-            std::cerr << "No valid combination of input parameters used" << std::endl;
-            std::exit(1);
-        }
     }
     // Check if the conversion direction is sdf to matter
     else if(program.is_used("--sdf-to-matter")) {
+        // Check if the result should be validated, the schema gets compiled once for every output file
         bool validate = program.is_used("-validate");
+        Validator validator;
+        if (validate and LoadOutputSchema(program.get<std::string>("-validate").c_str(), program.is_used("--roundtrip"),
+                                          validator) != 0) {
+            std::cerr << "Failed to load schema: " << program.get<std::string>("-validate") << std::endl;
+            std::exit(1);
+        }
         if (!(program.is_used("-sdf-model") and program.is_used("-sdf-mapping"))) {
             std::cerr << "SDF Model or SDF Mapping missing as an input argument" << std::endl;
             std::exit(1);
@@ -249,86 +897,89 @@ int main(int argc, char *argv[]) {
         auto path_sdf_model = program.get<std::string>("-sdf-model");
         auto path_sdf_mapping = program.get<std::string>("-sdf-mapping");
 
-        std::cout << "Loading SDF-Model..." << std::endl;
-        json sdf_model_json;
-        LoadJsonFile(path_sdf_model.c_str(), sdf_model_json);
-
-        std::cout << "Loading SDF-Mapping..." << std::endl;
-        json sdf_mapping_json;
-        LoadJsonFile(path_sdf_mapping.c_str(), sdf_mapping_json);
-
-        std::optional<pugi::xml_document> optional_device_xml;
-        std::list<pugi::xml_document> cluster_xml_list;
-        ConvertSdfToMatter(sdf_model_json, sdf_mapping_json, optional_device_xml, cluster_xml_list);
-
-        // Check if the round-tripping flag was set
-        if (program.is_used("--roundtrip")) {
-            std::cout << "Round-tripping flag was set!" << std::endl;
-            std::cout << "Converting Matter to SDF..." << std::endl;
-            sdf_model_json.clear();
-            sdf_mapping_json.clear();
-
-            // Convert the Matter data model back to SDF
-            ConvertMatterToSdf(optional_device_xml, cluster_xml_list, sdf_model_json, sdf_mapping_json);
-            std::cout << "Successfully converted Matter to SDF!" << std::endl;
-
-            // Generate filenames for SDF based on the -output parameter
-            std::string path_output_sdf_model;
-            std::string path_output_sdf_mapping;
-            GenerateSdfFilenames(program.get<std::string>("-output"), path_sdf_model, path_sdf_mapping);
-
-            std::cout << "Saving JSON files...." << std::endl;
-            SaveJsonFile(path_output_sdf_model.c_str(), sdf_model_json);
-            std::cout << "Successfully saved SDF-Model!" << std::endl;
-            if (validate) {
-                if (ValidateSdf(path_output_sdf_model.c_str(), program.get<std::string>("-validate").c_str()) == 0) {
-                    std::cout << "SDF-model valid!..." << std::endl;
-                } else {
-                    std::cout << "SDF-model not valid!..." << std::endl;
-                }
-            }
+        // Check if the result of the conversion is already cached
+        if (conversion_cache.has_value()) {
+            cache_key = GenerateCacheKey({"--sdf-to-matter", program.is_used("--roundtrip") ? "--roundtrip" : "",
+                                          bundle ? "--bundle" : "", cbor ? "--cbor" : "",
+                                          output_path.substr(output_prefix.size())},
+                                         {path_sdf_model, path_sdf_mapping});
+            restored = !cache_key.empty() and conversion_cache->Restore(cache_key, output_prefix, output_paths) == 0;
+        }
 
-            SaveJsonFile(path_output_sdf_mapping.c_str(), sdf_mapping_json);
-            std::cout << "Successfully saved SDF-Mapping!" << std::endl;
+        if (restored) {
+            std::cout << "Restored the converted files from the cache" << std::endl;
             if (validate) {
-                if (ValidateSdf(path_output_sdf_mapping.c_str(), program.get<std::string>("-validate").c_str()) == 0) {
-                    std::cout << "SDF-mapping valid!..." << std::endl;
-                } else {
-                    std::cout << "SDF-mapping not valid!..." << std::endl;
-                }
+                succeeded &= ValidateOutputFiles(output_paths, program.is_used("--roundtrip"), bundle, validator);
             }
         }
         else {
-            std::string path_device_xml;
-            std::string path_cluster_xml;
-            GenerateMatterFilenames(program.get<std::string>("-output"), path_device_xml, path_cluster_xml);
+            std::cout << "Loading SDF-Model..." << std::endl;
+            sdf::SdfModel input_sdf_model;
+            if (LoadSdfModelFile(path_sdf_model.c_str(), input_sdf_model) != 0) {
+                std::cerr << "Failed to load SDF-Model: " << path_sdf_model << std::endl;
+                return -1;
+            }
+
+            std::cout << "Loading SDF-Mapping..." << std::endl;
+            sdf::SdfMapping input_sdf_mapping;
+            if (LoadSdfMappingFile(path_sdf_mapping.c_str(), input_sdf_mapping) != 0) {
+                std::cerr << "Failed to load SDF-Mapping: " << path_sdf_mapping << std::endl;
+                return -1;
+            }
 
-            if (optional_device_xml.has_value()) {
-                std::cout << "Saving Device XML..." << std::endl;
-                SaveXmlFile(path_device_xml.c_str(), optional_device_xml.value());
+            // Check if the round-tripping flag was set
+            if (program.is_used("--roundtrip")) {
+                std::optional<pugi::xml_document> optional_device_xml;
+                std::list<pugi::xml_document> cluster_xml_list;
+                succeeded &= ConvertSdfToMatter(input_sdf_model, input_sdf_mapping, optional_device_xml,
+                                                cluster_xml_list) == 0;
+
+                std::cout << "Round-tripping flag was set!" << std::endl;
+                std::cout << "Converting Matter to SDF..." << std::endl;
+                sdf::SdfModel sdf_model;
+                sdf::SdfMapping sdf_mapping;
+
+                // Convert the Matter data model back to SDF
+                succeeded &= ConvertMatterToSdf(optional_device_xml, cluster_xml_list, sdf_model, sdf_mapping) == 0;
+                std::cout << "Successfully converted Matter to SDF!" << std::endl;
+
+                // Generate filenames for SDF based on the -output parameter
+                std::string path_output_sdf_model;
+                std::string path_output_sdf_mapping;
+                GenerateSdfFilenames(program.get<std::string>("-output"), path_output_sdf_model, path_output_sdf_mapping);
+
+                std::cout << "Saving JSON files...." << std::endl;
+                succeeded &= SaveSdfModelFile(path_output_sdf_model.c_str(), sdf_model, cbor) == 0;
+                output_paths.push_back(path_output_sdf_model);
+                std::cout << "Successfully saved SDF-Model!" << std::endl;
                 if (validate) {
-                    if (ValidateMatter(path_device_xml.c_str(), program.get<std::string>("-validate").c_str()) == 0) {
-                        std::cout << "Device XML valid!..." << std::endl;
+                    if (ValidateSdfFile(path_output_sdf_model.c_str(), validator) == 0) {
+                        std::cout << "SDF-model valid!..." << std::endl;
                     } else {
-                        std::cout << "Device not valid!..." << std::endl;
+                        std::cout << "SDF-model not valid!..." << std::endl;
+                        succeeded = false;
                     }
                 }
-            }
 
-            std::cout << "Saving Cluster XML..." << std::endl;
-            int counter = 0;
-            for (const auto& cluster_xml : cluster_xml_list) {
-                // Generate a filename for each cluster by numbering them
-                std::string path = path_cluster_xml + "_" + std::to_string(counter) + ".xml";
-                SaveXmlFile(path.c_str(), cluster_xml);
+                succeeded &= SaveSdfMappingFile(path_output_sdf_mapping.c_str(), sdf_mapping, cbor) == 0;
+                output_paths.push_back(path_output_sdf_mapping);
+                std::cout << "Successfully saved SDF-Mapping!" << std::endl;
                 if (validate) {
-                    if (ValidateMatter(path.c_str(), program.get<std::string>("-validate").c_str())) {
-                        std::cout << "Cluster XML" << path << "valid!..." << std::endl;
+                    if (ValidateSdfFile(path_output_sdf_mapping.c_str(), validator) == 0) {
+                        std::cout << "SDF-mapping valid!..." << std::endl;
                     } else {
-                        std::cout << "Cluster XML" << path << "not valid!..." << std::endl;
+                        std::cout << "SDF-mapping not valid!..." << std::endl;
+                        succeeded = false;
                     }
                 }
-                counter ++;
+            }
+            else {
+                // The converted files get streamed directly from the Matter data model
+                std::optional<matter::Device> device;
+                std::list<matter::Cluster> clusters;
+                succeeded &= ConvertSdfToMatter(input_sdf_model, input_sdf_mapping, device, clusters) == 0;
+                succeeded &= SaveMatterFiles(program.get<std::string>("-output"), device, clusters, bundle, cbor,
+                                             validator, output_paths);
             }
         }
     }
@@ -337,5 +988,14 @@ int main(int argc, char *argv[]) {
         std::cout << program;
     }
 
-    return 0;
+    // Add the result of a conversion to the cache
+    if (!cache_key.empty() and !restored and succeeded) {
+        if (conversion_cache->Store(cache_key, output_prefix, output_paths) != 0) {
+            std::cerr << "Failed to add the converted files to the cache" << std::endl;
+        }
+    }
+
+    ReportProfile(program, std::cout);
+
+    return succeeded ? 0 : 1;
 }
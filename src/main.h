@@ -23,8 +23,22 @@
  * Functions to load and save xml and json files.
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <iomanip>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <pugixml.hpp>
+#include "bundle.h"
+#include "cbor.h"
+#include "converter.h"
+#include "library.h"
+#include "loader.h"
+#include "mapped_file.h"
+#include "matter.h"
+#include "profiler.h"
+#include "sdf.h"
 #include "validator.h"
 
 #ifndef SDF_MATTER_CONVERTER_MAIN_H
@@ -39,9 +53,92 @@
 //!@return 0 on success, negative on failure,
 static inline int LoadJsonFile(const char* path, nlohmann::ordered_json& json_file)
 {
+    profiler::ScopedTimer timer("LoadJsonFile", path);
     try {
-        std::ifstream f(path);
-        json_file = nlohmann::ordered_json::parse(f);
+        MappedFile mapped_file;
+        if (mapped_file.Map(path) == 0) {
+            json_file = nlohmann::ordered_json::parse(mapped_file.Data(), mapped_file.Data() + mapped_file.Size());
+        } else {
+            // Fall back to reading the file as a stream, e.g. for pipes
+            std::ifstream f(path);
+            json_file = nlohmann::ordered_json::parse(f);
+        }
+    }
+    catch (const std::exception& err) {
+        std::cerr << "Failed to load JSON file: " << path << std::endl;
+        std::cerr << err.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Load a sdf-model file.
+//!
+//! This function parses the sdf-model file for a given path directly into a sdf-model object.
+//! Files in the binary CBOR format are detected by their self-described tag.
+//!
+//! @param path The path to the file.
+//! @param sdf_model The resulting sdf-model.
+//! @return 0 on success, negative on failure.
+static inline int LoadSdfModelFile(const char* path, sdf::SdfModel& sdf_model)
+{
+    profiler::ScopedTimer timer("LoadSdfModelFile", path);
+    try {
+        MappedFile mapped_file;
+        if (mapped_file.Map(path) == 0) {
+            if (cbor::IsEncoded(mapped_file.Data(), mapped_file.Size())) {
+                sdf_model = cbor::ReadSdfModel(mapped_file.Data(), mapped_file.Size());
+            } else {
+                sdf_model = sdf::ReadSdfModel(mapped_file.Data(), mapped_file.Size());
+            }
+        } else {
+            // Fall back to reading the file as a stream, e.g. for pipes
+            std::ifstream f(path, std::ios::binary);
+            if (f.peek() == 0xd9) {
+                std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+                sdf_model = cbor::ReadSdfModel(data.data(), data.size());
+            } else {
+                sdf_model = sdf::ReadSdfModel(f);
+            }
+        }
+    }
+    catch (const std::exception& err) {
+        std::cerr << "Failed to load JSON file: " << path << std::endl;
+        std::cerr << err.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Load a sdf-mapping file.
+//!
+//! This function parses the sdf-mapping file for a given path directly into a sdf-mapping object.
+//! Files in the binary CBOR format are detected by their self-described tag.
+//!
+//! @param path The path to the file.
+//! @param sdf_mapping The resulting sdf-mapping.
+//! @return 0 on success, negative on failure.
+static inline int LoadSdfMappingFile(const char* path, sdf::SdfMapping& sdf_mapping)
+{
+    profiler::ScopedTimer timer("LoadSdfMappingFile", path);
+    try {
+        MappedFile mapped_file;
+        if (mapped_file.Map(path) == 0) {
+            if (cbor::IsEncoded(mapped_file.Data(), mapped_file.Size())) {
+                sdf_mapping = cbor::ReadSdfMapping(mapped_file.Data(), mapped_file.Size());
+            } else {
+                sdf_mapping = sdf::ReadSdfMapping(mapped_file.Data(), mapped_file.Size());
+            }
+        } else {
+            // Fall back to reading the file as a stream, e.g. for pipes
+            std::ifstream f(path, std::ios::binary);
+            if (f.peek() == 0xd9) {
+                std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+                sdf_mapping = cbor::ReadSdfMapping(data.data(), data.size());
+            } else {
+                sdf_mapping = sdf::ReadSdfMapping(f);
+            }
+        }
     }
     catch (const std::exception& err) {
         std::cerr << "Failed to load JSON file: " << path << std::endl;
@@ -60,9 +157,11 @@ static inline int LoadJsonFile(const char* path, nlohmann::ordered_json& json_fi
 //! @return 0 on success, negative on failure.
 static inline int SaveJsonFile(const char* path, const nlohmann::ordered_json& json_file)
 {
+    profiler::ScopedTimer timer("SaveJsonFile", path);
     try {
         std::ofstream f(path);
-        f << json_file.dump(4);
+        // Stream the output instead of creating the whole document as a string first
+        f << std::setw(4) << json_file;
     }
     catch (const std::exception& err) {
         std::cerr << "Failed to save JSON file: " << path << std::endl;
@@ -72,16 +171,73 @@ static inline int SaveJsonFile(const char* path, const nlohmann::ordered_json& j
     return 0;
 }
 
+//! @brief Save a sdf-model into a json file.
+//!
+//! This function streams a sdf-model into a new json file without serializing it into a json object first.
+//!
+//! @param path The path to the file.
+//! @param sdf_model The input sdf-model.
+//! @param cbor Save the sdf-model in the binary CBOR format instead.
+//! @return 0 on success, negative on failure.
+static inline int SaveSdfModelFile(const char* path, const sdf::SdfModel& sdf_model, bool cbor = false)
+{
+    profiler::ScopedTimer timer("SaveSdfModelFile", path);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to save JSON file: " << path << std::endl;
+        return -1;
+    }
+    int result = cbor ? cbor::WriteSdfModel(sdf_model, fd) : sdf::WriteSdfModel(sdf_model, fd);
+    if (close(fd) != 0 or result != 0) {
+        std::cerr << "Failed to save JSON file: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Save a sdf-mapping into a json file.
+//!
+//! This function streams a sdf-mapping into a new json file without serializing it into a json object first.
+//!
+//! @param path The path to the file.
+//! @param sdf_mapping The input sdf-mapping.
+//! @param cbor Save the sdf-mapping in the binary CBOR format instead.
+//! @return 0 on success, negative on failure.
+static inline int SaveSdfMappingFile(const char* path, const sdf::SdfMapping& sdf_mapping, bool cbor = false)
+{
+    profiler::ScopedTimer timer("SaveSdfMappingFile", path);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to save JSON file: " << path << std::endl;
+        return -1;
+    }
+    int result = cbor ? cbor::WriteSdfMapping(sdf_mapping, fd) : sdf::WriteSdfMapping(sdf_mapping, fd);
+    if (close(fd) != 0 or result != 0) {
+        std::cerr << "Failed to save JSON file: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
 //!@brief Load a xml file.
 //!
 //! This function loads the xml file for a given path.
+//! The file gets mapped into memory and parsed in place, so the mapping has to outlive the resulting xml file.
 //!
 //! @param path The path to the file.
 //! @param xml_file The resulting xml file.
+//! @param mapped_file The mapping of the file.
 //! @return 0 on success, negative on failure.
-static inline int LoadXmlFile(const char* path, pugi::xml_document& xml_file)
+static inline int LoadXmlFile(const char* path, pugi::xml_document& xml_file, MappedFile& mapped_file)
 {
-    pugi::xml_parse_result result = xml_file.load_file(path);
+    profiler::ScopedTimer timer("LoadXmlFile", path);
+    pugi::xml_parse_result result;
+    if (mapped_file.Map(path) == 0 and mapped_file.Size() > 0) {
+        result = xml_file.load_buffer_inplace(mapped_file.Data(), mapped_file.Size());
+    } else {
+        // Fall back to letting pugixml read the file, e.g. for pipes
+        result = xml_file.load_file(path);
+    }
     if (!result){
         std::cerr << "Failed to load XML file: " << path << std::endl;
         return -1;
@@ -98,7 +254,362 @@ static inline int LoadXmlFile(const char* path, pugi::xml_document& xml_file)
 //! @return 0 on success, negative on failure.
 static inline int SaveXmlFile(const char* path, const pugi::xml_document& xml_file)
 {
-    return xml_file.save_file(path);
+    profiler::ScopedTimer timer("SaveXmlFile", path);
+    if (!xml_file.save_file(path)) {
+        std::cerr << "Failed to save XML file: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Parse a Matter file.
+//!
+//! This function parses the content of a xml file or a file in the binary CBOR format with the matching function.
+//! The format is detected by the self-described tag of CBOR. Xml files get parsed in place, so the content gets
+//! modified.
+//!
+//! @param path The path to the file, used for error messages.
+//! @param data The content of the file.
+//! @param size The size of the content.
+//! @param result The resulting Matter object.
+//! @param read_cbor The function used to decode the CBOR format.
+//! @param parse_xml The function used to parse the root node of the xml file.
+//! @return 0 on success, negative on failure.
+template <typename T, typename ReadCbor, typename ParseXml>
+static inline int ParseMatterFile(const char* path, char* data, std::size_t size, T& result, ReadCbor read_cbor,
+                                  ParseXml parse_xml)
+{
+    try {
+        if (cbor::IsEncoded(data, size)) {
+            result = read_cbor(data, size);
+            return 0;
+        }
+        // The xml document gets parsed in place, the parsed Matter object does not refer to it
+        pugi::xml_document xml_file;
+        if (!xml_file.load_buffer_inplace(data, size)) {
+            std::cerr << "Failed to load XML file: " << path << std::endl;
+            return -1;
+        }
+        result = parse_xml(xml_file.document_element());
+    }
+    catch (const std::exception& err) {
+        std::cerr << "Failed to load Matter file: " << path << std::endl;
+        std::cerr << err.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Load a Matter file.
+//!
+//! This function loads a xml file or a file in the binary CBOR format for a given path and parses it with the
+//! matching function.
+//!
+//! @param path The path to the file.
+//! @param result The resulting Matter object.
+//! @param read_cbor The function used to decode the CBOR format.
+//! @param parse_xml The function used to parse the root node of the xml file.
+//! @return 0 on success, negative on failure.
+template <typename T, typename ReadCbor, typename ParseXml>
+static inline int LoadMatterFile(const char* path, T& result, ReadCbor read_cbor, ParseXml parse_xml)
+{
+    MappedFile mapped_file;
+    std::string contents;
+    char* data = nullptr;
+    std::size_t size = 0;
+    if (mapped_file.Map(path) == 0) {
+        data = mapped_file.Data();
+        size = mapped_file.Size();
+    } else {
+        // Fall back to reading the file as a stream, e.g. for pipes
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            std::cerr << "Failed to load Matter file: " << path << std::endl;
+            return -1;
+        }
+        contents.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        data = contents.data();
+        size = contents.size();
+    }
+    return ParseMatterFile(path, data, size, result, read_cbor, parse_xml);
+}
+
+//! @brief Load a device type file.
+//!
+//! This function loads a device type definition in the xml or the CBOR format.
+//!
+//! @param path The path to the file.
+//! @param device The resulting device type.
+//! @return 0 on success, negative on failure.
+static inline int LoadDeviceFile(const char* path, matter::Device& device)
+{
+    profiler::ScopedTimer timer("LoadDeviceFile", path);
+    return LoadMatterFile(path, device, cbor::ReadDevice, [](const pugi::xml_node& device_node) {
+        profiler::ScopedTimer timer("ParseDevice");
+        return matter::ParseDevice(device_node);
+    });
+}
+
+//! @brief Load a cluster file.
+//!
+//! This function loads a cluster definition in the xml or the CBOR format.
+//!
+//! @param path The path to the file.
+//! @param cluster The resulting cluster.
+//! @return 0 on success, negative on failure.
+static inline int LoadClusterFile(const char* path, matter::Cluster& cluster)
+{
+    profiler::ScopedTimer timer("LoadClusterFile", path);
+    return LoadMatterFile(path, cluster, cbor::ReadCluster, [](const pugi::xml_node& cluster_node) {
+        profiler::ScopedTimer timer("ParseCluster", cluster_node.attribute("name").value());
+        return matter::ParseCluster(cluster_node);
+    });
+}
+
+//! @brief Parse a loaded device type file.
+//!
+//! This function parses a device type definition in the xml or the CBOR format loaded by the bulk loader.
+//!
+//! @param file The loaded file, gets parsed in place.
+//! @param device The resulting device type.
+//! @return 0 on success, negative on failure.
+static inline int ParseDeviceFile(loader::LoadedFile& file, matter::Device& device)
+{
+    if (file.error != 0) {
+        std::cerr << "Failed to load Matter file: " << file.path << std::endl;
+        std::cerr << std::strerror(file.error) << std::endl;
+        return -1;
+    }
+    return ParseMatterFile(file.path.c_str(), file.data.get(), file.size, device, cbor::ReadDevice,
+                           [](const pugi::xml_node& device_node) {
+        profiler::ScopedTimer timer("ParseDevice");
+        return matter::ParseDevice(device_node);
+    });
+}
+
+//! @brief Parse a loaded cluster file.
+//!
+//! This function parses a cluster definition in the xml or the CBOR format loaded by the bulk loader.
+//!
+//! @param file The loaded file, gets parsed in place.
+//! @param cluster The resulting cluster.
+//! @return 0 on success, negative on failure.
+static inline int ParseClusterFile(loader::LoadedFile& file, matter::Cluster& cluster)
+{
+    if (file.error != 0) {
+        std::cerr << "Failed to load Matter file: " << file.path << std::endl;
+        std::cerr << std::strerror(file.error) << std::endl;
+        return -1;
+    }
+    return ParseMatterFile(file.path.c_str(), file.data.get(), file.size, cluster, cbor::ReadCluster,
+                           [](const pugi::xml_node& cluster_node) {
+        profiler::ScopedTimer timer("ParseCluster", cluster_node.attribute("name").value());
+        return matter::ParseCluster(cluster_node);
+    });
+}
+
+//! @brief Save a device type into a xml file.
+//!
+//! This function streams a device type into a new xml file without building a xml document first.
+//!
+//! @param path The path to the file.
+//! @param device The input device type.
+//! @param cbor Save the device type in the binary CBOR format instead.
+//! @return 0 on success, negative on failure.
+static inline int SaveDeviceFile(const char* path, const matter::Device& device, bool cbor = false)
+{
+    profiler::ScopedTimer timer("SaveDeviceFile", path);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to save XML file: " << path << std::endl;
+        return -1;
+    }
+    int result = cbor ? cbor::WriteDevice(device, fd) : matter::WriteDevice(device, fd);
+    if (close(fd) != 0 or result != 0) {
+        std::cerr << "Failed to save XML file: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Save a cluster into a xml file.
+//!
+//! This function streams a cluster into a new xml file without building a xml document first.
+//!
+//! @param path The path to the file.
+//! @param cluster The input cluster.
+//! @param cbor Save the cluster in the binary CBOR format instead.
+//! @return 0 on success, negative on failure.
+static inline int SaveClusterFile(const char* path, const matter::Cluster& cluster, bool cbor = false)
+{
+    profiler::ScopedTimer timer("SaveClusterFile", path);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to save XML file: " << path << std::endl;
+        return -1;
+    }
+    int result = cbor ? cbor::WriteCluster(cluster, fd) : matter::WriteCluster(cluster, fd);
+    if (close(fd) != 0 or result != 0) {
+        std::cerr << "Failed to save XML file: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Save a device type and its clusters into a bundle.
+//!
+//! This function streams the device type and every cluster into a single bundle instead of separate xml files.
+//! The members are called `device.xml` and `cluster_<n>.xml`, where the clusters are numbered like the separate files.
+//! In the CBOR format, the members end with `.cbor` instead.
+//!
+//! @param path The path to the bundle.
+//! @param device The input device type, if any.
+//! @param clusters The input clusters.
+//! @param cbor Save the members in the binary CBOR format instead.
+//! @return 0 on success, negative on failure.
+static inline int SaveMatterBundle(const char* path, const std::optional<matter::Device>& device,
+                                   const std::list<matter::Cluster>& clusters, bool cbor = false)
+{
+    profiler::ScopedTimer timer("SaveMatterBundle", path);
+    bundle::BundleWriter writer;
+    if (writer.Open(path) != 0) {
+        std::cerr << "Failed to save bundle: " << path << std::endl;
+        return -1;
+    }
+    const char* extension = cbor ? ".cbor" : ".xml";
+    if (device.has_value()) {
+        writer.Add(std::string("device") + extension, [&device, cbor](int fd) {
+            return cbor ? cbor::WriteDevice(device.value(), fd) : matter::WriteDevice(device.value(), fd);
+        });
+    }
+    int counter = 0;
+    for (const auto& cluster : clusters) {
+        writer.Add("cluster_" + std::to_string(counter++) + extension, [&cluster, cbor](int fd) {
+            return cbor ? cbor::WriteCluster(cluster, fd) : matter::WriteCluster(cluster, fd);
+        });
+    }
+    if (writer.Close() != 0) {
+        std::cerr << "Failed to save bundle: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Save clusters into a cluster library.
+//!
+//! This function lays out the given clusters as a flat cluster library, which can be used without parsing it.
+//!
+//! @param path The path to the library.
+//! @param clusters The input clusters.
+//! @return 0 on success, negative on failure.
+static inline int SaveLibraryFile(const char* path, const std::list<matter::Cluster>& clusters)
+{
+    profiler::ScopedTimer timer("SaveLibraryFile", path);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to save cluster library: " << path << std::endl;
+        return -1;
+    }
+    int result = library::WriteLibrary(clusters, fd);
+    if (close(fd) != 0 or result != 0) {
+        std::cerr << "Failed to save cluster library: " << path << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+//! @brief Load the schema used to validate the output files.
+//!
+//! This function compiles the schema at the given path once, a json schema for sdf files and a xsd schema for
+//! xml files. The returned validator can be used for every output file by multiple threads.
+//!
+//! @param schema_path The path to the schema.
+//! @param sdf_output Whether the output files are sdf files.
+//! @param validator The validator of the compiled schema.
+//! @return 0 on success, negative on failure.
+static inline int LoadOutputSchema(const char* schema_path, bool sdf_output, Validator& validator)
+{
+    profiler::ScopedTimer timer("LoadSchema", schema_path);
+    if (sdf_output) {
+        auto schema = std::make_shared<SdfSchema>();
+        if (schema->Load(schema_path) != 0) {
+            return -1;
+        }
+        validator = [schema](const char* data, std::size_t size, const char* name) {
+            return schema->Validate(data, size, name);
+        };
+    } else {
+        auto schema = std::make_shared<MatterSchema>();
+        if (schema->Load(schema_path) != 0) {
+            return -1;
+        }
+        validator = [schema](const char* data, std::size_t size, const char* name) {
+            return schema->Validate(data, size, name);
+        };
+    }
+    return 0;
+}
+
+//! @brief Validate a sdf file.
+//!
+//! This function validates the sdf file for a given path with the given compiled schema.
+//!
+//! @param path The path to the file.
+//! @param validator The validator of the compiled schema.
+//! @return 0 on success, negative on failure.
+static inline int ValidateSdfFile(const char* path, const Validator& validator)
+{
+    profiler::ScopedTimer timer("ValidateSdf", path);
+    MappedFile file;
+    if (file.Map(path) != 0) {
+        std::cerr << "Failed to load file: " << path << std::endl;
+        return -1;
+    }
+    return validator(file.Data(), file.Size(), path);
+}
+
+//! @brief Validate a xml file.
+//!
+//! This function validates the xml file for a given path with the given compiled schema.
+//!
+//! @param path The path to the file.
+//! @param validator The validator of the compiled schema.
+//! @return 0 on success, negative on failure.
+static inline int ValidateMatterFile(const char* path, const Validator& validator)
+{
+    profiler::ScopedTimer timer("ValidateMatter", path);
+    MappedFile file;
+    if (file.Map(path) != 0) {
+        std::cerr << "Failed to load file: " << path << std::endl;
+        return -1;
+    }
+    return validator(file.Data(), file.Size(), path);
+}
+
+//! @brief Validate the xml files of a bundle.
+//!
+//! This function validates every member of the bundle for a given path with the given compiled schema.
+//!
+//! @param path The path to the bundle.
+//! @param validator The validator of the compiled schema.
+//! @return 0 if every member is valid, negative otherwise.
+static inline int ValidateMatterBundleFile(const char* path, const Validator& validator)
+{
+    profiler::ScopedTimer timer("ValidateMatterBundle", path);
+    bundle::BundleReader reader;
+    if (reader.Open(path) != 0) {
+        std::cerr << "Failed to load bundle: " << path << std::endl;
+        return -1;
+    }
+    int result = 0;
+    for (const auto& entry : reader.Entries()) {
+        std::string_view content = reader.Content(entry);
+        std::string name = std::string(path) + ":" + entry.name;
+        if (validator(content.data(), content.size(), name.c_str()) != 0) {
+            result = -1;
+        }
+    }
+    return result;
 }
 
 #endif //SDF_MATTER_CONVERTER_MAIN_H
@@ -0,0 +1,212 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <writer.h>
+#include "main.h"
+#include "ndjson.h"
+#include "queue.h"
+
+namespace ndjson {
+
+namespace {
+
+//! Number of requests that can wait between two stages
+const std::size_t kQueueDepth = 16;
+
+//! Request that gets passed through the stages
+//! Holds the parsed input and the result of the conversion.
+struct Job {
+    nlohmann::ordered_json id;
+    //! Set, if the request failed in one of the stages
+    std::string error;
+    //! Set, if the request gets converted from sdf to Matter
+    bool to_matter = false;
+    sdf::SdfModel sdf_model;
+    sdf::SdfMapping sdf_mapping;
+    std::optional<matter::Device> device;
+    std::list<matter::Cluster> clusters;
+};
+
+//! Function used to parse a sdf-model or sdf-mapping member of a request
+//! The member either contains the json itself or the path to a file.
+template <typename T, typename Load, typename Parse>
+int ParseSdfMember(nlohmann::ordered_json& member, T& result, Load load, Parse parse) {
+    if (member.is_string()) {
+        return load(member.get_ref<const std::string&>().c_str(), result);
+    }
+    result = parse(member);
+    return 0;
+}
+
+//! Function used to parse a request and load its input
+void ParseRequest(const std::string& line, Job& job) {
+    profiler::ScopedTimer timer("ParseRequest");
+    try {
+        auto request = nlohmann::ordered_json::parse(line);
+        if (!request.is_object()) {
+            job.error = "Request is not a json object";
+            return;
+        }
+        if (request.contains("id")) {
+            job.id = request.at("id");
+        }
+
+        if (request.contains("sdf-model")) {
+            job.to_matter = true;
+            if (!request.contains("sdf-mapping")) {
+                job.error = "Request contains no sdf-mapping";
+            } else if (ParseSdfMember(request.at("sdf-model"), job.sdf_model, LoadSdfModelFile,
+                                      sdf::ParseSdfModel) != 0) {
+                job.error = "Failed to load the sdf-model";
+            } else if (ParseSdfMember(request.at("sdf-mapping"), job.sdf_mapping, LoadSdfMappingFile,
+                                      sdf::ParseSdfMapping) != 0) {
+                job.error = "Failed to load the sdf-mapping";
+            }
+        } else if (request.contains("device-xml")) {
+            const auto& path = request.at("device-xml").get_ref<const std::string&>();
+            if (LoadDeviceFile(path.c_str(), job.device.emplace()) != 0) {
+                job.error = "Failed to load the device-xml";
+            }
+        } else {
+            job.error = "Request contains neither a sdf-model nor a device-xml";
+        }
+    }
+    catch (const std::exception& err) {
+        job.error = err.what();
+    }
+}
+
+//! Function used to convert the input of a request with the given session
+void ConvertRequest(const Converter& converter, Job& job) {
+    if (!job.error.empty()) {
+        return;
+    }
+    try {
+        int result;
+        if (job.to_matter) {
+            result = converter.ConvertSdfToMatter(job.sdf_model, job.sdf_mapping, job.device, job.clusters);
+        } else {
+            result = converter.ConvertMatterToSdf(job.device, job.sdf_model, job.sdf_mapping);
+        }
+        if (result != 0) {
+            job.error = "Conversion failed";
+        }
+    }
+    catch (const std::exception& err) {
+        job.error = err.what();
+    }
+}
+
+//! Function used to save a xml document into a string
+std::string SaveXml(const pugi::xml_document& xml_file) {
+    std::ostringstream stream;
+    xml_file.save(stream);
+    return stream.str();
+}
+
+//! Function used to serialize the response to a request into a single line
+std::string SerializeResponse(const Job& job) {
+    profiler::ScopedTimer timer("SerializeResponse");
+    nlohmann::ordered_json response;
+    response["id"] = job.id;
+    if (!job.error.empty()) {
+        response["error"] = job.error;
+    } else if (job.to_matter) {
+        if (job.device.has_value()) {
+            pugi::xml_document device_xml;
+            matter::SerializeDevice(job.device.value(), device_xml);
+            response["device-xml"] = SaveXml(device_xml);
+        }
+        response["cluster-xml"] = nlohmann::ordered_json::array();
+        for (const auto& cluster : job.clusters) {
+            pugi::xml_document cluster_xml;
+            matter::SerializeCluster(cluster, cluster_xml);
+            response["cluster-xml"].push_back(SaveXml(cluster_xml));
+        }
+    } else {
+        response["sdf-model"] = sdf::SerializeSdfModel(job.sdf_model);
+        response["sdf-mapping"] = sdf::SerializeSdfMapping(job.sdf_mapping);
+    }
+    // Invalid UTF-8 inside the definitions must not stop the service
+    return response.dump(-1, ' ', false, nlohmann::ordered_json::error_handler_t::replace) + "\n";
+}
+
+} // namespace
+
+//! Function used to serve conversion requests
+//! The requests are passed through bounded queues, so the stages stay in order and at most a few requests are in
+//! flight if the output is slower than the input.
+int Serve(const Converter& converter, std::istream& input, int output_fd) {
+    BoundedQueue<Job> parsed(kQueueDepth, "ParsedRequestQueue");
+    BoundedQueue<Job> converted(kQueueDepth, "ConvertedRequestQueue");
+    std::atomic<bool> failed(false);
+
+    std::thread convert_thread([&] {
+        while (auto job = parsed.Pop()) {
+            ConvertRequest(converter, *job);
+            if (!converted.Push(std::move(*job))) {
+                break;
+            }
+        }
+        converted.Close();
+    });
+
+    std::thread write_thread([&] {
+        BufferedWriter output(output_fd);
+        while (auto job = converted.Pop()) {
+            if (!job->error.empty()) {
+                failed = true;
+            }
+            output.Write(SerializeResponse(*job));
+            // Hand the responses to the output as soon as no further response is ready
+            if (converted.Size() == 0 and output.Flush() != 0) {
+                break;
+            }
+        }
+        // If the output got closed, the other stages get stopped
+        if (output.Flush() != 0) {
+            failed = true;
+            converted.Close();
+            parsed.Close();
+        }
+    });
+
+    std::string line;
+    while (std::getline(input, line)) {
+        // Empty lines between the requests get ignored
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        Job job;
+        ParseRequest(line, job);
+        if (!parsed.Push(std::move(job))) {
+            break;
+        }
+    }
+    parsed.Close();
+
+    convert_thread.join();
+    write_thread.join();
+    return failed ? -1 : 0;
+}
+
+} // namespace ndjson
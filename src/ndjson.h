@@ -0,0 +1,54 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Conversion service that reads newline-delimited json requests and writes the results as newline-delimited json.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_NDJSON_H
+#define SDF_MATTER_CONVERTER_NDJSON_H
+
+#include <istream>
+#include <converter.h>
+
+namespace ndjson {
+
+//! @brief Serve conversion requests.
+//!
+//! This function reads one json request per line from the input and writes one json response per line to the
+//! output, in the order of the requests. A request either contains a "sdf-model" and a "sdf-mapping", inline or as
+//! paths, which get converted to Matter, or a "device-xml" path, which gets converted to sdf with the clusters of the
+//! session. The optional "id" of a request gets copied into its response. Failed requests are answered with an
+//! "error" and do not stop the service.
+//!
+//! Reading and parsing, converting as well as serializing and writing run on separate threads, so the next request
+//! gets parsed while the previous one is converted and serialized.
+//!
+//! @param converter The session used for every request.
+//! @param input The stream the requests get read from.
+//! @param output_fd The file descriptor the responses get written to.
+//! @return 0 if every request was converted, negative if a request failed or the output could not be written.
+int Serve(const Converter& converter, std::istream& input, int output_fd);
+
+} // namespace ndjson
+
+#endif //SDF_MATTER_CONVERTER_NDJSON_H
@@ -0,0 +1,103 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Bounded queue used to hand work between the threads of a pipeline.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_QUEUE_H
+#define SDF_MATTER_CONVERTER_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <profiler.h>
+
+//! Bounded queue for multiple producers and consumers
+//! Producers block while the queue is full, so a slow stage slows down the stages in front of it instead of
+//! collecting an unbounded amount of work. The depth of the queue gets sampled as a gauge of the profiler.
+template <typename T>
+class BoundedQueue {
+public:
+    //! Constructor
+    //! The name of the depth gauge has to outlive the profiler, usually it is a string literal.
+    BoundedQueue(std::size_t capacity, const char* name) : capacity(capacity), name(name) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    //! Function used to append an item, blocks while the queue is full
+    //! Returns false if the queue was closed and the item was dropped.
+    //! The depth is sampled before waiting, so a depth equal to the capacity means that the producer was blocked.
+    bool Push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        profiler::Sample(name, items.size());
+        not_full.wait(lock, [this] { return closed or items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    //! Function used to take the next item, blocks while the queue is empty
+    //! Returns no item once the queue is closed and all remaining items were taken.
+    std::optional<T> Pop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this] { return closed or !items.empty(); });
+        if (items.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return item;
+    }
+
+    //! Function used to close the queue
+    //! Items that are already queued can still be taken, further items get dropped.
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    //! Function used to get the number of queued items
+    std::size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return items.size();
+    }
+
+private:
+    std::size_t capacity;
+    const char* name;
+    mutable std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<T> items;
+    bool closed = false;
+};
+
+#endif //SDF_MATTER_CONVERTER_QUEUE_H
@@ -0,0 +1,776 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Regression test that converts a checked-in corpus and compares the results against golden files.
+ * The corpus contains a directory per test case:
+ *
+ * - The xml files in `matter-to-sdf/<case>/input` get converted and compared with `sdf-model.json` and
+ *   `sdf-mapping.json`.
+ * - `sdf-to-matter/<case>/input/sdf-model.json` and `sdf-mapping.json` get converted and compared with
+ *   `device.xml` and the xml files in `clusters`.
+ *
+ * The test cases run in parallel. The comparison is structural, so the order of named elements and the
+ * formatting of the files do not matter. Additionally, the xml files streamed by matter::WriteDevice and
+ * matter::WriteCluster have to be byte-identical to the saved documents and every converted model has to survive a
+ * round-trip through the CBOR format unchanged. Converting Matter with the clusters of a flat cluster library has to
+ * give the same result as with the parsed clusters. Loading the corpus many times over has to succeed even if there are
+ * more files than open descriptors allowed. Reading and parsing sdf-models with sdfRefs has to give the same
+ * resolution.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <argparse/argparse.hpp>
+#include <nlohmann/json.hpp>
+#include <pugixml.hpp>
+#include "cbor.h"
+#include "converter.h"
+#include "library.h"
+#include "loader.h"
+#include "matter.h"
+#include "model_diff.h"
+#include "prescan.h"
+#include "sdf.h"
+
+namespace fs = std::filesystem;
+
+//! Single test case of the corpus
+struct GoldenCase {
+    //! Either matter-to-sdf or sdf-to-matter
+    std::string direction;
+    fs::path path;
+};
+
+//! Result of a single test case
+struct GoldenResult {
+    //! Set, if the test case could not be run
+    std::string error;
+    std::vector<model_diff::Difference> differences;
+};
+
+//! Function used to load a json file
+nlohmann::ordered_json LoadJson(const fs::path& path) {
+    std::ifstream f(path);
+    if (!f) {
+        throw std::runtime_error("Failed to load JSON file: " + path.string());
+    }
+    return nlohmann::ordered_json::parse(f);
+}
+
+//! Function used to save a json file in the format used by the converter
+void SaveJson(const fs::path& path, const nlohmann::ordered_json& json_file) {
+    std::ofstream f(path);
+    f << json_file.dump(4) << std::endl;
+    if (!f) {
+        throw std::runtime_error("Failed to save JSON file: " + path.string());
+    }
+}
+
+//! Parsed cluster together with its definition
+struct ParsedCluster {
+    matter::Cluster cluster;
+    const pugi::xml_document* cluster_xml;
+};
+
+//! Function used to parse the given clusters, sorted by their id and side
+//! Sorting makes the comparison and the names of the golden files independent of the order of the output.
+std::vector<ParsedCluster> ParseClusters(const std::list<pugi::xml_document>& cluster_xml_list) {
+    std::vector<ParsedCluster> clusters;
+    for (const auto& cluster_xml : cluster_xml_list) {
+        clusters.push_back({matter::ParseCluster(cluster_xml.document_element()), &cluster_xml});
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const ParsedCluster& lhs, const ParsedCluster& rhs) {
+        return std::tie(lhs.cluster.id, lhs.cluster.side, lhs.cluster.name) <
+               std::tie(rhs.cluster.id, rhs.cluster.side, rhs.cluster.name);
+    });
+    return clusters;
+}
+
+//! Function used to generate the file names of the golden clusters
+std::vector<std::string> GenerateClusterFilenames(const std::vector<ParsedCluster>& clusters) {
+    std::vector<std::string> filenames;
+    for (const auto& parsed_cluster : clusters) {
+        std::string filename = IntToHex(parsed_cluster.cluster.id);
+        // Clusters with the same id get numbered
+        while (std::find(filenames.begin(), filenames.end(), filename + ".xml") != filenames.end()) {
+            filename += "_";
+        }
+        filenames.push_back(filename + ".xml");
+    }
+    return filenames;
+}
+
+//! Function used to save a xml document into a string in the format used by the converter
+std::string SaveXml(const pugi::xml_document& xml_file) {
+    std::ostringstream stream;
+    xml_file.save(stream);
+    return stream.str();
+}
+
+//! Function used to stream a value into a string with the given write function
+template <typename T>
+std::string WriteString(const T& value, int (*write)(const T&, int)) {
+    std::FILE* file = std::tmpfile();
+    if (file == nullptr) {
+        throw std::runtime_error("Failed to create a temporary file");
+    }
+    std::string content;
+    if (write(value, fileno(file)) == 0 and std::fseek(file, 0, SEEK_SET) == 0) {
+        char buffer[4096];
+        std::size_t size;
+        while ((size = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            content.append(buffer, size);
+        }
+    }
+    std::fclose(file);
+    return content;
+}
+
+//! Function used to compare the streamed xml with the saved document
+void CompareStreamedXml(const std::string& saved, const std::string& streamed, const std::string& path,
+                        GoldenResult& result) {
+    if (saved == streamed) {
+        return;
+    }
+    std::size_t offset = std::mismatch(saved.begin(), saved.end(), streamed.begin(), streamed.end()).first -
+                         saved.begin();
+    result.differences.push_back({path + ".streamed", saved.substr(offset, 40), streamed.substr(offset, 40)});
+}
+
+//! Function used to compare a value with the result of its round-trip through the CBOR format
+template <typename T, typename Diff>
+void CompareCbor(const T& value, int (*write)(const T&, int), T (*read)(const char*, std::size_t), Diff diff,
+                 const std::string& path, GoldenResult& result) {
+    std::string encoded = WriteString(value, write);
+    diff(value, read(encoded.data(), encoded.size()), path + ".cbor", result.differences);
+}
+
+//! Function used to check the round-trip of the converted models through the CBOR format
+void CompareCborModels(const std::optional<matter::Device>& device, const std::list<matter::Cluster>& clusters,
+                       const sdf::SdfModel& sdf_model, const sdf::SdfMapping& sdf_mapping, GoldenResult& result) {
+    if (device.has_value()) {
+        CompareCbor(device.value(), cbor::WriteDevice, cbor::ReadDevice, model_diff::DiffDevice, "device", result);
+    }
+    for (const auto& cluster : clusters) {
+        CompareCbor(cluster, cbor::WriteCluster, cbor::ReadCluster, model_diff::DiffCluster,
+                    "clusters[" + IntToHex(cluster.id) + "]", result);
+    }
+    CompareCbor(sdf_model, cbor::WriteSdfModel, cbor::ReadSdfModel, model_diff::DiffSdfModel, "sdf-model", result);
+    CompareCbor(sdf_mapping, cbor::WriteSdfMapping, cbor::ReadSdfMapping, model_diff::DiffSdfMapping, "sdf-mapping",
+                result);
+}
+
+//! Function used to compare the conversion with the clusters of a flat cluster library with the given result
+//! With a device type, only the clusters it depends on get loaded from the library. The clusters get converted by a
+//! converter session, which gets used twice.
+void CompareLibraryConversion(const GoldenCase& golden_case, const std::optional<matter::Device>& device,
+                              const std::list<matter::Cluster>& clusters,
+                              const nlohmann::ordered_json& sdf_model_json,
+                              const nlohmann::ordered_json& sdf_mapping_json, GoldenResult& result) {
+    fs::path library_path = fs::temp_directory_path() / ("golden_test_" + golden_case.path.filename().string() +
+                                                         "_" + std::to_string(getpid()) + ".library");
+    int fd = open(library_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 or library::WriteLibrary(clusters, fd) != 0 or close(fd) != 0) {
+        throw std::runtime_error("Failed to save cluster library: " + library_path.string());
+    }
+    library::LibraryView cluster_library;
+    int opened = cluster_library.Open(library_path.c_str());
+    fs::remove(library_path);
+    if (opened != 0) {
+        throw std::runtime_error("Failed to load cluster library: " + library_path.string());
+    }
+
+    std::size_t index = 0;
+    for (const auto& cluster : clusters) {
+        library::ClusterView cluster_view = cluster_library.Clusters()[index++];
+        if (cluster_view.Id() != cluster.id or cluster_view.Name() != cluster.name or
+            cluster_view.Aliases().size() != cluster.cluster_aliases.size()) {
+            result.differences.push_back({"clusters[" + IntToHex(cluster.id) + "].library", cluster.name,
+                                          std::string(cluster_view.Name())});
+        }
+    }
+
+    // A session has to give the same result for every conversion
+    Converter converter(device.has_value() ? cluster_library.LoadClusters(device.value())
+                                           : cluster_library.LoadClusters());
+    for (const char* run : {".library", ".library.reused"}) {
+        sdf::SdfModel sdf_model;
+        sdf::SdfMapping sdf_mapping;
+        converter.ConvertMatterToSdf(device, sdf_model, sdf_mapping);
+        model_diff::DiffJson(sdf_model_json, sdf::SerializeSdfModel(sdf_model), std::string("sdf-model") + run,
+                             result.differences);
+        model_diff::DiffJson(sdf_mapping_json, sdf::SerializeSdfMapping(sdf_mapping), std::string("sdf-mapping") + run,
+                             result.differences);
+    }
+}
+
+//! Function used to compare the conversion with the clusters of a scanned cluster library with the given result
+//! The headers of the cluster definitions have to match the parsed clusters, both when they are scanned and when they
+//! are taken from a saved cluster index. With a device type, only the clusters it depends on get parsed.
+void CompareScannedConversion(const GoldenCase& golden_case, const std::vector<std::string>& cluster_paths,
+                              const std::optional<matter::Device>& device,
+                              const std::list<matter::Cluster>& clusters,
+                              const nlohmann::ordered_json& sdf_model_json,
+                              const nlohmann::ordered_json& sdf_mapping_json, GoldenResult& result) {
+    prescan::LazyClusterLibrary cluster_library(loader::LoadFiles(cluster_paths));
+    if (cluster_library.Size() != clusters.size()) {
+        result.differences.push_back({"clusters.scanned", std::to_string(clusters.size()),
+                                      std::to_string(cluster_library.Size())});
+        return;
+    }
+
+    std::size_t index = 0;
+    for (const auto& cluster : clusters) {
+        const prescan::ClusterHeader& header = cluster_library.Header(index++);
+        std::string base_cluster = cluster.classification.has_value() ? cluster.classification->base_cluster : "";
+        if (header.id != cluster.id or header.name != cluster.name or
+            header.cluster_aliases != cluster.cluster_aliases or header.base_cluster != base_cluster) {
+            result.differences.push_back({"clusters[" + IntToHex(cluster.id) + "].scanned", cluster.name,
+                                          header.name});
+        }
+    }
+
+    // A saved index has to give the same headers as the scanned files and has to be reused as long as they do not
+    // change
+    fs::path index_path = fs::temp_directory_path() / ("golden_test_" + golden_case.path.filename().string() + "_" +
+                                                       std::to_string(getpid()) + ".index.json");
+    prescan::ClusterIndex cluster_index;
+    std::vector<std::string> failed_paths;
+    cluster_index.Update(cluster_paths, failed_paths);
+    int saved = cluster_index.Save(index_path);
+    prescan::ClusterIndex saved_index;
+    int loaded = saved_index.Load(index_path);
+    fs::remove(index_path);
+    if (saved != 0 or loaded != 0 or saved_index.Update(cluster_paths, failed_paths) or !failed_paths.empty()) {
+        result.differences.push_back({"clusters.index", "<reused>", "<scanned>"});
+    }
+    for (const auto& cluster : clusters) {
+        auto entry = std::find_if(saved_index.Entries().begin(), saved_index.Entries().end(),
+                                  [&cluster](const auto& entry) { return entry.header.id == cluster.id; });
+        if (entry == saved_index.Entries().end() or entry->header.name != cluster.name) {
+            result.differences.push_back({"clusters[" + IntToHex(cluster.id) + "].index", cluster.name,
+                                          entry == saved_index.Entries().end() ? "<missing>" : entry->header.name});
+        }
+    }
+
+    prescan::LazyClusterLibrary indexed_library(saved_index);
+    for (const auto* scanned_library : {&cluster_library, &indexed_library}) {
+        std::string run = scanned_library == &cluster_library ? ".scanned" : ".indexed";
+        Converter converter(device.has_value() ? scanned_library->LoadClusters(device.value())
+                                               : scanned_library->LoadClusters());
+        sdf::SdfModel sdf_model;
+        sdf::SdfMapping sdf_mapping;
+        converter.ConvertMatterToSdf(device, sdf_model, sdf_mapping);
+        model_diff::DiffJson(sdf_model_json, sdf::SerializeSdfModel(sdf_model), "sdf-model" + run,
+                             result.differences);
+        model_diff::DiffJson(sdf_mapping_json, sdf::SerializeSdfMapping(sdf_mapping), "sdf-mapping" + run,
+                             result.differences);
+    }
+}
+
+//! Function used to load the device type and cluster definitions of a test case converting Matter to sdf
+void LoadMatterInputs(const GoldenCase& golden_case, std::optional<pugi::xml_document>& device_xml,
+                      std::list<pugi::xml_document>& cluster_xml_list, std::vector<std::string>& cluster_paths) {
+    std::vector<fs::path> input_paths;
+    for (const auto& entry : fs::directory_iterator(golden_case.path / "input")) {
+        if (entry.path().extension() == ".xml") {
+            input_paths.push_back(entry.path());
+        }
+    }
+    std::sort(input_paths.begin(), input_paths.end());
+    for (const auto& input_path : input_paths) {
+        pugi::xml_document xml_document;
+        if (!xml_document.load_file(input_path.c_str())) {
+            throw std::runtime_error("Failed to load XML file: " + input_path.string());
+        }
+        if (std::string(xml_document.document_element().name()) == "deviceType") {
+            device_xml = std::move(xml_document);
+        } else {
+            cluster_xml_list.push_back(std::move(xml_document));
+            cluster_paths.push_back(input_path.string());
+        }
+    }
+}
+
+//! Function used to run a test case converting Matter to sdf
+void RunMatterToSdf(const GoldenCase& golden_case, bool update, GoldenResult& result) {
+    std::optional<pugi::xml_document> device_xml;
+    std::list<pugi::xml_document> cluster_xml_list;
+    std::vector<std::string> cluster_paths;
+    LoadMatterInputs(golden_case, device_xml, cluster_xml_list, cluster_paths);
+
+    nlohmann::ordered_json sdf_model_json;
+    nlohmann::ordered_json sdf_mapping_json;
+    ConvertMatterToSdf(device_xml, cluster_xml_list, sdf_model_json, sdf_mapping_json);
+
+    if (update) {
+        SaveJson(golden_case.path / "sdf-model.json", sdf_model_json);
+        SaveJson(golden_case.path / "sdf-mapping.json", sdf_mapping_json);
+        return;
+    }
+    // The json documents get compared directly, as objects compare equal regardless of the order of their keys
+    model_diff::DiffJson(LoadJson(golden_case.path / "sdf-model.json"), sdf_model_json, "sdf-model",
+                         result.differences);
+    model_diff::DiffJson(LoadJson(golden_case.path / "sdf-mapping.json"), sdf_mapping_json, "sdf-mapping",
+                         result.differences);
+
+    std::optional<matter::Device> device;
+    if (device_xml.has_value()) {
+        device = matter::ParseDevice(device_xml->document_element());
+    }
+    std::list<matter::Cluster> clusters;
+    for (const auto& cluster_xml : cluster_xml_list) {
+        clusters.push_back(matter::ParseCluster(cluster_xml.document_element()));
+    }
+    CompareCborModels(device, clusters, sdf::ParseSdfModel(sdf_model_json), sdf::ParseSdfMapping(sdf_mapping_json),
+                      result);
+    CompareLibraryConversion(golden_case, device, clusters, sdf_model_json, sdf_mapping_json, result);
+    CompareScannedConversion(golden_case, cluster_paths, device, clusters, sdf_model_json, sdf_mapping_json, result);
+}
+
+//! Function used to run a test case converting sdf to Matter
+void RunSdfToMatter(const GoldenCase& golden_case, bool update, GoldenResult& result) {
+    nlohmann::ordered_json sdf_model_json = LoadJson(golden_case.path / "input" / "sdf-model.json");
+    nlohmann::ordered_json sdf_mapping_json = LoadJson(golden_case.path / "input" / "sdf-mapping.json");
+    std::optional<pugi::xml_document> device_xml;
+    std::list<pugi::xml_document> cluster_xml_list;
+    ConvertSdfToMatter(sdf_model_json, sdf_mapping_json, device_xml, cluster_xml_list);
+
+    std::vector<ParsedCluster> clusters = ParseClusters(cluster_xml_list);
+    std::vector<std::string> cluster_filenames = GenerateClusterFilenames(clusters);
+    fs::path device_path = golden_case.path / "device.xml";
+    fs::path clusters_path = golden_case.path / "clusters";
+
+    if (update) {
+        fs::remove(device_path);
+        fs::remove_all(clusters_path);
+        fs::create_directories(clusters_path);
+        if (device_xml.has_value() and !device_xml->save_file(device_path.c_str())) {
+            throw std::runtime_error("Failed to save XML file: " + device_path.string());
+        }
+        for (std::size_t i = 0; i < clusters.size(); i++) {
+            fs::path cluster_path = clusters_path / cluster_filenames[i];
+            if (!clusters[i].cluster_xml->save_file(cluster_path.c_str())) {
+                throw std::runtime_error("Failed to save XML file: " + cluster_path.string());
+            }
+        }
+        return;
+    }
+
+    if (fs::exists(device_path) or device_xml.has_value()) {
+        if (!fs::exists(device_path)) {
+            result.differences.push_back({"device", "<missing>", "<present>"});
+        } else if (!device_xml.has_value()) {
+            result.differences.push_back({"device", "<present>", "<missing>"});
+        } else {
+            pugi::xml_document golden_device_xml;
+            if (!golden_device_xml.load_file(device_path.c_str())) {
+                throw std::runtime_error("Failed to load XML file: " + device_path.string());
+            }
+            model_diff::DiffDevice(matter::ParseDevice(golden_device_xml.document_element()),
+                                   matter::ParseDevice(device_xml->document_element()), "device",
+                                   result.differences);
+        }
+    }
+
+    std::list<pugi::xml_document> golden_cluster_xml_list;
+    if (fs::exists(clusters_path)) {
+        for (const auto& entry : fs::directory_iterator(clusters_path)) {
+            if (!golden_cluster_xml_list.emplace_back().load_file(entry.path().c_str())) {
+                throw std::runtime_error("Failed to load XML file: " + entry.path().string());
+            }
+        }
+    }
+    std::vector<ParsedCluster> golden_clusters = ParseClusters(golden_cluster_xml_list);
+    if (golden_clusters.size() != clusters.size()) {
+        result.differences.push_back({"clusters.size", std::to_string(golden_clusters.size()),
+                                      std::to_string(clusters.size())});
+    }
+    for (std::size_t i = 0; i < golden_clusters.size() and i < clusters.size(); i++) {
+        model_diff::DiffCluster(golden_clusters[i].cluster, clusters[i].cluster,
+                                "clusters[" + IntToHex(clusters[i].cluster.id) + "]", result.differences);
+    }
+
+    // The streamed output has to equal the saved documents byte for byte
+    std::optional<matter::Device> device;
+    std::list<matter::Cluster> cluster_list;
+    sdf::SdfModel sdf_model = sdf::ParseSdfModel(sdf_model_json);
+    sdf::SdfMapping sdf_mapping = sdf::ParseSdfMapping(sdf_mapping_json);
+    ConvertSdfToMatter(sdf_model, sdf_mapping, device, cluster_list);
+    CompareCborModels(device, cluster_list, sdf_model, sdf_mapping, result);
+    if (device.has_value() and device_xml.has_value()) {
+        CompareStreamedXml(SaveXml(device_xml.value()), WriteString(device.value(), matter::WriteDevice), "device",
+                           result);
+    }
+    auto cluster_xml = cluster_xml_list.begin();
+    for (const auto& cluster : cluster_list) {
+        if (cluster_xml == cluster_xml_list.end()) {
+            break;
+        }
+        CompareStreamedXml(SaveXml(*cluster_xml++), WriteString(cluster, matter::WriteCluster),
+                           "clusters[" + IntToHex(cluster.id) + "]", result);
+    }
+}
+
+//! Function used to convert a sdf-model and a sdf-mapping with a converter session
+//! Returns the serialized device type and clusters.
+std::string ConvertSdfWithSession(nlohmann::ordered_json& sdf_model_json, nlohmann::ordered_json& sdf_mapping_json,
+                                  const Converter& converter) {
+    sdf::SdfModel sdf_model = sdf::ParseSdfModel(sdf_model_json);
+    sdf::SdfMapping sdf_mapping = sdf::ParseSdfMapping(sdf_mapping_json);
+    std::optional<matter::Device> device;
+    std::list<matter::Cluster> cluster_list;
+    converter.ConvertSdfToMatter(sdf_model, sdf_mapping, device, cluster_list);
+    std::string output;
+    if (device.has_value()) {
+        output = WriteString(device.value(), matter::WriteDevice);
+    }
+    for (const auto& cluster : cluster_list) {
+        output += WriteString(cluster, matter::WriteCluster);
+    }
+    return output;
+}
+
+//! Function used to remove every sdfRequired quality from a sdf-model
+void RemoveRequired(nlohmann::ordered_json& sdf_model_json) {
+    if (sdf_model_json.is_object()) {
+        sdf_model_json.erase("sdfRequired");
+    }
+    if (sdf_model_json.is_structured()) {
+        for (auto& value : sdf_model_json) {
+            RemoveRequired(value);
+        }
+    }
+}
+
+//! Function used to convert the inputs of a test case with a converter session
+//! Returns the serialized output of the conversion.
+//! A sdf-model can be converted without its sdfRequired qualities and without its sdf-mapping, which must not give the
+//! same result as a previous conversion with them.
+std::string ConvertWithSession(const GoldenCase& golden_case, const Converter& sdf_converter, bool stripped = false) {
+    std::string output;
+    if (golden_case.direction == "matter-to-sdf") {
+        std::optional<pugi::xml_document> device_xml;
+        std::list<pugi::xml_document> cluster_xml_list;
+        std::vector<std::string> cluster_paths;
+        LoadMatterInputs(golden_case, device_xml, cluster_xml_list, cluster_paths);
+        std::optional<matter::Device> device;
+        if (device_xml.has_value()) {
+            device = matter::ParseDevice(device_xml->document_element());
+        }
+        Converter converter(cluster_xml_list);
+        sdf::SdfModel sdf_model;
+        sdf::SdfMapping sdf_mapping;
+        converter.ConvertMatterToSdf(device, sdf_model, sdf_mapping);
+        output = sdf::SerializeSdfModel(sdf_model).dump(4) + sdf::SerializeSdfMapping(sdf_mapping).dump(4);
+    } else {
+        nlohmann::ordered_json sdf_model_json = LoadJson(golden_case.path / "input" / "sdf-model.json");
+        nlohmann::ordered_json sdf_mapping_json = LoadJson(golden_case.path / "input" / "sdf-mapping.json");
+        if (stripped) {
+            RemoveRequired(sdf_model_json);
+            sdf_mapping_json = nlohmann::ordered_json::object();
+        }
+        output = ConvertSdfWithSession(sdf_model_json, sdf_mapping_json, sdf_converter);
+    }
+    return output;
+}
+
+//! Function used to check that conversions on the same thread do not influence each other
+//! The inputs of every test case get converted one after the other on this thread, the sdf-models by a single reused
+//! converter session. Every sdf-model gets converted a second time without its sdfRequired qualities and its
+//! sdf-mapping. Every result has to equal the result of a conversion on a fresh thread.
+void RunReusedConversions(const std::vector<GoldenCase>& golden_cases, GoldenResult& result) {
+    Converter reused_converter{std::list<matter::Cluster>()};
+    for (const auto& golden_case : golden_cases) {
+        for (bool stripped : {false, true}) {
+            if (stripped and golden_case.direction != "sdf-to-matter") {
+                continue;
+            }
+            std::string reused = ConvertWithSession(golden_case, reused_converter, stripped);
+            std::string fresh;
+            std::thread thread([&]() {
+                Converter fresh_converter{std::list<matter::Cluster>()};
+                fresh = ConvertWithSession(golden_case, fresh_converter, stripped);
+            });
+            thread.join();
+            if (reused != fresh) {
+                result.differences.push_back({golden_case.direction + "/" + golden_case.path.filename().string() +
+                                              (stripped ? ".stripped" : ""),
+                                              "<fresh conversion>", "<differs after previous conversions>"});
+            }
+        }
+    }
+}
+
+//! Sdf-model with sdfRefs together with its expected resolution
+struct SdfRefCase {
+    const char* name;
+    const char* sdf_model;
+    const char* expected;
+};
+
+//! Function used to check that reading and parsing a sdf-model resolve sdfRefs the same way
+//! Every sdf-model gets read by sdf::ReadSdfModel and parsed by sdf::ParseSdfModel. Both models have to be equal and
+//! have to serialize to the expected resolution.
+void RunSdfRefCases(GoldenResult& result) {
+    const SdfRefCase kSdfRefCases[] = {
+        // Null removes a quality of the target
+        {"null-quality",
+         R"({"sdfObject": {"O": {"sdfData": {"D": {"type": "string", "description": "d"}},
+             "sdfProperty": {"P": {"sdfRef": "#/sdfObject/O/sdfData/D", "description": null}}}}})",
+         R"({"sdfObject": {"O": {"sdfProperty": {"P": {"sdfRef": "#/sdfObject/O/sdfData/D", "type": "string"}},
+             "sdfData": {"D": {"description": "d", "type": "string"}}}}})"},
+        // Null removes an element of a map of the target
+        {"null-element",
+         R"({"sdfObject": {"O": {"sdfData": {"D": {"sdfChoice": {"a": {"const": 1}, "b": {"const": 2}},
+             "properties": {"x": {"type": "string"}, "y": {"type": "string"}}}},
+             "sdfProperty": {"P": {"sdfRef": "#/sdfObject/O/sdfData/D", "sdfChoice": {"a": null},
+             "properties": {"y": null}}}}}})",
+         R"({"sdfObject": {"O": {"sdfProperty": {"P": {"sdfRef": "#/sdfObject/O/sdfData/D",
+             "sdfChoice": {"b": {"const": 2.0}}, "properties": {"x": {"type": "string"}}}},
+             "sdfData": {"D": {"sdfChoice": {"a": {"const": 1.0}, "b": {"const": 2.0}},
+             "properties": {"x": {"type": "string"}, "y": {"type": "string"}}}}}}})"},
+        // The target of a sdfRef gets resolved before it is merged
+        {"chain",
+         R"({"sdfObject": {"O": {"sdfData": {"A": {"type": "integer", "minimum": 1},
+             "B": {"sdfRef": "#/sdfObject/O/sdfData/A", "maximum": 5}},
+             "sdfProperty": {"P": {"sdfRef": "#/sdfObject/O/sdfData/B"}}}}})",
+         R"({"sdfObject": {"O": {"sdfProperty": {"P": {"sdfRef": "#/sdfObject/O/sdfData/B", "type": "integer",
+             "minimum": 1, "maximum": 5}}, "sdfData": {"A": {"type": "integer", "minimum": 1},
+             "B": {"sdfRef": "#/sdfObject/O/sdfData/A", "type": "integer", "minimum": 1, "maximum": 5}}}}})"},
+        // A repeated key replaces the previous value
+        {"repeated-key",
+         R"({"sdfObject": {"O": {"sdfProperty": {"P": {"type": "string"}},
+             "sdfProperty": {"Q": {"type": "integer", "type": "string", "items": {"minimum": 1}, "items": null}}}}})",
+         R"({"sdfObject": {"O": {"sdfProperty": {"Q": {"type": "string"}}}}})"},
+    };
+
+    for (const auto& sdf_ref_case : kSdfRefCases) {
+        std::string path = std::string("sdfRef/") + sdf_ref_case.name;
+        nlohmann::ordered_json sdf_model_json = nlohmann::ordered_json::parse(sdf_ref_case.sdf_model);
+        sdf::SdfModel read_sdf_model = sdf::ReadSdfModel(sdf_ref_case.sdf_model, std::strlen(sdf_ref_case.sdf_model));
+        model_diff::DiffSdfModel(sdf::ParseSdfModel(sdf_model_json), read_sdf_model, path, result.differences);
+        model_diff::DiffJson(nlohmann::ordered_json::parse(sdf_ref_case.expected),
+                             sdf::SerializeSdfModel(read_sdf_model), path, result.differences);
+    }
+}
+
+//! Function used to collect the test cases of the corpus
+std::vector<GoldenCase> CollectCases(const fs::path& corpus) {
+    std::vector<GoldenCase> golden_cases;
+    for (const char* direction : {"matter-to-sdf", "sdf-to-matter"}) {
+        if (!fs::exists(corpus / direction)) {
+            continue;
+        }
+        for (const auto& entry : fs::directory_iterator(corpus / direction)) {
+            if (entry.is_directory()) {
+                golden_cases.push_back({direction, entry.path()});
+            }
+        }
+    }
+    std::sort(golden_cases.begin(), golden_cases.end(), [](const GoldenCase& lhs, const GoldenCase& rhs) {
+        return lhs.path < rhs.path;
+    });
+    return golden_cases;
+}
+
+//! Main function
+//! Function used to check that a batch of files larger than the limit of open descriptors gets loaded completely
+//! The files of the corpus get loaded many times over with a lowered limit, every copy has to have the content of its
+//! file. Has to run while no other test case opens files.
+void RunLoadBeyondDescriptorLimit(const std::vector<GoldenCase>& golden_cases, GoldenResult& result) {
+    const rlim_t kLowerLimit = 64;
+    std::vector<std::string> corpus_paths;
+    for (const auto& golden_case : golden_cases) {
+        for (const auto& entry : fs::recursive_directory_iterator(golden_case.path)) {
+            if (entry.is_regular_file()) {
+                corpus_paths.push_back(entry.path().string());
+            }
+        }
+    }
+    std::vector<loader::LoadedFile> expected_files = loader::LoadFiles(corpus_paths, loader::Backend::kThreads);
+    std::vector<std::string> paths;
+    while (!corpus_paths.empty() and paths.size() < 4 * kLowerLimit) {
+        paths.insert(paths.end(), corpus_paths.begin(), corpus_paths.end());
+    }
+
+    struct rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        throw std::runtime_error("Failed to query the limit of open descriptors");
+    }
+    struct rlimit lowered_limit = limit;
+    lowered_limit.rlim_cur = std::min(limit.rlim_cur, kLowerLimit);
+    if (setrlimit(RLIMIT_NOFILE, &lowered_limit) != 0) {
+        throw std::runtime_error("Failed to lower the limit of open descriptors");
+    }
+    std::vector<loader::LoadedFile> files = loader::LoadFiles(paths);
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    for (std::size_t i = 0; i < files.size(); i++) {
+        const loader::LoadedFile& expected = expected_files[i % expected_files.size()];
+        if (files[i].error != 0 or files[i].size != expected.size or
+            (expected.size > 0 and std::memcmp(files[i].data.get(), expected.data.get(), expected.size) != 0)) {
+            result.differences.push_back({"files[" + std::to_string(i) + "]", expected.path,
+                                          files[i].error != 0 ? std::strerror(files[i].error) : "<different content>"});
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Define the program name
+    argparse::ArgumentParser program("golden-test");
+
+    program.add_argument("-corpus")
+            .help("Path to the corpus containing the test cases")
+            .default_value(std::string(GOLDEN_CORPUS));
+
+    program.add_argument("-jobs")
+            .help("Number of test cases converted in parallel, defaults to the number of processors")
+            .default_value(0)
+            .scan<'i', int>();
+
+    program.add_argument("-max-differences")
+            .help("Maximal number of printed differences per test case")
+            .default_value(20)
+            .scan<'i', int>();
+
+    program.add_argument("--update")
+            .help("Overwrite the golden files with the current output instead of comparing them")
+            .default_value(false)
+            .implicit_value(true);
+
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << program;
+        std::exit(1);
+    }
+
+    std::vector<GoldenCase> golden_cases = CollectCases(program.get<std::string>("-corpus"));
+    if (golden_cases.empty()) {
+        std::cerr << "No test cases found in " << program.get<std::string>("-corpus") << std::endl;
+        return 1;
+    }
+    bool update = program.get<bool>("--update");
+    std::size_t max_differences = std::max(program.get<int>("-max-differences"), 0);
+    std::size_t jobs = program.get<int>("-jobs") > 0 ? program.get<int>("-jobs") : std::thread::hardware_concurrency();
+    jobs = std::clamp<std::size_t>(jobs, 1, golden_cases.size());
+
+    // Every worker takes the next test case until all test cases are done
+    std::vector<GoldenResult> results(golden_cases.size());
+    std::atomic<std::size_t> next_case = 0;
+    auto worker = [&]() {
+        for (std::size_t i = next_case++; i < golden_cases.size(); i = next_case++) {
+            try {
+                if (golden_cases[i].direction == "matter-to-sdf") {
+                    RunMatterToSdf(golden_cases[i], update, results[i]);
+                } else {
+                    RunSdfToMatter(golden_cases[i], update, results[i]);
+                }
+            }
+            catch (const std::exception& err) {
+                results[i].error = err.what();
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < jobs; i++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    // The conversions of every test case get repeated on a single thread, which has to give the same results
+    if (!update) {
+        golden_cases.push_back({"reused", "conversions"});
+        results.emplace_back();
+        try {
+            RunReusedConversions(std::vector<GoldenCase>(golden_cases.begin(), golden_cases.end() - 1),
+                                 results.back());
+        }
+        catch (const std::exception& err) {
+            results.back().error = err.what();
+        }
+
+        golden_cases.push_back({"sdf", "references"});
+        results.emplace_back();
+        try {
+            RunSdfRefCases(results.back());
+        }
+        catch (const std::exception& err) {
+            results.back().error = err.what();
+        }
+
+        golden_cases.push_back({"loader", "descriptors"});
+        results.emplace_back();
+        try {
+            RunLoadBeyondDescriptorLimit(std::vector<GoldenCase>(golden_cases.begin(), golden_cases.end() - 3),
+                                         results.back());
+        }
+        catch (const std::exception& err) {
+            results.back().error = err.what();
+        }
+    }
+
+    std::size_t failed = 0;
+    for (std::size_t i = 0; i < golden_cases.size(); i++) {
+        const GoldenResult& result = results[i];
+        std::string name = golden_cases[i].direction + "/" + golden_cases[i].path.filename().string();
+        if (!result.error.empty()) {
+            std::cout << "ERROR  " << name << ": " << result.error << std::endl;
+            failed++;
+        } else if (update) {
+            std::cout << "UPDATE " << name << std::endl;
+        } else if (!result.differences.empty()) {
+            std::cout << "FAIL   " << name << ": " << result.differences.size() << " differences" << std::endl;
+            for (std::size_t j = 0; j < result.differences.size() and j < max_differences; j++) {
+                const auto& difference = result.differences[j];
+                std::cout << "    " << difference.path << ": expected " << difference.expected << ", got "
+                          << difference.actual << std::endl;
+            }
+            failed++;
+        } else {
+            std::cout << "OK     " << name << std::endl;
+        }
+    }
+    std::cout << golden_cases.size() - failed << " of " << golden_cases.size() << " test cases passed" << std::endl;
+    return failed > 0 ? 1 : 0;
+}
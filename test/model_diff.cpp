@@ -0,0 +1,646 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Structural comparison of Matter and sdf models, used to check conversions for unchanged output.
+ */
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "model_diff.h"
+
+namespace model_diff {
+
+namespace {
+
+//! Value used for elements that only exist in one of the models
+const char* const kMissing = "<missing>";
+
+//! Functions used to describe a value for the report
+std::string Describe(const std::string& value);
+std::string Describe(bool value);
+std::string Describe(const std::monostate&);
+std::string Describe(const nlohmann::json& value);
+std::string Describe(const nlohmann::ordered_json& value);
+template <typename T> std::enable_if_t<std::is_arithmetic_v<T>, std::string> Describe(T value);
+template <typename T> std::string Describe(const std::optional<T>& value);
+template <typename... Types> std::string Describe(const std::variant<Types...>& value);
+template <typename T> std::string Describe(const std::list<T>& value);
+template <typename First, typename Second> std::string Describe(const std::pair<First, Second>& value);
+
+//! Functions used to describe the key of a map for the path
+std::string DescribeKey(const std::string& key);
+template <typename T> std::string DescribeKey(T key);
+
+//! Functions used to compare values, lists and maps
+template <typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                const T& expected, const T& actual);
+template <typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                const std::optional<T>& expected, const std::optional<T>& actual);
+template <typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                const std::list<T>& expected, const std::list<T>& actual);
+template <typename Key, typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                              const std::map<Key, T>& expected, const std::map<Key, T>& actual);
+template <typename Key, typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                              const OrderedMap<Key, T>& expected,
+                                              const OrderedMap<Key, T>& actual);
+
+//! Functions used to compare the structures of the models
+//! Declared up front, so the templates above find them for nested elements.
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::OtherQuality& expected, const matter::OtherQuality& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Constraint& expected, const matter::Constraint& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Conformance& expected, const matter::Conformance& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Access& expected, const matter::Access& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Item& expected, const matter::Item& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Bitfield& expected, const matter::Bitfield& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::DataField& expected, const matter::DataField& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Feature& expected, const matter::Feature& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Event& expected, const matter::Event& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Command& expected, const matter::Command& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Attribute& expected, const matter::Attribute& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::ClusterClassification& expected, const matter::ClusterClassification& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::DeviceClassification& expected, const matter::DeviceClassification& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Cluster& expected, const matter::Cluster& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::JsoItem& expected, const sdf::JsoItem& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::DataQuality& expected, const sdf::DataQuality& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfEvent& expected, const sdf::SdfEvent& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfAction& expected, const sdf::SdfAction& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfProperty& expected, const sdf::SdfProperty& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfObject& expected, const sdf::SdfObject& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfThing& expected, const sdf::SdfThing& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::NamespaceBlock& expected, const sdf::NamespaceBlock& actual);
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::InformationBlock& expected, const sdf::InformationBlock& actual);
+
+std::string Describe(const std::string& value) {
+    return "\"" + value + "\"";
+}
+
+std::string Describe(bool value) {
+    return value ? "true" : "false";
+}
+
+std::string Describe(const std::monostate&) {
+    return "null";
+}
+
+std::string Describe(const nlohmann::json& value) {
+    return value.dump();
+}
+
+std::string Describe(const nlohmann::ordered_json& value) {
+    return value.dump();
+}
+
+//! Numbers are described like the json library prints them, so doubles keep their shortest representation
+template <typename T> std::enable_if_t<std::is_arithmetic_v<T>, std::string> Describe(T value) {
+    return nlohmann::json(+value).dump();
+}
+
+template <typename T> std::string Describe(const std::optional<T>& value) {
+    return value.has_value() ? Describe(value.value()) : "null";
+}
+
+//! Variants additionally get described by the index of their type, as e.g. 1 and 1.0 are different values
+template <typename... Types> std::string Describe(const std::variant<Types...>& value) {
+    return std::visit([](const auto& item) { return Describe(item); }, value) +
+           " (type " + std::to_string(value.index()) + ")";
+}
+
+template <typename T> std::string Describe(const std::list<T>& value) {
+    std::string result = "[";
+    for (const auto& item : value) {
+        if (result.size() > 1) {
+            result += ", ";
+        }
+        result += Describe(item);
+    }
+    return result + "]";
+}
+
+template <typename First, typename Second> std::string Describe(const std::pair<First, Second>& value) {
+    return "(" + Describe(value.first) + ", " + Describe(value.second) + ")";
+}
+
+std::string DescribeKey(const std::string& key) {
+    return key;
+}
+
+template <typename T> std::string DescribeKey(T key) {
+    return std::to_string(+key);
+}
+
+//! Function used to compare two plain values
+template <typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                const T& expected, const T& actual) {
+    if (!(expected == actual)) {
+        differences.push_back({path, Describe(expected), Describe(actual)});
+    }
+}
+
+//! Function used to compare two optional values
+template <typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                const std::optional<T>& expected, const std::optional<T>& actual) {
+    if (expected.has_value() and actual.has_value()) {
+        Diff(differences, path, expected.value(), actual.value());
+    } else if (expected.has_value()) {
+        differences.push_back({path, "<present>", kMissing});
+    } else if (actual.has_value()) {
+        differences.push_back({path, kMissing, "<present>"});
+    }
+}
+
+//! Trait used to detect elements that are identified by their name
+template <typename T, typename = void> struct HasName : std::false_type {};
+template <typename T> struct HasName<T, std::void_t<decltype(std::declval<const T&>().name)>>
+        : std::is_same<std::decay_t<decltype(std::declval<const T&>().name)>, std::string> {};
+
+//! Function used to index a list of named elements by their name
+//! Returns false if a name is used more than once, as the elements can not be matched by their name in that case.
+template <typename T> bool IndexByName(const std::list<T>& list, std::map<std::string, const T*>& index) {
+    for (const auto& item : list) {
+        if (!index.emplace(item.name, &item).second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Function used to compare two lists
+//! Lists of uniquely named elements get matched by the names of their elements, as a conversion does not necessarily
+//! keep their order. Every other list gets compared element by element, if the sizes differ, the
+//! common elements still get compared.
+template <typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                const std::list<T>& expected, const std::list<T>& actual) {
+    if constexpr (HasName<T>::value) {
+        std::map<std::string, const T*> expected_index;
+        std::map<std::string, const T*> actual_index;
+        if (IndexByName(expected, expected_index) and IndexByName(actual, actual_index)) {
+            for (const auto& item : expected_index) {
+                auto actual_it = actual_index.find(item.first);
+                if (actual_it == actual_index.end()) {
+                    differences.push_back({path + "[" + item.first + "]", "<present>", kMissing});
+                } else {
+                    Diff(differences, path + "[" + item.first + "]", *item.second, *actual_it->second);
+                }
+            }
+            for (const auto& item : actual_index) {
+                if (expected_index.count(item.first) == 0) {
+                    differences.push_back({path + "[" + item.first + "]", kMissing, "<present>"});
+                }
+            }
+            return;
+        }
+    }
+    if (expected.size() != actual.size()) {
+        differences.push_back({path + ".size", std::to_string(expected.size()), std::to_string(actual.size())});
+    }
+    auto expected_it = expected.begin();
+    auto actual_it = actual.begin();
+    for (std::size_t i = 0; expected_it != expected.end() and actual_it != actual.end();
+         i++, expected_it++, actual_it++) {
+        Diff(differences, path + "[" + std::to_string(i) + "]", *expected_it, *actual_it);
+    }
+}
+
+//! Function used to compare two maps by their keys
+//! The keys get sorted, so the order of the differences does not depend on the order of the map.
+template <typename Map> void DiffMap(std::vector<Difference>& differences, const std::string& path,
+                                     const Map& expected, const Map& actual) {
+    std::vector<typename Map::key_type> keys;
+    for (const auto& item : expected) {
+        keys.push_back(item.first);
+    }
+    for (const auto& item : actual) {
+        if (expected.count(item.first) == 0) {
+            keys.push_back(item.first);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    for (const auto& key : keys) {
+        std::string key_path = path + "[" + DescribeKey(key) + "]";
+        auto expected_it = expected.find(key);
+        auto actual_it = actual.find(key);
+        if (expected_it == expected.end()) {
+            differences.push_back({key_path, kMissing, "<present>"});
+        } else if (actual_it == actual.end()) {
+            differences.push_back({key_path, "<present>", kMissing});
+        } else {
+            Diff(differences, key_path, expected_it->second, actual_it->second);
+        }
+    }
+}
+
+template <typename Key, typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                              const std::map<Key, T>& expected, const std::map<Key, T>& actual) {
+    DiffMap(differences, path, expected, actual);
+}
+
+template <typename Key, typename T> void Diff(std::vector<Difference>& differences, const std::string& path,
+                                              const OrderedMap<Key, T>& expected,
+                                              const OrderedMap<Key, T>& actual) {
+    DiffMap(differences, path, expected, actual);
+}
+
+//! Macro used to compare a member of the expected and the actual structure
+#define DIFF_MEMBER(member) Diff(differences, path + "." #member, expected.member, actual.member)
+
+//! Function used to compare the common qualities of Matter elements
+void DiffCommonQuality(std::vector<Difference>& differences, const std::string& path,
+                       const matter::CommonQuality& expected, const matter::CommonQuality& actual) {
+    DIFF_MEMBER(id);
+    DIFF_MEMBER(name);
+    DIFF_MEMBER(conformance);
+    DIFF_MEMBER(access);
+    DIFF_MEMBER(summary);
+}
+
+//! Function used to compare the common qualities of sdf elements
+void DiffCommonQuality(std::vector<Difference>& differences, const std::string& path,
+                       const sdf::CommonQuality& expected, const sdf::CommonQuality& actual) {
+    DIFF_MEMBER(description);
+    DIFF_MEMBER(label);
+    DIFF_MEMBER(comment);
+    DIFF_MEMBER(sdf_ref);
+    DIFF_MEMBER(sdf_required);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::OtherQuality& expected, const matter::OtherQuality& actual) {
+    DIFF_MEMBER(nullable);
+    DIFF_MEMBER(non_volatile);
+    DIFF_MEMBER(fixed);
+    DIFF_MEMBER(scene);
+    DIFF_MEMBER(reportable);
+    DIFF_MEMBER(change_omitted);
+    DIFF_MEMBER(singleton);
+    DIFF_MEMBER(diagnostics);
+    DIFF_MEMBER(large_message);
+    DIFF_MEMBER(quieter_reporting);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Constraint& expected, const matter::Constraint& actual) {
+    DIFF_MEMBER(type);
+    DIFF_MEMBER(value);
+    DIFF_MEMBER(min);
+    DIFF_MEMBER(max);
+    DIFF_MEMBER(entry_type);
+    // The constraint of the entries is owned by pointer
+    if (expected.entry_constraint != nullptr and actual.entry_constraint != nullptr) {
+        Diff(differences, path + ".entry_constraint", *expected.entry_constraint, *actual.entry_constraint);
+    } else if (expected.entry_constraint != nullptr) {
+        differences.push_back({path + ".entry_constraint", "<present>", kMissing});
+    } else if (actual.entry_constraint != nullptr) {
+        differences.push_back({path + ".entry_constraint", kMissing, "<present>"});
+    }
+    DIFF_MEMBER(byte_size);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Conformance& expected, const matter::Conformance& actual) {
+    DIFF_MEMBER(mandatory);
+    DIFF_MEMBER(optional);
+    DIFF_MEMBER(provisional);
+    DIFF_MEMBER(deprecated);
+    DIFF_MEMBER(disallowed);
+    DIFF_MEMBER(otherwise);
+    DIFF_MEMBER(choice);
+    DIFF_MEMBER(choice_more);
+    DIFF_MEMBER(condition);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Access& expected, const matter::Access& actual) {
+    DIFF_MEMBER(read);
+    DIFF_MEMBER(write);
+    DIFF_MEMBER(fabric_scoped);
+    DIFF_MEMBER(fabric_sensitive);
+    DIFF_MEMBER(read_privilege);
+    DIFF_MEMBER(write_privilege);
+    DIFF_MEMBER(invoke_privilege);
+    DIFF_MEMBER(timed);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Item& expected, const matter::Item& actual) {
+    DIFF_MEMBER(value);
+    DIFF_MEMBER(name);
+    DIFF_MEMBER(summary);
+    DIFF_MEMBER(conformance);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Bitfield& expected, const matter::Bitfield& actual) {
+    DIFF_MEMBER(bit);
+    DIFF_MEMBER(name);
+    DIFF_MEMBER(summary);
+    DIFF_MEMBER(conformance);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::DataField& expected, const matter::DataField& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(type);
+    DIFF_MEMBER(constraint);
+    DIFF_MEMBER(quality);
+    DIFF_MEMBER(default_);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Feature& expected, const matter::Feature& actual) {
+    DIFF_MEMBER(bit);
+    DIFF_MEMBER(conformance);
+    DIFF_MEMBER(code);
+    DIFF_MEMBER(name);
+    DIFF_MEMBER(summary);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Event& expected, const matter::Event& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(priority);
+    DIFF_MEMBER(quality);
+    DIFF_MEMBER(data);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Command& expected, const matter::Command& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(direction);
+    DIFF_MEMBER(response);
+    DIFF_MEMBER(command_fields);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Attribute& expected, const matter::Attribute& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(type);
+    DIFF_MEMBER(constraint);
+    DIFF_MEMBER(quality);
+    DIFF_MEMBER(default_);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::ClusterClassification& expected, const matter::ClusterClassification& actual) {
+    DIFF_MEMBER(hierarchy);
+    DIFF_MEMBER(role);
+    DIFF_MEMBER(pics_code);
+    DIFF_MEMBER(scope);
+    DIFF_MEMBER(base_cluster);
+    DIFF_MEMBER(primary_transaction);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::DeviceClassification& expected, const matter::DeviceClassification& actual) {
+    DIFF_MEMBER(superset);
+    DIFF_MEMBER(class_);
+    DIFF_MEMBER(scope);
+}
+
+//! The shared base cluster is not compared, as it only exists while mapping derived clusters
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const matter::Cluster& expected, const matter::Cluster& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(side);
+    DIFF_MEMBER(revision);
+    DIFF_MEMBER(revision_history);
+    DIFF_MEMBER(cluster_aliases);
+    DIFF_MEMBER(classification);
+    DIFF_MEMBER(feature_map);
+    DIFF_MEMBER(attributes);
+    DIFF_MEMBER(client_commands);
+    DIFF_MEMBER(server_commands);
+    DIFF_MEMBER(events);
+    DIFF_MEMBER(enums);
+    DIFF_MEMBER(bitmaps);
+    DIFF_MEMBER(structs);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::JsoItem& expected, const sdf::JsoItem& actual) {
+    DIFF_MEMBER(sdf_ref);
+    DIFF_MEMBER(description);
+    DIFF_MEMBER(comment);
+    DIFF_MEMBER(type);
+    DIFF_MEMBER(sdf_choice);
+    DIFF_MEMBER(enum_);
+    DIFF_MEMBER(minimum);
+    DIFF_MEMBER(maximum);
+    DIFF_MEMBER(min_length);
+    DIFF_MEMBER(max_length);
+    DIFF_MEMBER(format);
+    DIFF_MEMBER(properties);
+    DIFF_MEMBER(required);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::DataQuality& expected, const sdf::DataQuality& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(type);
+    DIFF_MEMBER(sdf_choice);
+    DIFF_MEMBER(enum_);
+    DIFF_MEMBER(const_);
+    DIFF_MEMBER(default_);
+    DIFF_MEMBER(minimum);
+    DIFF_MEMBER(maximum);
+    DIFF_MEMBER(exclusive_minimum);
+    DIFF_MEMBER(exclusive_maximum);
+    DIFF_MEMBER(multiple_of);
+    DIFF_MEMBER(min_length);
+    DIFF_MEMBER(max_length);
+    DIFF_MEMBER(pattern);
+    DIFF_MEMBER(format);
+    DIFF_MEMBER(min_items);
+    DIFF_MEMBER(max_items);
+    DIFF_MEMBER(unique_items);
+    DIFF_MEMBER(items);
+    DIFF_MEMBER(properties);
+    DIFF_MEMBER(required);
+    DIFF_MEMBER(unit);
+    DIFF_MEMBER(nullable);
+    DIFF_MEMBER(sdf_type);
+    DIFF_MEMBER(content_format);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfEvent& expected, const sdf::SdfEvent& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(sdf_output_data);
+    DIFF_MEMBER(sdf_data);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfAction& expected, const sdf::SdfAction& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(sdf_input_data);
+    DIFF_MEMBER(sdf_output_data);
+    DIFF_MEMBER(sdf_data);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfProperty& expected, const sdf::SdfProperty& actual) {
+    Diff(differences, path, static_cast<const sdf::DataQuality&>(expected),
+         static_cast<const sdf::DataQuality&>(actual));
+    DIFF_MEMBER(readable);
+    DIFF_MEMBER(writable);
+    DIFF_MEMBER(observable);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfObject& expected, const sdf::SdfObject& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(sdf_property);
+    DIFF_MEMBER(sdf_action);
+    DIFF_MEMBER(sdf_event);
+    DIFF_MEMBER(sdf_data);
+    DIFF_MEMBER(min_items);
+    DIFF_MEMBER(max_items);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::SdfThing& expected, const sdf::SdfThing& actual) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(sdf_thing);
+    DIFF_MEMBER(sdf_object);
+    DIFF_MEMBER(sdf_property);
+    DIFF_MEMBER(sdf_action);
+    DIFF_MEMBER(sdf_event);
+    DIFF_MEMBER(sdf_data);
+    DIFF_MEMBER(min_items);
+    DIFF_MEMBER(max_items);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::NamespaceBlock& expected, const sdf::NamespaceBlock& actual) {
+    DIFF_MEMBER(namespaces);
+    DIFF_MEMBER(default_namespace);
+}
+
+void Diff(std::vector<Difference>& differences, const std::string& path,
+          const sdf::InformationBlock& expected, const sdf::InformationBlock& actual) {
+    DIFF_MEMBER(title);
+    DIFF_MEMBER(description);
+    DIFF_MEMBER(version);
+    DIFF_MEMBER(modified);
+    DIFF_MEMBER(copyright);
+    DIFF_MEMBER(license);
+    DIFF_MEMBER(features);
+    DIFF_MEMBER(comment);
+}
+
+} // namespace
+
+//! Function used to compare two clusters
+void DiffCluster(const matter::Cluster& expected, const matter::Cluster& actual, const std::string& path,
+                 std::vector<Difference>& differences) {
+    Diff(differences, path, expected, actual);
+}
+
+//! Function used to compare two devices
+void DiffDevice(const matter::Device& expected, const matter::Device& actual, const std::string& path,
+                std::vector<Difference>& differences) {
+    DiffCommonQuality(differences, path, expected, actual);
+    DIFF_MEMBER(revision);
+    DIFF_MEMBER(revision_history);
+    DIFF_MEMBER(classification);
+    DIFF_MEMBER(conditions);
+    DIFF_MEMBER(clusters);
+}
+
+//! Function used to compare two sdf-models
+void DiffSdfModel(const sdf::SdfModel& expected, const sdf::SdfModel& actual, const std::string& path,
+                  std::vector<Difference>& differences) {
+    DIFF_MEMBER(information_block);
+    DIFF_MEMBER(namespace_block);
+    DIFF_MEMBER(sdf_thing);
+    DIFF_MEMBER(sdf_object);
+}
+
+//! Function used to compare two sdf-mappings
+void DiffSdfMapping(const sdf::SdfMapping& expected, const sdf::SdfMapping& actual, const std::string& path,
+                    std::vector<Difference>& differences) {
+    DIFF_MEMBER(information_block);
+    DIFF_MEMBER(namespace_block);
+    DIFF_MEMBER(map);
+}
+
+//! Function used to compare two json values
+void DiffJson(const nlohmann::ordered_json& expected, const nlohmann::ordered_json& actual, const std::string& path,
+              std::vector<Difference>& differences) {
+    if (expected.is_object() and actual.is_object()) {
+        for (const auto& item : expected.items()) {
+            auto actual_it = actual.find(item.key());
+            if (actual_it == actual.end()) {
+                differences.push_back({path + "." + item.key(), Describe(item.value()), kMissing});
+            } else {
+                DiffJson(item.value(), *actual_it, path + "." + item.key(), differences);
+            }
+        }
+        for (const auto& item : actual.items()) {
+            if (!expected.contains(item.key())) {
+                differences.push_back({path + "." + item.key(), kMissing, Describe(item.value())});
+            }
+        }
+    } else if (expected.is_array() and actual.is_array()) {
+        if (expected.size() != actual.size()) {
+            differences.push_back({path + ".size", std::to_string(expected.size()), std::to_string(actual.size())});
+        }
+        for (std::size_t i = 0; i < expected.size() and i < actual.size(); i++) {
+            DiffJson(expected[i], actual[i], path + "[" + std::to_string(i) + "]", differences);
+        }
+    } else if (expected != actual) {
+        differences.push_back({path, Describe(expected), Describe(actual)});
+    }
+}
+
+#undef DIFF_MEMBER
+
+} // namespace model_diff
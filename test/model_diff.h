@@ -0,0 +1,98 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Structural comparison of Matter and sdf models, used to check conversions for unchanged output.
+ */
+
+#ifndef SDF_MATTER_CONVERTER_TEST_MODEL_DIFF_H_
+#define SDF_MATTER_CONVERTER_TEST_MODEL_DIFF_H_
+
+#include <string>
+#include <vector>
+#include "matter.h"
+#include "sdf.h"
+
+namespace model_diff {
+
+//! Single difference between two models
+struct Difference {
+    //! Path of the differing element, e.g. `attributes[2].constraint.max`
+    std::string path;
+    //! Expected value, `<missing>` if the element only exists in the actual model
+    std::string expected;
+    //! Actual value, `<missing>` if the element only exists in the expected model
+    std::string actual;
+};
+
+//! @brief Compare two clusters.
+//!
+//! Maps and lists of uniquely named elements get compared by their keys, so their order does not matter. Every other list gets compared element by element.
+//!
+//! @param expected The expected cluster.
+//! @param actual The actual cluster.
+//! @param path The path used as prefix for the differences.
+//! @param differences The list the found differences get appended to.
+void DiffCluster(const matter::Cluster& expected, const matter::Cluster& actual, const std::string& path,
+                 std::vector<Difference>& differences);
+
+//! @brief Compare two devices.
+//!
+//! @param expected The expected device.
+//! @param actual The actual device.
+//! @param path The path used as prefix for the differences.
+//! @param differences The list the found differences get appended to.
+void DiffDevice(const matter::Device& expected, const matter::Device& actual, const std::string& path,
+                std::vector<Difference>& differences);
+
+//! @brief Compare two sdf-models.
+//!
+//! @param expected The expected sdf-model.
+//! @param actual The actual sdf-model.
+//! @param path The path used as prefix for the differences.
+//! @param differences The list the found differences get appended to.
+void DiffSdfModel(const sdf::SdfModel& expected, const sdf::SdfModel& actual, const std::string& path,
+                  std::vector<Difference>& differences);
+
+//! @brief Compare two sdf-mappings.
+//!
+//! @param expected The expected sdf-mapping.
+//! @param actual The actual sdf-mapping.
+//! @param path The path used as prefix for the differences.
+//! @param differences The list the found differences get appended to.
+void DiffSdfMapping(const sdf::SdfMapping& expected, const sdf::SdfMapping& actual, const std::string& path,
+                    std::vector<Difference>& differences);
+
+//! @brief Compare two json documents.
+//!
+//! Objects get compared by their keys, so the order of the keys does not matter. Arrays get compared element by
+//! element.
+//!
+//! @param expected The expected json document.
+//! @param actual The actual json document.
+//! @param path The path used as prefix for the differences.
+//! @param differences The list the found differences get appended to.
+void DiffJson(const nlohmann::ordered_json& expected, const nlohmann::ordered_json& actual, const std::string& path,
+              std::vector<Difference>& differences);
+
+} // namespace model_diff
+
+#endif //SDF_MATTER_CONVERTER_TEST_MODEL_DIFF_H_
@@ -0,0 +1,301 @@
+/**
+ *  Copyright 2024 Niklas Meyer
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/**
+ * @file
+ * @author Niklas Meyer <nik_mey@uni-bremen.de>
+ *
+ * @section Description
+ *
+ * Harness that runs round trips over a corpus in memory.
+ * Reports the round trips per second and the structural differences between the input and the output models.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+#include <argparse/argparse.hpp>
+#include <nlohmann/json.hpp>
+#include <pugixml.hpp>
+#include "converter.h"
+#include "matter.h"
+#include "model_diff.h"
+#include "sdf.h"
+
+//! Result of the round trips of a single corpus entry
+struct RoundTripResult {
+    std::string name;
+    std::size_t iterations = 0;
+    double seconds = 0;
+    std::vector<model_diff::Difference> differences;
+};
+
+//! Function used to collect the files of a corpus with the given suffix, sorted by path
+std::vector<std::filesystem::path> CollectFiles(const std::string& directory, const std::string& suffix) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
+        const std::string path = entry.path().string();
+        if (entry.is_regular_file() and path.size() >= suffix.size() and
+            path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+//! Function used to compare the Matter input of a round trip with its output
+void DiffMatter(const std::optional<pugi::xml_document>& device_xml,
+                const std::list<pugi::xml_document>& cluster_xml_list,
+                const std::optional<pugi::xml_document>& output_device_xml,
+                const std::list<pugi::xml_document>& output_cluster_xml_list,
+                std::vector<model_diff::Difference>& differences) {
+    std::list<matter::Cluster> cluster_list;
+    for (const auto& cluster_xml : cluster_xml_list) {
+        cluster_list.push_back(matter::ParseCluster(cluster_xml.document_element()));
+    }
+
+    std::list<uint32_t> expected_ids;
+    if (device_xml.has_value()) {
+        matter::Device device = matter::ParseDevice(device_xml->document_element());
+        for (const auto& device_cluster : device.clusters) {
+            expected_ids.push_back(device_cluster.id);
+        }
+        if (output_device_xml.has_value()) {
+            model_diff::DiffDevice(device, matter::ParseDevice(output_device_xml->document_element()), "Device",
+                                   differences);
+        } else {
+            differences.push_back({"Device", "<present>", "<missing>"});
+        }
+    } else {
+        for (const auto& cluster : cluster_list) {
+            expected_ids.push_back(cluster.id);
+        }
+    }
+
+    // The output clusters get matched by their id, as their order depends on the sdf-model
+    for (const auto& output_cluster_xml : output_cluster_xml_list) {
+        matter::Cluster output_cluster = matter::ParseCluster(output_cluster_xml.document_element());
+        std::string path = "Cluster[" + IntToHex(output_cluster.id) + "]";
+        auto cluster_it = std::find_if(cluster_list.begin(), cluster_list.end(), [&](const matter::Cluster& cluster) {
+            return cluster.id == output_cluster.id;
+        });
+        if (cluster_it == cluster_list.end()) {
+            differences.push_back({path, "<missing>", "<present>"});
+            continue;
+        }
+        model_diff::DiffCluster(*cluster_it, output_cluster, path, differences);
+        expected_ids.remove(output_cluster.id);
+    }
+    for (uint32_t id : expected_ids) {
+        if (std::any_of(cluster_list.begin(), cluster_list.end(),
+                        [&](const matter::Cluster& cluster) { return cluster.id == id; })) {
+            differences.push_back({"Cluster[" + IntToHex(id) + "]", "<present>", "<missing>"});
+        }
+    }
+}
+
+//! Function used to run the round trip Matter -> SDF -> Matter
+RoundTripResult RoundTripMatter(const std::string& name, const std::optional<pugi::xml_document>& device_xml,
+                                const std::list<pugi::xml_document>& cluster_xml_list, std::size_t iterations) {
+    RoundTripResult result;
+    result.name = name;
+    std::optional<pugi::xml_document> output_device_xml;
+    std::list<pugi::xml_document> output_cluster_xml_list;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        sdf::SdfModel sdf_model;
+        sdf::SdfMapping sdf_mapping;
+        output_device_xml.reset();
+        output_cluster_xml_list.clear();
+        ConvertMatterToSdf(device_xml, cluster_xml_list, sdf_model, sdf_mapping);
+        ConvertSdfToMatter(sdf_model, sdf_mapping, output_device_xml, output_cluster_xml_list);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.iterations = iterations;
+
+    DiffMatter(device_xml, cluster_xml_list, output_device_xml, output_cluster_xml_list, result.differences);
+    return result;
+}
+
+//! Function used to run the round trip SDF -> Matter -> SDF
+RoundTripResult RoundTripSdf(const std::string& name, const nlohmann::ordered_json& sdf_model_json,
+                             const nlohmann::ordered_json& sdf_mapping_json, std::size_t iterations) {
+    RoundTripResult result;
+    result.name = name;
+    sdf::SdfModel output_sdf_model;
+    sdf::SdfMapping output_sdf_mapping;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        nlohmann::ordered_json input_sdf_model_json = sdf_model_json;
+        nlohmann::ordered_json input_sdf_mapping_json = sdf_mapping_json;
+        std::optional<pugi::xml_document> device_xml;
+        std::list<pugi::xml_document> cluster_xml_list;
+        output_sdf_model = sdf::SdfModel();
+        output_sdf_mapping = sdf::SdfMapping();
+        ConvertSdfToMatter(input_sdf_model_json, input_sdf_mapping_json, device_xml, cluster_xml_list);
+        ConvertMatterToSdf(device_xml, cluster_xml_list, output_sdf_model, output_sdf_mapping);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.iterations = iterations;
+
+    // Both sides get parsed the same way, so references are resolved in both sdf-models
+    nlohmann::ordered_json input_sdf_model_json = sdf_model_json;
+    nlohmann::ordered_json output_sdf_model_json = sdf::SerializeSdfModel(output_sdf_model);
+    model_diff::DiffSdfModel(sdf::ParseSdfModel(input_sdf_model_json), sdf::ParseSdfModel(output_sdf_model_json),
+                             "SdfModel", result.differences);
+    return result;
+}
+
+//! Function used to print the result of a corpus entry
+void PrintResult(const RoundTripResult& result, std::size_t max_differences) {
+    std::cout << result.name << ": " << result.iterations / result.seconds << " round trips/s, "
+              << result.differences.size() << " differences" << std::endl;
+    for (std::size_t i = 0; i < result.differences.size() and i < max_differences; i++) {
+        const auto& difference = result.differences[i];
+        std::cout << "    " << difference.path << ": expected " << difference.expected << ", got "
+                  << difference.actual << std::endl;
+    }
+    if (result.differences.size() > max_differences) {
+        std::cout << "    ..." << std::endl;
+    }
+}
+
+//! Main function
+int main(int argc, char *argv[]) {
+    // Define the program name
+    argparse::ArgumentParser program("roundtrip-harness");
+
+    program.add_argument("-matter-corpus")
+            .help("Path to a directory containing cluster and device type definitions\n"
+                  "Every cluster gets round-tripped on its own, every device type together with all clusters");
+
+    program.add_argument("-sdf-corpus")
+            .help("Path to a directory containing sdf-models and sdf-mappings\n"
+                  "Every file ending with -model.json gets round-tripped with the matching -mapping.json");
+
+    program.add_argument("-iterations")
+            .help("Number of round trips per corpus entry")
+            .default_value(10)
+            .scan<'i', int>();
+
+    program.add_argument("-max-differences")
+            .help("Maximal number of printed differences per corpus entry")
+            .default_value(20)
+            .scan<'i', int>();
+
+    program.add_argument("--fail-on-difference")
+            .help("Exit with an error if any round trip changes the model")
+            .default_value(false)
+            .implicit_value(true);
+
+    try {
+        program.parse_args(argc, argv);
+    }
+    catch (const std::exception &err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << program;
+        std::exit(1);
+    }
+
+    std::size_t iterations = std::max(program.get<int>("-iterations"), 1);
+    std::size_t max_differences = std::max(program.get<int>("-max-differences"), 0);
+    std::list<RoundTripResult> results;
+
+    if (program.is_used("-matter-corpus")) {
+        // Sort the corpus into clusters and device types by their root element
+        std::list<pugi::xml_document> cluster_xml_list;
+        std::list<std::string> cluster_names;
+        std::list<std::pair<std::string, pugi::xml_document>> device_xml_list;
+        for (const auto& path : CollectFiles(program.get<std::string>("-matter-corpus"), ".xml")) {
+            pugi::xml_document xml_document;
+            if (!xml_document.load_file(path.c_str())) {
+                std::cerr << "Failed to load XML file: " << path << std::endl;
+                return 1;
+            }
+            if (std::string(xml_document.document_element().name()) == "deviceType") {
+                device_xml_list.emplace_back(path.string(), std::move(xml_document));
+            } else {
+                cluster_xml_list.push_back(std::move(xml_document));
+                cluster_names.push_back(path.string());
+            }
+        }
+
+        auto cluster_name = cluster_names.begin();
+        for (const auto& cluster_xml : cluster_xml_list) {
+            std::list<pugi::xml_document> single_cluster_xml_list;
+            single_cluster_xml_list.emplace_back().reset(cluster_xml);
+            results.push_back(RoundTripMatter(*cluster_name++, std::nullopt, single_cluster_xml_list, iterations));
+            PrintResult(results.back(), max_differences);
+        }
+        for (const auto& device_xml : device_xml_list) {
+            std::optional<pugi::xml_document> optional_device_xml;
+            optional_device_xml.emplace().reset(device_xml.second);
+            results.push_back(RoundTripMatter(device_xml.first, optional_device_xml, cluster_xml_list, iterations));
+            PrintResult(results.back(), max_differences);
+        }
+    }
+
+    if (program.is_used("-sdf-corpus")) {
+        for (const auto& path : CollectFiles(program.get<std::string>("-sdf-corpus"), "-model.json")) {
+            std::string path_sdf_mapping = path.string();
+            path_sdf_mapping.replace(path_sdf_mapping.size() - 11, 6, "-mapping");
+            nlohmann::ordered_json sdf_model_json;
+            nlohmann::ordered_json sdf_mapping_json;
+            try {
+                std::ifstream sdf_model_file(path);
+                sdf_model_json = nlohmann::ordered_json::parse(sdf_model_file);
+                std::ifstream sdf_mapping_file(path_sdf_mapping);
+                sdf_mapping_json = nlohmann::ordered_json::parse(sdf_mapping_file);
+            }
+            catch (const std::exception& err) {
+                std::cerr << "Failed to load JSON file: " << err.what() << std::endl;
+                return 1;
+            }
+            results.push_back(RoundTripSdf(path.string(), sdf_model_json, sdf_mapping_json, iterations));
+            PrintResult(results.back(), max_differences);
+        }
+    }
+
+    if (results.empty()) {
+        std::cout << program;
+        return 0;
+    }
+
+    double seconds = 0;
+    std::size_t round_trips = 0;
+    std::size_t differences = 0;
+    for (const auto& result : results) {
+        seconds += result.seconds;
+        round_trips += result.iterations;
+        differences += result.differences.size();
+    }
+    std::cout << "Total: " << round_trips / seconds << " round trips/s over " << results.size()
+              << " corpus entries, " << differences << " differences" << std::endl;
+
+    if (program.get<bool>("--fail-on-difference") and differences > 0) {
+        return 1;
+    }
+    return 0;
+}